@@ -0,0 +1,295 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include "benchmark.h"
+#include "binary_data/binary_data_file.h"
+
+using namespace undicht;
+using namespace bench;
+using namespace tools;
+
+// number of blocks stored / read / updated per iteration
+const uint32_t BLOCK_COUNT = 256;
+const uint32_t MIN_BLOCK_SIZE = 64;
+const uint32_t MAX_BLOCK_SIZE = 16384; // a compressed chunk is a few kilobytes
+
+// number of blocks in the file for the open() benchmarks
+const uint32_t OPEN_BLOCK_COUNT = 16384;
+
+////////////////////////////////////////// generating the benchmark data //////////////////////////////////////////
+
+static void createBlocks(BenchmarkState& state, std::vector<std::vector<char>>& blocks) {
+
+    blocks.resize(BLOCK_COUNT);
+
+    for(std::vector<char>& block : blocks) {
+
+        block.resize(state.random(MIN_BLOCK_SIZE, MAX_BLOCK_SIZE));
+
+        for(char& c : block)
+            c = char(state.random(0, 255));
+    }
+
+}
+
+static bool createFile(BenchmarkState& state, BinaryDataFile& file, const std::string& file_name, BinaryDataFile::Mode mode = BinaryDataFile::STREAM) {
+    // opens an empty file (BinaryDataFile::open() fails for files that dont exist yet)
+
+    std::ofstream empty_file(file_name, std::ios::out | std::ios::trunc);
+    empty_file.close();
+    std::remove((file_name + ".index").c_str()); // might be left from a previous run
+
+    if(!file.open(file_name, mode)) {
+        state.skip("could not create file " + file_name);
+        return false;
+    }
+
+    return true;
+}
+
+static void removeFile(const std::string& file_name) {
+    // removes the file and its block index
+
+    std::remove(file_name.c_str());
+    std::remove((file_name + ".index").c_str());
+}
+
+static void storeBlocks(BinaryDataFile& file, std::vector<std::vector<char>>& blocks, std::vector<uint64_t>& locations) {
+
+    locations.clear();
+
+    for(std::vector<char>& block : blocks)
+        locations.push_back(file.store(block.data(), block.size()));
+
+}
+
+////////////////////////////////////////// BinaryDataFile //////////////////////////////////////////
+
+static void benchStore(BenchmarkState& state, BinaryDataFile::Mode mode, bool transaction = false) {
+
+    std::string file_name = state.getDataFile("store.bin");
+
+    std::vector<std::vector<char>> blocks;
+    createBlocks(state, blocks);
+
+    BinaryDataFile file;
+    if(!createFile(state, file, file_name, mode))
+        return;
+
+    std::vector<uint64_t> locations;
+
+    state.setItemsPerIteration(blocks.size());
+    state.measure([&]() {
+        file.newBinaryFile();
+    }, [&]() {
+
+        if(transaction)
+            file.beginTransaction();
+
+        storeBlocks(file, blocks, locations);
+
+        if(transaction)
+            file.commitTransaction();
+
+    });
+
+    file.close();
+    removeFile(file_name);
+}
+
+static void benchRead(BenchmarkState& state, BinaryDataFile::Mode mode, bool zero_copy) {
+
+    std::string file_name = state.getDataFile("read.bin");
+
+    std::vector<std::vector<char>> blocks;
+    createBlocks(state, blocks);
+
+    BinaryDataFile file;
+    if(!createFile(state, file, file_name, mode))
+        return;
+
+    std::vector<uint64_t> locations;
+    storeBlocks(file, blocks, locations);
+
+    // reading in a random order, as when chunks get loaded around the player
+    for(uint32_t i = locations.size() - 1; i > 0; i--)
+        std::swap(locations.at(i), locations.at(state.random(0, i)));
+
+    std::vector<char> data;
+
+    state.setItemsPerIteration(locations.size());
+    state.measure([&]() {
+        for(uint64_t location : locations) {
+
+            if(zero_copy) {
+                const char* block;
+                size_t byte_size;
+                file.read(location, block, byte_size);
+                doNotOptimize(block);
+            } else {
+                file.read(location, data);
+                doNotOptimize(data.data());
+            }
+        }
+    });
+
+    file.close();
+    removeFile(file_name);
+}
+
+static void benchReadBatch(BenchmarkState& state, BinaryDataFile::Mode mode) {
+
+    std::string file_name = state.getDataFile("read_batch.bin");
+
+    std::vector<std::vector<char>> blocks;
+    createBlocks(state, blocks);
+
+    BinaryDataFile file;
+    if(!createFile(state, file, file_name, mode))
+        return;
+
+    std::vector<uint64_t> locations;
+    storeBlocks(file, blocks, locations);
+
+    // the same random order as in benchRead()
+    for(uint32_t i = locations.size() - 1; i > 0; i--)
+        std::swap(locations.at(i), locations.at(state.random(0, i)));
+
+    std::vector<BinaryDataFile::ReadRequest> requests(locations.size());
+    for(uint32_t i = 0; i < locations.size(); i++) {
+        requests.at(i).location = locations.at(i);
+        requests.at(i).on_read = [](const char* data, size_t byte_size) {
+            doNotOptimize(data);
+        };
+    }
+
+    state.setItemsPerIteration(requests.size());
+    state.measure([&]() {
+        file.read(requests);
+    });
+
+    file.close();
+    removeFile(file_name);
+}
+
+UND_BENCHMARK(benchBinaryDataStore, "BinaryDataFile::store") {
+
+    benchStore(state, BinaryDataFile::STREAM);
+}
+
+UND_BENCHMARK(benchBinaryDataStoreMapped, "BinaryDataFile::store (mapped)") {
+
+    benchStore(state, BinaryDataFile::MEMORY_MAPPED);
+}
+
+UND_BENCHMARK(benchBinaryDataStoreTransaction, "BinaryDataFile::store (transaction)") {
+    // includes waiting for the data to be written to the disk
+
+    benchStore(state, BinaryDataFile::STREAM, true);
+}
+
+UND_BENCHMARK(benchBinaryDataRead, "BinaryDataFile::read") {
+
+    benchRead(state, BinaryDataFile::STREAM, false);
+}
+
+UND_BENCHMARK(benchBinaryDataReadMapped, "BinaryDataFile::read (mapped)") {
+
+    benchRead(state, BinaryDataFile::MEMORY_MAPPED, false);
+}
+
+UND_BENCHMARK(benchBinaryDataReadZeroCopy, "BinaryDataFile::read (mapped, zero-copy)") {
+
+    benchRead(state, BinaryDataFile::MEMORY_MAPPED, true);
+}
+
+UND_BENCHMARK(benchBinaryDataReadBatch, "BinaryDataFile::read (batch)") {
+
+    benchReadBatch(state, BinaryDataFile::STREAM);
+}
+
+UND_BENCHMARK(benchBinaryDataReadBatchMapped, "BinaryDataFile::read (mapped, batch)") {
+
+    benchReadBatch(state, BinaryDataFile::MEMORY_MAPPED);
+}
+
+UND_BENCHMARK(benchBinaryDataUpdate, "BinaryDataFile::update") {
+
+    std::string file_name = state.getDataFile("update.bin");
+
+    std::vector<std::vector<char>> blocks;
+    std::vector<std::vector<char>> new_blocks; // most of them have a different size than the old ones
+    createBlocks(state, blocks);
+    createBlocks(state, new_blocks);
+
+    BinaryDataFile file;
+    if(!createFile(state, file, file_name))
+        return;
+
+    std::vector<uint64_t> locations;
+
+    // updating the blocks in a random order
+    std::vector<uint32_t> order;
+    for(uint32_t i = 0; i < BLOCK_COUNT; i++)
+        order.push_back(i);
+
+    for(uint32_t i = order.size() - 1; i > 0; i--)
+        std::swap(order.at(i), order.at(state.random(0, i)));
+
+    state.setItemsPerIteration(order.size());
+    state.measure([&]() {
+        file.newBinaryFile();
+        storeBlocks(file, blocks, locations);
+    }, [&]() {
+        for(uint32_t i : order)
+            locations.at(i) = file.update(new_blocks.at(i).data(), new_blocks.at(i).size(), locations.at(i));
+    });
+
+    file.close();
+    removeFile(file_name);
+}
+
+static void benchOpen(BenchmarkState& state, bool use_index) {
+
+    std::string file_name = state.getDataFile("open.bin");
+
+    BinaryDataFile file;
+    if(!createFile(state, file, file_name))
+        return;
+
+    // many small blocks, every 4th one is unused
+    std::vector<char> block(64);
+    std::vector<uint64_t> locations;
+    for(uint32_t i = 0; i < OPEN_BLOCK_COUNT; i++)
+        locations.push_back(file.store(block.data(), block.size()));
+
+    for(uint32_t i = 0; i < OPEN_BLOCK_COUNT; i += 4)
+        file.free(locations.at(i));
+
+    std::string index_file_name = file_name + ".index";
+
+    state.setItemsPerIteration(OPEN_BLOCK_COUNT);
+    state.measure([&]() {
+        file.close(); // writes the index
+
+        if(!use_index)
+            std::remove(index_file_name.c_str());
+
+    }, [&]() {
+        file.open(file_name);
+    });
+
+    file.close();
+    removeFile(file_name);
+}
+
+UND_BENCHMARK(benchBinaryDataOpen, "BinaryDataFile::open") {
+
+    benchOpen(state, false);
+}
+
+UND_BENCHMARK(benchBinaryDataOpenIndex, "BinaryDataFile::open (index)") {
+
+    benchOpen(state, true);
+}
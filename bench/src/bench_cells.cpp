@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "benchmark.h"
+#include "linear_arena.h"
+#include "glm/glm.hpp"
+
+#include "world/cells/cell_chunk.h"
+#include "world/cells/cell_world.h"
+#include "world/edit/chunk_edit.h"
+#include "world/edit/chunk_optimizer.h"
+
+using namespace undicht;
+using namespace bench;
+using namespace cell;
+
+// number of cells / edits / rays per iteration
+const uint32_t COLUMN_SIZE = 5; // 51 * 51 columns of cells
+const uint32_t LOOKUP_COUNT = 4096;
+const uint32_t VOLUME_COUNT = 256;
+const uint32_t EDIT_COUNT = 64;
+const uint32_t RAY_COUNT = 1024;
+
+////////////////////////////////////////// generating the benchmark data //////////////////////////////////////////
+
+static void createTerrain(BenchmarkState& state, std::vector<Cell>& cells) {
+    // a height map made from columns of cells with random heights and materials
+
+    for(uint32_t x = 0; x + COLUMN_SIZE <= 255; x += COLUMN_SIZE) {
+        for(uint32_t z = 0; z + COLUMN_SIZE <= 255; z += COLUMN_SIZE) {
+
+            uint32_t height = state.random(1, 128);
+            uint32_t material = state.random(1, 4);
+
+            cells.push_back(Cell(x, 0, z, x + COLUMN_SIZE, height, z + COLUMN_SIZE, material));
+        }
+    }
+
+}
+
+static void createTerrain(BenchmarkState& state, CellChunk& chunk) {
+
+    std::vector<Cell> cells;
+    createTerrain(state, cells);
+
+    for(const Cell& c : cells)
+        chunk.addCell(c);
+
+}
+
+static Cell randomVolume(BenchmarkState& state, uint32_t max_size, uint32_t material = 0) {
+    // a random volume within a chunk
+
+    uint32_t x0 = state.random(0, 254), y0 = state.random(0, 254), z0 = state.random(0, 254);
+    uint32_t x1 = std::min(255u, x0 + state.random(1, max_size));
+    uint32_t y1 = std::min(255u, y0 + state.random(1, max_size));
+    uint32_t z1 = std::min(255u, z0 + state.random(1, max_size));
+
+    return Cell(x0, y0, z0, x1, y1, z1, material);
+}
+
+////////////////////////////////////////// CellChunk //////////////////////////////////////////
+
+UND_BENCHMARK(benchAddCell, "CellChunk::addCell") {
+
+    std::vector<Cell> cells;
+    createTerrain(state, cells);
+
+    std::unique_ptr<CellChunk> chunk;
+
+    state.setItemsPerIteration(cells.size());
+    state.measure([&]() {
+        chunk.reset(new CellChunk);
+    }, [&]() {
+        for(const Cell& c : cells)
+            doNotOptimize(chunk->addCell(c));
+    });
+
+}
+
+UND_BENCHMARK(benchGetCellID, "CellChunk::getCellID") {
+
+    CellChunk chunk;
+    createTerrain(state, chunk);
+
+    std::vector<glm::uvec3> positions;
+    for(uint32_t i = 0; i < LOOKUP_COUNT; i++) {
+        // separate statements, the order in which function arguments are evaluated is unspecified
+        uint32_t x = state.random(0, 254);
+        uint32_t y = state.random(0, 128);
+        uint32_t z = state.random(0, 254);
+        positions.push_back(glm::uvec3(x, y, z));
+    }
+
+    state.setItemsPerIteration(positions.size());
+    state.measure([&]() {
+        for(const glm::uvec3& pos : positions)
+            doNotOptimize(chunk.getCellID(pos.x, pos.y, pos.z));
+    });
+
+}
+
+UND_BENCHMARK(benchGetCellsInVolume, "CellChunk::getCellsInVolume") {
+
+    CellChunk chunk;
+    createTerrain(state, chunk);
+
+    std::vector<Cell> volumes;
+    for(uint32_t i = 0; i < VOLUME_COUNT; i++)
+        volumes.push_back(randomVolume(state, 32));
+
+    state.setItemsPerIteration(volumes.size());
+    state.measure([&]() {
+        for(const Cell& volume : volumes) {
+            std::vector<const Cell*> cells = chunk.getCellsInVolume(volume);
+            doNotOptimize(cells.data());
+        }
+    });
+
+}
+
+UND_BENCHMARK(benchGetCellsInVolumeArena, "CellChunk::getCellsInVolume (arena)") {
+
+    CellChunk chunk;
+    createTerrain(state, chunk);
+
+    std::vector<Cell> volumes;
+    for(uint32_t i = 0; i < VOLUME_COUNT; i++)
+        volumes.push_back(randomVolume(state, 32));
+
+    // the frame arena, because getCellsInVolume() takes its temporary data from it as well
+    // (the scope releases both every iteration, so the arena doesnt grow during the benchmark)
+    LinearArena& arena = FrameArena::get();
+
+    state.setItemsPerIteration(volumes.size());
+    state.measure([&]() {
+        for(const Cell& volume : volumes) {
+            ArenaScope scope(arena);
+            ArenaVector<const Cell*> cells(arena);
+            chunk.getCellsInVolume(volume, cells);
+            doNotOptimize(cells.data());
+        }
+    });
+
+}
+
+////////////////////////////////////////// editing chunks //////////////////////////////////////////
+
+UND_BENCHMARK(benchChunkEditAdd, "ChunkEdit::add") {
+
+    CellChunk terrain;
+    createTerrain(state, terrain);
+
+    std::vector<Cell> volumes;
+    for(uint32_t i = 0; i < EDIT_COUNT; i++) {
+        uint32_t material = state.random(1, 4);
+        volumes.push_back(randomVolume(state, 32, material));
+    }
+
+    ChunkEdit edit;
+    CellChunk chunk;
+
+    state.setItemsPerIteration(volumes.size());
+    state.measure([&]() {
+        chunk = terrain;
+    }, [&]() {
+        for(const Cell& volume : volumes)
+            edit.add(chunk, volume);
+    });
+
+}
+
+UND_BENCHMARK(benchChunkEditSubtract, "ChunkEdit::subtract") {
+
+    CellChunk terrain;
+    createTerrain(state, terrain);
+
+    std::vector<Cell> volumes;
+    for(uint32_t i = 0; i < EDIT_COUNT; i++)
+        volumes.push_back(randomVolume(state, 32));
+
+    ChunkEdit edit;
+    CellChunk chunk;
+
+    state.setItemsPerIteration(volumes.size());
+    state.measure([&]() {
+        chunk = terrain;
+    }, [&]() {
+        for(const Cell& volume : volumes)
+            edit.subtract(chunk, volume);
+    });
+
+}
+
+UND_BENCHMARK(benchOptimizeChunk, "ChunkOptimizer::optimizeChunk") {
+
+    // a chunk that got fragmented by edits
+    CellChunk edited;
+    createTerrain(state, edited);
+
+    ChunkEdit edit;
+    for(uint32_t i = 0; i < EDIT_COUNT; i++)
+        edit.subtract(edited, randomVolume(state, 32));
+
+    // the optimizer is too big for the stack
+    std::unique_ptr<ChunkOptimizer> optimizer(new ChunkOptimizer);
+    std::unique_ptr<CellChunk> optimized;
+
+    state.measure([&]() {
+        optimized.reset(new CellChunk);
+    }, [&]() {
+        optimizer->optimizeChunk(edited, optimized.get());
+    });
+
+}
+
+////////////////////////////////////////// CellWorld //////////////////////////////////////////
+
+UND_BENCHMARK(benchRayCastCell, "CellWorld::rayCastCell") {
+
+    // 3 * 3 chunks of terrain, the cell buffer is not initialized (no gpu needed)
+    CellWorld world;
+
+    for(int x = -1; x <= 1; x++) {
+        for(int z = -1; z <= 1; z++) {
+
+            CellChunk* chunk = new CellChunk;
+            createTerrain(state, *chunk);
+            world.loadChunk(glm::ivec3(x * 255, 0, z * 255), chunk);
+        }
+    }
+
+    // rays starting above the terrain, pointing down at varying angles
+    std::vector<glm::vec3> origins;
+    std::vector<glm::vec3> dirs;
+
+    for(uint32_t i = 0; i < RAY_COUNT; i++) {
+
+        glm::vec3 origin;
+        origin.x = state.randomFloat(-200.0f, 200.0f);
+        origin.y = state.randomFloat(150.0f, 250.0f);
+        origin.z = state.randomFloat(-200.0f, 200.0f);
+
+        glm::vec3 dir(0.0f, -1.0f, 0.0f);
+        dir.x = state.randomFloat(-1.0f, 1.0f);
+        dir.z = state.randomFloat(-1.0f, 1.0f);
+
+        origins.push_back(origin);
+        dirs.push_back(glm::normalize(dir));
+    }
+
+    state.setItemsPerIteration(origins.size());
+    state.measure([&]() {
+        glm::ivec3 hit;
+        uint8_t face;
+
+        for(uint32_t i = 0; i < origins.size(); i++)
+            doNotOptimize(world.rayCastCell(origins.at(i), dirs.at(i), hit, face));
+    });
+
+}
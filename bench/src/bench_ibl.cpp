@@ -0,0 +1,232 @@
+#include <vector>
+#include "benchmark.h"
+#include "IBL/ibl.h"
+#include "images/image_sampler.h"
+#include "images/mip_chain.h"
+
+using namespace undicht;
+using namespace bench;
+using namespace tools;
+
+// the sizes of the maps created by the cell example (environment.h, brdf_integration_map.h)
+// except for the environment map (1024) and the brdf map (512), which would make the benchmarks take minutes
+const uint32_t ENV_MAP_SIZE = 128;
+const uint32_t IRRADIANCE_MAP_SIZE = 16;
+const uint32_t SPECULAR_MAP_SIZE = 64;
+const uint32_t SPECULAR_MIP_LEVELS = 5;
+const uint32_t BRDF_MAP_SIZE = 128;
+
+// the size of the cloud density map of the cell example (cloud_layer.h)
+const uint32_t VOLUME_SIZE = 256;
+const uint32_t VOLUME_DEPTH = 24;
+const uint32_t VOLUME_SAMPLES = 1 << 18;
+
+// the size of the material atlas of the cell example (material_atlas.h)
+const uint32_t ATLAS_SIZE = 1024;
+const uint32_t ATLAS_TILE_SIZE = 16;
+
+////////////////////////////////////////// generating the benchmark data //////////////////////////////////////////
+
+static void createEnvironmentMap(BenchmarkState& state, CubeMapData<float>& env_map) {
+    // a sky gradient with a few bright spots (hdr values > 1)
+
+    env_map.setExtent(ENV_MAP_SIZE);
+    env_map.setNrChannels(4);
+
+    for(int face = 0; face < 6; face++) {
+
+        ImageData<float>& image = env_map.getFace(CubeMapData<float>::Face(face));
+
+        for(uint32_t x = 0; x < ENV_MAP_SIZE; x++) {
+            for(uint32_t y = 0; y < ENV_MAP_SIZE; y++) {
+
+                float brightness = (face == CubeMapData<float>::Y_NEGATIVE) ? 1.0f : 0.2f + 0.6f * float(y) / ENV_MAP_SIZE;
+
+                if(state.random(0, 999) == 0)
+                    brightness = state.randomFloat(5.0f, 50.0f);
+
+                float* pixel = image.getPixel(x, y);
+                pixel[0] = 0.6f * brightness;
+                pixel[1] = 0.8f * brightness;
+                pixel[2] = 1.0f * brightness;
+                pixel[3] = 1.0f;
+            }
+        }
+
+    }
+
+}
+
+////////////////////////////////////////// image based lighting //////////////////////////////////////////
+
+UND_BENCHMARK(benchConvoluteCubeMap, "convoluteCubeMap") {
+
+    CubeMapData<float> env_map;
+    createEnvironmentMap(state, env_map);
+
+    CubeMapData<float> irradiance_map;
+
+    state.setItemsPerIteration(6 * IRRADIANCE_MAP_SIZE * IRRADIANCE_MAP_SIZE);
+    state.measure([&]() {
+        convoluteCubeMap(env_map, irradiance_map, IRRADIANCE_MAP_SIZE);
+    });
+
+}
+
+UND_BENCHMARK(benchPrefilterSpecularReflections, "prefilterSpecularReflections") {
+
+    CubeMapData<float> env_map;
+    createEnvironmentMap(state, env_map);
+
+    std::vector<CubeMapData<float>> mip_maps;
+
+    state.measure([&]() {
+        prefilterSpecularReflections(env_map, mip_maps, SPECULAR_MAP_SIZE, SPECULAR_MIP_LEVELS);
+    });
+
+}
+
+UND_BENCHMARK(benchCreateBRDFIntegrationMap, "createBRDFIntegrationMap") {
+
+    ImageData<float> brdf_map;
+
+    state.setItemsPerIteration(BRDF_MAP_SIZE * BRDF_MAP_SIZE);
+    state.measure([&]() {
+        createBRDFIntegrationMap(brdf_map, BRDF_MAP_SIZE);
+    });
+
+}
+
+////////////////////////////////////////// sampling images //////////////////////////////////////////
+
+static void createVolume(BenchmarkState& state, ImageData3D<float>& volume, std::vector<float>& u, std::vector<float>& v, std::vector<float>& w) {
+    // random densities and coordinates (the uv coordinates repeat the volume a few times, like the clouds of the cell example)
+
+    volume.setExtent(VOLUME_SIZE, VOLUME_SIZE, VOLUME_DEPTH);
+    volume.setNrChannels(1);
+
+    for(uint32_t z = 0; z < VOLUME_DEPTH; z++) {
+        for(uint32_t y = 0; y < VOLUME_SIZE; y++) {
+            for(uint32_t x = 0; x < VOLUME_SIZE; x++) {
+                float density = state.randomFloat(0.0f, 1.0f);
+                volume.setPixel(&density, x, y, z);
+            }
+        }
+    }
+
+    u.resize(VOLUME_SAMPLES);
+    v.resize(VOLUME_SAMPLES);
+    w.resize(VOLUME_SAMPLES);
+
+    for(uint32_t i = 0; i < VOLUME_SAMPLES; i++) {
+        u[i] = state.randomFloat(-4.0f, 4.0f);
+        v[i] = state.randomFloat(-4.0f, 4.0f);
+        w[i] = state.randomFloat(0.0f, 1.0f);
+    }
+
+}
+
+UND_BENCHMARK(benchSampleLinear3D, "ImageData3D::sampleLinear (reference)") {
+
+    ImageData3D<float> volume;
+    std::vector<float> u, v, w;
+    createVolume(state, volume, u, v, w);
+
+    state.setItemsPerIteration(VOLUME_SAMPLES);
+    state.measure([&]() {
+        float sum = 0.0f;
+        for(uint32_t i = 0; i < VOLUME_SAMPLES; i++)
+            sum += volume.sampleLinear(u[i], v[i], w[i])[0];
+        doNotOptimize(sum);
+    });
+
+}
+
+UND_BENCHMARK(benchImageSampler3D, "ImageSampler3D::sample (trilinear)") {
+
+    ImageData3D<float> volume;
+    std::vector<float> u, v, w;
+    createVolume(state, volume, u, v, w);
+
+    ImageSampler3D<float, 1> sampler(volume);
+
+    state.setItemsPerIteration(VOLUME_SAMPLES);
+    state.measure([&]() {
+        float sum = 0.0f;
+        for(uint32_t i = 0; i < VOLUME_SAMPLES; i++) {
+            float density;
+            sampler.sample(u[i], v[i], w[i], &density);
+            sum += density;
+        }
+        doNotOptimize(sum);
+    });
+
+}
+
+UND_BENCHMARK(benchImageSampler3DBatched, "ImageSampler3D::sample (trilinear, batched)") {
+
+    ImageData3D<float> volume;
+    std::vector<float> u, v, w;
+    createVolume(state, volume, u, v, w);
+
+    ImageSampler3D<float, 1> sampler(volume);
+    std::vector<float> densities(VOLUME_SAMPLES);
+
+    state.setItemsPerIteration(VOLUME_SAMPLES);
+    state.measure([&]() {
+        sampler.sample(u.data(), v.data(), w.data(), VOLUME_SAMPLES, densities.data());
+        doNotOptimize(densities.data());
+    });
+
+}
+
+////////////////////////////////////////// mip chains //////////////////////////////////////////
+
+static void createAtlas(BenchmarkState& state, ImageData<char>& atlas) {
+    // random albedo + roughness tiles
+
+    atlas.setExtent(ATLAS_SIZE, ATLAS_SIZE);
+    atlas.setNrChannels(4);
+
+    for(uint32_t y = 0; y < ATLAS_SIZE; y++) {
+        for(uint32_t x = 0; x < ATLAS_SIZE; x++) {
+            char pixel[4];
+            for(int c = 0; c < 4; c++)
+                pixel[c] = char(state.random(0, 255));
+            atlas.setPixel(pixel, x, y);
+        }
+    }
+
+}
+
+static void benchMipChain(BenchmarkState& state, MipFilter filter) {
+
+    ImageData<char> atlas;
+    createAtlas(state, atlas);
+
+    MipChainSettings settings;
+    settings.filter = filter;
+    settings.srgb = true;
+    settings.address_mode = SamplerAddressMode::REPEAT;
+    settings.tile_width = ATLAS_TILE_SIZE;
+    settings.tile_height = ATLAS_TILE_SIZE;
+
+    std::vector<ImageData<char>> levels;
+
+    state.setItemsPerIteration(ATLAS_SIZE * ATLAS_SIZE);
+    state.measure([&]() {
+        buildMipChain(atlas, levels, settings);
+        doNotOptimize(levels.data());
+    });
+
+}
+
+UND_BENCHMARK(benchMipChainBox, "buildMipChain (tiled atlas, box)") {
+
+    benchMipChain(state, MipFilter::BOX);
+}
+
+UND_BENCHMARK(benchMipChainKaiser, "buildMipChain (tiled atlas, kaiser)") {
+
+    benchMipChain(state, MipFilter::KAISER);
+}
@@ -0,0 +1,338 @@
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "benchmark.h"
+#include "model_loading/obj/obj_file.h"
+#include "model_loading/collada/collada_file.h"
+#include "model_loading/mesh_optimizer.h"
+#include "model_loading/cooked_mesh_file.h"
+#include "file_tools.h"
+
+using namespace undicht;
+using namespace bench;
+using namespace tools;
+
+// a uv sphere, 2 * stacks * slices triangles
+const uint32_t SPHERE_STACKS = 48;
+const uint32_t SPHERE_SLICES = 96;
+
+// buildIndices used to compare each vertex with all unique ones found so far, the mesh stays small to keep the results comparable
+const uint32_t INDEXED_SPHERE_STACKS = 24;
+const uint32_t INDEXED_SPHERE_SLICES = 48;
+
+class IndexBuilder : public OBJFile {
+    // makes the protected ModelLoader::buildIndices() accessible
+
+  public:
+
+    using OBJFile::buildIndices;
+};
+
+////////////////////////////////////////// generating the benchmark data //////////////////////////////////////////
+
+struct SphereData {
+
+    std::vector<float> positions; // 3 floats per vertex
+    std::vector<float> uvs; // 2 floats per vertex
+    std::vector<float> normals; // 3 floats per vertex
+    std::vector<uint32_t> triangles; // 3 vertex indices per triangle
+};
+
+static void createSphere(SphereData& sphere, uint32_t stacks, uint32_t slices) {
+    // the vertices on the seam and the poles exist multiple times with different uvs, as in files exported by blender
+
+    const float pi = 3.14159265f;
+
+    for(uint32_t stack = 0; stack <= stacks; stack++) {
+        for(uint32_t slice = 0; slice <= slices; slice++) {
+
+            float u = float(slice) / slices;
+            float v = float(stack) / stacks;
+
+            float x = std::sin(v * pi) * std::cos(u * 2.0f * pi);
+            float y = std::cos(v * pi);
+            float z = std::sin(v * pi) * std::sin(u * 2.0f * pi);
+
+            sphere.positions.insert(sphere.positions.end(), {x, y, z});
+            sphere.uvs.insert(sphere.uvs.end(), {u, v});
+            sphere.normals.insert(sphere.normals.end(), {x, y, z});
+        }
+    }
+
+    for(uint32_t stack = 0; stack < stacks; stack++) {
+        for(uint32_t slice = 0; slice < slices; slice++) {
+
+            uint32_t v0 = stack * (slices + 1) + slice;
+            uint32_t v1 = v0 + slices + 1;
+
+            sphere.triangles.insert(sphere.triangles.end(), {v0, v1, v0 + 1});
+            sphere.triangles.insert(sphere.triangles.end(), {v0 + 1, v1, v1 + 1});
+        }
+    }
+
+}
+
+static bool writeOBJFile(const SphereData& sphere, const std::string& file_name) {
+
+    std::ofstream file(file_name, std::ios::out | std::ios::trunc);
+
+    if(!file.is_open())
+        return false;
+
+    file << "# generated by undicht_bench\n";
+    file << "o sphere\n";
+
+    for(uint32_t i = 0; i < sphere.positions.size(); i += 3)
+        file << "v " << sphere.positions.at(i) << " " << sphere.positions.at(i + 1) << " " << sphere.positions.at(i + 2) << "\n";
+
+    for(uint32_t i = 0; i < sphere.uvs.size(); i += 2)
+        file << "vt " << sphere.uvs.at(i) << " " << sphere.uvs.at(i + 1) << "\n";
+
+    for(uint32_t i = 0; i < sphere.normals.size(); i += 3)
+        file << "vn " << sphere.normals.at(i) << " " << sphere.normals.at(i + 1) << " " << sphere.normals.at(i + 2) << "\n";
+
+    for(uint32_t i = 0; i < sphere.triangles.size(); i += 3) {
+
+        // obj indices start at 1
+        uint32_t a = sphere.triangles.at(i) + 1, b = sphere.triangles.at(i + 1) + 1, c = sphere.triangles.at(i + 2) + 1;
+        file << "f " << a << "/" << a << "/" << a << " " << b << "/" << b << "/" << b << " " << c << "/" << c << "/" << c << "\n";
+    }
+
+    return file.good();
+}
+
+static void writeFloatArray(std::ofstream& file, const std::string& id, const std::vector<float>& data, uint32_t stride) {
+
+    file << "        <source id=\"" << id << "\">\n";
+    file << "          <float_array id=\"" << id << "-array\" count=\"" << data.size() << "\">";
+
+    for(uint32_t i = 0; i < data.size(); i++)
+        file << (i ? " " : "") << data.at(i);
+
+    file << "</float_array>\n";
+    file << "          <technique_common>\n";
+    file << "            <accessor source=\"#" << id << "-array\" count=\"" << data.size() / stride << "\" stride=\"" << stride << "\"/>\n";
+    file << "          </technique_common>\n";
+    file << "        </source>\n";
+}
+
+static bool writeColladaFile(const SphereData& sphere, const std::string& file_name) {
+
+    std::ofstream file(file_name, std::ios::out | std::ios::trunc);
+
+    if(!file.is_open())
+        return false;
+
+    file << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n";
+    file << "<COLLADA xmlns=\"http://www.collada.org/2005/11/COLLADASchema\" version=\"1.4.1\">\n";
+    file << "  <library_geometries>\n";
+    file << "    <geometry id=\"sphere-mesh\" name=\"sphere\">\n";
+    file << "      <mesh>\n";
+
+    writeFloatArray(file, "sphere-mesh-positions", sphere.positions, 3);
+    writeFloatArray(file, "sphere-mesh-normals", sphere.normals, 3);
+    writeFloatArray(file, "sphere-mesh-map-0", sphere.uvs, 2);
+
+    file << "        <vertices id=\"sphere-mesh-vertices\">\n";
+    file << "          <input semantic=\"POSITION\" source=\"#sphere-mesh-positions\"/>\n";
+    file << "        </vertices>\n";
+    file << "        <triangles material=\"material-material\" count=\"" << sphere.triangles.size() / 3 << "\">\n";
+    file << "          <input semantic=\"VERTEX\" source=\"#sphere-mesh-vertices\" offset=\"0\"/>\n";
+    file << "          <input semantic=\"NORMAL\" source=\"#sphere-mesh-normals\" offset=\"1\"/>\n";
+    file << "          <input semantic=\"TEXCOORD\" source=\"#sphere-mesh-map-0\" offset=\"2\" set=\"0\"/>\n";
+    file << "          <p>";
+
+    // position, normal and uv index per vertex
+    for(uint32_t i = 0; i < sphere.triangles.size(); i++)
+        file << (i ? " " : "") << sphere.triangles.at(i) << " " << sphere.triangles.at(i) << " " << sphere.triangles.at(i);
+
+    file << "</p>\n";
+    file << "        </triangles>\n";
+    file << "      </mesh>\n";
+    file << "    </geometry>\n";
+    file << "  </library_geometries>\n";
+    file << "</COLLADA>\n";
+
+    return file.good();
+}
+
+////////////////////////////////////////// loading models //////////////////////////////////////////
+
+UND_BENCHMARK(benchLoadOBJ, "OBJFile::loadAllMeshes") {
+
+    std::string file_name = state.getDataFile("sphere.obj");
+
+    SphereData sphere;
+    createSphere(sphere, SPHERE_STACKS, SPHERE_SLICES);
+
+    if(!writeOBJFile(sphere, file_name)) {
+        state.skip("could not create file " + file_name);
+        return;
+    }
+
+    state.setItemsPerIteration(sphere.triangles.size() / 3);
+    state.measure([&]() {
+        OBJFile file(file_name);
+        std::vector<MeshData> meshes;
+        file.loadAllMeshes(meshes);
+        doNotOptimize(meshes.data());
+    });
+
+    std::remove(file_name.c_str());
+}
+
+UND_BENCHMARK(benchLoadCollada, "ColladaFile::loadAllMeshes") {
+
+    std::string file_name = state.getDataFile("sphere.dae");
+
+    SphereData sphere;
+    createSphere(sphere, SPHERE_STACKS, SPHERE_SLICES);
+
+    if(!writeColladaFile(sphere, file_name)) {
+        state.skip("could not create file " + file_name);
+        return;
+    }
+
+    state.setItemsPerIteration(sphere.triangles.size() / 3);
+    state.measure([&]() {
+        ColladaFile file(file_name);
+        std::vector<MeshData> meshes;
+        file.loadAllMeshes(meshes);
+        doNotOptimize(meshes.data());
+    });
+
+    std::remove(file_name.c_str());
+}
+
+UND_BENCHMARK(benchLoadCookedMesh, "CookedMeshFile::open (cooked)") {
+    // the same sphere as benchLoadOBJ, loaded from the cooked file created by the first open()
+
+    std::string file_name = state.getDataFile("sphere_cooked.obj");
+    std::string cooked_file_name = CookedMeshFile::getCookedFileName(file_name);
+
+    SphereData sphere;
+    createSphere(sphere, SPHERE_STACKS, SPHERE_SLICES);
+
+    if(!writeOBJFile(sphere, file_name) || !CookedMeshFile::cook(file_name, cooked_file_name)) {
+        state.skip("could not create file " + cooked_file_name);
+        return;
+    }
+
+    state.setItemsPerIteration(sphere.triangles.size() / 3);
+    state.measure([&]() {
+        CookedMeshFile file(file_name);
+        doNotOptimize(file.getMeshes().data());
+        doNotOptimize(file.getMeshes().at(0).vertices);
+    });
+
+    std::remove(file_name.c_str());
+    std::remove(cooked_file_name.c_str());
+}
+
+////////////////////////////////////////// parsing numbers //////////////////////////////////////////
+
+const uint32_t FLOAT_ARRAY_SIZE = 1 << 20;
+
+static std::string createFloatArray(BenchmarkState& state) {
+    // floats written like in the float arrays of collada files
+
+    std::stringstream array;
+    for(uint32_t i = 0; i < FLOAT_ARRAY_SIZE; i++)
+        array << (i ? " " : "") << (float(state.random(0, 2000000)) / 1000.0f - 1000.0f);
+
+    return array.str();
+}
+
+UND_BENCHMARK(benchStrtofArray, "strtof (reference)") {
+    // the way float arrays were parsed before parseFloatArray()
+
+    std::string array = createFloatArray(state);
+    std::vector<float> floats(FLOAT_ARRAY_SIZE);
+
+    state.setItemsPerIteration(FLOAT_ARRAY_SIZE);
+    state.measure([&]() {
+        char* position = (char*)array.c_str();
+        for(uint32_t i = 0; i < FLOAT_ARRAY_SIZE; i++)
+            floats[i] = std::strtof(position, &position);
+
+        doNotOptimize(floats.data());
+    });
+}
+
+UND_BENCHMARK(benchParseFloatArray, "parseFloatArray") {
+
+    std::string array = createFloatArray(state);
+    std::vector<float> floats(FLOAT_ARRAY_SIZE);
+
+    state.setItemsPerIteration(FLOAT_ARRAY_SIZE);
+    state.measure([&]() {
+        doNotOptimize(parseFloatArray(array, floats.data(), floats.size()));
+    });
+}
+
+UND_BENCHMARK(benchBuildIndices, "ModelLoader::buildIndices") {
+
+    std::string file_name = state.getDataFile("indexed_sphere.obj");
+
+    SphereData sphere;
+    createSphere(sphere, INDEXED_SPHERE_STACKS, INDEXED_SPHERE_SLICES);
+
+    if(!writeOBJFile(sphere, file_name)) {
+        state.skip("could not create file " + file_name);
+        return;
+    }
+
+    // the vertices as they come from the file (3 per triangle)
+    IndexBuilder loader;
+    loader.open(file_name);
+    std::remove(file_name.c_str());
+
+    std::vector<MeshData> meshes;
+    loader.loadAllMeshes(meshes);
+
+    if(!meshes.size() || !meshes.at(0).vertices.size()) {
+        state.skip("could not load the mesh from " + file_name);
+        return;
+    }
+
+    const MeshData& mesh = meshes.at(0);
+
+    std::vector<float> vertices;
+    std::vector<int> indices;
+
+    state.setItemsPerIteration(mesh.vertices.size() * sizeof(float) / mesh.vertex_layout.getTotalSize());
+    state.measure([&]() {
+        vertices.clear();
+        indices.clear();
+        loader.buildIndices(mesh.vertices, mesh.vertex_layout, vertices, indices);
+        doNotOptimize(indices.data());
+    });
+
+}
+
+UND_BENCHMARK(benchOptimizeMesh, "optimizeMesh") {
+    // welding, vertex cache, overdraw and vertex fetch optimization of a mesh without indices
+
+    SphereData sphere;
+    createSphere(sphere, SPHERE_STACKS, SPHERE_SLICES);
+
+    MeshData mesh;
+    mesh.vertex_layout = BufferLayout({UND_VEC3F, UND_VEC2F, UND_VEC3F});
+
+    for(uint32_t vertex : sphere.triangles) {
+        mesh.vertices.insert(mesh.vertices.end(), sphere.positions.begin() + 3 * vertex, sphere.positions.begin() + 3 * vertex + 3);
+        mesh.vertices.insert(mesh.vertices.end(), sphere.uvs.begin() + 2 * vertex, sphere.uvs.begin() + 2 * vertex + 2);
+        mesh.vertices.insert(mesh.vertices.end(), sphere.normals.begin() + 3 * vertex, sphere.normals.begin() + 3 * vertex + 3);
+    }
+
+    MeshData optimized;
+
+    state.setItemsPerIteration(sphere.triangles.size() / 3);
+    state.measure([&]() {
+        optimized = mesh;
+        optimizeMesh(optimized);
+        doNotOptimize(optimized.indices.data());
+    });
+}
@@ -0,0 +1,219 @@
+#include <cstdio>
+#include <fstream>
+#include "benchmark.h"
+#include "xml/xml_file.h"
+#include "xml/xml_pull_parser.h"
+
+using namespace undicht;
+using namespace bench;
+using namespace tools;
+
+const uint32_t XML_CHUNK_COUNT = 64;
+const uint32_t XML_CELLS_PER_CHUNK = 64;
+
+////////////////////////////////////////// generating the benchmark data //////////////////////////////////////////
+
+static bool writeXmlFile(BenchmarkState& state, const std::string& file_name) {
+    // a file with a structure similar to the world files (nested elements, many attributes, some content)
+
+    std::ofstream file(file_name, std::ios::out | std::ios::trunc);
+
+    if(!file.is_open())
+        return false;
+
+    file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    file << "<world name=\"bench\" version=\"1\">\n";
+
+    for(uint32_t chunk = 0; chunk < XML_CHUNK_COUNT; chunk++) {
+
+        file << "    <chunk id=\"" << chunk << "\" x=\"" << (chunk % 8) * 255 << "\" y=\"0\" z=\"" << (chunk / 8) * 255 << "\">\n";
+
+        for(uint32_t cell = 0; cell < XML_CELLS_PER_CHUNK; cell++) {
+
+            uint32_t x = state.random(0, 250);
+            uint32_t y = state.random(0, 250);
+            uint32_t z = state.random(0, 250);
+            uint32_t material = state.random(1, 16);
+
+            file << "        <cell x0=\"" << x << "\" y0=\"" << y << "\" z0=\"" << z;
+            file << "\" x1=\"" << x + 5 << "\" y1=\"" << y + 5 << "\" z1=\"" << z + 5 << "\" material=\"" << material << "\"/>\n";
+        }
+
+        file << "        <description>chunk number " << chunk << " of the benchmark world</description>\n";
+        file << "    </chunk>\n";
+    }
+
+    file << "</world>\n";
+
+    return file.good();
+}
+
+////////////////////////////////////////// XmlFile //////////////////////////////////////////
+
+UND_BENCHMARK(benchXmlOpen, "XmlFile::open") {
+
+    std::string file_name = state.getDataFile("world.xml");
+
+    if(!writeXmlFile(state, file_name)) {
+        state.skip("could not create file " + file_name);
+        return;
+    }
+
+    state.setItemsPerIteration(XML_CHUNK_COUNT * (XML_CELLS_PER_CHUNK + 2));
+    state.measure([&]() {
+        XmlFile file;
+        doNotOptimize(file.open(file_name));
+    });
+
+    std::remove(file_name.c_str());
+}
+
+////////////////////////////////////////// XmlPullParser //////////////////////////////////////////
+
+UND_BENCHMARK(benchXmlPullParser, "XmlPullParser::next") {
+
+    std::string file_name = state.getDataFile("world_pull.xml");
+
+    if(!writeXmlFile(state, file_name)) {
+        state.skip("could not create file " + file_name);
+        return;
+    }
+
+    state.setItemsPerIteration(XML_CHUNK_COUNT * (XML_CELLS_PER_CHUNK + 2));
+    state.measure([&]() {
+        XmlPullParser parser(file_name);
+
+        size_t start_tags = 0;
+        XmlPullParser::Event event;
+        while((event = parser.next()) != XmlPullParser::END_OF_FILE && (event != XmlPullParser::INVALID))
+            start_tags += (event == XmlPullParser::START_TAG);
+
+        doNotOptimize(start_tags);
+    });
+
+    std::remove(file_name.c_str());
+}
+
+UND_BENCHMARK(benchXmlReadTree, "XmlPullParser::readTree") {
+
+    std::string file_name = state.getDataFile("world_tree.xml");
+
+    if(!writeXmlFile(state, file_name)) {
+        state.skip("could not create file " + file_name);
+        return;
+    }
+
+    LinearArena arena;
+
+    state.setItemsPerIteration(XML_CHUNK_COUNT * (XML_CELLS_PER_CHUNK + 2));
+    state.measure([&]() {
+        arena.reset();
+        XmlPullParser parser(file_name);
+        doNotOptimize(parser.readTree(arena));
+    });
+
+    std::remove(file_name.c_str());
+}
+
+////////////////////////////////////////// XmlElement lookup //////////////////////////////////////////
+
+const uint32_t XML_LOOKUP_CHUNK_COUNT = 4096;
+const uint32_t XML_LOOKUP_COUNT = 1024;
+
+static XmlElement* createChunkElements(XmlFile& file) {
+    // a WORLD element with a CHUNK element for every chunk (like in the world files of the cell example)
+
+    file.setName("WORLD_FILE");
+    XmlElement* world = file.addChildElement("WORLD");
+
+    for(uint32_t chunk = 0; chunk < XML_LOOKUP_CHUNK_COUNT; chunk++)
+        world->addChildElement("CHUNK", {"chunk_pos=" + std::to_string(chunk * 255) + "_0_0"})->setContent(std::to_string(chunk * 4096));
+
+    return world;
+}
+
+static std::vector<std::string> createChunkPositions(BenchmarkState& state) {
+
+    std::vector<std::string> chunk_positions;
+    for(uint32_t i = 0; i < XML_LOOKUP_COUNT; i++)
+        chunk_positions.push_back(std::to_string(state.random(0, XML_LOOKUP_CHUNK_COUNT - 1) * 255) + "_0_0");
+
+    return chunk_positions;
+}
+
+UND_BENCHMARK(benchXmlGetElement, "XmlElement::getElement (attribute strings)") {
+
+    XmlFile file;
+    XmlElement* world = createChunkElements(file);
+    std::vector<std::string> chunk_positions = createChunkPositions(state);
+
+    state.setItemsPerIteration(XML_LOOKUP_COUNT);
+    state.measure([&]() {
+        for(const std::string& chunk_pos : chunk_positions)
+            doNotOptimize(world->getElement({"CHUNK chunk_pos=" + chunk_pos}));
+    });
+}
+
+UND_BENCHMARK(benchXmlGetElementIndexed, "XmlElement::getElement (query, indexed)") {
+
+    XmlFile file;
+    XmlElement* world = createChunkElements(file);
+    std::vector<std::string> chunk_positions = createChunkPositions(state);
+
+    world->indexAttribute("chunk_pos");
+    XmlQuery query({"CHUNK chunk_pos="});
+
+    state.setItemsPerIteration(XML_LOOKUP_COUNT);
+    state.measure([&]() {
+        for(const std::string& chunk_pos : chunk_positions) {
+            query.setValue("chunk_pos", chunk_pos);
+            doNotOptimize(world->getElement(query));
+        }
+    });
+}
+
+////////////////////////////////////////// XmlFile writing //////////////////////////////////////////
+
+UND_BENCHMARK(benchXmlWrite, "XmlFile::write (one chunk changed)") {
+
+    std::string file_name = state.getDataFile("world_write.xml");
+
+    XmlFile file;
+    XmlElement* world = createChunkElements(file);
+    std::vector<XmlElement*> chunks = world->getAllElements({"CHUNK"});
+    file.write(file_name);
+
+    uint32_t location = 0;
+
+    state.setItemsPerIteration(1);
+    state.measure([&]() {
+        chunks.at(location % XML_LOOKUP_CHUNK_COUNT)->setContent(std::to_string(location));
+        file.write(file_name);
+        location++;
+    });
+
+    std::remove(file_name.c_str());
+}
+
+UND_BENCHMARK(benchXmlWriteChanges, "XmlFile::writeChanges (one chunk changed)") {
+    // includes folding the journal into the file once it gets too big
+
+    std::string file_name = state.getDataFile("world_journal.xml");
+
+    XmlFile file;
+    XmlElement* world = createChunkElements(file);
+    std::vector<XmlElement*> chunks = world->getAllElements({"CHUNK"});
+    file.write(file_name);
+
+    uint32_t location = 0;
+
+    state.setItemsPerIteration(1);
+    state.measure([&]() {
+        chunks.at(location % XML_LOOKUP_CHUNK_COUNT)->setContent(std::to_string(location));
+        file.writeChanges();
+        location++;
+    });
+
+    std::remove(file_name.c_str());
+    std::remove((file_name + ".journal").c_str());
+}
@@ -0,0 +1,285 @@
+#include "benchmark.h"
+#include "debug.h"
+#include "job_system.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+// set by the cmake file of the benchmarks
+#ifndef UND_BENCH_BUILD_TYPE
+#define UND_BENCH_BUILD_TYPE "unknown"
+#endif
+
+namespace undicht {
+
+    namespace bench {
+
+        ////////////////////////////////////////// benchmark state //////////////////////////////////////////
+
+        BenchmarkState::BenchmarkState(const BenchmarkConfig& config, BenchmarkResult& result)
+            : m_config(config), m_result(result), m_random(config.m_seed) {
+
+        }
+
+        void BenchmarkState::setItemsPerIteration(uint64_t items) {
+            /// @brief the number of items processed by one call to the measured function
+            /// stored in the results, so that the time per item can be calculated
+
+            m_result.m_items = items;
+        }
+
+        void BenchmarkState::skip(const std::string& reason) {
+            /// @brief marks the benchmark as not run
+
+            m_result.m_skipped = true;
+            m_result.m_skip_reason = reason;
+        }
+
+        uint32_t BenchmarkState::random(uint32_t min, uint32_t max) {
+            /// @return a pseudo random number in the range [min, max] (same sequence on every platform)
+            // the output of std::mt19937 is defined by the standard, the distributions are not
+
+            uint64_t range = uint64_t(max) - min + 1;
+
+            return min + uint32_t(m_random() % range);
+        }
+
+        float BenchmarkState::randomFloat(float min, float max) {
+
+            return min + (max - min) * float(m_random() >> 8) / float(1 << 24);
+        }
+
+        std::string BenchmarkState::getDataFile(const std::string& file_name) const {
+            /// @return a path inside of the data directory for a file used by the benchmark
+
+            return m_config.m_data_dir + "/undicht_bench_" + file_name;
+        }
+
+        bool BenchmarkState::addSample(int64_t duration, uint64_t iterations, int64_t benchmark_start) {
+            // stores the ns per iteration of a sample, returns false once the benchmark should stop
+
+            m_result.m_samples.push_back(double(duration) / double(iterations));
+            m_result.m_iterations += iterations;
+
+            uint32_t sample_count = m_result.m_samples.size();
+
+            if(sample_count >= m_config.m_samples)
+                return false;
+
+            if((sample_count >= m_config.m_min_samples) && (Profiler::getTime() - benchmark_start > m_config.m_max_benchmark_time))
+                return false;
+
+            return true;
+        }
+
+        ////////////////////////////////////////// registering benchmarks //////////////////////////////////////////
+
+        std::vector<Benchmark>& getBenchmarks() {
+            /// @return all benchmarks registered with UND_BENCHMARK (in the order of registration)
+
+            // constructed on first use, the registrations happen during static initialization
+            static std::vector<Benchmark> benchmarks;
+
+            return benchmarks;
+        }
+
+        BenchmarkRegistration::BenchmarkRegistration(const char* name, BenchmarkFunction function) {
+
+            getBenchmarks().push_back({name, function});
+        }
+
+        ////////////////////////////////////////// running benchmarks //////////////////////////////////////////
+
+        std::vector<BenchmarkResult> runBenchmarks(const BenchmarkConfig& config) {
+            /// @brief runs all benchmarks matching the filter of the config
+
+            std::vector<BenchmarkResult> results;
+
+            for(const Benchmark& benchmark : getBenchmarks()) {
+
+                if(benchmark.m_name.find(config.m_filter) == std::string::npos)
+                    continue;
+
+                results.emplace_back();
+                BenchmarkResult& result = results.back();
+                result.m_name = benchmark.m_name;
+
+                BenchmarkState state(config, result);
+                benchmark.m_function(state);
+
+                if(!result.m_skipped && !result.m_samples.size())
+                    state.skip("the benchmark did not measure anything");
+
+                calcStatistics(result);
+
+                // progress goes to stderr, so that the json results can be written to stdout
+                if(result.m_skipped)
+                    std::cerr << result.m_name << ": skipped (" << result.m_skip_reason << ")\n";
+                else
+                    std::cerr << result.m_name << ": median " << result.m_median / 1000.0 << " us, mean " << result.m_mean / 1000.0 << " us +- " << result.m_stddev / 1000.0 << " us (" << result.m_samples.size() << " samples)\n";
+            }
+
+            return results;
+        }
+
+        void calcStatistics(BenchmarkResult& result) {
+            /// @brief calculates min, max, mean ... from the samples
+
+            if(!result.m_samples.size())
+                return;
+
+            std::vector<double> sorted = result.m_samples;
+            std::sort(sorted.begin(), sorted.end());
+
+            size_t count = sorted.size();
+
+            result.m_min = sorted.front();
+            result.m_max = sorted.back();
+
+            if(count % 2)
+                result.m_median = sorted.at(count / 2);
+            else
+                result.m_median = (sorted.at(count / 2 - 1) + sorted.at(count / 2)) / 2.0;
+
+            // nearest rank
+            size_t p90_rank = size_t(std::ceil(0.9 * count));
+            result.m_p90 = sorted.at(p90_rank ? p90_rank - 1 : 0);
+
+            double sum = 0.0;
+            for(double sample : sorted)
+                sum += sample;
+
+            result.m_mean = sum / count;
+
+            // sample standard deviation
+            double squared_sum = 0.0;
+            for(double sample : sorted)
+                squared_sum += (sample - result.m_mean) * (sample - result.m_mean);
+
+            result.m_stddev = count > 1 ? std::sqrt(squared_sum / (count - 1)) : 0.0;
+        }
+
+        ////////////////////////////////////////// writing the results //////////////////////////////////////////
+
+        static void writeJsonString(std::ostream& out, const std::string& str) {
+
+            out << '"';
+
+            for(char c : str) {
+
+                if((c == '"') || (c == '\\')) {
+                    out << '\\' << c;
+                } else if((unsigned char)c < 0x20) {
+                    // control characters (i.e. line breaks in error messages) have to be escaped
+                    const char* hex = "0123456789abcdef";
+                    out << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+                } else {
+                    out << c;
+                }
+            }
+
+            out << '"';
+        }
+
+        static const char* getCompilerName() {
+
+#if defined(__clang__)
+            return "clang " __clang_version__;
+#elif defined(__GNUC__)
+            return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+            return "msvc";
+#else
+            return "unknown";
+#endif
+        }
+
+        static void writeResults(std::ostream& out, const std::vector<BenchmarkResult>& results, const BenchmarkConfig& config) {
+
+            out.setf(std::ios::fixed);
+            out.precision(3);
+
+            // the configuration, so that results can be compared with the ones of other runs
+            out << "{\n\"context\":{";
+            out << "\"compiler\":";
+            writeJsonString(out, getCompilerName());
+            out << ",\"build_type\":";
+            writeJsonString(out, UND_BENCH_BUILD_TYPE);
+            out << ",\"hardware_threads\":" << std::thread::hardware_concurrency();
+            out << ",\"job_workers\":" << JobSystem::getWorkerCount();
+            out << ",\"seed\":" << config.m_seed;
+            out << ",\"samples\":" << config.m_samples;
+            out << ",\"min_sample_time_ns\":" << config.m_min_sample_time;
+            out << ",\"max_benchmark_time_ns\":" << config.m_max_benchmark_time;
+            out << ",\"filter\":";
+            writeJsonString(out, config.m_filter);
+            out << "},\n\"benchmarks\":[";
+
+            for(uint32_t i = 0; i < results.size(); i++) {
+
+                const BenchmarkResult& result = results.at(i);
+
+                out << (i ? ",\n" : "\n") << "{\"name\":";
+                writeJsonString(out, result.m_name);
+
+                if(result.m_skipped) {
+                    out << ",\"skipped\":true,\"reason\":";
+                    writeJsonString(out, result.m_skip_reason);
+                    out << "}";
+                    continue;
+                }
+
+                // all times are in nanoseconds per iteration
+                out << ",\"iterations\":" << result.m_iterations;
+                out << ",\"items_per_iteration\":" << result.m_items;
+                out << ",\"min_ns\":" << result.m_min;
+                out << ",\"max_ns\":" << result.m_max;
+                out << ",\"mean_ns\":" << result.m_mean;
+                out << ",\"median_ns\":" << result.m_median;
+                out << ",\"stddev_ns\":" << result.m_stddev;
+                out << ",\"p90_ns\":" << result.m_p90;
+                out << ",\"median_ns_per_item\":" << result.m_median / result.m_items;
+                out << ",\"items_per_second\":" << (result.m_median > 0.0 ? 1.0e9 * result.m_items / result.m_median : 0.0);
+
+                out << ",\"samples_ns\":[";
+                for(uint32_t j = 0; j < result.m_samples.size(); j++)
+                    out << (j ? "," : "") << result.m_samples.at(j);
+                out << "]}";
+            }
+
+            out << "\n]}\n";
+        }
+
+        bool writeJson(const std::vector<BenchmarkResult>& results, const BenchmarkConfig& config, const std::string& file_name) {
+            /// @brief writes the results and the configuration they were recorded with as json
+            /// @param file_name "-" to write to stdout
+            /// @return false, if the file could not be written
+
+            if(file_name == "-") {
+                writeResults(std::cout, results, config);
+                return std::cout.good();
+            }
+
+            std::ofstream file(file_name, std::ios::out | std::ios::trunc);
+
+            if(!file.is_open()) {
+                UND_ERROR << "failed to write benchmark results: could not open file " << file_name << "\n";
+                return false;
+            }
+
+            writeResults(file, results, config);
+
+            if(!file.good()) {
+                UND_ERROR << "failed to write benchmark results to " << file_name << "\n";
+                return false;
+            }
+
+            return true;
+        }
+
+    } // bench
+
+} // undicht
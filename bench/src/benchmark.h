@@ -0,0 +1,216 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "profiler.h"
+
+namespace undicht {
+
+    namespace bench {
+
+        struct BenchmarkConfig {
+
+            std::string m_filter; // only benchmarks whose name contains the filter are run
+            uint32_t m_samples = 10; // number of timed samples per benchmark
+            uint32_t m_min_samples = 3; // taken even if the time budget of the benchmark is exceeded
+            int64_t m_min_sample_time = 10000000; // (ns) fast functions are repeated until a sample takes at least this long
+            int64_t m_max_benchmark_time = 5000000000; // (ns) no more samples are taken once a benchmark took longer
+            uint32_t m_seed = 42; // every benchmark gets its own random generator initialized with this seed
+            std::string m_data_dir = "."; // directory for files created by the benchmarks
+        };
+
+        struct BenchmarkResult {
+
+            std::string m_name;
+            uint64_t m_iterations = 0; // total number of timed calls over all samples
+            uint64_t m_items = 1; // processed per iteration (i.e. cells added, blocks read)
+            std::vector<double> m_samples; // ns per iteration
+
+            double m_min = 0.0;
+            double m_max = 0.0;
+            double m_mean = 0.0;
+            double m_median = 0.0;
+            double m_stddev = 0.0;
+            double m_p90 = 0.0;
+
+            bool m_skipped = false; // set if the benchmark couldnt run (i.e. a file couldnt be created)
+            std::string m_skip_reason;
+        };
+
+        class BenchmarkState {
+            /** passed to every benchmark function, the function prepares its data and then calls one of the measure() functions
+            * with the code that should be timed */
+
+          protected:
+
+            const BenchmarkConfig& m_config;
+            BenchmarkResult& m_result;
+            std::mt19937 m_random;
+
+          public:
+
+            BenchmarkState(const BenchmarkConfig& config, BenchmarkResult& result);
+
+            /// @brief times the function, fast functions get called multiple times per sample
+            template<typename FUNCTION>
+            void measure(FUNCTION function);
+
+            /// @brief times the function, setup gets called (untimed) before every call to the function
+            /// (for functions that change their input, i.e. editing a chunk)
+            template<typename SETUP, typename FUNCTION>
+            void measure(SETUP setup, FUNCTION function);
+
+            /// @brief the number of items processed by one call to the measured function
+            /// stored in the results, so that the time per item can be calculated
+            void setItemsPerIteration(uint64_t items);
+
+            /// @brief marks the benchmark as not run
+            void skip(const std::string& reason);
+
+            /// @return a pseudo random number in the range [min, max] (same sequence on every platform)
+            uint32_t random(uint32_t min, uint32_t max);
+            float randomFloat(float min, float max);
+
+            /// @return a path inside of the data directory for a file used by the benchmark
+            std::string getDataFile(const std::string& file_name) const;
+
+          protected:
+
+            // stores the ns per iteration of a sample, returns false once the benchmark should stop
+            bool addSample(int64_t duration, uint64_t iterations, int64_t benchmark_start);
+
+        };
+
+        ////////////////////////////////////////// registering benchmarks //////////////////////////////////////////
+
+        typedef void (*BenchmarkFunction)(BenchmarkState& state);
+
+        struct Benchmark {
+            std::string m_name;
+            BenchmarkFunction m_function;
+        };
+
+        /// @return all benchmarks registered with UND_BENCHMARK (in the order of registration)
+        std::vector<Benchmark>& getBenchmarks();
+
+        struct BenchmarkRegistration {
+            BenchmarkRegistration(const char* name, BenchmarkFunction function);
+        };
+
+        /// @brief runs all benchmarks matching the filter of the config
+        std::vector<BenchmarkResult> runBenchmarks(const BenchmarkConfig& config);
+
+        /// @brief calculates min, max, mean ... from the samples
+        void calcStatistics(BenchmarkResult& result);
+
+        /// @brief writes the results and the configuration they were recorded with as json
+        /// @param file_name "-" to write to stdout
+        /// @return false, if the file could not be written
+        bool writeJson(const std::vector<BenchmarkResult>& results, const BenchmarkConfig& config, const std::string& file_name);
+
+        ////////////////////////////////////////// preventing the compiler from removing benchmarked code //////////////////////////////////////////
+
+        template<typename T>
+        inline void doNotOptimize(const T& value) {
+            /// @brief forces the compiler to calculate the value, even if it is not used afterwards
+#if defined(__GNUC__) || defined(__clang__)
+            asm volatile("" : : "r,m"(value) : "memory");
+#else
+            static volatile const void* sink;
+            sink = &value;
+#endif
+        }
+
+        ////////////////////////////////////////// template functions //////////////////////////////////////////
+
+        template<typename FUNCTION>
+        void BenchmarkState::measure(FUNCTION function) {
+            /// @brief times the function, fast functions get called multiple times per sample
+
+            // warmup + finding the number of iterations so that a sample takes long enough
+            uint64_t iterations = 1;
+
+            while(true) {
+
+                int64_t start = Profiler::getTime();
+                for(uint64_t i = 0; i < iterations; i++)
+                    function();
+                int64_t duration = Profiler::getTime() - start;
+
+                if((duration >= m_config.m_min_sample_time) || (iterations >= (uint64_t(1) << 30)))
+                    break;
+
+                // aiming a bit higher than the min sample time
+                if(duration <= 0)
+                    iterations *= 10;
+                else
+                    iterations = iterations * (m_config.m_min_sample_time * 3 / 2) / duration + 1;
+            }
+
+            int64_t benchmark_start = Profiler::getTime();
+
+            while(true) {
+
+                int64_t start = Profiler::getTime();
+                for(uint64_t i = 0; i < iterations; i++)
+                    function();
+                int64_t duration = Profiler::getTime() - start;
+
+                if(!addSample(duration, iterations, benchmark_start))
+                    break;
+            }
+
+        }
+
+        template<typename SETUP, typename FUNCTION>
+        void BenchmarkState::measure(SETUP setup, FUNCTION function) {
+            /// @brief times the function, setup gets called (untimed) before every call to the function
+
+            // warmup
+            setup();
+            function();
+
+            int64_t benchmark_start = Profiler::getTime();
+
+            while(true) {
+
+                // each call is timed on its own, so the setup can be excluded
+                // (the functions should take much longer than reading the clock)
+                int64_t duration = 0;
+                uint64_t iterations = 0;
+
+                while((duration < m_config.m_min_sample_time) && (iterations < (uint64_t(1) << 30))) {
+
+                    setup();
+
+                    int64_t start = Profiler::getTime();
+                    function();
+                    duration += Profiler::getTime() - start;
+
+                    iterations++;
+                }
+
+                if(!addSample(duration, iterations, benchmark_start))
+                    break;
+            }
+
+        }
+
+    } // bench
+
+} // undicht
+
+#define UND_BENCH_CONCAT_IMPL(a, b) a##b
+#define UND_BENCH_CONCAT(a, b) UND_BENCH_CONCAT_IMPL(a, b)
+
+// defines and registers a benchmark function, i.e.:
+// UND_BENCHMARK(benchAddCell, "CellChunk::addCell") { ... state.measure([&]{ ... }); }
+#define UND_BENCHMARK(function, name) \
+    static void function(undicht::bench::BenchmarkState& state); \
+    static undicht::bench::BenchmarkRegistration UND_BENCH_CONCAT(function, _registration)(name, function); \
+    static void function(undicht::bench::BenchmarkState& state)
+
+#endif // BENCHMARK_H
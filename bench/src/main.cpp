@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "benchmark.h"
+#include "debug.h"
+#include "logger.h"
+#include "job_system.h"
+#include "profiler.h"
+
+using namespace undicht;
+using namespace bench;
+
+static void printUsage() {
+
+    std::cout << "usage: undicht_bench [options]\n";
+    std::cout << "  --list              print the names of all benchmarks\n";
+    std::cout << "  --filter <text>     only run benchmarks whose name contains the text\n";
+    std::cout << "  --out <file>        where to write the json results (default: bench_results.json, - for stdout)\n";
+    std::cout << "  --samples <n>       number of samples per benchmark (default: 10)\n";
+    std::cout << "  --min-time <ms>     minimum duration of a sample (default: 10)\n";
+    std::cout << "  --max-time <ms>     time budget per benchmark (default: 5000)\n";
+    std::cout << "  --seed <n>          seed for the generated benchmark data (default: 42)\n";
+    std::cout << "  --workers <n>       number of job system workers (default: hardware threads - 1)\n";
+    std::cout << "  --data-dir <dir>    directory for temporary files (default: .)\n";
+    std::cout << "  --trace <file>      record the profiler zones and write them as chrome trace\n";
+    std::cout << "  --verbose           keep the log notes of the benchmarked code (they distort the timings)\n";
+}
+
+int main(int argc, char** argv) {
+
+    BenchmarkConfig config;
+    std::string out_file = "bench_results.json";
+    std::string trace_file;
+    uint32_t worker_count = 0;
+    bool verbose = false;
+
+    for(int i = 1; i < argc; i++) {
+
+        std::string arg = argv[i];
+
+        if(arg == "--list") {
+            for(const Benchmark& benchmark : getBenchmarks())
+                std::cout << benchmark.m_name << "\n";
+            return 0;
+        }
+
+        if(arg == "--verbose") {
+            verbose = true;
+            continue;
+        }
+
+        if((arg == "--help") || (arg == "-h")) {
+            printUsage();
+            return 0;
+        }
+
+        if(i + 1 >= argc) {
+            std::cerr << "missing value for argument " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+
+        std::string value = argv[++i];
+
+        if(arg == "--filter") config.m_filter = value;
+        else if(arg == "--out") out_file = value;
+        else if(arg == "--samples") config.m_samples = std::max(1ul, std::strtoul(value.c_str(), nullptr, 10));
+        else if(arg == "--min-time") config.m_min_sample_time = std::strtoll(value.c_str(), nullptr, 10) * 1000000;
+        else if(arg == "--max-time") config.m_max_benchmark_time = std::strtoll(value.c_str(), nullptr, 10) * 1000000;
+        else if(arg == "--seed") config.m_seed = std::strtoul(value.c_str(), nullptr, 10);
+        else if(arg == "--workers") worker_count = std::strtoul(value.c_str(), nullptr, 10);
+        else if(arg == "--data-dir") config.m_data_dir = value;
+        else if(arg == "--trace") trace_file = value;
+        else {
+            std::cerr << "unknown argument " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+
+    }
+
+    config.m_min_samples = std::min(config.m_min_samples, config.m_samples);
+
+    // some of the benchmarked functions log every call
+    if(!verbose)
+        Logger::setMinLevel(UND_LOG_LEVEL_WARNING);
+
+    // recording zones costs time, so the profiler only runs if a trace was requested
+    Profiler::setEnabled(trace_file.size());
+    Profiler::setThreadName("main");
+
+    // the IBL functions use the job system
+    JobSystem::init(worker_count);
+
+    std::vector<BenchmarkResult> results = runBenchmarks(config);
+
+    bool success = writeJson(results, config, out_file);
+
+    JobSystem::cleanUp();
+
+    if(trace_file.size())
+        success = Profiler::writeChromeTrace(trace_file) && success;
+
+    Logger::flush();
+
+    return success ? 0 : 1;
+}
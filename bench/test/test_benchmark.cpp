@@ -0,0 +1,181 @@
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "benchmark.h"
+#include "check.h"
+#include "logger.h"
+#include "job_system.h"
+
+// checks the benchmark harness itself (statistics, sampling, filtering, json output)
+// without any of the benchmarked engine code, so it runs on every build machine
+
+using namespace undicht;
+using namespace bench;
+
+static bool isClose(double a, double b) {
+
+    return std::abs(a - b) < 1.0e-9;
+}
+
+///////////////////////////////////////// benchmarks used by the tests /////////////////////////////////////////
+
+static uint32_t setup_calls = 0;
+static uint32_t function_calls = 0;
+
+UND_BENCHMARK(testMeasure, "test/measure") {
+
+    state.setItemsPerIteration(4);
+
+    volatile uint32_t counter = 0;
+    state.measure([&]{ counter = counter + 1; });
+}
+
+UND_BENCHMARK(testMeasureSetup, "test/measure_setup") {
+
+    state.measure([&]{ setup_calls++; }, [&]{ function_calls++; });
+}
+
+UND_BENCHMARK(testNothing, "test/nothing") {
+    // doesnt measure anything, so the harness has to mark it as skipped
+    (void)state;
+}
+
+UND_BENCHMARK(testSkip, "test/skip") {
+
+    state.skip("line\nbreak \"quoted\"");
+}
+
+///////////////////////////////////////// tests /////////////////////////////////////////
+
+static void testStatistics() {
+
+    BenchmarkResult result;
+    result.m_samples = {5.0, 1.0, 3.0, 2.0, 4.0};
+    calcStatistics(result);
+
+    CHECK(isClose(result.m_min, 1.0));
+    CHECK(isClose(result.m_max, 5.0));
+    CHECK(isClose(result.m_mean, 3.0));
+    CHECK(isClose(result.m_median, 3.0));
+    CHECK(isClose(result.m_p90, 5.0));
+    CHECK(isClose(result.m_stddev, std::sqrt(2.5))); // sample standard deviation
+
+    // even number of samples: the median is the mean of the two middle samples
+    result.m_samples = {4.0, 1.0, 3.0, 2.0};
+    calcStatistics(result);
+    CHECK(isClose(result.m_median, 2.5));
+
+    // a single sample has no deviation
+    result.m_samples = {7.0};
+    calcStatistics(result);
+    CHECK(isClose(result.m_median, 7.0));
+    CHECK(isClose(result.m_stddev, 0.0));
+}
+
+static void testRandom() {
+    // the generated benchmark data has to be the same on every run
+
+    BenchmarkConfig config;
+    BenchmarkResult result_a, result_b;
+    BenchmarkState a(config, result_a), b(config, result_b);
+
+    for(uint32_t i = 0; i < 100; i++) {
+        uint32_t value = a.random(10, 20);
+        CHECK(value == b.random(10, 20));
+        CHECK((value >= 10) && (value <= 20));
+
+        float f = a.randomFloat(-1.0f, 1.0f);
+        CHECK(f == b.randomFloat(-1.0f, 1.0f));
+        CHECK((f >= -1.0f) && (f < 1.0f));
+    }
+}
+
+static std::vector<BenchmarkResult> runTestBenchmarks(const std::string& filter) {
+
+    BenchmarkConfig config;
+    config.m_filter = filter;
+    config.m_samples = 5;
+    config.m_min_samples = 2;
+    config.m_min_sample_time = 100000; // 0.1 ms
+
+    return runBenchmarks(config);
+}
+
+static void testRunning() {
+
+    std::vector<BenchmarkResult> results = runTestBenchmarks("test/measure");
+
+    // the filter matches "test/measure" and "test/measure_setup"
+    CHECK(results.size() == 2);
+    if(results.size() != 2) return;
+
+    const BenchmarkResult& measure = results.at(0);
+    CHECK(measure.m_name == "test/measure");
+    CHECK(!measure.m_skipped);
+    CHECK(measure.m_samples.size() == 5);
+    CHECK(measure.m_iterations >= 5);
+    CHECK(measure.m_items == 4);
+    CHECK(measure.m_min <= measure.m_median);
+    CHECK(measure.m_median <= measure.m_max);
+
+    // the setup is called once before every timed call (+ once for the warmup)
+    const BenchmarkResult& measure_setup = results.at(1);
+    CHECK(!measure_setup.m_skipped);
+    CHECK(measure_setup.m_samples.size() == 5);
+    CHECK(setup_calls == function_calls);
+    CHECK(function_calls == measure_setup.m_iterations + 1);
+
+    results = runTestBenchmarks("test/nothing");
+    CHECK((results.size() == 1) && results.at(0).m_skipped);
+
+    results = runTestBenchmarks("does not exist");
+    CHECK(results.empty());
+}
+
+static void testJson() {
+
+    std::vector<BenchmarkResult> results = runTestBenchmarks("test/");
+    CHECK(results.size() == 4);
+
+    const std::string file_name = "undicht_bench_test_results.json";
+    CHECK(writeJson(results, BenchmarkConfig(), file_name));
+
+    std::ifstream file(file_name);
+    std::stringstream json;
+    json << file.rdbuf();
+    file.close();
+    std::remove(file_name.c_str());
+
+    std::string str = json.str();
+    CHECK(str.find("\"name\":\"test/measure\"") != std::string::npos);
+    CHECK(str.find("\"items_per_iteration\":4") != std::string::npos);
+    CHECK(str.find("\"median_ns\":") != std::string::npos);
+    CHECK(str.find("\"samples_ns\":[") != std::string::npos);
+    CHECK(str.find("\"skipped\":true") != std::string::npos);
+
+    // strings have to be escaped, so that the file stays valid json
+    CHECK(str.find("\"reason\":\"line\\u000abreak \\\"quoted\\\"\"") != std::string::npos);
+
+    // writing to a directory that doesnt exist fails
+    CHECK(!writeJson(results, BenchmarkConfig(), "does_not_exist/results.json"));
+}
+
+int main() {
+
+    // the failing write at the end of testJson() logs an expected error
+    Logger::setMinLevel(UND_LOG_LEVEL_WARNING);
+    JobSystem::init(1);
+
+    testStatistics();
+    testRandom();
+    testRunning();
+    testJson();
+
+    JobSystem::cleanUp();
+    Logger::flush();
+
+    return reportChecks();
+}
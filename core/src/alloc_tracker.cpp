@@ -0,0 +1,355 @@
+#include "alloc_tracker.h"
+#include "config.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(PLATFORM_UNIX) && defined(__GLIBC__)
+#include <execinfo.h>
+#define UND_HAS_BACKTRACE
+#endif
+
+#ifdef PLATFORM_WINDOWS
+#include <malloc.h> // _aligned_malloc
+#endif
+
+namespace undicht {
+
+    // the counters of the current frame (indexed by tag)
+    static std::atomic<uint64_t> frame_count[ALLOC_TAG_COUNT];
+    static std::atomic<uint64_t> frame_bytes[ALLOC_TAG_COUNT];
+    static std::atomic<uint64_t> frame_violations(0);
+
+    static std::atomic<uint64_t> last_frame_count[ALLOC_TAG_COUNT];
+    static std::atomic<uint64_t> last_frame_bytes[ALLOC_TAG_COUNT];
+    static std::atomic<uint64_t> last_frame_violations(0);
+
+    static std::atomic<uint64_t> total_count(0);
+    static std::atomic<uint64_t> total_bytes(0);
+
+    static std::atomic<uint8_t> violation_mode((uint8_t)AllocViolationMode::COUNT);
+
+    // plain types only, so that accessing them from operator new cant allocate memory itself
+    static thread_local uint8_t t_tag = 0;
+    static thread_local uint32_t t_no_alloc_depth = 0;
+    static thread_local bool t_reporting = false;
+
+    static void reportViolation(size_t byte_size) {
+        // printing directly to stderr, the logger might allocate memory itself
+
+        std::fprintf(stderr, "ERROR: heap allocation of %zu bytes inside of a NoAllocationScope\n", byte_size);
+
+#ifdef UND_HAS_BACKTRACE
+        void* frames[64];
+        int frame_count = backtrace(frames, 64);
+        backtrace_symbols_fd(frames, frame_count, 2);
+#endif
+
+        std::fflush(stderr);
+    }
+
+    ////////////////////////////////////////// allocation tracker //////////////////////////////////////////
+
+    bool AllocationTracker::isEnabled() {
+        /// @return true, if the global operator new gets tracked
+
+        return UND_TRACK_ALLOCATIONS;
+    }
+
+    void AllocationTracker::endFrame() {
+        /// @brief stores the counters of the current frame as the stats of the last frame and resets them
+
+        for(uint32_t i = 0; i < ALLOC_TAG_COUNT; i++) {
+            last_frame_count[i].store(frame_count[i].exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+            last_frame_bytes[i].store(frame_bytes[i].exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+
+        last_frame_violations.store(frame_violations.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    AllocStats AllocationTracker::getLastFrameStats(AllocTag tag) {
+        /// @return the allocations made during the last frame with the tag
+
+        AllocStats stats;
+        stats.m_count = last_frame_count[(uint32_t)tag].load(std::memory_order_relaxed);
+        stats.m_bytes = last_frame_bytes[(uint32_t)tag].load(std::memory_order_relaxed);
+
+        return stats;
+    }
+
+    AllocStats AllocationTracker::getLastFrameStats() {
+        /// @return the allocations made during the last frame with all tags
+
+        AllocStats stats;
+
+        for(uint32_t i = 0; i < ALLOC_TAG_COUNT; i++) {
+            AllocStats tag_stats = getLastFrameStats((AllocTag)i);
+            stats.m_count += tag_stats.m_count;
+            stats.m_bytes += tag_stats.m_bytes;
+        }
+
+        return stats;
+    }
+
+    uint64_t AllocationTracker::getLastFrameViolations() {
+        /// @return the number of allocations inside of NoAllocationScopes during the last frame
+
+        return last_frame_violations.load(std::memory_order_relaxed);
+    }
+
+    AllocStats AllocationTracker::getTotalStats() {
+        /// @return the allocations made since the program started
+
+        AllocStats stats;
+        stats.m_count = total_count.load(std::memory_order_relaxed);
+        stats.m_bytes = total_bytes.load(std::memory_order_relaxed);
+
+        return stats;
+    }
+
+    void AllocationTracker::setViolationMode(AllocViolationMode mode) {
+
+        violation_mode.store((uint8_t)mode, std::memory_order_relaxed);
+    }
+
+    AllocViolationMode AllocationTracker::getViolationMode() {
+
+        return (AllocViolationMode)violation_mode.load(std::memory_order_relaxed);
+    }
+
+    void AllocationTracker::onAllocation(size_t byte_size) {
+        /// @brief called by the global operator new
+
+        frame_count[t_tag].fetch_add(1, std::memory_order_relaxed);
+        frame_bytes[t_tag].fetch_add(byte_size, std::memory_order_relaxed);
+        total_count.fetch_add(1, std::memory_order_relaxed);
+        total_bytes.fetch_add(byte_size, std::memory_order_relaxed);
+
+        if(!t_no_alloc_depth || t_reporting)
+            return;
+
+        frame_violations.fetch_add(1, std::memory_order_relaxed);
+
+        AllocViolationMode mode = getViolationMode();
+
+        if(mode == AllocViolationMode::COUNT)
+            return;
+
+        t_reporting = true;
+        reportViolation(byte_size);
+        t_reporting = false;
+
+        if(mode == AllocViolationMode::ABORT)
+            std::abort();
+
+    }
+
+    const char* AllocationTracker::getTagName(AllocTag tag) {
+
+        switch(tag) {
+            case AllocTag::GENERAL: return "general";
+            case AllocTag::WORLD: return "world";
+            case AllocTag::GRAPHICS: return "graphics";
+            case AllocTag::IO: return "io";
+            case AllocTag::ASSETS: return "assets";
+            case AllocTag::UI: return "ui";
+        }
+
+        return "unknown";
+    }
+
+    ////////////////////////////////////////// scopes //////////////////////////////////////////
+
+    AllocationTagScope::AllocationTagScope(AllocTag tag) {
+
+        m_previous_tag = (AllocTag)t_tag;
+        t_tag = (uint8_t)tag;
+    }
+
+    AllocationTagScope::~AllocationTagScope() {
+
+        t_tag = (uint8_t)m_previous_tag;
+    }
+
+    NoAllocationScope::NoAllocationScope() {
+
+        t_no_alloc_depth++;
+    }
+
+    NoAllocationScope::~NoAllocationScope() {
+
+        t_no_alloc_depth--;
+    }
+
+    AllowAllocationScope::AllowAllocationScope() {
+
+        m_previous_depth = t_no_alloc_depth;
+        t_no_alloc_depth = 0;
+    }
+
+    AllowAllocationScope::~AllowAllocationScope() {
+
+        t_no_alloc_depth = m_previous_depth;
+    }
+
+} // namespace undicht
+
+#if UND_TRACK_ALLOCATIONS
+
+////////////////////////////////////////// replacing the global operator new / delete //////////////////////////////////////////
+
+void* operator new(size_t byte_size) {
+
+    undicht::AllocationTracker::onAllocation(byte_size);
+
+    void* memory = std::malloc(byte_size ? byte_size : 1);
+
+    if(!memory)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+void* operator new[](size_t byte_size) {
+
+    return operator new(byte_size);
+}
+
+void* operator new(size_t byte_size, const std::nothrow_t&) noexcept {
+
+    undicht::AllocationTracker::onAllocation(byte_size);
+
+    return std::malloc(byte_size ? byte_size : 1);
+}
+
+void* operator new[](size_t byte_size, const std::nothrow_t& tag) noexcept {
+
+    return operator new(byte_size, tag);
+}
+
+void operator delete(void* memory) noexcept {
+
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+
+    std::free(memory);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* memory, size_t) noexcept {
+
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+
+    std::free(memory);
+}
+#endif
+
+#ifdef __cpp_aligned_new
+////////////////////////////////////////// over aligned allocations //////////////////////////////////////////
+
+// memory for types with an alignment above __STDCPP_DEFAULT_NEW_ALIGNMENT__ (i.e. alignas(64) structs)
+
+static void* allocateAligned(size_t byte_size, std::align_val_t alignment) noexcept {
+
+    size_t align = static_cast<size_t>(alignment);
+
+    if(align < sizeof(void*))
+        align = sizeof(void*);
+
+    // aligned_alloc wants the size to be a multiple of the alignment
+    size_t size = byte_size ? (byte_size + align - 1) / align * align : align;
+
+#ifdef PLATFORM_WINDOWS
+    return _aligned_malloc(size, align);
+#else
+    return std::aligned_alloc(align, size);
+#endif
+}
+
+static void freeAligned(void* memory) noexcept {
+
+#ifdef PLATFORM_WINDOWS
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+void* operator new(size_t byte_size, std::align_val_t alignment) {
+
+    undicht::AllocationTracker::onAllocation(byte_size);
+
+    void* memory = allocateAligned(byte_size, alignment);
+
+    if(!memory)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+void* operator new[](size_t byte_size, std::align_val_t alignment) {
+
+    return operator new(byte_size, alignment);
+}
+
+void* operator new(size_t byte_size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+
+    undicht::AllocationTracker::onAllocation(byte_size);
+
+    return allocateAligned(byte_size, alignment);
+}
+
+void* operator new[](size_t byte_size, std::align_val_t alignment, const std::nothrow_t& tag) noexcept {
+
+    return operator new(byte_size, alignment, tag);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+
+    freeAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept {
+
+    freeAligned(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept {
+
+    freeAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept {
+
+    freeAligned(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept {
+
+    freeAligned(memory);
+}
+
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept {
+
+    freeAligned(memory);
+}
+#endif // __cpp_aligned_new
+
+#endif // UND_TRACK_ALLOCATIONS
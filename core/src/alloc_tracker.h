@@ -0,0 +1,128 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// set to 1 (cmake option UND_TRACK_ALLOCATIONS) to replace the global operator new / delete with versions that count the allocations
+#ifndef UND_TRACK_ALLOCATIONS
+#define UND_TRACK_ALLOCATIONS 0
+#endif
+
+namespace undicht {
+
+    // the subsystem an allocation gets counted for
+    enum class AllocTag : uint8_t {
+        GENERAL = 0,
+        WORLD = 1,
+        GRAPHICS = 2,
+        IO = 3,
+        ASSETS = 4,
+        UI = 5,
+    };
+
+    const uint32_t ALLOC_TAG_COUNT = 6;
+
+    // what happens when memory gets allocated inside of a NoAllocationScope
+    enum class AllocViolationMode : uint8_t {
+        COUNT, // only count the allocation
+        REPORT, // print the size of the allocation and a stack trace
+        ABORT, // report, then abort the program
+    };
+
+    struct AllocStats {
+        uint64_t m_count = 0;
+        uint64_t m_bytes = 0;
+    };
+
+    class AllocationTracker {
+        /** counts heap allocations (number and bytes) per frame and per subsystem tag
+        * only does something if the engine was built with UND_TRACK_ALLOCATIONS, the functions can always be called though */
+
+      public:
+
+        /// @return true, if the global operator new gets tracked
+        static bool isEnabled();
+
+        /// @brief stores the counters of the current frame as the stats of the last frame and resets them
+        static void endFrame();
+
+        /// @return the allocations made during the last frame (with the tag / with all tags)
+        static AllocStats getLastFrameStats(AllocTag tag);
+        static AllocStats getLastFrameStats();
+
+        /// @return the number of allocations inside of NoAllocationScopes during the last frame
+        static uint64_t getLastFrameViolations();
+
+        /// @return the allocations made since the program started
+        static AllocStats getTotalStats();
+
+        static void setViolationMode(AllocViolationMode mode);
+        static AllocViolationMode getViolationMode();
+
+        /// @brief called by the global operator new
+        static void onAllocation(size_t byte_size);
+
+        static const char* getTagName(AllocTag tag);
+    };
+
+    class AllocationTagScope {
+        /** allocations on this thread get counted for the tag until the scope ends
+        * use it through the UND_ALLOC_TAG macro */
+
+      protected:
+
+        AllocTag m_previous_tag;
+
+      public:
+
+        AllocationTagScope(AllocTag tag);
+        AllocationTagScope(const AllocationTagScope&) = delete;
+        AllocationTagScope& operator=(const AllocationTagScope&) = delete;
+        ~AllocationTagScope();
+    };
+
+    class NoAllocationScope {
+        /** marks a region (i.e. the main loop) in which no heap allocations are expected on this thread
+        * allocations inside of the region are handled according to the AllocViolationMode
+        * use it through the UND_NO_ALLOC_SCOPE macro */
+
+      public:
+
+        NoAllocationScope();
+        NoAllocationScope(const NoAllocationScope&) = delete;
+        NoAllocationScope& operator=(const NoAllocationScope&) = delete;
+        ~NoAllocationScope();
+    };
+
+    class AllowAllocationScope {
+        /** suspends the enclosing NoAllocationScope, for code that is known to allocate (i.e. loading assets) */
+
+      protected:
+
+        uint32_t m_previous_depth;
+
+      public:
+
+        AllowAllocationScope();
+        AllowAllocationScope(const AllowAllocationScope&) = delete;
+        AllowAllocationScope& operator=(const AllowAllocationScope&) = delete;
+        ~AllowAllocationScope();
+    };
+
+} // namespace undicht
+
+#define UND_ALLOC_CONCAT_IMPL(a, b) a##b
+#define UND_ALLOC_CONCAT(a, b) UND_ALLOC_CONCAT_IMPL(a, b)
+
+#if UND_TRACK_ALLOCATIONS
+#define UND_ALLOC_TAG(tag) undicht::AllocationTagScope UND_ALLOC_CONCAT(und_alloc_tag_, __LINE__)(tag)
+#define UND_NO_ALLOC_SCOPE() undicht::NoAllocationScope UND_ALLOC_CONCAT(und_no_alloc_, __LINE__)
+#define UND_ALLOW_ALLOC_SCOPE() undicht::AllowAllocationScope UND_ALLOC_CONCAT(und_allow_alloc_, __LINE__)
+#else
+#define UND_ALLOC_TAG(tag)
+#define UND_NO_ALLOC_SCOPE()
+#define UND_ALLOW_ALLOC_SCOPE()
+#endif
+
+#endif // ALLOC_TRACKER_H
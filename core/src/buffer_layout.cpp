@@ -3,9 +3,12 @@
 
 namespace undicht {
 
-    BufferLayout::BufferLayout(const std::vector<FixedType> &types) {
+    BufferLayout::BufferLayout(const std::vector<FixedType> &types, LayoutPacking packing) {
 
         m_types = types;
+        m_packing = packing;
+
+        calcOffsets();
     }
 
     void BufferLayout::setType(uint32_t index, const FixedType& type) {
@@ -19,6 +22,14 @@ namespace undicht {
         // storing the attribute
         m_types.at(index) = type;
 
+        calcOffsets();
+    }
+
+    void BufferLayout::addType(const FixedType& type) {
+
+        m_types.push_back(type);
+
+        calcOffsets();
     }
 
     const FixedType& BufferLayout::getType(uint32_t index) const {
@@ -26,25 +37,65 @@ namespace undicht {
         return m_types.at(index);
     }
 
-    uint32_t BufferLayout::getOffset(uint32_t index) const {
+    const std::vector<FixedType>& BufferLayout::getTypes() const {
 
-        uint32_t offset = 0;
-        for(uint32_t i = 0; i < index; i++) {
-            offset += m_types.at(i).getSize();
-        }
+        return m_types;
+    }
+
+    uint32_t BufferLayout::getTypeCount() const {
+
+        return m_types.size();
+    }
 
-        return offset;
+    uint32_t BufferLayout::getOffset(uint32_t index) const {
+
+        return m_offsets.at(index);
     }
 
     unsigned int BufferLayout::getTotalSize() const {
         // @return The size of the data struct described by thisBufferLayout
 
-        unsigned int size = 0;
+        return m_total_size;
+    }
+
+    uint32_t BufferLayout::getEnd() const {
+        // @return the offset at which the last type ends
 
-        for (const FixedType &t : m_types)
-            size += t.getSize();
+        return m_end;
+    }
+
+    LayoutPacking BufferLayout::getPacking() const {
+
+        return m_packing;
+    }
+
+    ///////////////////////////////////////// protected functions /////////////////////////////////////////
+
+    void BufferLayout::calcOffsets() {
+        // uses the same rules as StaticBufferLayout, only at runtime
+
+        m_offsets.resize(m_types.size());
+
+        uint32_t offset = 0;
+        uint32_t max_alignment = 1;
+
+        for(uint32_t i = 0; i < m_types.size(); i++) {
+
+            const FixedType& type = m_types.at(i);
+            uint32_t alignment = layoutAlignment(m_packing, type.getCompSize(), type.getNumComp());
+
+            if(!alignment) // for undefined types
+                alignment = 1;
+
+            offset = alignOffset(offset, alignment);
+            m_offsets.at(i) = offset;
+
+            offset += layoutSize(m_packing, type.getCompSize(), type.getNumComp());
+            max_alignment = alignment > max_alignment ? alignment : max_alignment;
+        }
 
-        return size;
+        m_end = offset;
+        m_total_size = layoutStride(m_packing, offset, max_alignment);
     }
 
-} // namespace undicht
\ No newline at end of file
+} // namespace undicht
@@ -7,22 +7,94 @@
 
 namespace undicht {
 
+    enum class LayoutPacking {
+        PACKED, // no padding between the types (vertex buffers, data stored in files)
+        STD140, // alignment rules for uniform buffers
+        STD430, // alignment rules for storage buffers
+    };
+
+    ////////////////////////////////// alignment rules (usable at compile time) //////////////////////////////////
+    // source: https://registry.khronos.org/vulkan/specs/1.3-extensions/html/chap15.html#interfaces-resources-layout
+
+    /// @return offset rounded up to the next multiple of alignment
+    constexpr uint32_t alignOffset(uint32_t offset, uint32_t alignment) {
+
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    /// @return the number of rows of a matrix type (types with more than 4 components are treated as square matrices)
+    constexpr uint32_t layoutMatrixRows(uint32_t num_comp) {
+
+        return num_comp == 9 ? 3 : 4;
+    }
+
+    /// @return the base alignment of a type
+    constexpr uint32_t layoutAlignment(LayoutPacking packing, uint32_t comp_size, uint32_t num_comp) {
+
+        return (packing == LayoutPacking::PACKED) ? 1 :
+               (num_comp == 1) ? comp_size : // a scalar of size N has a base alignment of N
+               (num_comp == 2) ? 2 * comp_size : // a two-component vector has a base alignment of 2 N
+               (num_comp <= 4) ? 4 * comp_size : // a three- or four-component vector has a base alignment of 4 N
+               // matrices are stored as arrays of column vectors, std140 aligns array elements to 16 bytes
+               (packing == LayoutPacking::STD140) && (4 * comp_size < 16) ? 16 : 4 * comp_size;
+    }
+
+    /// @return the number of bytes occupied by a type (including padding inside matrices)
+    constexpr uint32_t layoutSize(LayoutPacking packing, uint32_t comp_size, uint32_t num_comp) {
+
+        return ((packing == LayoutPacking::PACKED) || (num_comp <= 4)) ? comp_size * num_comp :
+               (num_comp / layoutMatrixRows(num_comp)) * alignOffset(layoutMatrixRows(num_comp) * comp_size, layoutAlignment(packing, comp_size, num_comp));
+    }
+
+    /// @return the size of a complete struct with the end offset and largest member alignment, including padding at the end
+    constexpr uint32_t layoutStride(LayoutPacking packing, uint32_t end_offset, uint32_t max_alignment) {
+
+        return (packing == LayoutPacking::PACKED) ? end_offset :
+               (packing == LayoutPacking::STD140) ? alignOffset(end_offset, max_alignment < 16 ? 16 : max_alignment) :
+               alignOffset(end_offset, max_alignment);
+    }
+
+    ////////////////////////////////////////////// BufferLayout //////////////////////////////////////////////
+
     class BufferLayout {
-        /** layout of the data structure in a buffer */
-      public:
-      
+        /** layout of the data structure in a buffer
+        * the offsets and the total size get calculated when the types are set, so looking them up is cheap */
+
+      protected:
+
         std::vector<FixedType> m_types;
+        std::vector<uint32_t> m_offsets;
+        uint32_t m_end = 0; // end of the last type
+        uint32_t m_total_size = 0; // including padding at the end
+
+        LayoutPacking m_packing = LayoutPacking::PACKED;
+
+      public:
 
         BufferLayout() = default;
-        BufferLayout(const std::vector<FixedType> &types);
+        BufferLayout(const std::vector<FixedType> &types, LayoutPacking packing = LayoutPacking::PACKED);
         virtual ~BufferLayout() = default;
 
         void setType(uint32_t index, const FixedType& type);
+        void addType(const FixedType& type);
+
         const FixedType& getType(uint32_t index) const;
+        const std::vector<FixedType>& getTypes() const;
+        uint32_t getTypeCount() const;
 
         uint32_t getOffset(uint32_t index) const;
 
+        /// @return the size of the data struct described by this BufferLayout (the stride between two structs)
         unsigned int getTotalSize() const;
+
+        /// @return the offset at which the last type ends
+        uint32_t getEnd() const;
+
+        LayoutPacking getPacking() const;
+
+      protected:
+
+        void calcOffsets();
     };
 
 } // namespace undicht
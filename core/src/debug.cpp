@@ -1,15 +1,10 @@
 #include "debug.h"
 
-long first_time = 0;
-
 long getTimeMillesec() {
-    // https://stackoverflow.com/questions/19555121/how-to-get-current-timestamp-in-milliseconds-since-1970-just-the-way-java-gets
+    /// @return milliseconds since the first call (monotonic)
+    // using the steady clock, so that the time cant jump when the system time gets adjusted
 
-    if(!first_time) {
-        first_time = 1;
-        first_time = getTimeMillesec();
-    }
+    static const int64_t first_time = undicht::Logger::getTime();
 
-    using namespace std::chrono;
-    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count() - first_time;
+    return (undicht::Logger::getTime() - first_time) / 1000000;
 }
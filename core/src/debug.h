@@ -1,17 +1,21 @@
 #ifndef DEBUG_H
 #define DEBUG_H
 
-#include <iostream>
-#include <chrono>
+#include "logger.h"
 
 // macros for logging and debugging
+// the messages are written asynchronously by the Logger (see logger.h)
 
-#define UND_ERROR std::cout << "ERROR: " <<  " from " << __FILE__ << " : " << __LINE__ << "\n    "
+#define UND_ERROR UND_LOG_MESSAGE(UND_LOG_LEVEL_ERROR, undicht::LogCategory::GENERAL)
 
-#define UND_WARNING std::cout << "WARNING: " << " from " << __FILE__ << "\n    "
+#define UND_WARNING UND_LOG_MESSAGE(UND_LOG_LEVEL_WARNING, undicht::LogCategory::GENERAL)
 
-#define UND_LOG std::cout << std::flush << "Note: " <<  getTimeMillesec() << " ms\n    "
+#define UND_LOG UND_LOG_MESSAGE(UND_LOG_LEVEL_NOTE, undicht::LogCategory::GENERAL)
 
+// notes that can be filtered by category, i.e. UND_LOG_CAT(IO) << "message\n";
+#define UND_LOG_CAT(category) UND_LOG_MESSAGE(UND_LOG_LEVEL_NOTE, undicht::LogCategory::category)
+
+/// @return milliseconds since the first call (monotonic)
 long getTimeMillesec();
 
 
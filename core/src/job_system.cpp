@@ -0,0 +1,353 @@
+#include "job_system.h"
+#include "debug.h"
+#include "profiler.h"
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace undicht {
+
+    ////////////////////////////////////////// job counter //////////////////////////////////////////
+
+    JobCounter::JobCounter() : m_pending(0) {
+
+    }
+
+    bool JobCounter::isDone() const {
+        /// @return true, if all jobs tracked by this counter have finished
+
+        return m_pending.load(std::memory_order_acquire) == 0;
+    }
+
+    uint32_t JobCounter::getPending() const {
+        /// @return the number of jobs that have not yet finished
+
+        return m_pending.load(std::memory_order_acquire);
+    }
+
+    void JobCounter::increment() {
+
+        m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void JobCounter::decrement() {
+
+        std::vector<Job> ready;
+
+        {
+            // the mutex has to be held while decrementing,
+            // so that a waiting thread can't destroy the counter before it gets released again
+            std::lock_guard<std::mutex> lock(m_dependents_mutex);
+
+            if(m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                ready.swap(m_dependents);
+        }
+
+        // scheduling the jobs that were waiting for this counter
+        // (the counter may not be accessed anymore from here on)
+        for(Job& job : ready)
+            JobSystem::schedule(job);
+
+    }
+
+    bool JobCounter::addDependent(Job& job) {
+        /// @brief the job gets scheduled once the counter reaches zero
+        /// @return false, if the counter already was zero (the job was not stored)
+
+        std::lock_guard<std::mutex> lock(m_dependents_mutex);
+
+        if(m_pending.load(std::memory_order_acquire) == 0)
+            return false;
+
+        m_dependents.push_back(job);
+
+        return true;
+    }
+
+    ////////////////////////////////////////// job system //////////////////////////////////////////
+
+    struct WorkQueue {
+        std::mutex m_mutex;
+        std::deque<Job> m_jobs;
+    };
+
+    struct JobSystem::Data {
+
+        // queue 0 is shared by all threads that are not workers
+        // queue i + 1 is owned by worker i
+        std::vector<WorkQueue*> m_queues;
+        std::vector<std::thread> m_workers;
+
+        std::atomic<bool> m_running;
+
+        // total number of jobs waiting in any queue
+        std::atomic<uint32_t> m_queued_jobs;
+
+        // used to let idle workers sleep
+        std::mutex m_sleep_mutex;
+        std::condition_variable m_wake_up;
+    };
+
+    JobSystem::Data* JobSystem::s_data = nullptr;
+
+    // the queue owned by the current thread
+    static thread_local uint32_t t_queue_id = 0;
+
+    void JobSystem::init(uint32_t worker_count) {
+        /// @param worker_count number of worker threads to start, 0 uses one thread less than there are hardware threads
+
+        if(s_data) {
+            UND_WARNING << "the job system was already initialized\n";
+            return;
+        }
+
+        if(!worker_count) {
+            uint32_t hardware_threads = std::thread::hardware_concurrency();
+            worker_count = hardware_threads > 1 ? hardware_threads - 1 : 1;
+        }
+
+        s_data = new Data;
+        s_data->m_running = true;
+        s_data->m_queued_jobs = 0;
+
+        for(uint32_t i = 0; i < worker_count + 1; i++)
+            s_data->m_queues.push_back(new WorkQueue);
+
+        for(uint32_t i = 0; i < worker_count; i++)
+            s_data->m_workers.push_back(std::thread(workerMain, i));
+
+    }
+
+    void JobSystem::cleanUp() {
+
+        if(!s_data)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(s_data->m_sleep_mutex);
+            s_data->m_running = false;
+        }
+
+        s_data->m_wake_up.notify_all();
+
+        for(std::thread& worker : s_data->m_workers)
+            worker.join();
+
+        // finishing the jobs that were still queued
+        // so that nobody waits forever for their counters
+        while(executeNextJob());
+
+        for(WorkQueue* queue : s_data->m_queues)
+            delete queue;
+
+        delete s_data;
+        s_data = nullptr;
+    }
+
+    bool JobSystem::isInitialized() {
+
+        return s_data;
+    }
+
+    uint32_t JobSystem::getWorkerCount() {
+
+        if(!s_data)
+            return 0;
+
+        return s_data->m_workers.size();
+    }
+
+    void JobSystem::run(const std::function<void()>& function, JobCounter* counter, JobCounter* dependency) {
+        /// @brief submit a job for execution
+        /// @param counter gets incremented now and decremented once the job has finished (may be null)
+        /// @param dependency the job wont start before this counter reached zero (may be null)
+
+        Job job;
+        job.m_function = function;
+        job.m_counter = counter;
+
+        if(counter)
+            counter->increment();
+
+        if(dependency && dependency->addDependent(job))
+            return;
+
+        schedule(job);
+    }
+
+    void JobSystem::parallelFor(uint32_t begin, uint32_t end, uint32_t grain_size, const std::function<void(uint32_t)>& function) {
+        /// @brief calls function(i) for every i in [begin, end) and returns once all calls have finished
+        /// @param grain_size number of consecutive indices handled by a single job (0 picks a size based on the worker count)
+
+        if(end <= begin)
+            return;
+
+        const uint32_t count = end - begin;
+
+        if(!grain_size) {
+            // a few jobs per thread, so that stealing can even out the load
+            grain_size = count / ((getWorkerCount() + 1) * 4);
+            grain_size = grain_size ? grain_size : 1;
+        }
+
+        if(!s_data || (count <= grain_size)) {
+
+            for(uint32_t i = begin; i < end; i++)
+                function(i);
+
+            return;
+        }
+
+        JobCounter counter;
+
+        for(uint32_t first = begin; first < end; first += grain_size) {
+
+            uint32_t last = (end - first) > grain_size ? first + grain_size : end;
+
+            run([&function, first, last]() {
+                for(uint32_t i = first; i < last; i++)
+                    function(i);
+            }, &counter);
+
+            // dont overflow when end is close to the maximum index
+            if(last == end)
+                break;
+        }
+
+        waitFor(counter);
+    }
+
+    void JobSystem::waitFor(const JobCounter& counter) {
+        /// @brief returns once the counter reached zero
+        /// the calling thread executes pending jobs in the meantime
+
+        while(!counter.isDone()) {
+
+            if(!executeNextJob())
+                std::this_thread::yield();
+        }
+
+        // the thread that finished the last job may still hold the mutex of the counter
+        std::lock_guard<std::mutex> lock(counter.m_dependents_mutex);
+    }
+
+    bool JobSystem::executeNextJob() {
+        /// @brief executes a single pending job on the calling thread
+        /// @return false, if there was no job to execute
+
+        Job job;
+
+        if(!popJob(job))
+            return false;
+
+        execute(job);
+
+        return true;
+    }
+
+    ///////////////////////////////////////// protected functions /////////////////////////////////////////
+
+    void JobSystem::schedule(Job& job) {
+
+        if(!s_data) {
+            // no workers, executing the job right away
+            execute(job);
+            return;
+        }
+
+        WorkQueue* queue = s_data->m_queues.at(t_queue_id);
+
+        {
+            std::lock_guard<std::mutex> lock(queue->m_mutex);
+            queue->m_jobs.push_back(job);
+            s_data->m_queued_jobs.fetch_add(1);
+        }
+
+        {
+            // taking the lock so that the notification cant get lost
+            // between a worker checking for jobs and going to sleep
+            std::lock_guard<std::mutex> lock(s_data->m_sleep_mutex);
+        }
+
+        s_data->m_wake_up.notify_one();
+    }
+
+    void JobSystem::execute(Job& job) {
+
+        job.m_function();
+
+        if(job.m_counter)
+            job.m_counter->decrement();
+
+    }
+
+    bool JobSystem::popJob(Job& job) {
+
+        if(!s_data || !s_data->m_queued_jobs.load())
+            return false;
+
+        const uint32_t queue_count = s_data->m_queues.size();
+
+        // taking the newest job from the own queue (its data is most likely still in the cache)
+        // the shared queue gets processed in the order the jobs were submitted
+        {
+            WorkQueue* own = s_data->m_queues.at(t_queue_id);
+            std::lock_guard<std::mutex> lock(own->m_mutex);
+
+            if(!own->m_jobs.empty()) {
+
+                if(t_queue_id) {
+                    job = std::move(own->m_jobs.back());
+                    own->m_jobs.pop_back();
+                } else {
+                    job = std::move(own->m_jobs.front());
+                    own->m_jobs.pop_front();
+                }
+
+                s_data->m_queued_jobs.fetch_sub(1);
+                return true;
+            }
+
+        }
+
+        // stealing the oldest job from another queue
+        for(uint32_t i = 1; i < queue_count; i++) {
+
+            WorkQueue* victim = s_data->m_queues.at((t_queue_id + i) % queue_count);
+            std::lock_guard<std::mutex> lock(victim->m_mutex);
+
+            if(victim->m_jobs.empty())
+                continue;
+
+            job = std::move(victim->m_jobs.front());
+            victim->m_jobs.pop_front();
+
+            s_data->m_queued_jobs.fetch_sub(1);
+            return true;
+        }
+
+        return false;
+    }
+
+    void JobSystem::workerMain(uint32_t worker_id) {
+
+        t_queue_id = worker_id + 1;
+        Profiler::setThreadName("worker " + std::to_string(worker_id + 1));
+
+        while(s_data->m_running) {
+
+            if(executeNextJob())
+                continue;
+
+            // sleeping until new jobs arrive
+            std::unique_lock<std::mutex> lock(s_data->m_sleep_mutex);
+            s_data->m_wake_up.wait(lock, [] {
+                return !s_data->m_running || s_data->m_queued_jobs.load();
+            });
+
+        }
+
+    }
+
+} // namespace undicht
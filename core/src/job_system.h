@@ -0,0 +1,112 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace undicht {
+
+    class JobCounter;
+
+    struct Job {
+        // a unit of work that can be executed by any thread of the job system
+
+        std::function<void()> m_function;
+
+        // gets decremented once the job has finished (may be null)
+        JobCounter* m_counter = nullptr;
+    };
+
+    class JobCounter {
+        /** counts the jobs that still have to finish before the work depending on them can continue
+        * serves as the handle for jobs started by the job system (one counter can track multiple jobs)
+        * the counter has to stay alive until all jobs tracking it (and depending on it) have finished */
+
+      protected:
+
+        std::atomic<uint32_t> m_pending;
+
+        // jobs that wait for this counter to reach zero
+        mutable std::mutex m_dependents_mutex;
+        std::vector<Job> m_dependents;
+
+        friend class JobSystem;
+
+      public:
+
+        JobCounter();
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        /// @return true, if all jobs tracked by this counter have finished
+        bool isDone() const;
+
+        /// @return the number of jobs that have not yet finished
+        uint32_t getPending() const;
+
+      protected:
+
+        void increment();
+        void decrement();
+
+        /// @brief the job gets scheduled once the counter reaches zero
+        /// @return false, if the counter already was zero (the job was not stored)
+        bool addDependent(Job& job);
+    };
+
+    class JobSystem {
+        /** a fixed pool of worker threads executing jobs
+        * every worker owns a deque of jobs: the owner takes its newest job, idle workers steal the oldest jobs of others
+        * threads that are not workers (i.e. the main thread) submit their jobs to a shared queue
+        * waiting for a job does not block the calling thread, instead it helps executing pending jobs
+        * if the job system is not initialized, all jobs get executed immediately on the calling thread */
+
+      protected:
+
+        struct Data;
+
+        static Data* s_data;
+
+        friend class JobCounter;
+
+      public:
+
+        /// @param worker_count number of worker threads to start, 0 uses one thread less than there are hardware threads
+        static void init(uint32_t worker_count = 0);
+        static void cleanUp();
+
+        static bool isInitialized();
+        static uint32_t getWorkerCount();
+
+        /// @brief submit a job for execution
+        /// @param counter gets incremented now and decremented once the job has finished (may be null)
+        /// @param dependency the job wont start before this counter reached zero (may be null)
+        static void run(const std::function<void()>& function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+        /// @brief calls function(i) for every i in [begin, end) and returns once all calls have finished
+        /// @param grain_size number of consecutive indices handled by a single job (0 picks a size based on the worker count)
+        static void parallelFor(uint32_t begin, uint32_t end, uint32_t grain_size, const std::function<void(uint32_t)>& function);
+
+        /// @brief returns once the counter reached zero
+        /// the calling thread executes pending jobs in the meantime
+        static void waitFor(const JobCounter& counter);
+
+        /// @brief executes a single pending job on the calling thread
+        /// @return false, if there was no job to execute
+        static bool executeNextJob();
+
+      protected:
+
+        static void schedule(Job& job);
+        static void execute(Job& job);
+        static bool popJob(Job& job);
+
+        static void workerMain(uint32_t worker_id);
+    };
+
+} // namespace undicht
+
+#endif // JOB_SYSTEM_H
@@ -0,0 +1,148 @@
+#include "linear_arena.h"
+#include "debug.h"
+
+#include <cstdlib>
+
+namespace undicht {
+
+    ////////////////////////////////////////// linear arena //////////////////////////////////////////
+
+    LinearArena::LinearArena(size_t block_size) {
+
+        m_block_size = block_size;
+    }
+
+    LinearArena::~LinearArena() {
+
+        for(Block& block : m_blocks)
+            std::free(block.m_data);
+
+    }
+
+    void* LinearArena::allocate(size_t byte_size, size_t alignment) {
+        /// @brief reserve memory from the arena
+        /// @param alignment has to be a power of 2
+
+        // trying the current block and the blocks that were kept from before the last reset
+        while(m_current_block < m_blocks.size()) {
+
+            Block& block = m_blocks.at(m_current_block);
+
+            // aligning the address, not just the offset (malloc only guarantees max_align_t)
+            uintptr_t address = (uintptr_t)(block.m_data + m_offset);
+            size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+
+            if(m_offset + padding + byte_size <= block.m_size) {
+
+                void* memory = block.m_data + m_offset + padding;
+                m_offset += padding + byte_size;
+
+                return memory;
+            }
+
+            m_current_block++;
+            m_offset = 0;
+        }
+
+        // allocating a new block that is big enough
+        Block block;
+        block.m_size = (byte_size + alignment > m_block_size) ? byte_size + alignment : m_block_size;
+        block.m_data = (char*)std::malloc(block.m_size);
+
+        if(!block.m_data) {
+            UND_ERROR << "failed to allocate a block of " << block.m_size << " bytes for a linear arena\n";
+            return nullptr;
+        }
+
+        m_blocks.push_back(block);
+        m_current_block = m_blocks.size() - 1;
+        m_offset = 0;
+
+        return allocate(byte_size, alignment);
+    }
+
+    void LinearArena::reset() {
+        /// @brief releases all memory allocated from the arena (without returning it to the heap)
+
+        m_current_block = 0;
+        m_offset = 0;
+    }
+
+    LinearArena::Marker LinearArena::getMarker() const {
+        /// @brief the current state of the arena, rewinding to it releases all later allocations
+
+        Marker marker;
+        marker.m_block = m_current_block;
+        marker.m_offset = m_offset;
+
+        return marker;
+    }
+
+    void LinearArena::rewind(const Marker& marker) {
+
+        m_current_block = marker.m_block;
+        m_offset = marker.m_offset;
+    }
+
+    size_t LinearArena::getUsedSize() const {
+        /// @return the number of bytes that are currently allocated from the arena (including alignment padding)
+
+        size_t used = m_offset;
+
+        for(uint32_t i = 0; (i < m_current_block) && (i < m_blocks.size()); i++)
+            used += m_blocks.at(i).m_size;
+
+        return used;
+    }
+
+    size_t LinearArena::getCapacity() const {
+        /// @return the number of bytes that were allocated from the heap
+
+        size_t capacity = 0;
+
+        for(const Block& block : m_blocks)
+            capacity += block.m_size;
+
+        return capacity;
+    }
+
+    ////////////////////////////////////////// arena scope //////////////////////////////////////////
+
+    ArenaScope::ArenaScope(LinearArena& arena) : m_arena(arena) {
+
+        m_marker = arena.getMarker();
+    }
+
+    ArenaScope::~ArenaScope() {
+
+        m_arena.rewind(m_marker);
+    }
+
+    LinearArena& ArenaScope::getArena() const {
+
+        return m_arena;
+    }
+
+    ////////////////////////////////////////// frame arena //////////////////////////////////////////
+
+    static LinearArena& getThreadFrameArena() {
+
+        static thread_local LinearArena arena;
+
+        return arena;
+    }
+
+    LinearArena& FrameArena::get() {
+        /// @return the frame arena of the calling thread
+
+        return getThreadFrameArena();
+    }
+
+    void FrameArena::endFrame() {
+        /// @brief resets the frame arena of the calling thread
+        /// (the arenas of other threads may still be in use by their jobs, they get released by ArenaScopes)
+
+        getThreadFrameArena().reset();
+    }
+
+} // namespace undicht
@@ -0,0 +1,141 @@
+#ifndef LINEAR_ARENA_H
+#define LINEAR_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace undicht {
+
+    class LinearArena {
+        /** a bump allocator for short lived (transient) allocations
+        * memory gets taken from big blocks by moving a pointer forward, single allocations cant be freed
+        * instead everything gets released at once with reset() (or rewind() to a marker)
+        * the blocks are kept after a reset, so once the arena has grown large enough no more heap allocations happen
+        * an arena must only be used by one thread at a time */
+
+      public:
+
+        struct Marker {
+            uint32_t m_block = 0;
+            size_t m_offset = 0;
+        };
+
+      protected:
+
+        struct Block {
+            char* m_data = nullptr;
+            size_t m_size = 0;
+        };
+
+        std::vector<Block> m_blocks;
+        uint32_t m_current_block = 0;
+        size_t m_offset = 0; // in the current block
+
+        size_t m_block_size;
+
+      public:
+
+        /// @param block_size the minimum size of the blocks that get allocated from the heap
+        LinearArena(size_t block_size = 1 << 20);
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+        ~LinearArena();
+
+        /// @brief reserve memory from the arena
+        /// @param alignment has to be a power of 2
+        void* allocate(size_t byte_size, size_t alignment = alignof(std::max_align_t));
+
+        template<typename T>
+        T* allocate(size_t count) {
+            return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+        }
+
+        /// @brief releases all memory allocated from the arena (without returning it to the heap)
+        void reset();
+
+        /// @brief the current state of the arena, rewinding to it releases all later allocations
+        Marker getMarker() const;
+        void rewind(const Marker& marker);
+
+        /// @return the number of bytes that are currently allocated from the arena (including alignment padding)
+        size_t getUsedSize() const;
+
+        /// @return the number of bytes that were allocated from the heap
+        size_t getCapacity() const;
+
+    };
+
+    class ArenaScope {
+        /** releases all allocations that were made from the arena during the lifetime of the scope object */
+
+      protected:
+
+        LinearArena& m_arena;
+        LinearArena::Marker m_marker;
+
+      public:
+
+        ArenaScope(LinearArena& arena);
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+        ~ArenaScope();
+
+        LinearArena& getArena() const;
+    };
+
+    template<typename T>
+    class ArenaAllocator {
+        /** allocator that lets stl containers take their memory from an arena
+        * deallocate does nothing, the memory gets released when the arena is reset */
+
+      public:
+
+        typedef T value_type;
+
+        LinearArena* m_arena;
+
+        ArenaAllocator(LinearArena& arena) : m_arena(&arena) {}
+
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.m_arena) {}
+
+        T* allocate(size_t count) {
+            return m_arena->allocate<T>(count);
+        }
+
+        void deallocate(T* p, size_t count) {}
+
+        template<typename U>
+        bool operator==(const ArenaAllocator<U>& other) const {
+            return m_arena == other.m_arena;
+        }
+
+        template<typename U>
+        bool operator!=(const ArenaAllocator<U>& other) const {
+            return m_arena != other.m_arena;
+        }
+    };
+
+    // a vector that takes its memory from an arena, i.e.: ArenaVector<int> v(FrameArena::get());
+    template<typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+    class FrameArena {
+        /** every thread has its own arena for allocations that only live until the end of the frame
+        * endFrame() only resets the arena of the calling thread (the main thread, once per frame)
+        * worker threads may be running jobs at that point, so their allocations have to be released
+        * with an ArenaScope inside the job instead */
+
+      public:
+
+        /// @return the frame arena of the calling thread
+        static LinearArena& get();
+
+        /// @brief resets the frame arena of the calling thread
+        static void endFrame();
+    };
+
+} // namespace undicht
+
+#endif // LINEAR_ARENA_H
@@ -0,0 +1,551 @@
+#include "logger.h"
+#include "ref_counted.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace undicht {
+
+    ////////////////////////////////////////// ring buffer //////////////////////////////////////////
+
+    struct LogRecord {
+        // header in front of every message in a ring buffer
+
+        uint32_t m_size; // size of the record including the header (multiple of 8)
+        uint32_t m_text_size;
+        uint32_t m_line;
+        uint8_t m_level;
+        uint8_t m_category;
+        int64_t m_time;
+        const char* m_file;
+    };
+
+    // records that only fill the space until the end of the ring buffer
+    const uint8_t PADDING_RECORD = 0xff;
+
+    class LogRingBuffer : public RefCounted {
+        /** single producer (the owning thread), single consumer (the logging thread)
+        * referenced by both threads, whichever releases it last deletes it */
+
+      public:
+
+        static const uint64_t CAPACITY = 1 << 16;
+
+        char m_data[CAPACITY];
+
+        std::atomic<uint64_t> m_write_pos; // only written by the owning thread
+        std::atomic<uint64_t> m_read_pos; // only written by the logging thread
+
+        LogRingBuffer() : m_write_pos(0), m_read_pos(0) {}
+
+        /// @return false, if there is not enough space left
+        bool push(const LogRecord& header, const char* text) {
+
+            const uint64_t size = (sizeof(LogRecord) + header.m_text_size + 7) & ~uint64_t(7);
+
+            uint64_t write_pos = m_write_pos.load(std::memory_order_relaxed);
+            const uint64_t read_pos = m_read_pos.load(std::memory_order_acquire);
+
+            uint64_t offset = write_pos % CAPACITY;
+            const uint64_t space_to_end = CAPACITY - offset;
+
+            // records dont wrap around, they start at the beginning of the buffer instead
+            const uint64_t needed = space_to_end < size ? space_to_end + size : size;
+
+            if(write_pos + needed - read_pos > CAPACITY)
+                return false;
+
+            if(space_to_end < size) {
+
+                // if even a header doesnt fit, the reader skips the rest on its own
+                if(space_to_end >= sizeof(LogRecord)) {
+                    LogRecord padding;
+                    padding.m_size = space_to_end;
+                    padding.m_level = PADDING_RECORD;
+                    std::memcpy(m_data + offset, &padding, sizeof(LogRecord));
+                }
+
+                write_pos += space_to_end;
+                offset = 0;
+            }
+
+            LogRecord record = header;
+            record.m_size = size;
+            std::memcpy(m_data + offset, &record, sizeof(LogRecord));
+            std::memcpy(m_data + offset + sizeof(LogRecord), text, header.m_text_size);
+
+            m_write_pos.store(write_pos + size, std::memory_order_release);
+
+            return true;
+        }
+
+        /// @brief calls function(header, text) for every message in the buffer
+        /// @return the number of messages that were read
+        template<typename Function>
+        uint32_t consume(Function function) {
+
+            uint64_t read_pos = m_read_pos.load(std::memory_order_relaxed);
+            const uint64_t write_pos = m_write_pos.load(std::memory_order_acquire);
+
+            uint32_t count = 0;
+
+            while(read_pos < write_pos) {
+
+                const uint64_t offset = read_pos % CAPACITY;
+                const uint64_t space_to_end = CAPACITY - offset;
+
+                if(space_to_end < sizeof(LogRecord)) {
+                    read_pos += space_to_end;
+                    continue;
+                }
+
+                LogRecord record;
+                std::memcpy(&record, m_data + offset, sizeof(LogRecord));
+
+                if(record.m_level != PADDING_RECORD) {
+                    function(record, m_data + offset + sizeof(LogRecord));
+                    count++;
+                }
+
+                read_pos += record.m_size;
+            }
+
+            m_read_pos.store(read_pos, std::memory_order_release);
+
+            return count;
+        }
+
+    };
+
+    ////////////////////////////////////////// logging thread //////////////////////////////////////////
+
+    // set once the logging thread was stopped at exit
+    static std::atomic<bool> writer_destroyed(false);
+
+    class LogWriter {
+
+      public:
+
+        // registered ring buffers (the mutex is only used when threads log for the first time)
+        std::mutex m_buffers_mutex;
+        std::vector<RefPtr<LogRingBuffer>> m_buffers;
+
+        std::thread m_thread;
+        std::atomic<bool> m_running;
+
+        std::mutex m_wake_mutex;
+        std::condition_variable m_wake_up;
+        std::condition_variable m_flushed;
+        uint64_t m_flush_requested = 0;
+        uint64_t m_flush_completed = 0;
+
+        std::atomic<uint64_t> m_dropped;
+
+        int64_t m_start_time;
+
+        // used for formatting the messages
+        std::string m_output;
+
+        LogWriter() : m_running(true), m_dropped(0) {
+
+            m_start_time = Logger::getTime();
+            m_thread = std::thread(&LogWriter::threadMain, this);
+        }
+
+        ~LogWriter() {
+
+            {
+                std::lock_guard<std::mutex> lock(m_wake_mutex);
+                m_running = false;
+            }
+
+            m_wake_up.notify_all();
+            m_thread.join();
+
+            // the remaining messages got written by the thread before it exited
+            // (the buffers of threads that are still running get deleted by them)
+            writer_destroyed = true;
+        }
+
+        RefPtr<LogRingBuffer> registerBuffer() {
+
+            RefPtr<LogRingBuffer> buffer = makeRef<LogRingBuffer>();
+
+            std::lock_guard<std::mutex> lock(m_buffers_mutex);
+            m_buffers.push_back(buffer);
+
+            return buffer;
+        }
+
+        void wakeUp() {
+
+            {
+                std::lock_guard<std::mutex> lock(m_wake_mutex);
+            }
+
+            m_wake_up.notify_one();
+        }
+
+        void flush() {
+
+            std::unique_lock<std::mutex> lock(m_wake_mutex);
+
+            const uint64_t flush_id = ++m_flush_requested;
+            m_wake_up.notify_one();
+            m_flushed.wait(lock, [&] { return (m_flush_completed >= flush_id) || !m_running; });
+        }
+
+      protected:
+
+        void threadMain() {
+
+            bool running = true;
+
+            while(running) {
+
+                uint64_t flush_id;
+                {
+                    std::unique_lock<std::mutex> lock(m_wake_mutex);
+
+                    // notes dont wake up the thread, so it checks the buffers regularly
+                    m_wake_up.wait_for(lock, std::chrono::milliseconds(10), [&] {
+                        return !m_running || (m_flush_requested > m_flush_completed);
+                    });
+
+                    flush_id = m_flush_requested;
+                    running = m_running;
+                }
+
+                writeMessages();
+
+                {
+                    std::lock_guard<std::mutex> lock(m_wake_mutex);
+                    m_flush_completed = flush_id;
+                }
+
+                m_flushed.notify_all();
+            }
+
+        }
+
+        void writeMessages() {
+
+            m_output.clear();
+
+            std::lock_guard<std::mutex> lock(m_buffers_mutex);
+
+            for(uint32_t i = 0; i < m_buffers.size(); i++) {
+
+                LogRingBuffer* buffer = m_buffers.at(i).get();
+
+                // only referenced by the logging thread once the owning thread has exited
+                // (the fence makes its last messages visible, it synchronizes with the release of its reference)
+                bool abandoned = buffer->getRefCount() == 1;
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                buffer->consume([this](const LogRecord& record, const char* text) {
+                    formatMessage(record, text);
+                });
+
+                // deleting the buffers of threads that have exited
+                if(abandoned) {
+                    m_buffers.erase(m_buffers.begin() + i);
+                    i--;
+                }
+            }
+
+            uint64_t dropped = m_dropped.exchange(0);
+            if(dropped)
+                m_output += "WARNING:  from " __FILE__ "\n    dropped " + std::to_string(dropped) + " log messages (ring buffer full)\n";
+
+            if(m_output.size()) {
+                std::fwrite(m_output.data(), 1, m_output.size(), stdout);
+                std::fflush(stdout);
+            }
+
+        }
+
+        void formatMessage(const LogRecord& record, const char* text) {
+            // keeps the format of the old std::cout based macros
+
+            char prefix[64];
+
+            if(record.m_level == UND_LOG_LEVEL_ERROR) {
+                std::snprintf(prefix, sizeof(prefix), " : %u\n    ", record.m_line);
+                m_output += "ERROR:  from ";
+                m_output += record.m_file;
+                m_output += prefix;
+            } else if(record.m_level == UND_LOG_LEVEL_WARNING) {
+                m_output += "WARNING:  from ";
+                m_output += record.m_file;
+                m_output += "\n    ";
+            } else {
+                std::snprintf(prefix, sizeof(prefix), "Note: %lld ms\n    ", (long long)((record.m_time - m_start_time) / 1000000));
+                m_output += prefix;
+            }
+
+            m_output.append(text, record.m_text_size);
+        }
+
+    };
+
+    // constructed when the first message gets logged, destroyed (and flushed) at exit
+    static LogWriter& getWriter() {
+
+        static LogWriter writer;
+        return writer;
+    }
+
+    // set once the ring buffer of the current thread was given up
+    // (trivially destructible, so it can still be read by destructors that run after t_log_buffer was destroyed)
+    static thread_local bool t_log_buffer_destroyed = false;
+
+    struct ThreadLogBuffer {
+        // the ring buffer of the current thread
+
+        RefPtr<LogRingBuffer> m_buffer;
+
+        ~ThreadLogBuffer() {
+
+            t_log_buffer_destroyed = true;
+        }
+    };
+
+    static thread_local ThreadLogBuffer t_log_buffer;
+
+    ////////////////////////////////////////// logger //////////////////////////////////////////
+
+    std::atomic<uint32_t> Logger::s_min_level(UND_MIN_LOG_LEVEL);
+    std::atomic<uint32_t> Logger::s_categories(UND_LOG_CATEGORIES);
+
+    void Logger::setMinLevel(uint8_t level) {
+        /// @brief messages with a lower level are ignored (at runtime)
+
+        s_min_level.store(level, std::memory_order_relaxed);
+    }
+
+    void Logger::setCategoryEnabled(LogCategory category, bool enabled) {
+
+        if(enabled)
+            s_categories.fetch_or(1u << uint32_t(category), std::memory_order_relaxed);
+        else
+            s_categories.fetch_and(~(1u << uint32_t(category)), std::memory_order_relaxed);
+
+    }
+
+    bool Logger::isEnabled(uint8_t level, LogCategory category) {
+
+        return (level >= s_min_level.load(std::memory_order_relaxed)) && ((s_categories.load(std::memory_order_relaxed) >> uint32_t(category)) & 1u);
+    }
+
+    void Logger::flush() {
+        /// @brief waits until all messages submitted so far were written
+
+        getWriter().flush();
+    }
+
+    uint64_t Logger::getDroppedCount() {
+        /// @return the number of messages that were dropped because a ring buffer was full
+        /// (since the last time the logging thread reported dropped messages)
+
+        return getWriter().m_dropped.load();
+    }
+
+    void Logger::submit(uint8_t level, LogCategory category, const char* file, uint32_t line, int64_t time, const char* text, uint32_t size) {
+        /// @brief submit a finished message (used by LogMessage)
+
+        if(writer_destroyed || t_log_buffer_destroyed) {
+            // messages from destructors that run after the logging thread was stopped
+            // or after the ring buffer of the thread was given up (the logging thread may have deleted it already)
+            std::fwrite(text, 1, size, stdout);
+            std::fflush(stdout);
+            return;
+        }
+
+        LogWriter& writer = getWriter();
+
+        if(!t_log_buffer.m_buffer)
+            t_log_buffer.m_buffer = writer.registerBuffer();
+
+        LogRecord record;
+        record.m_text_size = size;
+        record.m_line = line;
+        record.m_level = level;
+        record.m_category = uint8_t(category);
+        record.m_time = time;
+        record.m_file = file;
+
+        if(level < UND_LOG_LEVEL_ERROR) {
+
+            if(!t_log_buffer.m_buffer->push(record, text)) {
+                writer.m_dropped.fetch_add(1, std::memory_order_relaxed);
+                writer.wakeUp();
+            }
+
+            return;
+        }
+
+        // errors dont get dropped
+        while(!t_log_buffer.m_buffer->push(record, text)) {
+            writer.wakeUp();
+            std::this_thread::yield();
+        }
+
+        writer.flush();
+    }
+
+    int64_t Logger::getTime() {
+        /// @return nanoseconds on the monotonic clock used for the log timestamps
+
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    ////////////////////////////////////////// log message //////////////////////////////////////////
+
+    LogMessage::LogMessage(uint8_t level, LogCategory category, const char* file, uint32_t line)
+        : m_level(level), m_category(category), m_file(file), m_line(line) {
+
+        m_time = Logger::getTime();
+    }
+
+    LogMessage::~LogMessage() {
+
+        Logger::submit(m_level, m_category, m_file, m_line, m_time, m_text, m_size);
+    }
+
+    LogMessage& LogMessage::operator<<(const char* text) {
+
+        if(text)
+            append(text, std::strlen(text));
+
+        return *this;
+    }
+
+    LogMessage& LogMessage::operator<<(const std::string& text) {
+
+        append(text.data(), text.size());
+
+        return *this;
+    }
+
+    LogMessage& LogMessage::operator<<(char c) {
+
+        append(&c, 1);
+
+        return *this;
+    }
+
+    LogMessage& LogMessage::operator<<(bool b) {
+        // std::cout prints bools as numbers as well
+
+        append(b ? "1" : "0", 1);
+
+        return *this;
+    }
+
+    LogMessage& LogMessage::operator<<(char* text) {
+
+        return *this << (const char*)text;
+    }
+
+    LogMessage& LogMessage::operator<<(std::string_view text) {
+
+        append(text.data(), text.size());
+
+        return *this;
+    }
+
+    LogMessage& LogMessage::operator<<(signed char c) {
+
+        return *this << char(c);
+    }
+
+    LogMessage& LogMessage::operator<<(unsigned char c) {
+
+        return *this << char(c);
+    }
+
+    // formats a number into the message
+    #define UND_LOG_APPEND_FORMATTED(format, value) \
+        char buffer[32]; \
+        int size = std::snprintf(buffer, sizeof(buffer), format, value); \
+        if(size > 0) append(buffer, size < int(sizeof(buffer)) ? size : sizeof(buffer) - 1); \
+        return *this;
+
+    LogMessage& LogMessage::operator<<(int i) {
+        UND_LOG_APPEND_FORMATTED("%d", i)
+    }
+
+    LogMessage& LogMessage::operator<<(unsigned int i) {
+        UND_LOG_APPEND_FORMATTED("%u", i)
+    }
+
+    LogMessage& LogMessage::operator<<(long i) {
+        UND_LOG_APPEND_FORMATTED("%ld", i)
+    }
+
+    LogMessage& LogMessage::operator<<(unsigned long i) {
+        UND_LOG_APPEND_FORMATTED("%lu", i)
+    }
+
+    LogMessage& LogMessage::operator<<(long long i) {
+        UND_LOG_APPEND_FORMATTED("%lld", i)
+    }
+
+    LogMessage& LogMessage::operator<<(unsigned long long i) {
+        UND_LOG_APPEND_FORMATTED("%llu", i)
+    }
+
+    LogMessage& LogMessage::operator<<(float f) {
+        // %g matches the default formatting of std::cout
+        UND_LOG_APPEND_FORMATTED("%g", f)
+    }
+
+    LogMessage& LogMessage::operator<<(double d) {
+        UND_LOG_APPEND_FORMATTED("%g", d)
+    }
+
+    LogMessage& LogMessage::operator<<(const void* p) {
+        UND_LOG_APPEND_FORMATTED("%p", p)
+    }
+
+    LogMessage& LogMessage::operator<<(short i) {
+        UND_LOG_APPEND_FORMATTED("%hd", i)
+    }
+
+    LogMessage& LogMessage::operator<<(unsigned short i) {
+        UND_LOG_APPEND_FORMATTED("%hu", i)
+    }
+
+    LogMessage& LogMessage::operator<<(long double d) {
+        UND_LOG_APPEND_FORMATTED("%Lg", d)
+    }
+
+    #undef UND_LOG_APPEND_FORMATTED
+
+    LogMessage::LogStreamBuffer::LogStreamBuffer(LogMessage& message) : m_message(message) {
+
+        setp(message.m_text + message.m_size, message.m_text + UND_LOG_MESSAGE_SIZE);
+    }
+
+    uint32_t LogMessage::LogStreamBuffer::getSize() const {
+
+        return uint32_t(pptr() - m_message.m_text);
+    }
+
+    void LogMessage::append(const char* text, uint32_t size) {
+
+        if(m_size + size > UND_LOG_MESSAGE_SIZE)
+            size = UND_LOG_MESSAGE_SIZE - m_size;
+
+        std::memcpy(m_text + m_size, text, size);
+        m_size += size;
+    }
+
+} // namespace undicht
@@ -0,0 +1,161 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+// severity levels (preprocessor constants, so that levels can be removed at compile time)
+#define UND_LOG_LEVEL_NOTE 0
+#define UND_LOG_LEVEL_WARNING 1
+#define UND_LOG_LEVEL_ERROR 2
+
+// messages below this level are compiled out
+#ifndef UND_MIN_LOG_LEVEL
+#define UND_MIN_LOG_LEVEL UND_LOG_LEVEL_NOTE
+#endif
+
+// one bit per LogCategory, messages of categories that are not set are compiled out
+#ifndef UND_LOG_CATEGORIES
+#define UND_LOG_CATEGORIES 0xffffffffu
+#endif
+
+// maximum length of a single message, longer messages get cut off
+#ifndef UND_LOG_MESSAGE_SIZE
+#define UND_LOG_MESSAGE_SIZE 512
+#endif
+
+namespace undicht {
+
+    enum class LogCategory : uint8_t {
+        GENERAL = 0,
+        IO = 1,
+        WORLD = 2,
+        GRAPHICS = 3,
+        ASSETS = 4,
+    };
+
+    class Logger {
+        /** logging backend used by the UND_LOG, UND_WARNING and UND_ERROR macros
+        * every thread writes its messages into its own lock-free ring buffer
+        * a single background thread formats the messages and writes them to stdout
+        * if a ring buffer is full, notes and warnings get dropped (and counted), errors wait for free space
+        * errors get written before the logging thread returns, so that they dont get lost when the program crashes */
+
+      public:
+
+        /// @brief messages with a lower level are ignored (at runtime)
+        static void setMinLevel(uint8_t level);
+        static void setCategoryEnabled(LogCategory category, bool enabled);
+
+        static bool isEnabled(uint8_t level, LogCategory category);
+
+        /// @brief waits until all messages submitted so far were written
+        static void flush();
+
+        /// @return the number of messages that were dropped because a ring buffer was full
+        static uint64_t getDroppedCount();
+
+        /// @brief submit a finished message (used by LogMessage)
+        static void submit(uint8_t level, LogCategory category, const char* file, uint32_t line, int64_t time, const char* text, uint32_t size);
+
+        /// @return nanoseconds on the monotonic clock used for the log timestamps
+        static int64_t getTime();
+
+      protected:
+
+        static std::atomic<uint32_t> s_min_level;
+        static std::atomic<uint32_t> s_categories;
+    };
+
+    class LogMessage {
+        /** collects the text of a single message on the stack
+        * the message is handed to the Logger when it gets destroyed (at the end of the logging statement) */
+
+      protected:
+
+        char m_text[UND_LOG_MESSAGE_SIZE];
+        uint32_t m_size = 0;
+
+        uint8_t m_level;
+        LogCategory m_category;
+        const char* m_file;
+        uint32_t m_line;
+        int64_t m_time;
+
+      public:
+
+        LogMessage(uint8_t level, LogCategory category, const char* file, uint32_t line);
+        LogMessage(const LogMessage&) = delete;
+        LogMessage& operator=(const LogMessage&) = delete;
+        ~LogMessage();
+
+        LogMessage& operator<<(const char* text);
+        LogMessage& operator<<(const std::string& text);
+        LogMessage& operator<<(char c);
+        LogMessage& operator<<(bool b);
+        LogMessage& operator<<(int i);
+        LogMessage& operator<<(unsigned int i);
+        LogMessage& operator<<(long i);
+        LogMessage& operator<<(unsigned long i);
+        LogMessage& operator<<(long long i);
+        LogMessage& operator<<(unsigned long long i);
+        LogMessage& operator<<(float f);
+        LogMessage& operator<<(double d);
+        LogMessage& operator<<(const void* p);
+
+        LogMessage& operator<<(char* text);
+        LogMessage& operator<<(std::string_view text);
+        LogMessage& operator<<(signed char c);
+        LogMessage& operator<<(unsigned char c);
+        LogMessage& operator<<(short i);
+        LogMessage& operator<<(unsigned short i);
+        LogMessage& operator<<(long double d);
+
+        // slow path for all other types that can be written to a std::ostream
+        // the stream writes directly into the message, so it doesnt allocate memory either
+        template<typename T>
+        LogMessage& operator<<(const T& value) {
+
+            LogStreamBuffer buffer(*this);
+            std::ostream stream(&buffer);
+            stream << value;
+
+            m_size = buffer.getSize();
+
+            return *this;
+        }
+
+      protected:
+
+        class LogStreamBuffer : public std::streambuf {
+            // writes into the free space of the message (the rest gets cut off)
+
+          protected:
+
+            LogMessage& m_message;
+
+          public:
+
+            LogStreamBuffer(LogMessage& message);
+
+            uint32_t getSize() const;
+        };
+
+        void append(const char* text, uint32_t size);
+    };
+
+} // namespace undicht
+
+// the loop runs at most once, it makes sure the arguments of disabled messages dont get evaluated
+// and lets the compiler remove messages below UND_MIN_LOG_LEVEL or of a disabled category entirely
+// (unlike an if / else, a following else cant bind to it)
+#define UND_LOG_MESSAGE(level, category) \
+    for(bool und_log_once = ((level) >= UND_MIN_LOG_LEVEL) && ((UND_LOG_CATEGORIES >> uint32_t(category)) & 1u) && undicht::Logger::isEnabled(level, category); \
+        und_log_once; und_log_once = false) \
+        undicht::LogMessage(level, category, __FILE__, __LINE__)
+
+#endif // LOGGER_H
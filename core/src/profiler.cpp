@@ -0,0 +1,208 @@
+#include "profiler.h"
+#include "debug.h"
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace undicht {
+
+    struct ProfileBuffer {
+        // the zones recorded by a single thread
+
+        std::mutex m_mutex; // only contended while the trace is written
+        std::vector<ProfileEvent> m_events;
+        uint64_t m_next = 0; // total number of recorded events, m_next % size is the next slot
+
+        uint32_t m_thread_id = 0;
+        std::string m_thread_name;
+
+        int64_t m_frame_start = -1;
+    };
+
+    // buffers are kept after their thread exits, so that its zones still show up in the trace
+    static std::mutex buffers_mutex;
+    static std::vector<std::unique_ptr<ProfileBuffer>> buffers;
+
+    static ProfileBuffer& getThreadBuffer() {
+
+        static thread_local ProfileBuffer* buffer = nullptr;
+
+        if(!buffer) {
+
+            std::lock_guard<std::mutex> lock(buffers_mutex);
+
+            buffers.emplace_back(new ProfileBuffer);
+            buffer = buffers.back().get();
+            buffer->m_events.resize(UND_PROFILER_BUFFER_SIZE);
+            buffer->m_thread_id = buffers.size();
+            buffer->m_thread_name = "thread " + std::to_string(buffer->m_thread_id);
+        }
+
+        return *buffer;
+    }
+
+    static void writeJsonString(std::ofstream& file, const std::string& str) {
+
+        file << '"';
+
+        for(char c : str) {
+            if((c == '"') || (c == '\\'))
+                file << '\\';
+            file << c;
+        }
+
+        file << '"';
+    }
+
+    ////////////////////////////////////////// profiler //////////////////////////////////////////
+
+    std::atomic<bool> Profiler::s_enabled(true);
+
+    void Profiler::setEnabled(bool enabled) {
+        /// @brief zones that end while the profiler is disabled are not recorded
+
+        s_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool Profiler::isEnabled() {
+
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    void Profiler::setThreadName(const std::string& name) {
+        /// @brief name that the calling thread gets in the trace (i.e. "main", "worker 1")
+
+        ProfileBuffer& buffer = getThreadBuffer();
+        std::lock_guard<std::mutex> lock(buffer.m_mutex);
+
+        buffer.m_thread_name = name;
+    }
+
+    void Profiler::beginFrame() {
+        /// @brief mark the start of a frame on the calling thread
+
+        getThreadBuffer().m_frame_start = isEnabled() ? getTime() : -1;
+    }
+
+    void Profiler::endFrame() {
+        /// @brief mark the end of a frame, the frame gets recorded as a zone
+
+        ProfileBuffer& buffer = getThreadBuffer();
+
+        if(buffer.m_frame_start >= 0)
+            record("frame", buffer.m_frame_start, getTime());
+
+        buffer.m_frame_start = -1;
+    }
+
+    void Profiler::record(const char* name, int64_t start, int64_t end) {
+        /// @brief stores a finished zone in the buffer of the calling thread
+
+        if(!isEnabled())
+            return;
+
+        ProfileBuffer& buffer = getThreadBuffer();
+        std::lock_guard<std::mutex> lock(buffer.m_mutex);
+
+        ProfileEvent& event = buffer.m_events[buffer.m_next % buffer.m_events.size()];
+        event.m_name = name;
+        event.m_start = start;
+        event.m_end = end;
+
+        buffer.m_next++;
+    }
+
+    void Profiler::clear() {
+        /// @brief removes all zones recorded so far
+
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+
+        for(std::unique_ptr<ProfileBuffer>& buffer : buffers) {
+            std::lock_guard<std::mutex> buffer_lock(buffer->m_mutex);
+            buffer->m_next = 0;
+        }
+
+    }
+
+    bool Profiler::writeChromeTrace(const std::string& file_name) {
+        /// @brief writes the recorded zones of all threads as chrome trace json
+        /// the trace can be opened with chrome://tracing or https://ui.perfetto.dev
+        /// @return false, if the file could not be written
+
+        std::ofstream file(file_name, std::ios::out | std::ios::trunc);
+
+        if(!file.is_open()) {
+            UND_ERROR << "failed to write profiler trace: could not open file " << file_name << "\n";
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+
+        // copying the events, so that the threads are only blocked for a short time
+        std::vector<std::vector<ProfileEvent>> events(buffers.size());
+        std::vector<std::string> thread_names(buffers.size());
+        int64_t first_time = INT64_MAX;
+
+        for(uint32_t i = 0; i < buffers.size(); i++) {
+
+            ProfileBuffer& buffer = *buffers.at(i);
+            std::lock_guard<std::mutex> buffer_lock(buffer.m_mutex);
+
+            uint64_t size = buffer.m_events.size();
+            uint64_t count = buffer.m_next < size ? buffer.m_next : size;
+
+            // oldest events first
+            for(uint64_t j = buffer.m_next - count; j < buffer.m_next; j++) {
+                events.at(i).push_back(buffer.m_events[j % size]);
+                first_time = events.at(i).back().m_start < first_time ? events.at(i).back().m_start : first_time;
+            }
+
+            thread_names.at(i) = buffer.m_thread_name;
+        }
+
+        // chrome trace format: https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+        file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        file.setf(std::ios::fixed);
+        file.precision(3);
+
+        bool first_event = true;
+
+        for(uint32_t i = 0; i < events.size(); i++) {
+
+            file << (first_event ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i + 1 << ",\"args\":{\"name\":";
+            writeJsonString(file, thread_names.at(i));
+            file << "}}";
+            first_event = false;
+
+            for(const ProfileEvent& event : events.at(i)) {
+
+                // timestamps are in microseconds
+                file << ",\n{\"name\":";
+                writeJsonString(file, event.m_name);
+                file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << i + 1;
+                file << ",\"ts\":" << (event.m_start - first_time) / 1000.0;
+                file << ",\"dur\":" << (event.m_end - event.m_start) / 1000.0 << "}";
+            }
+
+        }
+
+        file << "\n]}\n";
+
+        if(!file.good()) {
+            UND_ERROR << "failed to write profiler trace to " << file_name << "\n";
+            return false;
+        }
+
+        return true;
+    }
+
+    int64_t Profiler::getTime() {
+        /// @return nanoseconds on a monotonic clock
+
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+} // namespace undicht
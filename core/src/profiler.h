@@ -0,0 +1,99 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// set to 0 to compile out all profiling zones
+#ifndef UND_ENABLE_PROFILER
+#define UND_ENABLE_PROFILER 1
+#endif
+
+// number of zones each thread keeps, once full the oldest zones get overwritten
+#ifndef UND_PROFILER_BUFFER_SIZE
+#define UND_PROFILER_BUFFER_SIZE 32768
+#endif
+
+namespace undicht {
+
+    struct ProfileEvent {
+
+        const char* m_name = nullptr; // has to be a string with static lifetime (i.e. a string literal)
+        int64_t m_start = 0; // nanoseconds
+        int64_t m_end = 0;
+    };
+
+    class Profiler {
+        /** records timed zones (UND_PROFILE_SCOPE) and frames
+        * every thread stores its zones in its own ring buffer, so only the most recent zones are kept
+        * the recorded zones can be written to a file in the chrome trace format (chrome://tracing, ui.perfetto.dev) */
+
+      public:
+
+        /// @brief zones that end while the profiler is disabled are not recorded
+        static void setEnabled(bool enabled);
+        static bool isEnabled();
+
+        /// @brief name that the calling thread gets in the trace (i.e. "main", "worker 1")
+        static void setThreadName(const std::string& name);
+
+        /// @brief mark the start / end of a frame on the calling thread, the frame gets recorded as a zone
+        static void beginFrame();
+        static void endFrame();
+
+        /// @brief stores a finished zone in the buffer of the calling thread
+        static void record(const char* name, int64_t start, int64_t end);
+
+        /// @brief removes all zones recorded so far
+        static void clear();
+
+        /// @brief writes the recorded zones of all threads as chrome trace json
+        /// @return false, if the file could not be written
+        static bool writeChromeTrace(const std::string& file_name);
+
+        /// @return nanoseconds on a monotonic clock
+        static int64_t getTime();
+
+      protected:
+
+        static std::atomic<bool> s_enabled;
+    };
+
+    class ProfileZone {
+        /** records the time between its construction and destruction
+        * use it through the UND_PROFILE_SCOPE macro */
+
+      protected:
+
+        const char* m_name;
+        int64_t m_start;
+
+      public:
+
+        ProfileZone(const char* name) : m_name(name) {
+            m_start = Profiler::isEnabled() ? Profiler::getTime() : -1;
+        }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+        ~ProfileZone() {
+            if(m_start >= 0)
+                Profiler::record(m_name, m_start, Profiler::getTime());
+        }
+    };
+
+} // namespace undicht
+
+#define UND_PROFILE_CONCAT_IMPL(a, b) a##b
+#define UND_PROFILE_CONCAT(a, b) UND_PROFILE_CONCAT_IMPL(a, b)
+
+#if UND_ENABLE_PROFILER
+// times the rest of the enclosing scope, name has to be a string literal
+#define UND_PROFILE_SCOPE(name) undicht::ProfileZone UND_PROFILE_CONCAT(und_profile_zone_, __LINE__)(name)
+#else
+#define UND_PROFILE_SCOPE(name)
+#endif
+
+#endif // PROFILER_H
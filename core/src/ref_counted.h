@@ -0,0 +1,154 @@
+#ifndef REF_COUNTED_H
+#define REF_COUNTED_H
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace undicht {
+
+    class RefCounted {
+        /** base class for objects that are shared between multiple owners (and threads)
+        * the reference count is stored in the object itself, so sharing it needs no extra allocation
+        * the count is atomic, copying a RefPtr on a worker thread is safe without locks
+        * use RefPtr to manage the references instead of calling addRef() / releaseRef() directly */
+
+      protected:
+
+        mutable std::atomic<uint32_t> m_ref_count;
+
+      public:
+
+        RefCounted() : m_ref_count(0) {}
+
+        // a copy is a new object, nobody references it yet
+        RefCounted(const RefCounted&) : m_ref_count(0) {}
+        RefCounted& operator=(const RefCounted&) { return *this; }
+
+        void addRef() const {
+
+            m_ref_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /// @return true, if the last reference was released (the object should be deleted now)
+        bool releaseRef() const {
+
+            // acq_rel: all writes by other owners have to be visible before the object gets deleted
+            return m_ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        }
+
+        uint32_t getRefCount() const {
+
+            return m_ref_count.load(std::memory_order_relaxed);
+        }
+
+        // virtual, because the last reference may be released through a RefPtr to a base class
+        virtual ~RefCounted() = default;
+    };
+
+    template<typename T>
+    class RefPtr {
+        /** holds a reference to an object derived from RefCounted
+        * the object gets deleted when the last RefPtr referencing it is destroyed */
+
+      protected:
+
+        T* m_ptr = nullptr;
+
+      public:
+
+        RefPtr() = default;
+
+        /// @brief takes a reference to the object (which has to be allocated with new)
+        explicit RefPtr(T* ptr) : m_ptr(ptr) {
+            if(m_ptr)
+                m_ptr->addRef();
+        }
+
+        RefPtr(const RefPtr& other) : m_ptr(other.m_ptr) {
+            if(m_ptr)
+                m_ptr->addRef();
+        }
+
+        RefPtr(RefPtr&& other) : m_ptr(other.m_ptr) {
+            other.m_ptr = nullptr;
+        }
+
+        // from references to derived types
+        template<typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+        RefPtr(const RefPtr<U>& other) : m_ptr(other.get()) {
+            if(m_ptr)
+                m_ptr->addRef();
+        }
+
+        ~RefPtr() {
+            reset();
+        }
+
+        RefPtr& operator=(const RefPtr& other) {
+            // adding the new reference first, in case both point to the same object
+            if(other.m_ptr)
+                other.m_ptr->addRef();
+
+            reset();
+            m_ptr = other.m_ptr;
+
+            return *this;
+        }
+
+        RefPtr& operator=(RefPtr&& other) {
+
+            if(this != &other) {
+                reset();
+                m_ptr = other.m_ptr;
+                other.m_ptr = nullptr;
+            }
+
+            return *this;
+        }
+
+        /// @brief releases the reference (deleting the object if it was the last one)
+        void reset() {
+
+            if(m_ptr && m_ptr->releaseRef())
+                delete m_ptr;
+
+            m_ptr = nullptr;
+        }
+
+        T* get() const {
+            return m_ptr;
+        }
+
+        T* operator->() const {
+            return m_ptr;
+        }
+
+        T& operator*() const {
+            return *m_ptr;
+        }
+
+        explicit operator bool() const {
+            return m_ptr != nullptr;
+        }
+
+        bool operator==(const RefPtr& other) const {
+            return m_ptr == other.m_ptr;
+        }
+
+        bool operator!=(const RefPtr& other) const {
+            return m_ptr != other.m_ptr;
+        }
+    };
+
+    /// @brief creates a new reference counted object
+    template<typename T, typename... Args>
+    RefPtr<T> makeRef(Args&&... args) {
+
+        return RefPtr<T>(new T(std::forward<Args>(args)...));
+    }
+
+} // namespace undicht
+
+#endif // REF_COUNTED_H
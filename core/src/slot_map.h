@@ -0,0 +1,193 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace undicht {
+
+    struct Handle {
+        /** refers to an object stored in a SlotMap
+        * the generation makes sure that a handle to a removed object never refers to an object
+        * that was later stored in the same slot */
+
+        uint32_t m_index = 0;
+        uint32_t m_generation = 0; // valid handles always have odd generations
+
+        bool isNull() const {
+            return m_generation == 0;
+        }
+
+        bool operator==(const Handle& other) const {
+            return (m_index == other.m_index) && (m_generation == other.m_generation);
+        }
+
+        bool operator!=(const Handle& other) const {
+            return !(*this == other);
+        }
+    };
+
+    template<typename T>
+    class SlotMap {
+        /** stores objects in a fixed number of slots that are referenced through generational handles
+        * the slots never move, so get() can be called from any thread without locking
+        * insert() and remove() may be called from multiple threads as well (they share a mutex)
+        * removed objects are only destroyed by collect(), so an object returned by get() stays valid
+        * until the next call to collect(). collect() should be called at a point where no other thread
+        * can access the map (i.e. once per frame, after the jobs of the frame have finished) */
+
+      protected:
+
+        struct Slot {
+            // odd generations mark a slot that is in use
+            std::atomic<uint32_t> m_generation;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type m_storage;
+
+            Slot() : m_generation(0) {}
+
+            T* getObject() {
+                return reinterpret_cast<T*>(&m_storage);
+            }
+        };
+
+        std::unique_ptr<Slot[]> m_slots;
+        uint32_t m_capacity = 0;
+
+        std::mutex m_mutex;
+        std::vector<uint32_t> m_free_slots;
+        std::vector<uint32_t> m_removed_slots; // waiting for collect()
+        std::atomic<uint32_t> m_size;
+
+      public:
+
+        SlotMap(uint32_t capacity) : m_slots(new Slot[capacity]), m_capacity(capacity), m_size(0) {
+
+            // using the lowest indices first
+            m_free_slots.reserve(capacity);
+            for(uint32_t i = capacity; i > 0; i--)
+                m_free_slots.push_back(i - 1);
+
+        }
+
+        SlotMap(const SlotMap&) = delete;
+        SlotMap& operator=(const SlotMap&) = delete;
+
+        ~SlotMap() {
+
+            for(uint32_t i = 0; i < m_capacity; i++)
+                if(m_slots[i].m_generation.load() & 1u)
+                    m_slots[i].getObject()->~T();
+
+            for(uint32_t index : m_removed_slots)
+                m_slots[index].getObject()->~T();
+
+        }
+
+        /// @brief stores the object in a free slot
+        /// @return a null handle, if there is no free slot left
+        template<typename... Args>
+        Handle insert(Args&&... args) {
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if(m_free_slots.empty())
+                return Handle();
+
+            uint32_t index = m_free_slots.back();
+            m_free_slots.pop_back();
+
+            Slot& slot = m_slots[index];
+            new (slot.getObject()) T(std::forward<Args>(args)...);
+
+            // release: the object has to be constructed before another thread can see the slot in use
+            uint32_t generation = slot.m_generation.load(std::memory_order_relaxed) + 1;
+            slot.m_generation.store(generation, std::memory_order_release);
+
+            m_size++;
+
+            Handle handle;
+            handle.m_index = index;
+            handle.m_generation = generation;
+
+            return handle;
+        }
+
+        /// @brief invalidates the handle, the object gets destroyed by the next call to collect()
+        /// @return false, if the handle didnt refer to an object in the map
+        bool remove(const Handle& handle) {
+
+            if(handle.m_index >= m_capacity)
+                return false;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            Slot& slot = m_slots[handle.m_index];
+
+            if(slot.m_generation.load(std::memory_order_relaxed) != handle.m_generation)
+                return false;
+
+            slot.m_generation.store(handle.m_generation + 1, std::memory_order_release);
+            m_removed_slots.push_back(handle.m_index);
+            m_size--;
+
+            return true;
+        }
+
+        /// @return the object referenced by the handle, nullptr if the handle is no longer valid
+        T* get(const Handle& handle) const {
+
+            if((handle.m_index >= m_capacity) || handle.isNull())
+                return nullptr;
+
+            Slot& slot = m_slots[handle.m_index];
+
+            if(slot.m_generation.load(std::memory_order_acquire) != handle.m_generation)
+                return nullptr;
+
+            return slot.getObject();
+        }
+
+        bool contains(const Handle& handle) const {
+
+            return get(handle) != nullptr;
+        }
+
+        /// @brief destroys the removed objects and makes their slots available again
+        /// no other thread may access objects of the map while this function runs
+        void collect() {
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            for(uint32_t index : m_removed_slots) {
+
+                Slot& slot = m_slots[index];
+                slot.getObject()->~T();
+
+                m_free_slots.push_back(index);
+            }
+
+            m_removed_slots.clear();
+        }
+
+        /// @return the number of objects that can be accessed through a handle
+        uint32_t getSize() const {
+
+            return m_size;
+        }
+
+        uint32_t getCapacity() const {
+
+            return m_capacity;
+        }
+
+    };
+
+} // namespace undicht
+
+#endif // SLOT_MAP_H
@@ -0,0 +1,138 @@
+#ifndef STATIC_BUFFER_LAYOUT_H
+#define STATIC_BUFFER_LAYOUT_H
+
+#include "buffer_layout.h"
+
+namespace undicht {
+
+    template<Type TYPE, uint32_t COMP_SIZE, uint32_t NUM_COMP = 1>
+    struct StaticFixedType {
+        /** a FixedType that is known at compile time */
+
+        static constexpr Type TYPE_ID = TYPE;
+        static constexpr uint32_t COMP_SIZE_BYTES = COMP_SIZE;
+        static constexpr uint32_t NUM_COMPONENTS = NUM_COMP;
+
+        static FixedType get() {
+            return FixedType(TYPE, COMP_SIZE, NUM_COMP);
+        }
+    };
+
+    template<LayoutPacking PACKING, uint32_t OFFSET, typename... Types>
+    struct StaticLayoutOffsets;
+
+    template<LayoutPacking PACKING, uint32_t OFFSET>
+    struct StaticLayoutOffsets<PACKING, OFFSET> {
+        // end of the recursion
+
+        static constexpr uint32_t END = OFFSET;
+        static constexpr uint32_t MAX_ALIGNMENT = 1;
+
+        static constexpr uint32_t getOffset(uint32_t index) {
+            return END;
+        }
+
+        static void addTypes(std::vector<FixedType>& types) {}
+    };
+
+    template<LayoutPacking PACKING, uint32_t OFFSET, typename First, typename... Rest>
+    struct StaticLayoutOffsets<PACKING, OFFSET, First, Rest...> {
+        // calculates the offset of the first type, the rest of the types get handled recursively
+
+        static constexpr uint32_t ALIGNMENT = layoutAlignment(PACKING, First::COMP_SIZE_BYTES, First::NUM_COMPONENTS);
+        static constexpr uint32_t OFFSET_HERE = alignOffset(OFFSET, ALIGNMENT);
+        static constexpr uint32_t SIZE = layoutSize(PACKING, First::COMP_SIZE_BYTES, First::NUM_COMPONENTS);
+
+        typedef StaticLayoutOffsets<PACKING, OFFSET_HERE + SIZE, Rest...> Next;
+
+        static constexpr uint32_t END = Next::END;
+        static constexpr uint32_t MAX_ALIGNMENT = ALIGNMENT > Next::MAX_ALIGNMENT ? ALIGNMENT : Next::MAX_ALIGNMENT;
+
+        static constexpr uint32_t getOffset(uint32_t index) {
+            return index ? Next::getOffset(index - 1) : OFFSET_HERE;
+        }
+
+        static void addTypes(std::vector<FixedType>& types) {
+            types.push_back(First::get());
+            Next::addTypes(types);
+        }
+    };
+
+    template<LayoutPacking PACKING, typename... Types>
+    class StaticBufferLayout {
+        /** a buffer layout that is known at compile time
+        * offsets, alignment and size are calculated by the compiler, so they can be used in static_asserts
+        * i.e. to make sure that a C++ struct matches the data layout expected by the shaders:
+        * typedef StaticBufferLayout<LayoutPacking::PACKED, UND_STATIC_UINT32, UND_STATIC_VEC3F> MyLayout;
+        * static_assert(sizeof(MyStruct) == MyLayout::SIZE, "MyStruct does not match MyLayout");
+        * static_assert(offsetof(MyStruct, second) == MyLayout::getOffset(1), "MyStruct does not match MyLayout"); */
+
+      protected:
+
+        typedef StaticLayoutOffsets<PACKING, 0, Types...> Offsets;
+
+      public:
+
+        static constexpr uint32_t COUNT = sizeof...(Types);
+
+        // the offset at which the last type ends
+        static constexpr uint32_t END = Offsets::END;
+
+        // the size of the complete struct (the stride in an array of them)
+        static constexpr uint32_t SIZE = layoutStride(PACKING, Offsets::END, Offsets::MAX_ALIGNMENT);
+
+        // the largest alignment of the types (the alignment the complete struct needs, 1 for PACKED layouts)
+        static constexpr uint32_t ALIGNMENT = Offsets::MAX_ALIGNMENT;
+
+        static constexpr uint32_t getOffset(uint32_t index) {
+            return Offsets::getOffset(index);
+        }
+
+        /// @brief runtime view of the layout for functions that expect a BufferLayout
+        static BufferLayout getLayout() {
+
+            std::vector<FixedType> types;
+            Offsets::addTypes(types);
+
+            return BufferLayout(types, PACKING);
+        }
+
+    };
+
+} // namespace undicht
+
+// compile time versions of the FixedType macros (types.h)
+#define UND_STATIC_INT8 undicht::StaticFixedType<undicht::Type::INT, 1>
+#define UND_STATIC_INT16 undicht::StaticFixedType<undicht::Type::INT, 2>
+#define UND_STATIC_INT32 undicht::StaticFixedType<undicht::Type::INT, 4>
+#define UND_STATIC_INT64 undicht::StaticFixedType<undicht::Type::INT, 8>
+
+#define UND_STATIC_UINT8 undicht::StaticFixedType<undicht::Type::UNSIGNED_INT, 1>
+#define UND_STATIC_UINT16 undicht::StaticFixedType<undicht::Type::UNSIGNED_INT, 2>
+#define UND_STATIC_UINT32 undicht::StaticFixedType<undicht::Type::UNSIGNED_INT, 4>
+#define UND_STATIC_UINT64 undicht::StaticFixedType<undicht::Type::UNSIGNED_INT, 8>
+
+#define UND_STATIC_FLOAT16 undicht::StaticFixedType<undicht::Type::FLOAT, 2>
+#define UND_STATIC_FLOAT32 undicht::StaticFixedType<undicht::Type::FLOAT, 4>
+#define UND_STATIC_FLOAT64 undicht::StaticFixedType<undicht::Type::FLOAT, 8>
+
+#define UND_STATIC_VEC2F undicht::StaticFixedType<undicht::Type::FLOAT, 4, 2>
+#define UND_STATIC_VEC3F undicht::StaticFixedType<undicht::Type::FLOAT, 4, 3>
+#define UND_STATIC_VEC4F undicht::StaticFixedType<undicht::Type::FLOAT, 4, 4>
+
+#define UND_STATIC_VEC2F16 undicht::StaticFixedType<undicht::Type::FLOAT, 2, 2>
+#define UND_STATIC_VEC3F16 undicht::StaticFixedType<undicht::Type::FLOAT, 2, 3>
+#define UND_STATIC_VEC4F16 undicht::StaticFixedType<undicht::Type::FLOAT, 2, 4>
+
+#define UND_STATIC_VEC2I undicht::StaticFixedType<undicht::Type::INT, 4, 2>
+#define UND_STATIC_VEC3I undicht::StaticFixedType<undicht::Type::INT, 4, 3>
+#define UND_STATIC_VEC4I undicht::StaticFixedType<undicht::Type::INT, 4, 4>
+
+#define UND_STATIC_VEC2UI8 undicht::StaticFixedType<undicht::Type::UNSIGNED_INT, 1, 2>
+#define UND_STATIC_VEC3UI8 undicht::StaticFixedType<undicht::Type::UNSIGNED_INT, 1, 3>
+#define UND_STATIC_VEC4UI8 undicht::StaticFixedType<undicht::Type::UNSIGNED_INT, 1, 4>
+
+#define UND_STATIC_MAT3F undicht::StaticFixedType<undicht::Type::FLOAT, 4, 9>
+#define UND_STATIC_MAT4F undicht::StaticFixedType<undicht::Type::FLOAT, 4, 16>
+
+#endif // STATIC_BUFFER_LAYOUT_H
@@ -1,15 +1,22 @@
 #include "engine.h"
+#include "algorithm"
 #include "debug.h"
 #include "vma_global_allocator.h"
+#include "job_system.h"
+#include "alloc_tracker.h"
+#include "profiler.h"
 
 namespace undicht {
 
-    Engine::Engine() : _monitor(_window_api.getMonitor(0)) {
+    Engine::Engine() : _monitor(_window_api.getMonitor(0)), _should_stop(false), _tick_count(0), _dropped_ticks(0) {
     }
 
     void Engine::init(bool full_screen) {
         /** @brief initializes core engine objects */
 
+        // starting the worker threads
+        JobSystem::init();
+
         // initializing the vulkan instance
         _vk_instance.init();
 
@@ -46,15 +53,28 @@ namespace undicht {
          * stops running the main loop if the window is requested to close */
 
         _should_stop = false;
+        _this_frame_time = std::chrono::high_resolution_clock::now();
 
-        while (!_main_window.shouldClose() && !_should_stop) {
-            
-            _last_frame_time = _this_frame_time;
-            _this_frame_time = std::chrono::high_resolution_clock::now();
+        if(!_use_fixed_timestep)
+            runVariableTimestep();
+        else if(!_threaded_update)
+            runFixedTimestep();
+        else
+            runThreadedFixedTimestep();
 
-            mainLoop();
-            updateWindow();
-        }
+    }
+
+    void Engine::setFixedTimestep(double ticks_per_second, uint32_t max_ticks_per_frame, bool threaded_update) {
+        /** @brief makes run() call update() at a fixed rate instead of mainLoop() once per frame
+        * has to be called before run()
+        * @param ticks_per_second how often update() gets called
+        * @param max_ticks_per_frame if the simulation falls behind, at most this many ticks are used to catch up
+        * @param threaded_update run update() on its own thread */
+
+        _use_fixed_timestep = true;
+        _threaded_update = threaded_update;
+        _tick_duration = 1000.0 / ticks_per_second;
+        _max_ticks_per_frame = max_ticks_per_frame ? max_ticks_per_frame : 1;
     }
 
     void Engine::stop() {
@@ -78,6 +98,9 @@ namespace undicht {
 
         // terminating the vulkan instance
         _vk_instance.cleanUp();
+
+        // stopping the worker threads
+        JobSystem::cleanUp();
     }
 
     double Engine::getDeltaT() const {
@@ -96,5 +119,169 @@ namespace undicht {
         return _this_frame_time.time_since_epoch().count();
     }
 
+    double Engine::getTickDuration() const {
+        /** fixed timestep mode: time in milliseconds simulated by one call to update() */
+
+        return _tick_duration;
+    }
+
+    uint64_t Engine::getTickCount() const {
+
+        return _tick_count;
+    }
+
+    uint64_t Engine::getDroppedTicks() const {
+        /** fixed timestep mode: number of ticks that were skipped because the simulation fell too far behind */
+
+        return _dropped_ticks;
+    }
+
+    ////////////////////////////////////////// the different main loops //////////////////////////////////////////
+
+    void Engine::runVariableTimestep() {
+        // calls mainLoop() once per frame
+
+        while (!_main_window.shouldClose() && !_should_stop) {
+            
+            _last_frame_time = _this_frame_time;
+            _this_frame_time = std::chrono::high_resolution_clock::now();
+
+            {
+                // the main loop should not need heap allocations once everything is loaded
+                // (see AllocationTracker::setViolationMode(), only checked when built with UND_TRACK_ALLOCATIONS)
+                UND_NO_ALLOC_SCOPE();
+                mainLoop();
+            }
+
+            updateWindow();
+        }
+
+    }
+
+    void Engine::runFixedTimestep() {
+        // the time that passed since the last frame gets simulated in steps of _tick_duration
+        // the time left over (less than a tick) is carried over to the next frame
+
+        _accumulated_time = 0.0;
+
+        while (!_main_window.shouldClose() && !_should_stop) {
+
+            _last_frame_time = _this_frame_time;
+            _this_frame_time = std::chrono::high_resolution_clock::now();
+            _accumulated_time += getDeltaT();
+
+            {
+                UND_NO_ALLOC_SCOPE();
+
+                uint32_t ticks = 0;
+
+                while(_accumulated_time >= _tick_duration) {
+
+                    if(ticks == _max_ticks_per_frame) {
+                        // catching up would take too long (and make the next frame even slower), so the time gets dropped
+                        uint64_t dropped = uint64_t(_accumulated_time / _tick_duration);
+                        _dropped_ticks += dropped;
+                        _accumulated_time -= dropped * _tick_duration;
+                        break;
+                    }
+
+                    tick();
+                    _accumulated_time -= _tick_duration;
+                    ticks++;
+                }
+
+                _alpha = _accumulated_time / _tick_duration;
+
+                syncRenderState(_alpha);
+                render(_alpha);
+            }
+
+            updateWindow();
+        }
+
+    }
+
+    void Engine::runThreadedFixedTimestep() {
+        // update() runs on its own thread, this thread renders as often as possible
+
+        _last_tick_time = _this_frame_time;
+        _update_thread = std::thread(&Engine::updateThreadMain, this);
+
+        while (!_main_window.shouldClose() && !_should_stop) {
+
+            _last_frame_time = _this_frame_time;
+            _this_frame_time = std::chrono::high_resolution_clock::now();
+
+            {
+                UND_NO_ALLOC_SCOPE();
+
+                {
+                    // the update thread waits until the state is copied
+                    std::lock_guard<std::mutex> lock(_simulation_mutex);
+
+                    double time_since_tick = std::chrono::duration<double, std::milli>(_this_frame_time - _last_tick_time).count();
+                    _alpha = std::min(std::max(time_since_tick / _tick_duration, 0.0), 1.0);
+
+                    syncRenderState(_alpha);
+                }
+
+                render(_alpha);
+            }
+
+            updateWindow();
+        }
+
+        _should_stop = true;
+        _update_thread.join();
+    }
+
+    void Engine::updateThreadMain() {
+        // calls update() at a fixed rate until the engine stops
+
+        Profiler::setThreadName("update");
+        UND_NO_ALLOC_SCOPE();
+
+        const std::chrono::high_resolution_clock::duration tick_duration = std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(std::chrono::duration<double, std::milli>(_tick_duration));
+        std::chrono::high_resolution_clock::time_point next_tick = _last_tick_time + tick_duration;
+
+        while(!_should_stop) {
+
+            std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
+            uint32_t ticks = 0;
+
+            while((next_tick <= now) && !_should_stop) {
+
+                if(ticks == _max_ticks_per_frame) {
+                    // dropping the ticks that cant be caught up with
+                    uint64_t dropped = (now - next_tick) / tick_duration + 1;
+                    _dropped_ticks += dropped;
+                    next_tick += dropped * tick_duration;
+                    break;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(_simulation_mutex);
+                    tick();
+                    _last_tick_time = next_tick;
+                }
+
+                next_tick += tick_duration;
+                ticks++;
+            }
+
+            std::this_thread::sleep_until(next_tick);
+        }
+
+    }
+
+    void Engine::tick() {
+        // advance the simulation by one step
+
+        UND_PROFILE_SCOPE("Engine::update");
+
+        update(_tick_duration);
+        _tick_count++;
+    }
+
 
 } // namespace undicht
\ No newline at end of file
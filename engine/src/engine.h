@@ -3,6 +3,9 @@
 
 #include "vector"
 #include "chrono"
+#include "atomic"
+#include "mutex"
+#include "thread"
 
 #include "window/glfw/window_api.h"
 #include "window/glfw/monitor.h"
@@ -29,11 +32,27 @@ namespace undicht {
         vulkan::Instance _vk_instance;
         vulkan::LogicalDevice _gpu;
 
-        bool _should_stop = false;
+        std::atomic<bool> _should_stop;
 
         std::chrono::high_resolution_clock::time_point _this_frame_time;
         std::chrono::high_resolution_clock::time_point _last_frame_time;
 
+        // fixed timestep mode (see setFixedTimestep())
+        bool _use_fixed_timestep = false;
+        bool _threaded_update = false;
+        double _tick_duration = 1000.0 / 60.0; // milliseconds
+        uint32_t _max_ticks_per_frame = 5;
+        double _accumulated_time = 0.0; // simulation time (ms) not yet processed by update()
+        double _alpha = 0.0;
+
+        std::atomic<uint64_t> _tick_count;
+        std::atomic<uint64_t> _dropped_ticks;
+
+        // threaded update
+        std::thread _update_thread;
+        std::mutex _simulation_mutex; // locked while update() or syncRenderState() run
+        std::chrono::high_resolution_clock::time_point _last_tick_time;
+
     public:
 
         Engine();
@@ -46,6 +65,28 @@ namespace undicht {
         /** can be implemented by a child "application" class */
         virtual void mainLoop(){};
 
+        /** @brief makes run() call update() at a fixed rate instead of mainLoop() once per frame
+        * rendering happens in render() as often as possible, interpolating between the last two simulation states
+        * has to be called before run()
+        * @param ticks_per_second how often update() gets called
+        * @param max_ticks_per_frame if the simulation falls behind (i.e. after a slow frame), at most this many ticks are used to catch up,
+        * the remaining time gets dropped (see getDroppedTicks())
+        * @param threaded_update run update() on its own thread, the window functions must then only be used from render() and syncRenderState() */
+        virtual void setFixedTimestep(double ticks_per_second, uint32_t max_ticks_per_frame = 5, bool threaded_update = false);
+
+        /** fixed timestep mode: advance the simulation by delta_t milliseconds (always the same value) */
+        virtual void update(double delta_t){};
+
+        /** fixed timestep mode: called right before render(), while update() is not running
+        * copy the simulation state that render() needs here (only necessary with a threaded update)
+        * @param alpha how far the current time is between the last and the next tick (0 to 1) */
+        virtual void syncRenderState(double alpha){};
+
+        /** fixed timestep mode: draw a frame
+        * @param alpha how far the current time is between the last and the next tick (0 to 1),
+        * can be used to interpolate between the previous and the current simulation state (see Interpolated<T>) */
+        virtual void render(double alpha){};
+
         /** updates the window */
         virtual void updateWindow();
 
@@ -67,6 +108,27 @@ namespace undicht {
 
         double getTimeSinceEpoch() const;
 
+        /** fixed timestep mode: time in milliseconds simulated by one call to update() */
+        double getTickDuration() const;
+
+        /** fixed timestep mode: number of calls to update() so far */
+        uint64_t getTickCount() const;
+
+        /** fixed timestep mode: number of ticks that were skipped because the simulation fell too far behind */
+        uint64_t getDroppedTicks() const;
+
+    protected:
+        // the different main loops
+
+        void runVariableTimestep();
+        void runFixedTimestep();
+        void runThreadedFixedTimestep();
+
+        // main function of the update thread
+        void updateThreadMain();
+
+        void tick();
+
     protected:
         // default event handling
 
@@ -1,6 +1,9 @@
 #include "frame_manager.h"
 #include "vulkan/vulkan.h"
 #include "debug.h"
+#include "linear_arena.h"
+#include "profiler.h"
+#include "alloc_tracker.h"
 
 namespace undicht {
 
@@ -60,6 +63,8 @@ namespace undicht {
         /// @brief begin the frame (starts the draw command buffer)
         /// @return true, if the frame was started successfully, false if not (maybe the swap chain is out of date?)
 
+        Profiler::beginFrame();
+
         _swap_image_id = _swap_chain.acquireNextSwapImage(getCurrentFrame().getSwapImageReadySemaphore().getAsSignal());
 
         if(_swap_image_id == -1) return false; // failed to accquire a swap image
@@ -83,6 +88,11 @@ namespace undicht {
         // advance the frame id
         _frame_id = (_frame_id + 1) % _frames.size();
 
+        // releasing the transient allocations made during the frame
+        FrameArena::endFrame();
+
+        AllocationTracker::endFrame();
+        Profiler::endFrame();
     }
 
     Frame& FrameManager::getCurrentFrame() const {
@@ -0,0 +1,51 @@
+#ifndef UNDICHT_INTERPOLATED_H
+#define UNDICHT_INTERPOLATED_H
+
+namespace undicht {
+
+    template<typename T>
+    class Interpolated {
+        /** stores the value of something from the last two simulation ticks
+        * so that rendering can happen in between ticks (see Engine::setFixedTimestep())
+        * T needs to support T + T, T - T and T * float (i.e. float, glm::vec3) */
+
+      protected:
+
+        T _previous;
+        T _current;
+
+      public:
+
+        Interpolated() = default;
+        Interpolated(const T& value) : _previous(value), _current(value) {}
+
+        /** sets both the previous and the current value (i.e. after teleporting) */
+        void reset(const T& value) {
+            _previous = value;
+            _current = value;
+        }
+
+        /** should be called once per tick, the old current value becomes the previous one */
+        void set(const T& value) {
+            _previous = _current;
+            _current = value;
+        }
+
+        const T& getPrevious() const {
+            return _previous;
+        }
+
+        const T& getCurrent() const {
+            return _current;
+        }
+
+        /** @param alpha 0 returns the previous value, 1 the current one */
+        T get(double alpha) const {
+            return _previous + (_current - _previous) * float(alpha);
+        }
+
+    };
+
+} // undicht
+
+#endif // UNDICHT_INTERPOLATED_H
@@ -1,5 +1,6 @@
 #include "app.h"
 #include "debug.h"
+#include "alloc_tracker.h"
 #include "file_tools.h"
 #include "IBL/ibl.h"
 #include "files/chunk_file.h"
@@ -8,6 +9,11 @@
 #include "math/cell_math.h"
 #include "world/edit/chunk_optimizer.h"
 
+// how many bytes of the world file get compacted per tick (see WorldLoader::compactWorldFile())
+#ifndef CELL_COMPACTION_BYTES_PER_TICK
+#define CELL_COMPACTION_BYTES_PER_TICK (256 * 1024)
+#endif
+
 namespace cell {
 
     using namespace undicht;
@@ -32,6 +38,7 @@ namespace cell {
 
             _player.init();
             _player.setPosition(glm::vec3(0, -5, 10));
+            _player_position.reset(_player.getPosition());
             _world.init(_gpu, transfer_cmd, transfer_buffer);
             _master_renderer.init(_vk_instance.getInstance(), _main_window, _gpu, transfer_cmd, transfer_buffer);
             _world_loader.init();
@@ -48,6 +55,8 @@ namespace cell {
         transfer_buffer.cleanUp();
         _gpu.resetGraphicsCmdPool();
 
+        // the world and the renderer share state, so the update runs on the main thread
+        setFixedTimestep(60.0);
     }
 
     void App::cleanUp() {
@@ -63,7 +72,7 @@ namespace cell {
         undicht::Engine::cleanUp();
     }
 
-    void App::mainLoop() {
+    void App::update(double delta_t) {
 
         // user input
         if(_main_window.isKeyPressed(GLFW_KEY_ESCAPE))
@@ -91,18 +100,15 @@ namespace cell {
             UND_LOG << "new cell count: " << optimized->getCellCount() << "\n";
         }
 
-        // checking if the window is minimized
-        if(_main_window.isMinimized())
-            return;
-        
-        // debug menu
-        if(_main_window.isKeyPressed(GLFW_KEY_V)) 
-            _debug_menu.open();
-
         // update the world
-        _player.move(getDeltaT(), _main_window);
+        // (this keeps running while the window is minimized, only render() is skipped,
+        // so that the interpolated player position doesnt go stale)
+        _player.move(delta_t, _main_window);
         _world_loader.loadChunks(_player.getPosition(), _world, 1);
 
+        // reclaiming the space of overwritten chunks in the background (a bit with every tick)
+        _world_loader.compactWorldFile(CELL_COMPACTION_BYTES_PER_TICK);
+
         // some ray casting
         if(getTimeSinceEpoch() - _last_edit > 200000000) {
             glm::ivec3 pointed_at;
@@ -119,6 +125,23 @@ namespace cell {
             }
         }
 
+        _player_position.set(_player.getPosition());
+    }
+
+    void App::render(double alpha) {
+
+        // checking if the window is minimized
+        if(_main_window.isMinimized())
+            return;
+
+        // debug menu
+        if(_main_window.isKeyPressed(GLFW_KEY_V))
+            _debug_menu.open();
+
+        // drawing the player between the last two ticks
+        glm::vec3 player_position = _player.getPosition();
+        _player.setPosition(_player_position.get(alpha));
+
         // frame preperation
         _master_renderer.beginFramePreperation();
         _debug_menu.applyUpdates(_world.getEnvironment(), _master_renderer.getTransferCmd(), _master_renderer.getTransferBuf());
@@ -128,6 +151,8 @@ namespace cell {
 
         // drawing a new frame
         if(_master_renderer.beginFrame()) {
+
+            UND_ALLOC_TAG(AllocTag::GRAPHICS);
             
             // shadow pass
             _master_renderer.beginShadowPass(_world.getSun(), _player.getPosition());
@@ -161,6 +186,7 @@ namespace cell {
             // onWindowResize();
         }
 
+        _player.setPosition(player_position);
     }
 
     void App::onWindowResize() {
@@ -2,6 +2,7 @@
 #define CELL_APP_H
 
 #include "engine.h"
+#include "interpolated.h"
 
 #include <ctime>
 
@@ -17,6 +18,7 @@ namespace cell {
     protected:
 
         Player _player;
+        undicht::Interpolated<glm::vec3> _player_position; // position at the last two ticks
 
         MasterRenderer _master_renderer;
         DebugMenu _debug_menu;
@@ -33,7 +35,8 @@ namespace cell {
         void init();
         void cleanUp();
 
-        void mainLoop();
+        void update(double delta_t);
+        void render(double alpha);
         void onWindowResize();
 
     };
@@ -2,7 +2,14 @@
 
 #include "stb_perlin.h"
 #include "debug.h"
+#include "job_system.h"
 #include "array"
+#include "algorithm"
+
+// number of points that get converted to uvw coordinates and sampled at once
+#ifndef CLOUD_SAMPLE_BATCH_SIZE
+#define CLOUD_SAMPLE_BATCH_SIZE 64
+#endif
 
 namespace cell {
 
@@ -38,7 +45,8 @@ namespace cell {
         _random_map.setExtent(_random_map_size, _random_map_size, _random_map_height);
         _random_map.setNrChannels(1); // contains a single float
 
-        for(uint32_t x = 0; x < _random_map_size; x++) {
+        // every x slice of the map gets calculated by a separate job
+        undicht::JobSystem::parallelFor(0, _random_map_size, 1, [&](uint32_t x) {
             for(uint32_t y = 0; y < _random_map_size; y++) {
                 for(uint32_t z = 0; z < _random_map_height; z++) {
 
@@ -84,7 +92,7 @@ namespace cell {
                     _random_map.setPixel(&closest_distance, x, y, z);
                 }
             }
-        }
+        });
 
         UND_LOG << "initialized the random map \n";
     }
@@ -94,7 +102,8 @@ namespace cell {
         _density_map.setExtent(_random_map_size, _random_map_size, _random_map_height);
         _density_map.setNrChannels(1); // contains a single float
 
-        for(uint32_t x = 0; x < _random_map_size; x++) {
+        // every x slice of the map gets calculated by a separate job
+        undicht::JobSystem::parallelFor(0, _random_map_size, 1, [&](uint32_t x) {
             for(uint32_t y = 0; y < _random_map_size; y++) {
                 for(uint32_t z = 0; z < _random_map_height; z++) {
 
@@ -122,7 +131,11 @@ namespace cell {
                     _density_map.setPixel(&density, x, y, z);
                 }
             }
-        }
+        });
+
+        // the clouds repeat horizontally, but not vertically
+        _density_sampler.setImage(_density_map);
+        _density_sampler.setAddressMode(undicht::tools::SamplerAddressMode::REPEAT, undicht::tools::SamplerAddressMode::REPEAT, undicht::tools::SamplerAddressMode::CLAMP_TO_EDGE);
 
         UND_LOG << "initialized the density map \n";
     }
@@ -145,16 +158,42 @@ namespace cell {
         if((point.y < _base_height) || (point.y >= (_base_height + _cloud_height)))
             return 0.0f;
 
-        float u = point.x;
-        float v = point.z;
-        float w = point.y - _base_height;
+        float u = point.x / _cloud_wrap;
+        float v = point.z / _cloud_wrap;
+        float w = (point.y - _base_height) / _cloud_height;
+
+        float density;
+        _density_sampler.sample(u, v, w, &density);
+
+        return density;
+    }
+
+    void CloudLayer::sample(const glm::vec3* points, size_t count, float* densities) const {
+        /// @brief samples the density of the cloud layer at count points at once
+        /// @param densities: gets the density for every point (0.0f for points outside the cloud layer)
 
-        u = u / _cloud_wrap;
-        v = v / _cloud_wrap;
-        w = w / _cloud_height;
+        float u[CLOUD_SAMPLE_BATCH_SIZE];
+        float v[CLOUD_SAMPLE_BATCH_SIZE];
+        float w[CLOUD_SAMPLE_BATCH_SIZE];
+
+        for(size_t batch = 0; batch < count; batch += CLOUD_SAMPLE_BATCH_SIZE) {
+
+            size_t batch_size = std::min<size_t>(count - batch, CLOUD_SAMPLE_BATCH_SIZE);
+
+            for(size_t i = 0; i < batch_size; i++) {
+                u[i] = points[batch + i].x / _cloud_wrap;
+                v[i] = points[batch + i].z / _cloud_wrap;
+                w[i] = (points[batch + i].y - _base_height) / _cloud_height;
+            }
+
+            _density_sampler.sample(u, v, w, batch_size, densities + batch);
+
+            for(size_t i = 0; i < batch_size; i++)
+                if((w[i] < 0.0f) || (w[i] >= 1.0f))
+                    densities[batch + i] = 0.0f;
+
+        }
 
-        return _density_map.sampleLinear(u, v, w)[0];
-        //return _density_map.getPixel(u, v, w)[0];
     }
 
 } // cell
\ No newline at end of file
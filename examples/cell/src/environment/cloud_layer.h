@@ -3,6 +3,7 @@
 
 #include "images/image_data.h"
 #include "images/image_data_3d.h"
+#include "images/image_sampler.h"
 #include "glm/glm.hpp"
 
 namespace cell {
@@ -20,10 +21,14 @@ namespace cell {
         uint32_t _random_map_size = 256;
         undicht::tools::ImageData3D<float> _random_map;
         undicht::tools::ImageData3D<float> _density_map; // combines the detail levels, same size as random map
+        undicht::tools::ImageSampler3D<float, 1> _density_sampler; // points to the layers of the density map
 
       public:
 
         CloudLayer();
+        // the density sampler would still point to the density map of the original
+        CloudLayer(const CloudLayer&) = delete;
+        CloudLayer& operator=(const CloudLayer&) = delete;
 
         void initRandomMap();
         void initDensityMap();
@@ -35,6 +40,10 @@ namespace cell {
         /// @return the density of the cloud layer in the requested direction (0 to 1)
         /// @return 0.0f, if the point is below the cloud base height or above the cloud layer
         float sample(const glm::vec3& point) const;
+
+        /// @brief samples the density of the cloud layer at count points at once
+        /// @param densities: gets the density for every point (0.0f for points outside the cloud layer)
+        void sample(const glm::vec3* points, size_t count, float* densities) const;
         
     };
 
@@ -5,6 +5,7 @@
 #include "core/vulkan/formats.h"
 #include "debug.h"
 #include "images/image_file.h"
+#include "images/pixel_conversion.h"
 #include "renderer/vulkan/immediate_command.h"
 
 namespace cell {
@@ -18,17 +19,17 @@ namespace cell {
         _device_handle = gpu;
 
         _env_cube_map.setExtent(_env_cube_map_size, _env_cube_map_size, 1, 6);
-        _env_cube_map.setFormat(translate(UND_VEC4F)); // hdr (could be VEC4F16)
+        _env_cube_map.setFormat(translate(UND_VEC4F16)); // hdr
         _env_cube_map.setCubeMap(true);
         _env_cube_map.init(gpu);
 
         _irradiance_map.setExtent(_irradiance_map_size, _irradiance_map_size, 1, 6);
-        _irradiance_map.setFormat(translate(UND_VEC4F)); // hdr (could be VEC4F16)
+        _irradiance_map.setFormat(translate(UND_VEC4F16)); // hdr
         _irradiance_map.setCubeMap(true);
         _irradiance_map.init(gpu);
 
         _specular_prefilter_map.setExtent(_specular_prefilter_map_size, _specular_prefilter_map_size, 1, 6);
-        _specular_prefilter_map.setFormat(translate(UND_VEC4F)); // hdr (could be VEC4F16)
+        _specular_prefilter_map.setFormat(translate(UND_VEC4F16)); // hdr
         _specular_prefilter_map.setMipMaps(true, false, _specular_prefilter_mip_levels);
         _specular_prefilter_map.setCubeMap(true); // reflections for rougher surfaces will be stored in higher mip levels
         _specular_prefilter_map.init(gpu);
@@ -62,10 +63,12 @@ namespace cell {
 
     void Environment::load(const CubeMapData<float>& env_map, CommandBuffer& cmd, TransferBuffer& buf) {
 
-        // store the faces in the cubemap
+        // store the faces in the cubemap (converted to 16 bit floats)
+        std::vector<char> face_data;
         for(int i = 0; i < 6; i++) {
             const ImageData<float>& face = env_map.getFace((CubeMapData<float>::Face)i);
-            _env_cube_map.setData(cmd, buf, (const char*)face.getPixelData(), face.getPixelDataSize(), i);
+            convertImage(face, UND_VEC4F, UND_VEC4F16, face_data);
+            _env_cube_map.setData(cmd, buf, face_data.data(), face_data.size(), i);
         }
 
         UND_LOG << "finished loading the skybox\n";
@@ -78,10 +81,12 @@ namespace cell {
         CubeMapData<float> irradiance_map;
         convoluteCubeMap(env_map, irradiance_map, _irradiance_map_size);
 
-        // store the faces in the irradiance cubemap
+        // store the faces in the irradiance cubemap (converted to 16 bit floats)
+        std::vector<char> face_data;
         for(int i = 0; i < 6; i++) {
             const ImageData<float>& face = irradiance_map.getFace((CubeMapData<float>::Face)i);
-            _irradiance_map.setData(cmd, buf, (const char*)face.getPixelData(), face.getPixelDataSize(), i);
+            convertImage(face, UND_VEC4F, UND_VEC4F16, face_data);
+            _irradiance_map.setData(cmd, buf, face_data.data(), face_data.size(), i);
         }
 
         UND_LOG << "finished calculating the diffuse lighting from the environment\n";
@@ -93,8 +98,9 @@ namespace cell {
         for(int mip_level = 0; mip_level < _specular_prefilter_mip_levels; mip_level++) {
             for(int i = 0; i < 6; i++) {
                 const ImageData<float>& face = prefilter_mip_maps.at(mip_level).getFace((CubeMapData<float>::Face)i);
+                convertImage(face, UND_VEC4F, UND_VEC4F16, face_data);
                 ImmediateCommand cmd(_device_handle);
-                _specular_prefilter_map.setData(cmd, buf, (const char*)face.getPixelData(), face.getPixelDataSize(), i, mip_level);
+                _specular_prefilter_map.setData(cmd, buf, face_data.data(), face_data.size(), i, mip_level);
             }
         }
 
@@ -1,4 +1,6 @@
 #include "environment_generator.h"
+#include "job_system.h"
+#include "linear_arena.h"
 
 namespace cell {
 
@@ -46,26 +48,57 @@ namespace cell {
         dst.setExtent(_target_extent);
         dst.setNrChannels(4);
 
+        const glm::vec3 sky_color = glm::vec3(0.2f, 0.2f, 0.6f) * _sky_brightness;
+        const glm::vec3 cloud_color = glm::vec3(1.0f, 1.0f, 1.0f) * _cloud_brightness;
+        const glm::vec3 fog_color = glm::vec3(0.7f, 0.7f, 0.7f);
+
         for(int face = 0; face < 6; face++) {
 
-            for(int x = 0; x < _target_extent; x++) {
+            // every column of the face gets calculated by a separate job
+            undicht::JobSystem::parallelFor(0, _target_extent, 1, [&](uint32_t x) {
+
+                // the cloud densities of all pixels in the column get sampled at once
+                // (the buffers only live until the end of the job, so their memory is taken from the frame arena of the worker)
+                ArenaScope scope(FrameArena::get());
+                ArenaVector<glm::vec3> cloud_dirs(_target_extent, glm::vec3(0.0f), scope.getArena());
+                ArenaVector<glm::vec3> cloud_points(scope.getArena());
+                ArenaVector<float> cloud_densities(scope.getArena());
+                cloud_points.reserve(_target_extent * _cloud_samples);
 
                 for(int y = 0; y < _target_extent; y++) {
-                    
-                    glm::vec3 dir = dst.calcDir(x, y, (CubeMapData<float>::Face)face);
 
-                    glm::vec3 final_color;
-                    glm::vec3 sky_color = glm::vec3(0.2f, 0.2f, 0.6f) * _sky_brightness;
-                    glm::vec3 cloud_color = glm::vec3(1.0f, 1.0f, 1.0f) * _cloud_brightness;
-                    glm::vec3 fog_color = glm::vec3(0.7f, 0.7f, 0.7f);
+                    glm::vec3& cloud_dir = cloud_dirs.at(y);
+                    cloud_dir = calcCloudDir(dst.calcDir(int(x), y, (CubeMapData<float>::Face)face));
 
-                    glm::vec3 cloud_dir = dir + glm::vec3(0.0f, -0.07f, 0.0f); // a dirty trick to create a round looking sky
+                    if(cloud_dir.y < 0) {
+                        cloud_points.resize(cloud_points.size() + _cloud_samples);
+                        calcCloudSamplePoints(cloud_dir, _cloud_samples, cloud_points.data() + cloud_points.size() - _cloud_samples);
+                    }
+
+                }
+
+                cloud_densities.resize(cloud_points.size());
+                _cloud_layer.sample(cloud_points.data(), cloud_points.size(), cloud_densities.data());
+
+                const float* pixel_densities = cloud_densities.data();
+
+                for(int y = 0; y < _target_extent; y++) {
+
+                    const glm::vec3& cloud_dir = cloud_dirs.at(y);
+                    glm::vec3 final_color;
 
                     if(cloud_dir.y < 0) { // up
 
                         glm::vec3 point_in_cloud = cloud_dir / cloud_dir.y * _cloud_layer.getBaseHeight();
                         float distance_to_cloud = glm::length(point_in_cloud);
-                        float cloud_density = sampleCloudDensity(cloud_dir, 5);
+
+                        float cloud_density = 0.0f;
+                        for(uint32_t sample = 0; sample < _cloud_samples; sample++)
+                            cloud_density += pixel_densities[sample];
+
+                        cloud_density /= _cloud_samples;
+                        pixel_densities += _cloud_samples;
+
                         cloud_density = glm::min(1.0f, glm::max(0.0f, cloud_density - _cloud_threshold) / (1.0f - _cloud_threshold) * _cloud_density);
 
                         final_color = cloud_density * cloud_color + (1 - cloud_density) * sky_color;
@@ -78,7 +111,7 @@ namespace cell {
                     dst.getFace((CubeMapData<float>::Face)face).setPixel(pixel, x, y);
                 }
 
-            }
+            });
 
         }
 
@@ -86,23 +119,25 @@ namespace cell {
 
     ///////////////////////////////////////// protected EnvironmentGenerator functions //////////////////////////////////
 
-    float EnvironmentGenerator::sampleCloudDensity(const glm::vec3& dir, uint32_t num_samples) const {
-        
+    glm::vec3 EnvironmentGenerator::calcCloudDir(const glm::vec3& dir) const {
+
+        return dir + glm::vec3(0.0f, -0.07f, 0.0f); // a dirty trick to create a round looking sky
+    }
+
+    void EnvironmentGenerator::calcCloudSamplePoints(const glm::vec3& dir, uint32_t num_samples, glm::vec3* loadTo) const {
+
         // first point at the bottom of the cloud layer
         glm::vec3 point_in_cloud = dir / dir.y * _cloud_layer.getBaseHeight();
         glm::vec3 sample_step = dir / dir.y * (_cloud_layer.getCloudHeight() / float(num_samples));
 
         //point_in_cloud += 0.5f * sample_step; 
 
-        float total_density = 0.0f;
-
         for(uint32_t sample = 0; sample < num_samples; sample++) {
-            
-            total_density += _cloud_layer.sample(point_in_cloud);
+
+            loadTo[sample] = point_in_cloud;
             point_in_cloud += sample_step;
         }
 
-        return total_density / num_samples;
     }
 
 
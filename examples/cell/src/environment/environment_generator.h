@@ -22,6 +22,7 @@ namespace cell {
         float _cloud_density = 2.0f;
         float _sky_brightness = 1.0f;
         float _cloud_brightness = 1.0f;
+        uint32_t _cloud_samples = 5; // number of densities that get averaged per pixel
         CloudLayer _cloud_layer;
 
       public:
@@ -40,7 +41,10 @@ namespace cell {
 
       protected:
 
-        float sampleCloudDensity(const glm::vec3& dir, uint32_t num_samples) const;
+        glm::vec3 calcCloudDir(const glm::vec3& dir) const;
+
+        /// @brief calculates the points at which the density of the clouds in the direction gets sampled
+        void calcCloudSamplePoints(const glm::vec3& dir, uint32_t num_samples, glm::vec3* loadTo) const;
 
     };
 
@@ -18,7 +18,8 @@ namespace cell {
 
     bool ChunkFile::open(const std::string& file_name) {
 
-        return BinaryDataFile::open(file_name);
+        // chunks are read directly from the mapped file
+        return BinaryDataFile::open(file_name, MEMORY_MAPPED);
     }
 
     void ChunkFile::close() {
@@ -67,16 +68,52 @@ namespace cell {
         /// @return whether or not reading the chunk at the specified location was a success
 
         // read the chunk data
-        std::vector<char> buffer;
-        if(!BinaryDataFile::read(location, buffer))
+        const char* buffer;
+        size_t byte_size;
+        if(!BinaryDataFile::read(location, buffer, byte_size))
             return false; // reading failed
 
         // store the data in the chunk
-        chunk.loadFromBuffer(buffer.data(), buffer.size());
+        chunk.loadFromBuffer(buffer, byte_size);
 
         return true;
     }
 
+    template<typename T>
+    ChunkFile::ReadRequest ChunkFile::createReadRequest(Chunk<T>& chunk, size_t location) {
+        /// @return a request that loads the chunk once the data at the location was read (see readAsync())
+
+        ReadRequest request;
+        request.location = location;
+        request.on_read = [&chunk](const char* data, size_t byte_size) {
+            chunk.loadFromBuffer(data, byte_size);
+        };
+
+        return request;
+    }
+
+    bool ChunkFile::copyTo(ChunkFile& other, size_t location, size_t& new_location) {
+        /// @brief copies the chunk stored at the location to the other file (without loading it into a chunk)
+        /// @param new_location the location under which the chunk can be found in the other file
+        /// @return false if there is no chunk at the location
+
+        const char* buffer;
+        size_t byte_size;
+        if(!BinaryDataFile::read(location, buffer, byte_size))
+            return false;
+
+        new_location = other.BinaryDataFile::store((char*)buffer, byte_size);
+
+        return true;
+    }
+
+    void ChunkFile::readAsync(std::vector<ReadRequest>& requests, JobCounter& counter) {
+        /// @brief reads all requests in the background with as few reads as possible
+        /// the requests and their chunks have to stay alive until the counter is done
+
+        BinaryDataFile::readAsync(requests, counter);
+    }
+
     ////////////////// explizit template instanziations for the template functions //////////////////
     class Cell;
     class Light;
@@ -86,5 +123,7 @@ namespace cell {
     template size_t ChunkFile::update<Light>(const Chunk<Light>& chunk, size_t location);
     template bool ChunkFile::read<Cell>(Chunk<Cell>& chunk, size_t location);
     template bool ChunkFile::read<Light>(Chunk<Light>& chunk, size_t location);
+    template ChunkFile::ReadRequest ChunkFile::createReadRequest<Cell>(Chunk<Cell>& chunk, size_t location);
+    template ChunkFile::ReadRequest ChunkFile::createReadRequest<Light>(Chunk<Light>& chunk, size_t location);
 
 }
\ No newline at end of file
@@ -14,6 +14,10 @@ namespace cell {
 
       public:
 
+        using undicht::tools::BinaryDataFile::ReadRequest;
+        using undicht::tools::BinaryDataFile::getFileSize;
+        using undicht::tools::BinaryDataFile::getUnusedSize;
+
         ChunkFile() = default;
         ChunkFile(const std::string& file_name);
         virtual ~ChunkFile();
@@ -39,6 +43,19 @@ namespace cell {
         template<typename T>
         bool read(Chunk<T>& chunk, size_t location);
 
+        /// @return a request that loads the chunk once the data at the location was read (see readAsync())
+        template<typename T>
+        ReadRequest createReadRequest(Chunk<T>& chunk, size_t location);
+
+        /// @brief copies the chunk stored at the location to the other file (without loading it into a chunk)
+        /// @param new_location the location under which the chunk can be found in the other file
+        /// @return false if there is no chunk at the location
+        bool copyTo(ChunkFile& other, size_t location, size_t& new_location);
+
+        /// @brief reads all requests in the background with as few reads as possible
+        /// the requests and their chunks have to stay alive until the counter is done
+        void readAsync(std::vector<ReadRequest>& requests, undicht::JobCounter& counter);
+
     };
 
 } // cell
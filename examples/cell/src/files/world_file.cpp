@@ -3,6 +3,11 @@
 #include "debug.h"
 #include "file_tools.h"
 #include "material_file.h"
+#include "math/cell_math.h"
+#include "cstdio"
+#include "map"
+#include "limits"
+#include "algorithm"
 
 namespace cell {
 
@@ -12,20 +17,42 @@ namespace cell {
 
     const std::string CURRENT_WORLD_VERSION = "0.0.2";
 
+    // the elements of the world file that contain chunks
+    const std::vector<std::string> CHUNK_WORLD_NAMES = {"WORLD", "LIGHTS"};
+
+    static bool fileExists(const std::string& file_name) {
+
+        return std::ifstream(file_name).is_open();
+    }
+
     WorldFile::WorldFile(const std::string& file_name) {
 
         open(file_name);
     }
 
+    WorldFile::~WorldFile() {
+
+        cancelCompaction();
+    }
+
     bool WorldFile::open(const std::string& file_name) {
         /// @brief loads in the content stored in the world file
         /// @return true if the file exists and is a correct world file
 
+        cancelCompaction();
+
         _file_path = getFilePath(file_name);
         _file_name = getFileName(file_name);
 
+        // completing a compaction that was interrupted while the files were replaced (see finishCompaction())
+        _compaction_pending = false;
+        if(!replaceWithCompactedFiles()) {
+            UND_ERROR << "failed to replace the files of the world " << file_name << " with the compacted ones\n";
+            return false;
+        }
+
         if(!XmlFile::open(file_name)) return false;
-        if(!_chunk_file.open(_file_path + getFileName(file_name, true) + ".chunk")) return false;
+        if(!_chunk_file.open(getChunkFileName())) return false;
 
         // check if the file is a correct world file
 
@@ -43,11 +70,17 @@ namespace cell {
         if(!getElement({"MATERIALS"})) return false;
         if(!getElement({"ENVIRONMENT"})) return false;
 
+        // chunks are searched by their position
+        for(const std::string& world_name : CHUNK_WORLD_NAMES)
+            getElement({world_name})->indexAttribute("chunk_pos");
+
         return true;
     }
 
     void WorldFile::newWorldFile() {
-        
+
+        cancelCompaction();
+
         // root element
         setName("WORLD_FILE");
         addTagAttrib("version=" + CURRENT_WORLD_VERSION);
@@ -58,6 +91,9 @@ namespace cell {
         addChildElement("MATERIALS");
         addChildElement("ENVIRONMENT");
 
+        for(const std::string& world_name : CHUNK_WORLD_NAMES)
+            getElement({world_name})->indexAttribute("chunk_pos");
+
         // should create a new file if it doesnt exist already
         XmlFile::write(_file_path + _file_name);
 
@@ -91,6 +127,278 @@ namespace cell {
         return read<Light>(chunk, chunk_pos, "LIGHTS");
     }
 
+    /////////////////////////////////// load multiple chunks in the background ///////////////////////////////////
+
+    bool WorldFile::addReadRequest(CellChunk& chunk, const glm::ivec3& chunk_pos, std::vector<ChunkFile::ReadRequest>& batch) {
+        /// @brief adds a request for reading the chunk to the batch
+        /// @return false, if there is no chunk with the chunk_pos in the file
+
+        size_t location;
+        if(!findChunkLocation(chunk_pos, "WORLD", location)) return false;
+
+        batch.push_back(_chunk_file.createReadRequest<Cell>(chunk, location));
+
+        return true;
+    }
+
+    bool WorldFile::addReadRequest(LightChunk& chunk, const glm::ivec3& chunk_pos, std::vector<ChunkFile::ReadRequest>& batch) {
+        /// @brief adds a request for reading the chunk to the batch
+        /// @return false, if there is no chunk with the chunk_pos in the file
+
+        size_t location;
+        if(!findChunkLocation(chunk_pos, "LIGHTS", location)) return false;
+
+        batch.push_back(_chunk_file.createReadRequest<Light>(chunk, location));
+
+        return true;
+    }
+
+    void WorldFile::readAsync(std::vector<ChunkFile::ReadRequest>& batch, JobCounter& counter) {
+        /// @brief reads the chunks of the batch in the background (sorted by their location in the chunk file)
+        /// the chunks are loaded once the counter is done, the batch, the chunks and this file have to stay alive until then
+
+        _chunk_file.readAsync(batch, counter);
+    }
+
+    ///////////////////////////////////////// compacting the chunk file /////////////////////////////////////////
+
+    void WorldFile::beginCompaction() {
+        /// @brief starts moving the chunks to a new chunk file, where they are stored next to each other
+        /// and sorted by their position (in morton order), so that chunks close to each other are close in the file as well
+        /// the chunks get copied by continueCompaction(), in between chunks can still be read and written
+
+        cancelCompaction();
+
+        // the files of the last compaction still have to be replaced (see finishCompaction())
+        if(_compaction_pending) return;
+
+        // creating the file the chunks get copied to (might be left over from an interrupted compaction)
+        _compacted_file.open(getCompactedFileName(getChunkFileName()));
+        _compacted_file.newChunkFile();
+
+        // collecting all chunks stored in the world file
+        for(const std::string& world_name : CHUNK_WORLD_NAMES) {
+
+            XmlElement* world = getElement({world_name});
+            if(!world) continue;
+
+            for(XmlElement* chunk : world->getAllElements({"CHUNK"})) {
+
+                XmlTagAttrib* chunk_pos = chunk->getAttribute("chunk_pos");
+                if(!chunk_pos) continue;
+
+                CompactionEntry entry;
+                entry.world_name = world_name;
+                entry.chunk_pos = chunk_pos->m_value;
+                entry.morton_code = calcMortonCode(strToChunkPos(chunk_pos->m_value));
+                _compaction_entries.push_back(entry);
+            }
+
+        }
+
+        // the cell and light chunk at a position get stored next to each other (since they are usually loaded together)
+        std::stable_sort(_compaction_entries.begin(), _compaction_entries.end(), [](const CompactionEntry& a, const CompactionEntry& b) {
+            return a.morton_code < b.morton_code;
+        });
+
+        _compaction_progress = 0;
+        _is_compacting = true;
+    }
+
+    bool WorldFile::continueCompaction(size_t max_bytes) {
+        /// @brief copies the next chunks to the compacted file
+        /// @param max_bytes stops once at least this many bytes were copied
+        /// @return true once all chunks were copied (finishCompaction() should be called then)
+
+        if(!_is_compacting) return true;
+
+        size_t start_size = _compacted_file.getFileSize();
+
+        while((_compaction_progress < _compaction_entries.size()) && (_compacted_file.getFileSize() - start_size < max_bytes)) {
+
+            CompactionEntry& entry = _compaction_entries.at(_compaction_progress);
+            _compaction_progress++;
+
+            // the chunk might have been moved since beginCompaction()
+            size_t location;
+            if(!findChunkLocation(strToChunkPos(entry.chunk_pos), entry.world_name, location)) continue;
+
+            if(!_chunk_file.copyTo(_compacted_file, location, entry.new_location)) {
+                UND_WARNING << "failed to copy chunk " << entry.chunk_pos << " (" << entry.world_name << ") to the compacted chunk file\n";
+                continue;
+            }
+
+            entry.is_copied = true;
+            _changed_chunks.erase(getCompactionKey(entry.world_name, entry.chunk_pos));
+        }
+
+        return _compaction_progress >= _compaction_entries.size();
+    }
+
+    size_t WorldFile::finishCompaction() {
+        /// @brief replaces the chunk file with the compacted file (chunks that were written since they were copied get copied again)
+        /// and updates the locations of the chunks in the world file
+        /// the updated world file gets written to file_name + ".compact" before any file is replaced,
+        /// if the program stops while the files get replaced, open() completes the compaction
+        /// no chunks should be read in the background while this function is running
+        /// @return the number of bytes by which the chunk file got smaller
+
+        if(!_is_compacting) return 0;
+
+        continueCompaction(std::numeric_limits<size_t>::max());
+
+        // the new locations of the chunks
+        std::map<std::string, size_t> new_locations;
+        for(const CompactionEntry& entry : _compaction_entries)
+            if(entry.is_copied)
+                new_locations[getCompactionKey(entry.world_name, entry.chunk_pos)] = entry.new_location;
+
+        // the chunks that were written after they were copied (or that were added during the compaction) have to be copied (again)
+        // the outdated copies are freed first, so that the new copies can reuse their space
+        // (the compacted file only keeps a hole where a chunk grew while it was being compacted)
+        for(const std::string& key : _changed_chunks) {
+
+            std::map<std::string, size_t>::iterator old_copy = new_locations.find(key);
+            if(old_copy == new_locations.end()) continue;
+
+            _compacted_file.free(old_copy->second);
+            new_locations.erase(old_copy);
+        }
+
+        for(const std::string& key : _changed_chunks) {
+
+            std::string world_name = key.substr(0, key.find(' '));
+            std::string chunk_pos = key.substr(key.find(' ') + 1);
+
+            size_t location, new_location;
+            if(!findChunkLocation(strToChunkPos(chunk_pos), world_name, location)) continue;
+            if(!_chunk_file.copyTo(_compacted_file, location, new_location)) continue;
+
+            new_locations[key] = new_location;
+        }
+
+        // every chunk of the world file needs a location in the compacted file
+        // (a location that wasnt updated would point into the old chunk file)
+        for(const std::string& world_name : CHUNK_WORLD_NAMES) {
+
+            XmlElement* world = getElement({world_name});
+            if(!world) continue;
+
+            for(XmlElement* chunk : world->getAllElements({"CHUNK"})) {
+
+                XmlTagAttrib* chunk_pos = chunk->getAttribute("chunk_pos");
+                if(!chunk_pos) continue;
+
+                if(new_locations.find(getCompactionKey(world_name, chunk_pos->m_value)) == new_locations.end()) {
+                    UND_ERROR << "failed to compact the chunk file: chunk " << chunk_pos->m_value << " (" << world_name << ") was not copied\n";
+                    cancelCompaction();
+                    return 0;
+                }
+            }
+
+        }
+
+        std::string chunk_file_name = getChunkFileName();
+        std::string world_file_name = _file_path + _file_name;
+
+        size_t old_size = _chunk_file.getFileSize();
+        size_t new_size = _compacted_file.getFileSize();
+
+        _compacted_file.close(); // writes the index of the compacted file
+
+        // updating the locations stored in the world file
+        for(const std::string& world_name : CHUNK_WORLD_NAMES) {
+
+            XmlElement* world = getElement({world_name});
+            if(!world) continue;
+
+            for(XmlElement* chunk : world->getAllElements({"CHUNK"})) {
+
+                XmlTagAttrib* chunk_pos = chunk->getAttribute("chunk_pos");
+                if(!chunk_pos) continue;
+
+                chunk->setContent(toStr(new_locations.at(getCompactionKey(world_name, chunk_pos->m_value))));
+            }
+
+        }
+
+        _compaction_entries.clear();
+        _changed_chunks.clear();
+        _is_compacting = false;
+
+        // the compacted world file marks the compaction as complete, once it exists the compacted files replace the old ones
+        // (all locations changed, so the journal gets folded into the file as well)
+        if(!XmlFile::write(getCompactedFileName(world_file_name))) {
+            UND_ERROR << "failed to compact the chunk file " << chunk_file_name << ": could not write the world file\n";
+            std::remove(getCompactedFileName(chunk_file_name).c_str());
+            std::remove((getCompactedFileName(chunk_file_name) + ".index").c_str());
+            _chunk_file.close();
+            open(world_file_name); // dropping the changed locations
+            return 0;
+        }
+
+        _chunk_file.close();
+
+        if(!replaceWithCompactedFiles()) {
+            // the files stay consistent, the world file was written under the name of the compacted file
+            UND_ERROR << "failed to replace the files of the world " << world_file_name << " with the compacted ones, retrying when the world gets opened the next time\n";
+            _chunk_file.open(fileExists(getCompactedFileName(chunk_file_name)) ? getCompactedFileName(chunk_file_name) : chunk_file_name);
+            _compaction_pending = true;
+            return 0;
+        }
+
+        // the compacted world file is the current file now (with the same content)
+        m_file_name = world_file_name;
+
+        _chunk_file.open(chunk_file_name);
+
+        size_t reclaimed = (old_size > new_size) ? (old_size - new_size) : 0;
+        UND_LOG << "compacted the chunk file " << chunk_file_name << ", reclaimed " << reclaimed << " bytes\n";
+
+        return reclaimed;
+    }
+
+    void WorldFile::cancelCompaction() {
+        /// @brief drops the compacted file, the chunk file stays as it is
+
+        if(!_is_compacting) return;
+
+        std::string compacted_file_name = getCompactedFileName(getChunkFileName());
+        _compacted_file.close();
+        std::remove(compacted_file_name.c_str());
+        std::remove((compacted_file_name + ".index").c_str());
+
+        _compaction_entries.clear();
+        _changed_chunks.clear();
+        _is_compacting = false;
+    }
+
+    bool WorldFile::isCompacting() const {
+
+        return _is_compacting;
+    }
+
+    size_t WorldFile::getChunkFileSize() const {
+        /// @return the size of the chunk file
+
+        return _chunk_file.getFileSize();
+    }
+
+    size_t WorldFile::getChunkFileUnusedSize() const {
+        /// @return the number of bytes in the chunk file that could be reclaimed by compacting it
+
+        return _chunk_file.getUnusedSize();
+    }
+
+    size_t WorldFile::compactChunkFile() {
+        /// @brief compacts the chunk file in one go (see beginCompaction())
+        /// @return the number of bytes by which the chunk file got smaller
+
+        beginCompaction();
+
+        return finishCompaction();
+    }
+
     ///////////////////////////////////// load other stuff from the file////////////////////////////////////////
 
     bool WorldFile::readMaterials(MaterialAtlas& atlas, CommandBuffer& cmd, TransferBuffer& buf) {
@@ -148,7 +456,8 @@ namespace cell {
         if(!world) return false;
 
         // looking for a chunk entry with the same chunk_pos
-        XmlElement* c = world->getElement({"CHUNK chunk_pos=" + chunk_pos_str});
+        _chunk_query.setValue("chunk_pos", chunk_pos_str);
+        XmlElement* c = world->getElement(_chunk_query);
         size_t store_location;
 
         if(c) {
@@ -164,8 +473,12 @@ namespace cell {
         // storing the location of the chunk in the chunk file
         c->setContent(toStr(store_location));
 
-        // write the changes to the world file
-        XmlFile::write(_file_path + _file_name);
+        // the chunk has to be copied (again) before the compaction is finished
+        if(_is_compacting)
+            _changed_chunks.insert(getCompactionKey(world_name, chunk_pos_str));
+
+        // write the changes to the world file (only the changed chunk entries get appended to its journal)
+        XmlFile::writeChanges();
 
         return true;
     }
@@ -174,6 +487,16 @@ namespace cell {
     bool WorldFile::read(Chunk<T>& chunk, const glm::ivec3& chunk_pos, const std::string& world_name) {
         /// @return true, if a chunk with the chunk_pos existed in the file and could be read
 
+        size_t store_location;
+        if(!findChunkLocation(chunk_pos, world_name, store_location)) return false;
+
+        // read the chunk from the chunk file
+        return _chunk_file.read(chunk, store_location);
+    }
+
+    bool WorldFile::findChunkLocation(const glm::ivec3& chunk_pos, const std::string& world_name, size_t& location) {
+        // @return false, if there is no chunk with the chunk_pos in the file
+
         std::string chunk_pos_str = chunkPosToStr(chunk_pos);
 
         // get world element
@@ -181,12 +504,72 @@ namespace cell {
         if(!world) return false;
 
         // looking for a chunk entry with the same chunk_pos
-        XmlElement* c = world->getElement({"CHUNK chunk_pos=" + chunk_pos_str});
+        _chunk_query.setValue("chunk_pos", chunk_pos_str);
+        XmlElement* c = world->getElement(_chunk_query);
         if(!c) return false;
 
-        // read the chunk from the chunk file
-        size_t store_location = std::strtol(c->getContent().data(), nullptr, 10);
-        return _chunk_file.read(chunk, store_location);
+        location = std::strtol(c->getContent().data(), nullptr, 10);
+
+        return true;
+    }
+
+    std::string WorldFile::getChunkFileName() const {
+
+        return _file_path + getFileName(_file_name, true) + ".chunk";
+    }
+
+    std::string WorldFile::getCompactedFileName(const std::string& file_name) const {
+        // the name under which the compacted version of the file is written
+
+        return file_name + ".compact";
+    }
+
+    bool WorldFile::replaceWithCompactedFiles() {
+        // replaces the chunk file and the world file with their compacted versions, if the compaction was completed
+        // the world file is written last by finishCompaction(), without it the compacted chunk file gets removed
+        // the files are replaced in a fixed order, so that this can be repeated if the program stopped in between
+        // @return false if a file could not be replaced
+
+        std::string chunk_file_name = getChunkFileName();
+        std::string world_file_name = _file_path + _file_name;
+
+        if(fileExists(getCompactedFileName(world_file_name))) {
+
+            // chunk file
+            if(fileExists(getCompactedFileName(chunk_file_name))) {
+
+                std::remove((chunk_file_name + ".index").c_str());
+                if(std::rename(getCompactedFileName(chunk_file_name).c_str(), chunk_file_name.c_str())) return false;
+            }
+
+            // the index of the chunk file gets rebuilt if it is missing
+            std::rename((getCompactedFileName(chunk_file_name) + ".index").c_str(), (chunk_file_name + ".index").c_str());
+
+            // world file (the journal of the old file doesnt belong to it)
+            std::remove((world_file_name + ".journal").c_str());
+            if(std::rename(getCompactedFileName(world_file_name).c_str(), world_file_name.c_str())) return false;
+
+        } else {
+
+            // left over from a compaction that wasnt completed
+            std::remove(getCompactedFileName(chunk_file_name).c_str());
+            std::remove((getCompactedFileName(chunk_file_name) + ".index").c_str());
+        }
+
+        // changes made to the compacted world file after replacing it failed before
+        // (the journal stores the checksum of the file it belongs to, so it only gets applied to the compacted world file)
+        if(fileExists(getCompactedFileName(world_file_name) + ".journal")) {
+            std::remove((world_file_name + ".journal").c_str());
+            std::rename((getCompactedFileName(world_file_name) + ".journal").c_str(), (world_file_name + ".journal").c_str());
+        }
+
+        return true;
+    }
+
+    std::string WorldFile::getCompactionKey(const std::string& world_name, const std::string& chunk_pos) const {
+        // identifies a chunk in _changed_chunks
+
+        return world_name + " " + chunk_pos;
     }
 
     std::string WorldFile::chunkPosToStr(const glm::ivec3& chunk_pos) const {
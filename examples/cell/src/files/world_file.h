@@ -2,6 +2,8 @@
 #define WORLD_FILE_H
 
 #include <string>
+#include "vector"
+#include "set"
 #include "world/cells/cell_world.h"
 #include "world/cells/cell_chunk.h"
 #include "world/lights/light_chunk.h"
@@ -23,10 +25,30 @@ namespace cell {
 
         ChunkFile _chunk_file; // to store the binary data of all kinds of chunks
 
+        // finds the CHUNK element with a chunk_pos (see setValue())
+        undicht::tools::XmlQuery _chunk_query = undicht::tools::XmlQuery({"CHUNK chunk_pos="});
+
+        // compacting the chunk file (see beginCompaction())
+        struct CompactionEntry {
+            std::string world_name; // WORLD or LIGHTS
+            std::string chunk_pos; // as stored in the world file
+            uint64_t morton_code = 0;
+            size_t new_location = 0; // in the compacted file
+            bool is_copied = false;
+        };
+
+        bool _is_compacting = false;
+        ChunkFile _compacted_file;
+        std::vector<CompactionEntry> _compaction_entries; // sorted by the morton codes of the chunks
+        size_t _compaction_progress = 0; // number of entries that were handled by continueCompaction()
+        std::set<std::string> _changed_chunks; // chunks written since beginCompaction() that were not copied yet (see getCompactionKey())
+        bool _compaction_pending = false; // the compacted files couldnt replace the old ones, open() retries it
+
       public:
 
         WorldFile() = default;
         WorldFile(const std::string& file_name);
+        virtual ~WorldFile();
 
         /// @brief loads in the content stored in the world file
         /// @return true if the file exists and is a correct world file
@@ -44,6 +66,50 @@ namespace cell {
         bool read(CellChunk& chunk, const glm::ivec3& chunk_pos);
         bool read(LightChunk& chunk, const glm::ivec3& chunk_pos);
 
+        // load multiple chunks in the background
+
+        /// @brief adds a request for reading the chunk to the batch
+        /// @return false, if there is no chunk with the chunk_pos in the file
+        bool addReadRequest(CellChunk& chunk, const glm::ivec3& chunk_pos, std::vector<ChunkFile::ReadRequest>& batch);
+        bool addReadRequest(LightChunk& chunk, const glm::ivec3& chunk_pos, std::vector<ChunkFile::ReadRequest>& batch);
+
+        /// @brief reads the chunks of the batch in the background (sorted by their location in the chunk file)
+        /// the chunks are loaded once the counter is done, the batch, the chunks and this file have to stay alive until then
+        void readAsync(std::vector<ChunkFile::ReadRequest>& batch, undicht::JobCounter& counter);
+
+        // compacting the chunk file
+
+        /// @brief starts moving the chunks to a new chunk file, where they are stored next to each other
+        /// and sorted by their position (in morton order), so that chunks close to each other are close in the file as well
+        /// the chunks get copied by continueCompaction(), in between chunks can still be read and written
+        void beginCompaction();
+
+        /// @brief copies the next chunks to the compacted file
+        /// @param max_bytes stops once at least this many bytes were copied
+        /// @return true once all chunks were copied (finishCompaction() should be called then)
+        bool continueCompaction(size_t max_bytes);
+
+        /// @brief replaces the chunk file with the compacted file (chunks that were written since they were copied get copied again)
+        /// and updates the locations of the chunks in the world file
+        /// the updated world file gets written to file_name + ".compact" before any file is replaced,
+        /// if the program stops while the files get replaced, open() completes the compaction
+        /// no chunks should be read in the background while this function is running
+        /// @return the number of bytes by which the chunk file got smaller
+        size_t finishCompaction();
+
+        /// @brief drops the compacted file, the chunk file stays as it is
+        void cancelCompaction();
+
+        bool isCompacting() const;
+
+        /// @return the size of the chunk file and the number of bytes in it that could be reclaimed by compacting it
+        size_t getChunkFileSize() const;
+        size_t getChunkFileUnusedSize() const;
+
+        /// @brief compacts the chunk file in one go (see beginCompaction())
+        /// @return the number of bytes by which the chunk file got smaller
+        size_t compactChunkFile();
+
         // load other stuff from the file
         bool readMaterials(MaterialAtlas& atlas, undicht::vulkan::CommandBuffer& cmd, undicht::vulkan::TransferBuffer& buf);
         bool readEnvironment(Environment& env, undicht::vulkan::CommandBuffer& cmd, undicht::vulkan::TransferBuffer& buf);
@@ -57,6 +123,22 @@ namespace cell {
         template<typename T>
         bool read(Chunk<T>& chunk, const glm::ivec3& chunk_pos, const std::string& world_name);
 
+        // @return false, if there is no chunk with the chunk_pos in the file
+        bool findChunkLocation(const glm::ivec3& chunk_pos, const std::string& world_name, size_t& location);
+
+        std::string getChunkFileName() const;
+
+        // the name under which the compacted version of the file is written
+        std::string getCompactedFileName(const std::string& file_name) const;
+
+        // replaces the chunk file and the world file with their compacted versions, if the compaction was completed
+        // the files are replaced in a fixed order, so that this can be repeated if the program stopped in between
+        // @return false if a file could not be replaced
+        bool replaceWithCompactedFiles();
+
+        // identifies a chunk in _changed_chunks
+        std::string getCompactionKey(const std::string& world_name, const std::string& chunk_pos) const;
+
         std::string chunkPosToStr(const glm::ivec3& chunk_pos) const;
         glm::ivec3 strToChunkPos(std::string str) const;
 
@@ -2,6 +2,7 @@
 #include "types.h"
 #include "core/vulkan/formats.h"
 #include "images/image_file.h"
+#include "images/mip_chain.h"
 #include "debug.h"
 #include "renderer/vulkan/immediate_command.h"
 
@@ -17,6 +18,7 @@ namespace cell {
     const int32_t MaterialAtlas::TILE_MAP_HEIGHT = TILE_HEIGHT * 64; // 16 * 64 = 1024
     const int32_t MaterialAtlas::TILE_MAP_COLS = TILE_MAP_WIDTH / TILE_WIDTH;
     const int32_t MaterialAtlas::TILE_MAP_ROWS = TILE_MAP_HEIGHT / TILE_HEIGHT;
+    const int32_t MaterialAtlas::TILE_MIP_LEVELS = 5; // 16x16 -> 1x1
     const FixedType MaterialAtlas::TILE_MAP_FORMAT = UND_R8G8B8A8_SRGB;
 
     void MaterialAtlas::init(const undicht::vulkan::LogicalDevice& device) {
@@ -25,7 +27,7 @@ namespace cell {
 
         _tile_map.setExtent(TILE_MAP_WIDTH, TILE_MAP_HEIGHT, 1, 2);
         _tile_map.setFormat(translate(TILE_MAP_FORMAT));
-        _tile_map.setMipMaps(false);
+        _tile_map.setMipMaps(true, false, TILE_MIP_LEVELS); // the mip levels of the tiles get uploaded by setMaterial()
         _tile_map.init(device);
 
         _materials.resize(TILE_MAP_COLS * TILE_MAP_ROWS);
@@ -76,8 +78,8 @@ namespace cell {
         int pos_x = (fixed_id % TILE_MAP_COLS) * TILE_WIDTH;
         int pos_y = (fixed_id / TILE_MAP_COLS) * TILE_HEIGHT;
 
-        _tile_map.setData(cmd, buf, diffuse_data.getPixelData(), diffuse_data.getPixelDataSize(), 0, 0, {TILE_WIDTH, TILE_HEIGHT, 1}, {pos_x, pos_y, 0});
-        _tile_map.setData(cmd, buf, specular_data.getPixelData(), specular_data.getPixelDataSize(), 1, 0, {TILE_WIDTH, TILE_HEIGHT, 1}, {pos_x, pos_y, 0});
+        uploadTile(diffuse_data, false, 0, pos_x, pos_y, cmd, buf);
+        uploadTile(specular_data, true, 1, pos_x, pos_y, cmd, buf);
 
     }
 
@@ -173,4 +175,28 @@ namespace cell {
 
     }
 
+    void MaterialAtlas::uploadTile(const ImageData<char>& data, bool is_normal_map, uint32_t layer, int pos_x, int pos_y, CommandBuffer& cmd, TransferBuffer& buf) {
+        // uploads the mip levels of the texture to the tile of the material (every tile gets downsampled on its own)
+
+        if(data.getWidth() != TILE_WIDTH || data.getHeight() != TILE_HEIGHT)
+            return; // the texture failed to load
+
+        MipChainSettings settings;
+        settings.address_mode = SamplerAddressMode::REPEAT; // the textures repeat on the faces of the cells
+        settings.srgb = !is_normal_map; // albedo, roughness stays linear
+        settings.normal_map = is_normal_map; // metalness is not changed by the renormalization
+        settings.max_levels = TILE_MIP_LEVELS;
+
+        std::vector<ImageData<char>> levels;
+        if(!buildMipChain(data, levels, settings))
+            return;
+
+        for(uint32_t level = 0; level < levels.size(); level++) {
+
+            const ImageData<char>& image = levels.at(level);
+            _tile_map.setData(cmd, buf, image.getPixelData(), image.getPixelDataSize(), layer, level, {image.getWidth(), image.getHeight(), 1}, {pos_x >> level, pos_y >> level, 0});
+        }
+
+    }
+
 } // cell
\ No newline at end of file
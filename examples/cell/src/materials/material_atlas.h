@@ -22,6 +22,7 @@ namespace cell {
         const static int32_t TILE_MAP_HEIGHT;
         const static int32_t TILE_MAP_COLS;
         const static int32_t TILE_MAP_ROWS;
+        const static int32_t TILE_MIP_LEVELS; // until the tiles are 1x1
         const static undicht::FixedType TILE_MAP_FORMAT;
     
       protected:
@@ -53,6 +54,9 @@ namespace cell {
         void loadAlbedoTexture(const std::string& file_name, undicht::tools::ImageData<char>& data);
         void loadNormalTexture(const std::string& file_name, undicht::tools::ImageData<char>& data);
 
+        // uploads the mip levels of the texture to the tile of the material (every tile gets downsampled on its own)
+        void uploadTile(const undicht::tools::ImageData<char>& data, bool is_normal_map, uint32_t layer, int pos_x, int pos_y, undicht::vulkan::CommandBuffer& cmd, undicht::vulkan::TransferBuffer& buf);
+
     };
 
 } // cell
@@ -34,4 +34,23 @@ namespace cell {
         return cell_pos;
     }
 
+    uint64_t calcMortonCode(const glm::ivec3& chunk_pos) {
+        /** @brief calculates the position of the chunk on a z-order curve (morton code)
+         * chunks that are close to each other usually get similar codes
+         * @param chunk_pos a multiple of 255, the chunk coordinates need to fit into 21 bits (+- 2^20 chunks) */
+
+        // moving the chunk coordinates into the positive range
+        glm::ivec3 chunk = chunk_pos / 255 + glm::ivec3(1 << 20);
+
+        uint64_t code = 0;
+        for(int bit = 0; bit < 21; bit++) {
+
+            code |= uint64_t((chunk.x >> bit) & 1) << (3 * bit + 0);
+            code |= uint64_t((chunk.y >> bit) & 1) << (3 * bit + 1);
+            code |= uint64_t((chunk.z >> bit) & 1) << (3 * bit + 2);
+        }
+
+        return code;
+    }
+
 } // namespace cell
\ No newline at end of file
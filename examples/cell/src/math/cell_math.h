@@ -14,6 +14,11 @@ namespace cell {
      * simply casting wouldnt work for negative components of pos, since int(-0.5f) is 0, not -1 */
     glm::ivec3 toCellPos(const glm::vec3& pos);
 
+    /** @brief calculates the position of the chunk on a z-order curve (morton code)
+     * chunks that are close to each other usually get similar codes
+     * @param chunk_pos a multiple of 255, the chunk coordinates need to fit into 21 bits (+- 2^20 chunks) */
+    uint64_t calcMortonCode(const glm::ivec3& chunk_pos);
+
 } // cell
 
 #endif // CELL_MATH_H
\ No newline at end of file
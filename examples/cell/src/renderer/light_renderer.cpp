@@ -206,7 +206,7 @@ namespace cell {
         _point_light_renderer.bindPipeline(cmd);
         _point_light_renderer.bindVertexBuffer(cmd, lights.getBuffer(), false, true);
 
-        uint32_t light_byte_size = POINT_LIGHT_LAYOUT.getTotalSize();
+        uint32_t light_byte_size = PointLightLayout::SIZE;
         for(const LightBuffer::BufferEntry& entry : lights.getDrawAreas()) {
 
             // draw command
@@ -1,6 +1,7 @@
 #include "renderer/master_renderer.h"
 #include "core/vulkan/formats.h"
 #include "debug.h"
+#include "profiler.h"
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include "imgui/vulkan/imgui_api.h"
@@ -110,6 +111,7 @@ namespace cell {
     }
 
     void MasterRenderer::beginShadowPass(const Light& global_shadow_source, const glm::vec3& shadow_target) {
+        UND_PROFILE_SCOPE("MasterRenderer::beginShadowPass");
 
         _current_pass = SHADOW_PASS;
 
@@ -130,6 +132,7 @@ namespace cell {
     }
 
     void MasterRenderer::drawToShadowMap(const CellBuffer& world) {
+        UND_PROFILE_SCOPE("MasterRenderer::drawToShadowMap");
         
         _shadow_renderer.draw(world, getDrawCmd());
     }
@@ -143,6 +146,7 @@ namespace cell {
     }
 
     void MasterRenderer::beginMainRenderPass() {
+        UND_PROFILE_SCOPE("MasterRenderer::beginMainRenderPass");
 
         _current_pass = MAIN_PASS;
 
@@ -177,6 +181,7 @@ namespace cell {
     }
 
     void MasterRenderer::drawWorld(const CellBuffer& world) {
+        UND_PROFILE_SCOPE("MasterRenderer::drawWorld");
 
         _world_renderer.draw(world, getDrawCmd());
     }
@@ -195,6 +200,7 @@ namespace cell {
     }
 
     void MasterRenderer::drawLights(const LightBuffer& lights) {
+        UND_PROFILE_SCOPE("MasterRenderer::drawLights");
 
         _light_renderer.draw(lights, getDrawCmd());
     }
@@ -209,6 +215,7 @@ namespace cell {
     }
 
     void MasterRenderer::drawAmbientLight(const Environment& env) {
+        UND_PROFILE_SCOPE("MasterRenderer::drawAmbientLight");
 
         _light_renderer.draw(env, getDrawCmd());
     }
@@ -224,6 +231,7 @@ namespace cell {
     }
 
     void MasterRenderer::drawFinal(float exposure) {
+        UND_PROFILE_SCOPE("MasterRenderer::drawFinal");
 
         _final_renderer.draw(getDrawCmd(), exposure);
     }
@@ -246,6 +254,7 @@ namespace cell {
     }
 
     void MasterRenderer::drawImGui() {
+        UND_PROFILE_SCOPE("MasterRenderer::drawImGui");
 
         undicht::vulkan::ImGuiAPI::render(_swap_image_id, getDrawCmd());
     }
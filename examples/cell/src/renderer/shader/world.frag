@@ -36,8 +36,12 @@ void main() {
 
 	vec2 tile_map_uv = (material + fract(cell_uv) * 0.99) * local.tile_map_unit;
 
-	out_albedo_roughness = texture(tile_map, vec3(tile_map_uv, 0));
-	out_normal_metalness = vec4(normal_rel_cam, texture(tile_map, vec3(tile_map_uv, 1)).a); // no normal mapping for now
+	// selecting the mip level with the derivatives of the continuous uv (fract() jumps at the borders of the cells, which would select the last mip level there)
+	vec2 uv_dx = dFdx(cell_uv) * 0.99 * local.tile_map_unit;
+	vec2 uv_dy = dFdy(cell_uv) * 0.99 * local.tile_map_unit;
+
+	out_albedo_roughness = textureGrad(tile_map, vec3(tile_map_uv, 0), uv_dx, uv_dy);
+	out_normal_metalness = vec4(normal_rel_cam, textureGrad(tile_map, vec3(tile_map_uv, 1), uv_dx, uv_dy).a); // no normal mapping for now
 	out_position_rel_cam = vec4(pos_rel_cam, 0.0f);
 	out_shadow_pos = pos_on_shadow_map;
 
@@ -60,7 +60,7 @@ namespace cell {
         _renderer.bindVertexBuffer(cmd, world.getBuffer(), false, true);
 
         // drawing the chunks
-        uint32_t cell_byte_size = CELL_LAYOUT.getTotalSize();
+        uint32_t cell_byte_size = CellLayout::SIZE;
         createPerChunkUBOs(world.getDrawAreas().size());
         for(const CellBuffer::BufferEntry& entry : world.getDrawAreas()) {
 
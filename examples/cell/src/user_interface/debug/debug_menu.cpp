@@ -1,6 +1,8 @@
 #include "debug_menu.h"
 #include "imgui/vulkan/imgui_api.h"
 #include "file_tools.h"
+#include "profiler.h"
+#include "alloc_tracker.h"
 #include "environment/environment_generator.h"
 #include "world/chunk_system/chunk_system.h"
 #include "world/cells/cell.h"
@@ -28,6 +30,12 @@ namespace cell {
 
     void DebugMenu::applyUpdates( Environment& env, CommandBuffer& load_cmd, TransferBuffer& load_buf) {
 
+        if(!_update_environment && !_update_light_maps)
+            return;
+
+        // regenerating the environment is an occasional, user triggered action which is allowed to allocate
+        UND_ALLOW_ALLOC_SCOPE();
+
         if(_update_environment) {
             EnvironmentGenerator gen;
             gen.init();
@@ -53,6 +61,11 @@ namespace cell {
 
         if(!_open) return;
 
+        // the menu formats its text into strings (and imgui may allocate as well)
+        // it runs inside of the main loops NoAllocationScope, so the allocations get counted for the ui tag, but are not reported as violations
+        UND_ALLOW_ALLOC_SCOPE();
+        UND_ALLOC_TAG(AllocTag::UI);
+
         glm::ivec3 chunk = ChunkSystem<Cell>::calcChunkPosition(glm::ivec3(pos));
 
         std::string title = "Cell Debug Menu";
@@ -66,12 +79,31 @@ namespace cell {
         ImGui::Text(player_pos.data(), "");
         ImGui::Text(player_dir.data(), "");
         ImGui::Text(chunk_pos.data(), "");
+
+        // heap allocations made during the last frame
+        if(AllocationTracker::isEnabled()) {
+
+            AllocStats total = AllocationTracker::getLastFrameStats();
+            std::string allocations = "Allocations: " + toStr(total.m_count) + " (" + toStr(total.m_bytes) + " bytes), in no-alloc scopes: " + toStr(AllocationTracker::getLastFrameViolations());
+            ImGui::Text(allocations.data(), "");
+
+            for(uint32_t i = 0; i < ALLOC_TAG_COUNT; i++) {
+                AllocStats stats = AllocationTracker::getLastFrameStats((AllocTag)i);
+                std::string tag = std::string("    ") + AllocationTracker::getTagName((AllocTag)i) + ": " + toStr(stats.m_count) + " (" + toStr(stats.m_bytes) + " bytes)";
+                ImGui::Text(tag.data(), "");
+            }
+        }
+
         ImGui::SliderFloat("Cloud Coverage", &_cloud_coverage, 0.0f, 2.0f);
         ImGui::SliderFloat("Cloud Density", &_cloud_density, 0.0f, 10.0f);
         ImGui::SliderFloat("Sky Brightness", &_sky_brightness, 0.0f, 2.0f);
         ImGui::SliderFloat("Cloud Brightness", &_cloud_brightness, 0.0f, 2.0f);
         _update_environment = ImGui::Button("Generate");
         _update_light_maps = ImGui::Button("update Lighting");
+
+        if(ImGui::Button("Write Profiler Trace"))
+            Profiler::writeChromeTrace("profiler_trace.json");
+
         ImGui::End();
 
     }
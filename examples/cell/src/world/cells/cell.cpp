@@ -1,4 +1,6 @@
 #include "cell.h"
+#include "type_traits"
+#include "cstddef"
 
 // seems like this only gets defined on some systems / compilers
 #ifndef LITTLE_ENDIAN
@@ -8,7 +10,22 @@
 namespace cell {
 
     using namespace undicht;
-    const BufferLayout CELL_LAYOUT = BufferLayout({UND_VEC4UI8, UND_VEC4UI8, UND_UINT32});
+    const BufferLayout CELL_LAYOUT = CellLayout::getLayout();
+
+    // cells get copied to the gpu buffers as they are
+    static_assert(sizeof(Cell) == CellLayout::SIZE, "the Cell class does not match the CellLayout");
+    static_assert(alignof(Cell) >= CellLayout::ALIGNMENT, "the Cell class is less aligned than the CellLayout requires");
+    static_assert(CellLayout::SIZE % alignof(Cell) == 0, "arrays of Cells dont have the stride of the CellLayout");
+    static_assert(std::is_standard_layout<Cell>::value, "the Cell class has to be a standard layout type");
+
+    void Cell::checkLayout() {
+        // static_asserts that the members match the CellLayout (never called)
+        // (inside a member function, so that the protected members can be accessed)
+
+        static_assert(offsetof(Cell, _pos_0) == CellLayout::getOffset(0), "Cell::_pos_0 does not match the CellLayout");
+        static_assert(offsetof(Cell, _pos_1) == CellLayout::getOffset(1), "Cell::_pos_1 does not match the CellLayout");
+        static_assert(offsetof(Cell, _faces) == CellLayout::getOffset(2), "Cell::_faces does not match the CellLayout");
+    }
 
     const uint8_t CELL_FACE_YP = 0x01; // + y (00000001)
     const uint8_t CELL_FACE_YN = 0x02; // - y (00000010)
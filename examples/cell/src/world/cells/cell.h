@@ -4,10 +4,14 @@
 #include "iostream"
 
 #include "buffer_layout.h"
+#include "static_buffer_layout.h"
 #include "glm/glm.hpp"
 
 namespace cell {
 
+    // pos0 + uv, pos1 + uv, visible faces (has to match the members of Cell)
+    typedef undicht::StaticBufferLayout<undicht::LayoutPacking::PACKED, UND_STATIC_VEC4UI8, UND_STATIC_VEC4UI8, UND_STATIC_UINT32> CellLayout;
+
     const extern undicht::BufferLayout CELL_LAYOUT;
     const extern uint8_t CELL_FACE_YP; // + y (00000001)
     const extern uint8_t CELL_FACE_YN; // - y (00000010)
@@ -49,6 +53,11 @@ namespace cell {
 
         bool static sharedVolume(const Cell& c1, const Cell& c2);
 
+      protected:
+
+        // static_asserts that the members match the CellLayout (never called)
+        static void checkLayout();
+
     };
 
     std::ostream& operator<< (std::ostream& out, const Cell& c);
@@ -128,19 +128,12 @@ namespace cell {
     std::vector<uint32_t> CellChunk::getCellIDsInVolume(const Cell &volume) const {
         /// @return the ids of all cells within that volume
 
-        std::vector<uint32_t> ids;
-        std::vector<const MiniChunk *> mini_chunks = calcMiniChunks(volume);
-
-        for (const MiniChunk *mc : mini_chunks) {
-            
-            for (uint32_t id : mc->getCellRefs()) {
-
-                const Cell *cell = getCell(id);
+        // releases the mini chunks collected on the frame arena
+        // (the arena versions cant do this, their results may be stored on the frame arena as well)
+        undicht::ArenaScope scope(undicht::FrameArena::get());
 
-                if (cell && Cell::sharedVolume(*cell, volume))
-                    ids.push_back(id);
-            }
-        }
+        std::vector<uint32_t> ids;
+        collectCellIDs(volume, ids);
 
         return ids;
     }
@@ -148,21 +141,25 @@ namespace cell {
     std::vector<const Cell *> CellChunk::getCellsInVolume(const Cell &volume) const {
         /// @return all cells within the volume
 
+        // releases the mini chunks collected on the frame arena
+        undicht::ArenaScope scope(undicht::FrameArena::get());
+
         std::vector<const Cell *> cells;
-        std::vector<const MiniChunk *> mini_chunks = calcMiniChunks(volume);
+        collectCells(volume, cells);
 
-        for (const MiniChunk *mc : mini_chunks) {
+        return cells;
+    }
 
-            for (uint32_t id : mc->getCellRefs()) {
+    void CellChunk::getCellIDsInVolume(const Cell &volume, undicht::ArenaVector<uint32_t> &ids) const {
+        /// @brief stores the ids of all cells within that volume in ids
 
-                const Cell *cell = getCell(id);
+        collectCellIDs(volume, ids);
+    }
 
-                if (cell && Cell::sharedVolume(*cell, volume))
-                    cells.push_back(cell);
-            }
-        }
+    void CellChunk::getCellsInVolume(const Cell &volume, undicht::ArenaVector<const Cell *> &cells) const {
+        /// @brief stores all cells within the volume in cells
 
-        return cells;
+        collectCells(volume, cells);
     }
 
     uint32_t CellChunk::fillBuffer(char *buffer) const {
@@ -267,6 +264,60 @@ namespace cell {
         // @return all mini chunks within that volume
 
         std::vector<const MiniChunk *> mini_chunks;
+        collectMiniChunks(volume, mini_chunks);
+
+        return mini_chunks;
+    }
+
+    void CellChunk::calcMiniChunks(const Cell &volume, undicht::ArenaVector<const MiniChunk *> &mini_chunks) const {
+
+        collectMiniChunks(volume, mini_chunks);
+    }
+
+    template<typename Vector>
+    void CellChunk::collectCellIDs(const Cell &volume, Vector &ids) const {
+        // adds the ids of the cells within the volume to the vector
+
+        // the mini chunks are only needed until the end of the frame (or the ArenaScope of the caller)
+        undicht::ArenaVector<const MiniChunk *> mini_chunks(undicht::FrameArena::get());
+        collectMiniChunks(volume, mini_chunks);
+
+        for (const MiniChunk *mc : mini_chunks) {
+            
+            for (uint32_t id : mc->getCellRefs()) {
+
+                const Cell *cell = getCell(id);
+
+                if (cell && Cell::sharedVolume(*cell, volume))
+                    ids.push_back(id);
+            }
+        }
+
+    }
+
+    template<typename Vector>
+    void CellChunk::collectCells(const Cell &volume, Vector &cells) const {
+        // adds the cells within the volume to the vector
+
+        undicht::ArenaVector<const MiniChunk *> mini_chunks(undicht::FrameArena::get());
+        collectMiniChunks(volume, mini_chunks);
+
+        for (const MiniChunk *mc : mini_chunks) {
+
+            for (uint32_t id : mc->getCellRefs()) {
+
+                const Cell *cell = getCell(id);
+
+                if (cell && Cell::sharedVolume(*cell, volume))
+                    cells.push_back(cell);
+            }
+        }
+
+    }
+
+    template<typename Vector>
+    void CellChunk::collectMiniChunks(const Cell &volume, Vector &mini_chunks) const {
+        // adds the mini chunks within the volume to the vector
 
         uint8_t x1, y1, z1, x2, y2, z2;
         volume.getPos0(x1, y1, z1);
@@ -283,7 +334,6 @@ namespace cell {
             }
         }
 
-        return mini_chunks;
     }
 
     bool CellChunk::withinVolume(const Cell &c, uint32_t x, uint32_t y, uint32_t z) const {
@@ -5,6 +5,7 @@
 #include "world/cells/cell.h"
 #include "world/cells/mini_chunk.h"
 #include "vector"
+#include "linear_arena.h"
 
 namespace cell {
 
@@ -44,6 +45,11 @@ namespace cell {
         std::vector<uint32_t> getCellIDsInVolume(const Cell& volume) const;
         std::vector<const Cell*> getCellsInVolume(const Cell& volume) const;
 
+        // versions that store their results in a vector allocated from an arena (i.e. the frame arena)
+        // they use the frame arena for temporary data as well, which gets released with the ArenaScope of the caller
+        void getCellIDsInVolume(const Cell& volume, undicht::ArenaVector<uint32_t>& ids) const;
+        void getCellsInVolume(const Cell& volume, undicht::ArenaVector<const Cell*>& cells) const;
+
         uint32_t fillBuffer(char* buffer) const; // store the contents of the chunk in the buffer (if buffer != nullptr), return number of elements stored
         void loadFromBuffer(const char* buffer, uint32_t byte_size); // initialize the complete data of the chunk from the buffer
         void loadFromBuffer(const std::vector<Cell>& buffer);
@@ -60,6 +66,15 @@ namespace cell {
         void initMiniChunks();
         const MiniChunk* calcMiniChunk(uint32_t x, uint32_t y, uint32_t z) const;
         std::vector<const MiniChunk*> calcMiniChunks(const Cell& volume) const;
+        void calcMiniChunks(const Cell& volume, undicht::ArenaVector<const MiniChunk*>& mini_chunks) const;
+
+        // adds the ids / pointers of the cells within the volume to the vector
+        template<typename Vector>
+        void collectCellIDs(const Cell& volume, Vector& ids) const;
+        template<typename Vector>
+        void collectCells(const Cell& volume, Vector& cells) const;
+        template<typename Vector>
+        void collectMiniChunks(const Cell& volume, Vector& mini_chunks) const;
 
         bool withinVolume(const Cell& c, uint32_t x, uint32_t y, uint32_t z) const;
 
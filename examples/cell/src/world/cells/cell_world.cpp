@@ -1,5 +1,6 @@
 #include "world/cells/cell_world.h"
 #include "debug.h"
+#include "profiler.h"
 #include "math/math_tools.h"
 #include "math/ray_cast.h"
 #include "math/cell_math.h"
@@ -13,7 +14,7 @@ namespace cell {
 
         _buffer.init(device, load_cmd, load_buf);
 
-        _buffer.allocate(10000000 * CELL_LAYOUT.getTotalSize()); // 10.000.000 = 10 million cells
+        _buffer.allocate(10000000 * CellLayout::SIZE); // 10.000.000 = 10 million cells
     }
     
     void CellWorld::cleanUp() {
@@ -25,6 +26,7 @@ namespace cell {
         /** updates the vulkan buffer with the changes made since the last call to applyUpdates() 
         * @param load_cmd records the commands necessary to move the data from the transfer buffer to the internal vulkan buffer 
         * @param load_buf used as a staging buffer to transfer data to memory that is not directly visible to the cpu */
+        UND_PROFILE_SCOPE("CellWorld::applyUpdates");
 
         // make sure each chunk is correctly stored in the world buffer
         for(int i = 0; i < getLoadedChunks().size(); i++) {
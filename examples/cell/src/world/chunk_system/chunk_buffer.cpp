@@ -2,6 +2,7 @@
 #include "vector"
 #include "algorithm"
 #include "debug.h"
+#include "linear_arena.h"
 
 #include "world/lights/light.h"
 #include "world/cells/cell.h"
@@ -58,13 +59,15 @@ namespace cell {
             return;
         }*/
 
-        if(!c.fillBuffer(nullptr))
+        uint32_t chunk_buffer_size = c.fillBuffer(nullptr);
+        if(!chunk_buffer_size)
             return; // c has no data it wants to store
 
         // filling a buffer with the chunk data
-        uint32_t chunk_buffer_size = c.fillBuffer(nullptr);
-        std::vector<char> chunk_buffer(chunk_buffer_size);
-        c.fillBuffer(chunk_buffer.data());
+        // (the data gets copied to the transfer buffer right away, so the memory can be released at the end of the function)
+        undicht::ArenaScope scope(undicht::FrameArena::get());
+        char* chunk_buffer = (char*)scope.getArena().allocate(chunk_buffer_size);
+        c.fillBuffer(chunk_buffer);
 
         // finding a suitable location in the vertex buffer for the data to be stored
         BufferEntry free_memory = findFreeMemory(chunk_buffer_size);
@@ -74,7 +77,7 @@ namespace cell {
             _buffer.allocateInstanceBuffer((free_memory.offset + free_memory.byte_size) * 1.5f);
 
         // storing the data
-        _buffer.setInstanceData(chunk_buffer.data(), chunk_buffer.size(), free_memory.offset, load_cmd, load_buf);
+        _buffer.setInstanceData(chunk_buffer, chunk_buffer_size, free_memory.offset, load_cmd, load_buf);
 
         // storing the buffer entry
         free_memory._chunk_pos = chunk_pos;
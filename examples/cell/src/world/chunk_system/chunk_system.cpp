@@ -85,19 +85,30 @@ namespace cell {
     std::vector<glm::ivec3> ChunkSystem<T>::getChunkPositionsAt(const glm::ivec3& world_pos0, const glm::ivec3& world_pos1) const {
 
         std::vector<glm::ivec3> positions;
-
-        for(int x = world_pos0.x; x <= world_pos1.x; x += glm::max(1, glm::min(world_pos1.x - x, 255))) {
-            for(int y = world_pos0.y; y <= world_pos1.y; y+= glm::max(1, glm::min(world_pos1.y - y, 255))) {
-                for(int z = world_pos0.z; z <= world_pos1.z; z += glm::max(1, glm::min(world_pos1.z - z, 255))) {
-                    
-                    positions.push_back(calcChunkPosition(glm::ivec3(x, y, z)));
-                }            
-            }
-        }
+        collectChunkPositions(world_pos0, world_pos1, positions);
 
         return positions;
     }
 
+    template<typename T>
+    void ChunkSystem<T>::getChunksAt(const glm::ivec3& world_pos0, const glm::ivec3& world_pos1, undicht::ArenaVector<Chunk<T>*>& chunks) const {
+        /// @brief stores all chunks within the volume between pos0 and pos1 in chunks (unloaded chunks will be added as nullptr)
+
+        // the positions are allocated from the same arena as the chunks
+        undicht::ArenaVector<glm::ivec3> positions(chunks.get_allocator());
+        getChunkPositionsAt(world_pos0, world_pos1, positions);
+
+        for(glm::ivec3& pos : positions)
+            chunks.push_back(getChunkAt(pos)); // not loaded chunks will be added as nullptr
+
+    }
+
+    template<typename T>
+    void ChunkSystem<T>::getChunkPositionsAt(const glm::ivec3& world_pos0, const glm::ivec3& world_pos1, undicht::ArenaVector<glm::ivec3>& positions) const {
+
+        collectChunkPositions(world_pos0, world_pos1, positions);
+    }
+
     template<typename T>
     const std::vector<Chunk<T>*>& ChunkSystem<T>::getLoadedChunks() const {
 
@@ -116,6 +127,24 @@ namespace cell {
         return _loaded_chunks.size();
     }
 
+    ////////////////////////////////// protected functions //////////////////////////////////
+
+    template<typename T>
+    template<typename Vector>
+    void ChunkSystem<T>::collectChunkPositions(const glm::ivec3& world_pos0, const glm::ivec3& world_pos1, Vector& positions) const {
+        // adds the positions of all chunks within the volume to the vector
+
+        for(int x = world_pos0.x; x <= world_pos1.x; x += glm::max(1, glm::min(world_pos1.x - x, 255))) {
+            for(int y = world_pos0.y; y <= world_pos1.y; y+= glm::max(1, glm::min(world_pos1.y - y, 255))) {
+                for(int z = world_pos0.z; z <= world_pos1.z; z += glm::max(1, glm::min(world_pos1.z - z, 255))) {
+                    
+                    positions.push_back(calcChunkPosition(glm::ivec3(x, y, z)));
+                }            
+            }
+        }
+
+    }
+
     ////////////////////////////////// static functions functions //////////////////////////////////
 
     template<typename T>
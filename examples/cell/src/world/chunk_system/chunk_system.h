@@ -4,6 +4,7 @@
 #include "cstdint"
 #include "world/chunk_system/chunk.h"
 #include "glm/glm.hpp"
+#include "linear_arena.h"
 
 namespace cell {
 
@@ -37,10 +38,20 @@ namespace cell {
         virtual std::vector<Chunk<T>*> getChunksAt(const glm::ivec3& world_pos0, const glm::ivec3& world_pos1) const;
         virtual std::vector<glm::ivec3> getChunkPositionsAt(const glm::ivec3& world_pos0, const glm::ivec3& world_pos1) const;
 
+        // versions that store their results in a vector allocated from an arena (i.e. the frame arena)
+        void getChunksAt(const glm::ivec3& world_pos0, const glm::ivec3& world_pos1, undicht::ArenaVector<Chunk<T>*>& chunks) const;
+        void getChunkPositionsAt(const glm::ivec3& world_pos0, const glm::ivec3& world_pos1, undicht::ArenaVector<glm::ivec3>& positions) const;
+
         virtual const std::vector<Chunk<T>*>& getLoadedChunks() const;
         virtual const std::vector<glm::ivec3>& getChunkPositions() const; // returns the positions of the loaded chunks
         virtual uint32_t getNumberOfLoadedChunks() const;
 
+      protected:
+
+        // adds the positions of all chunks within the volume to the vector
+        template<typename Vector>
+        void collectChunkPositions(const glm::ivec3& world_pos0, const glm::ivec3& world_pos1, Vector& positions) const;
+
       public:
         // public static functions
 
@@ -1,5 +1,6 @@
 #include "world/drawable_world.h"
 #include "debug.h"
+#include "alloc_tracker.h"
 #include "glm/gtx/string_cast.hpp"
 #include "algorithm"
 #include "core/vulkan/command_buffer.h"
@@ -59,6 +60,7 @@ namespace cell {
     }
 
     void DrawableWorld::applyUpdates(undicht::vulkan::CommandBuffer& load_cmd, undicht::vulkan::TransferBuffer& load_buf) {
+        UND_ALLOC_TAG(undicht::AllocTag::WORLD);
 
         _cell_world.applyUpdates(load_cmd, load_buf);
         _light_world.applyUpdates(load_cmd, load_buf);
@@ -1,6 +1,7 @@
 #include "chunk_edit.h"
 #include "debug.h"
 #include "vector"
+#include "linear_arena.h"
 
 #include "math/math_tools.h"
 
@@ -24,7 +25,9 @@ namespace cell {
     void ChunkEdit::subtract(CellChunk& chunk, const Cell& volume) {
 
         // get the cells that will be effected by the subtraction
-        std::vector<uint32_t> affected_cells = chunk.getCellIDsInVolume(volume);
+        ArenaScope scope(FrameArena::get());
+        ArenaVector<uint32_t> affected_cells(scope.getArena());
+        chunk.getCellIDsInVolume(volume, affected_cells);
 
         // subtract the volume from each of the cells
         for(uint32_t id : affected_cells) {
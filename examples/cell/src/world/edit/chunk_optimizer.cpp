@@ -1,4 +1,5 @@
 #include <world/edit/chunk_optimizer.h>
+#include "profiler.h"
 
 namespace cell {
 
@@ -16,6 +17,7 @@ namespace cell {
 
     void ChunkOptimizer::optimizeChunk(CellChunk old_chunk, CellChunk* optimized) {
         /** tries to minimize the number of cells in the chunk */
+        UND_PROFILE_SCOPE("ChunkOptimizer::optimizeChunk");
 
         CellChunk& chunk = *optimized;
 
@@ -1,5 +1,7 @@
 #include "world_edit.h"
 #include "debug.h"
+#include "linear_arena.h"
+#include "alloc_tracker.h"
 
 namespace cell {
 
@@ -7,10 +9,15 @@ namespace cell {
 
     void WorldEdit::place(CellWorld& world, const glm::ivec3& pos0, const glm::ivec3& pos1, uint32_t material) {
         /// @brief fills the volume defined by pos0 and pos1
+        UND_ALLOC_TAG(AllocTag::WORLD);
 
         // get the chunks that are affected 
-        std::vector<Chunk<Cell>*> chunks = world.getChunksAt(pos0, pos1);
-        std::vector<glm::ivec3> positions = world.getChunkPositionsAt(pos0, pos1);
+        // (the vectors only live until the end of the edit, so their memory is taken from the frame arena)
+        ArenaScope scope(FrameArena::get());
+        ArenaVector<Chunk<Cell>*> chunks(scope.getArena());
+        ArenaVector<glm::ivec3> positions(scope.getArena());
+        world.getChunksAt(pos0, pos1, chunks);
+        world.getChunkPositionsAt(pos0, pos1, positions);
 
         // editing each of the chunks
         for(int i = 0; i < chunks.size(); i++) {
@@ -34,10 +41,15 @@ namespace cell {
 
     void WorldEdit::remove(CellWorld& world, const glm::ivec3& pos0, const glm::ivec3& pos1) {
         /// @brief removes all cells within the volume
+        UND_ALLOC_TAG(AllocTag::WORLD);
 
         // get the chunks that are affected
-        std::vector<Chunk<Cell>*> chunks = world.getChunksAt(pos0, pos1);
-        std::vector<glm::ivec3> positions = world.getChunkPositionsAt(pos0, pos1);
+        // (the vectors only live until the end of the edit, so their memory is taken from the frame arena)
+        ArenaScope scope(FrameArena::get());
+        ArenaVector<Chunk<Cell>*> chunks(scope.getArena());
+        ArenaVector<glm::ivec3> positions(scope.getArena());
+        world.getChunksAt(pos0, pos1, chunks);
+        world.getChunkPositionsAt(pos0, pos1, positions);
 
         // editing each of the chunks
         for(int i = 0; i < chunks.size(); i++) {
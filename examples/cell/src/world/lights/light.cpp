@@ -1,4 +1,6 @@
 #include "world/lights/light.h"
+#include "type_traits"
+#include "cstddef"
 
 namespace cell {
 
@@ -7,11 +9,31 @@ namespace cell {
     // vec3: position
     // vec3: color
     // float: range
-    const BufferLayout POINT_LIGHT_LAYOUT({UND_UINT32, UND_VEC3F, UND_VEC3F, UND_FLOAT32});
+    const BufferLayout POINT_LIGHT_LAYOUT = PointLightLayout::getLayout();
 
     // vec3: direction
     // vec3: color
-    const BufferLayout DIRECT_LIGHT_LAYOUT({UND_UINT32, UND_VEC3F, UND_VEC3F});
+    const BufferLayout DIRECT_LIGHT_LAYOUT = DirectLightLayout::getLayout();
+
+    static_assert(sizeof(Light) == PointLightLayout::SIZE, "the Light class does not match the PointLightLayout");
+    static_assert(alignof(Light) >= PointLightLayout::ALIGNMENT, "the Light class is less aligned than the PointLightLayout requires");
+    static_assert(PointLightLayout::SIZE % alignof(Light) == 0, "arrays of Lights dont have the stride of the PointLightLayout");
+    static_assert(std::is_standard_layout<Light>::value, "the Light class has to be a standard layout type");
+
+    void Light::checkLayout() {
+        // static_asserts that the members match the PointLightLayout / DirectLightLayout (never called)
+        // (inside a member function, so that the protected members can be accessed)
+
+        static_assert(offsetof(Light, _type) == PointLightLayout::getOffset(0), "Light::_type does not match the PointLightLayout");
+        static_assert(offsetof(Light, _pos_or_dir) == PointLightLayout::getOffset(1), "Light::_pos_or_dir does not match the PointLightLayout");
+        static_assert(offsetof(Light, _color) == PointLightLayout::getOffset(2), "Light::_color does not match the PointLightLayout");
+        static_assert(offsetof(Light, _range) == PointLightLayout::getOffset(3), "Light::_range does not match the PointLightLayout");
+
+        // directional lights use the beginning of the same data
+        static_assert(offsetof(Light, _type) == DirectLightLayout::getOffset(0), "Light::_type does not match the DirectLightLayout");
+        static_assert(offsetof(Light, _pos_or_dir) == DirectLightLayout::getOffset(1), "Light::_pos_or_dir does not match the DirectLightLayout");
+        static_assert(offsetof(Light, _color) == DirectLightLayout::getOffset(2), "Light::_color does not match the DirectLightLayout");
+    }
 
     Light::Light(Type type) {
 
@@ -96,9 +118,9 @@ namespace cell {
         }
 
         if(_type == Point)
-            return 7 * sizeof(float) + sizeof(uint32_t);
+            return PointLightLayout::SIZE;
         else 
-            return 6 * sizeof(float) + sizeof(uint32_t);
+            return DirectLightLayout::SIZE;
     }
 
     uint32_t Light::loadFromData(const char* buffer) {
@@ -129,9 +151,9 @@ namespace cell {
         }
 
         if(_type == Point)
-            return 7 * sizeof(float) + sizeof(uint32_t);
+            return PointLightLayout::SIZE;
         else 
-            return 6 * sizeof(float) + sizeof(uint32_t);
+            return DirectLightLayout::SIZE;
     }
 
 } // cell
\ No newline at end of file
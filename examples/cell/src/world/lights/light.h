@@ -3,9 +3,16 @@
 
 #include "glm/glm.hpp"
 #include "buffer_layout.h"
+#include "static_buffer_layout.h"
 
 namespace cell {
 
+    // type, position, color, range (has to match the members of Light)
+    typedef undicht::StaticBufferLayout<undicht::LayoutPacking::PACKED, UND_STATIC_UINT32, UND_STATIC_VEC3F, UND_STATIC_VEC3F, UND_STATIC_FLOAT32> PointLightLayout;
+
+    // type, direction, color
+    typedef undicht::StaticBufferLayout<undicht::LayoutPacking::PACKED, UND_STATIC_UINT32, UND_STATIC_VEC3F, UND_STATIC_VEC3F> DirectLightLayout;
+
     const extern undicht::BufferLayout POINT_LIGHT_LAYOUT;
     const extern undicht::BufferLayout DIRECT_LIGHT_LAYOUT;
 
@@ -53,6 +60,11 @@ namespace cell {
         /// @return the number of bytes used
         uint32_t loadFromData(const char* buffer);
 
+      protected:
+
+        // static_asserts that the members match the PointLightLayout / DirectLightLayout (never called)
+        static void checkLayout();
+
     };
 
 } // cell
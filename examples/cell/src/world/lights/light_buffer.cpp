@@ -1,5 +1,5 @@
 #include "light_buffer.h"
-#include "model_loading/obj/obj_file.h"
+#include "model_loading/cooked_mesh_file.h"
 #include "file_tools.h"
 
 namespace cell {
@@ -13,10 +13,10 @@ namespace cell {
 
         ChunkBuffer<Light>::init(device);
 
-        // load the point light model
+        // load the point light model (from the cooked file, the obj file only gets parsed when it changed)
         MeshData sphere_data;
-        OBJFile obj_file(UND_ENGINE_SOURCE_DIR + "examples/cell/res/entities/sphere.obj");
-        obj_file.getMesh(sphere_data, 0, true, false, false);
+        CookedMeshFile mesh_file(UND_ENGINE_SOURCE_DIR + "examples/cell/res/entities/sphere.obj");
+        mesh_file.getMesh(sphere_data, 0, true, false, false);
 
         setBaseModel(sphere_data.vertices, load_cmd, load_buf);
 
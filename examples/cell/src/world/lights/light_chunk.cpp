@@ -32,7 +32,7 @@ namespace cell {
     uint32_t LightChunk::fillBuffer(char* buffer) const {
         // store the contents of the chunk in the buffer (if buffer != nullptr), return size of elements stored
 
-        uint32_t light_size = POINT_LIGHT_LAYOUT.getTotalSize();
+        uint32_t light_size = PointLightLayout::SIZE;
 
         if(buffer != nullptr) {
 
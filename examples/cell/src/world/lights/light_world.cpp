@@ -1,11 +1,12 @@
 #include "world/lights/light_world.h"
+#include "profiler.h"
 
 namespace cell {
 
     void LightWorld::init(const undicht::vulkan::LogicalDevice& device, undicht::vulkan::CommandBuffer& load_cmd, undicht::vulkan::TransferBuffer& load_buf) {
 
         _buffer.init(device, load_cmd, load_buf);
-        _buffer.allocate(1000 * POINT_LIGHT_LAYOUT.getTotalSize());
+        _buffer.allocate(1000 * PointLightLayout::SIZE);
 
     }
     
@@ -18,6 +19,7 @@ namespace cell {
         /** updates the vulkan buffer with the changes made since the last call to applyUpdates() 
         * @param load_cmd records the commands necessary to move the data from the transfer buffer to the internal vulkan buffer 
         * @param load_buf used as a staging buffer to transfer data to memory that is not directly visible to the cpu */
+        UND_PROFILE_SCOPE("LightWorld::applyUpdates");
 
         // make sure each chunk is correctly stored in the buffer
         for(int i = 0; i < getLoadedChunks().size(); i++) {
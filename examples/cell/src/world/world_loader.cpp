@@ -1,8 +1,16 @@
 #include "world/world_loader.h"
 #include "debug.h"
+#include "profiler.h"
+#include "alloc_tracker.h"
 
 namespace cell {
 
+    WorldLoader::ChunkBatch::~ChunkBatch() {
+        // waits for the read job, which writes to the requests and chunks of the batch
+
+        undicht::JobSystem::waitFor(counter);
+    }
+
     void WorldLoader::init() {
 
         _env_gen.init();
@@ -10,6 +18,20 @@ namespace cell {
 
     void WorldLoader::cleanUp() {
 
+        if(_loading_chunks) {
+            // the chunks that were still being read are not needed anymore
+            // (the batch waits for the read job in its destructor, but the chunks are deleted before that)
+            undicht::JobSystem::waitFor(_loading_chunks->counter);
+
+            for(CellChunk* chunk : _loading_chunks->cell_chunks)
+                delete chunk;
+
+            for(LightChunk* chunk : _loading_chunks->light_chunks)
+                delete chunk;
+
+            _loading_chunks.reset();
+        }
+
         _env_gen.cleanUp();
         //_world.cleanUp();
     }
@@ -37,7 +59,16 @@ namespace cell {
 
     void WorldLoader::loadChunks(const glm::vec3& player_pos, DrawableWorld& world, int32_t chunk_distance) {
         /** @brief load the missing chunks around the player */
+        UND_PROFILE_SCOPE("WorldLoader::loadChunks");
+        UND_ALLOC_TAG(undicht::AllocTag::WORLD);
         
+        // adding the chunks that were read in the background
+        if(_loading_chunks && _loading_chunks->counter.isDone())
+            finishLoading(world);
+
+        if(_loading_chunks)
+            return; // still reading the last batch
+
         // calculating the chunk positions of the chunks that should be loaded
         std::vector<glm::ivec3> chunk_positions;
         glm::ivec3 player_chunk = ChunkSystem<Cell>::calcChunkPosition(glm::ivec3(player_pos));
@@ -51,41 +82,95 @@ namespace cell {
             }
         }
 
-        // loading currently unloaded chunks
-        bool update_cell_buffer = false;
-        bool update_light_buffer = false;
-        for(glm::ivec3& chunk_pos : chunk_positions) {
-            
-            // cell chunk
-            if(!world.getCellWorld().getChunkAt(chunk_pos)) {
+        // reading currently unloaded chunks (all in one batch)
+        std::unique_ptr<ChunkBatch> batch(new ChunkBatch);
 
-                update_cell_buffer = true;
+        for(glm::ivec3& chunk_pos : chunk_positions) {
 
-                CellChunk* new_chunk = new CellChunk; // gets deleted by the cell world
+            CellChunk* cell_chunk = nullptr;
+            LightChunk* light_chunk = nullptr;
 
-                if(!_world_file.read(*new_chunk, chunk_pos)) // reading the chunk from the file
-                    ; // new_chunk->addCell(Cell(0, 250, 0, 255, 255, 255, 0)); // generate new chunk
+            // cell chunk
+            if(!world.getCellWorld().getChunkAt(chunk_pos)) {
 
-                UND_LOG << "loaded chunk at: " << chunk_pos.x << " : " << chunk_pos.y << " : " << chunk_pos.z << "\n";
-                world.getCellWorld().loadChunk(chunk_pos, new_chunk);
+                cell_chunk = new CellChunk; // gets deleted by the cell world
 
+                if(!_world_file.addReadRequest(*cell_chunk, chunk_pos, batch->requests))
+                    ; // cell_chunk->addCell(Cell(0, 250, 0, 255, 255, 255, 0)); // generate new chunk
             }
 
             // light chunk
             if(!world.getLightWorld().getChunkAt(chunk_pos)) {
 
-                update_light_buffer = true;
-                LightChunk* new_chunk = new LightChunk; // gets deleted by the light world
+                light_chunk = new LightChunk; // gets deleted by the light world
 
-                if(!_world_file.read(*new_chunk, chunk_pos)) // readin the chunk from the file
+                if(!_world_file.addReadRequest(*light_chunk, chunk_pos, batch->requests))
                     ; // generate new chunk
+            }
 
-                world.getLightWorld().loadChunk(chunk_pos, new_chunk);
+            if(cell_chunk || light_chunk) {
+                batch->chunk_positions.push_back(chunk_pos);
+                batch->cell_chunks.push_back(cell_chunk);
+                batch->light_chunks.push_back(light_chunk);
+            }
 
+        }
+
+        if(batch->chunk_positions.empty())
+            return;
+
+        _loading_chunks = std::move(batch);
+        _world_file.readAsync(_loading_chunks->requests, _loading_chunks->counter);
+    }
+
+    bool WorldLoader::compactWorldFile(size_t max_bytes) {
+        /** @brief compacts the chunk file of the world a bit more with every call (see WorldFile::beginCompaction())
+         * a compaction is only started if enough space in the chunk file is unused (see CELL_COMPACTION_MIN_UNUSED_SIZE)
+         * and only finished while no chunks are being read
+         * @param max_bytes the number of bytes to copy per call
+         * @return true once the compaction is complete or if no compaction is needed */
+        UND_PROFILE_SCOPE("WorldLoader::compactWorldFile");
+        UND_ALLOC_TAG(undicht::AllocTag::IO);
+
+        if(!_world_file.isCompacting()) {
+
+            size_t unused_size = _world_file.getChunkFileUnusedSize();
+            if((unused_size < CELL_COMPACTION_MIN_UNUSED_SIZE) || (unused_size < _world_file.getChunkFileSize() / 4))
+                return true;
+
+            _world_file.beginCompaction();
+        }
+
+        if(!_world_file.continueCompaction(max_bytes))
+            return false;
+
+        // the chunk file gets closed and reopened
+        if(_loading_chunks)
+            return false;
+
+        _world_file.finishCompaction();
+
+        return true;
+    }
+
+    void WorldLoader::finishLoading(DrawableWorld& world) {
+        // adds the chunks of the batch to the world
+
+        for(size_t i = 0; i < _loading_chunks->chunk_positions.size(); i++) {
+
+            const glm::ivec3& chunk_pos = _loading_chunks->chunk_positions.at(i);
+
+            if(_loading_chunks->cell_chunks.at(i)) {
+                UND_LOG_CAT(WORLD) << "loaded chunk at: " << chunk_pos.x << " : " << chunk_pos.y << " : " << chunk_pos.z << "\n";
+                world.getCellWorld().loadChunk(chunk_pos, _loading_chunks->cell_chunks.at(i));
             }
 
+            if(_loading_chunks->light_chunks.at(i))
+                world.getLightWorld().loadChunk(chunk_pos, _loading_chunks->light_chunks.at(i));
+
         }
 
+        _loading_chunks.reset();
     }
 
 } // cell
\ No newline at end of file
@@ -6,6 +6,13 @@
 #include "environment/environment_generator.h"
 #include "glm/glm.hpp"
 #include "core/vulkan/fence.h"
+#include "job_system.h"
+#include "memory"
+
+// the chunk file of the world gets compacted once this many bytes (and at least a quarter of the file) are unused
+#ifndef CELL_COMPACTION_MIN_UNUSED_SIZE
+#define CELL_COMPACTION_MIN_UNUSED_SIZE (4 * 1024 * 1024)
+#endif
 
 namespace cell {
 
@@ -16,6 +23,24 @@ namespace cell {
         WorldFile _world_file;
         EnvironmentGenerator _env_gen;
 
+        struct ChunkBatch {
+            // chunks that are read from the world file in the background
+
+            std::vector<glm::ivec3> chunk_positions;
+            std::vector<CellChunk*> cell_chunks; // nullptr if the chunk is already loaded
+            std::vector<LightChunk*> light_chunks;
+
+            std::vector<ChunkFile::ReadRequest> requests;
+            undicht::JobCounter counter;
+
+            // waits for the read job, which writes to the requests and chunks of the batch
+            ~ChunkBatch();
+        };
+
+        // only one batch is read at a time
+        // (declared after _world_file, so that the read job is finished before the file gets closed)
+        std::unique_ptr<ChunkBatch> _loading_chunks;
+
       public:
 
         void init();
@@ -30,10 +55,22 @@ namespace cell {
         void updateEnvironment(DrawableWorld& world, undicht::vulkan::CommandBuffer& load_cmd, undicht::vulkan::TransferBuffer& load_buf);
 
         /** @brief load the missing chunks around the player 
-         * @param prev_frame_finished the fence will be waited on if vulkan buffers are modified
-        */
+         * the chunks are read in the background, they get added to the world by one of the next calls
+         * once reading them has finished */
         void loadChunks(const glm::vec3& player_pos, DrawableWorld& world, int32_t chunk_distance);  
 
+        /** @brief compacts the chunk file of the world a bit more with every call (see WorldFile::beginCompaction())
+         * a compaction is only started if enough space in the chunk file is unused (see CELL_COMPACTION_MIN_UNUSED_SIZE)
+         * and only finished while no chunks are being read
+         * @param max_bytes the number of bytes to copy per call
+         * @return true once the compaction is complete or if no compaction is needed */
+        bool compactWorldFile(size_t max_bytes);
+
+      protected:
+
+        // adds the chunks of the batch to the world
+        void finishLoading(DrawableWorld& world);
+
     };
 
 } // cell
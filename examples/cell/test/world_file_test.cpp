@@ -0,0 +1,304 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "logger.h"
+#include "job_system.h"
+#include "files/world_file.h"
+
+// round trip test for storing chunks in a world file and compacting its chunk file:
+// writes chunks, overwrites some of them, compacts the file (while writing more chunks), reopens it and compares every chunk
+// also checks that open() completes a compaction that was interrupted while the files were replaced
+// and that world files written by older versions (without the end tag of the root element) still open
+
+using namespace undicht;
+using namespace cell;
+
+const std::string WORLD_FILE = "./cell_test_world.world";
+const std::string CHUNK_FILE = "./cell_test_world.chunk";
+
+const std::vector<std::string> TEST_FILES = {
+    WORLD_FILE, WORLD_FILE + ".journal", WORLD_FILE + ".compact", WORLD_FILE + ".compact.journal", WORLD_FILE + ".backup", WORLD_FILE + ".journal.backup",
+    CHUNK_FILE, CHUNK_FILE + ".index", CHUNK_FILE + ".compact", CHUNK_FILE + ".compact.index", CHUNK_FILE + ".backup",
+};
+
+///////////////////////////////////////// helper functions /////////////////////////////////////////
+
+static std::mt19937 random_generator(42);
+
+static uint32_t random(uint32_t min, uint32_t max) {
+
+    return min + random_generator() % (max - min + 1);
+}
+
+static void fillChunk(CellChunk& chunk, uint32_t cell_count) {
+    // cells next to each other in a 16 * 16 grid, with random heights and materials
+
+    for(uint32_t i = 0; i < cell_count; i++) {
+        uint32_t x = (i % 16) * 15;
+        uint32_t z = (i / 16 % 16) * 15;
+        chunk.addCell(Cell(x, 0, z, x + 15, random(1, 255), z + 15, random(0, 100)));
+    }
+
+}
+
+static void fillChunk(LightChunk& chunk, uint32_t light_count) {
+
+    for(uint32_t i = 0; i < light_count; i++)
+        chunk.addLight(Light(Light::Point, glm::vec3(random(0, 255), random(0, 255), random(0, 255)), glm::vec3(1.0f, 0.5f, 0.25f)));
+
+}
+
+template<typename T>
+static std::vector<char> getChunkData(const Chunk<T>& chunk) {
+
+    std::vector<char> data(chunk.fillBuffer(nullptr));
+    chunk.fillBuffer(data.data());
+
+    return data;
+}
+
+static bool copyFile(const std::string& from, const std::string& to) {
+
+    std::ifstream in(from, std::ios::binary);
+    if(!in.is_open()) return false;
+
+    std::ofstream out(to, std::ios::binary | std::ios::trunc);
+    out << in.rdbuf();
+
+    return out.good();
+}
+
+static void removeTestFiles() {
+
+    for(const std::string& file : TEST_FILES)
+        std::remove(file.c_str());
+}
+
+static bool createEmptyWorld() {
+
+    std::ofstream world(WORLD_FILE, std::ios::trunc);
+    world << "<WORLD_FILE version=0.0.2>\n<WORLD></WORLD>\n<LIGHTS></LIGHTS>\n<MATERIALS></MATERIALS>\n<ENVIRONMENT></ENVIRONMENT>\n</WORLD_FILE>\n";
+    world.close();
+
+    std::ofstream chunks(CHUNK_FILE, std::ios::binary | std::ios::trunc);
+    chunks.close();
+
+    return world.good() && chunks.good();
+}
+
+///////////////////////////////////////// the expected content of the world /////////////////////////////////////////
+
+struct ExpectedChunks {
+
+    std::map<std::string, glm::ivec3> positions;
+    std::map<std::string, std::vector<char>> cell_chunks;
+    std::map<std::string, std::vector<char>> light_chunks;
+};
+
+static std::string getKey(const glm::ivec3& chunk_pos) {
+
+    return std::to_string(chunk_pos.x) + "_" + std::to_string(chunk_pos.y) + "_" + std::to_string(chunk_pos.z);
+}
+
+static void writeChunk(WorldFile& world, ExpectedChunks& expected, const glm::ivec3& chunk_pos, uint32_t cell_count) {
+
+    CellChunk cell_chunk;
+    fillChunk(cell_chunk, cell_count);
+    world.write(cell_chunk, chunk_pos);
+
+    LightChunk light_chunk;
+    fillChunk(light_chunk, cell_count / 8 + 1);
+    world.write(light_chunk, chunk_pos);
+
+    std::string key = getKey(chunk_pos);
+    expected.positions[key] = chunk_pos;
+    expected.cell_chunks[key] = getChunkData(cell_chunk);
+    expected.light_chunks[key] = getChunkData(light_chunk);
+}
+
+static void compareChunks(WorldFile& world, const ExpectedChunks& expected) {
+
+    for(const std::pair<const std::string, glm::ivec3>& position : expected.positions) {
+
+        CellChunk cell_chunk;
+        CHECK(world.read(cell_chunk, position.second));
+        CHECK(getChunkData(cell_chunk) == expected.cell_chunks.at(position.first));
+
+        LightChunk light_chunk;
+        CHECK(world.read(light_chunk, position.second));
+        CHECK(getChunkData(light_chunk) == expected.light_chunks.at(position.first));
+    }
+
+}
+
+///////////////////////////////////////// tests /////////////////////////////////////////
+
+static void testMissingRootEndTag() {
+
+    // older versions didnt write the end tag of the root element
+    {
+        std::ofstream world(WORLD_FILE, std::ios::trunc);
+        world << "<WORLD_FILE version=0.0.2>\n<WORLD></WORLD>\n<LIGHTS></LIGHTS>\n<MATERIALS></MATERIALS>\n<ENVIRONMENT></ENVIRONMENT>\n";
+        std::ofstream chunks(CHUNK_FILE, std::ios::binary | std::ios::trunc);
+    }
+
+    {
+        WorldFile world;
+        CHECK(world.open(WORLD_FILE));
+    }
+
+    // a file that ends inside of an element below the root is truncated
+    {
+        std::ofstream world(WORLD_FILE, std::ios::trunc);
+        world << "<WORLD_FILE version=0.0.2>\n<WORLD>\n<CHUNK chunk_pos=0_0_0>0</CHUNK>\n";
+    }
+
+    {
+        WorldFile world;
+        CHECK(!world.open(WORLD_FILE));
+    }
+
+}
+
+static void testCompaction(ExpectedChunks& expected) {
+
+    WorldFile world;
+    CHECK(world.open(WORLD_FILE));
+
+    // writing the chunks
+    std::vector<glm::ivec3> positions;
+    for(int32_t x = -3; x <= 3; x++)
+        for(int32_t z = -3; z <= 3; z++)
+            positions.push_back(glm::ivec3(x * 255, 0, z * 255));
+
+    for(const glm::ivec3& chunk_pos : positions)
+        writeChunk(world, expected, chunk_pos, random(10, 200));
+
+    // overwriting some of them with bigger chunks (so that they cant stay where they are)
+    for(uint32_t i = 0; i < positions.size(); i += 3)
+        writeChunk(world, expected, positions.at(i), 256);
+
+    compareChunks(world, expected);
+    CHECK(world.getChunkFileUnusedSize() > 0);
+
+    size_t old_size = world.getChunkFileSize();
+
+    // compacting in small steps, chunks get written in between (before and after they were copied)
+    world.beginCompaction();
+    CHECK(world.isCompacting());
+
+    uint32_t steps = 0;
+    while(!world.continueCompaction(4096)) {
+
+        if(steps % 4 == 0) writeChunk(world, expected, positions.at(random(0, positions.size() - 1)), random(10, 256));
+        if(steps % 7 == 0) writeChunk(world, expected, glm::ivec3(steps * 255, 255, 0), random(10, 100)); // new chunk
+
+        steps++;
+    }
+
+    CHECK(steps > 1);
+
+    // the chunks written after the last step have to be copied by finishCompaction()
+    writeChunk(world, expected, positions.front(), 256);
+    writeChunk(world, expected, positions.back(), 10);
+
+    size_t reclaimed = world.finishCompaction();
+    CHECK(!world.isCompacting());
+    CHECK(reclaimed > 0);
+    CHECK(world.getChunkFileSize() < old_size);
+
+    // the old copies of the chunks written at the end got reused (only the chunk that grew leaves a hole)
+    CHECK(world.getChunkFileUnusedSize() < world.getChunkFileSize() / 8);
+
+    compareChunks(world, expected);
+
+    // nothing is left over from the compaction
+    CHECK(!std::ifstream(WORLD_FILE + ".compact").is_open());
+    CHECK(!std::ifstream(CHUNK_FILE + ".compact").is_open());
+}
+
+static void testReopen(const ExpectedChunks& expected) {
+
+    WorldFile world;
+    CHECK(world.open(WORLD_FILE));
+    compareChunks(world, expected);
+}
+
+static void testInterruptedCompaction(ExpectedChunks& expected) {
+
+    // some unused space for the compaction to reclaim
+    {
+        WorldFile world;
+        CHECK(world.open(WORLD_FILE));
+
+        for(const std::pair<const std::string, glm::ivec3>& position : std::map<std::string, glm::ivec3>(expected.positions))
+            if(random(0, 1))
+                writeChunk(world, expected, position.second, random(10, 256));
+    }
+
+    // keeping the files from before the compaction
+    CHECK(copyFile(WORLD_FILE, WORLD_FILE + ".backup"));
+    bool has_journal = copyFile(WORLD_FILE + ".journal", WORLD_FILE + ".journal.backup");
+    CHECK(copyFile(CHUNK_FILE, CHUNK_FILE + ".backup"));
+
+    {
+        WorldFile world;
+        CHECK(world.open(WORLD_FILE));
+        CHECK(world.compactChunkFile() > 0);
+    }
+
+    // the state in which the program stopped after the compacted world file was written, but before any file was replaced
+    CHECK(!std::rename(WORLD_FILE.c_str(), (WORLD_FILE + ".compact").c_str()));
+    CHECK(!std::rename(CHUNK_FILE.c_str(), (CHUNK_FILE + ".compact").c_str()));
+    CHECK(!std::rename((CHUNK_FILE + ".index").c_str(), (CHUNK_FILE + ".compact.index").c_str()));
+    CHECK(!std::rename((WORLD_FILE + ".backup").c_str(), WORLD_FILE.c_str()));
+    CHECK(!std::rename((CHUNK_FILE + ".backup").c_str(), CHUNK_FILE.c_str()));
+    if(has_journal) CHECK(!std::rename((WORLD_FILE + ".journal.backup").c_str(), (WORLD_FILE + ".journal").c_str()));
+
+    // open() has to complete the compaction
+    testReopen(expected);
+    CHECK(!std::ifstream(WORLD_FILE + ".compact").is_open());
+    CHECK(!std::ifstream(CHUNK_FILE + ".compact").is_open());
+
+    // a compacted chunk file without the compacted world file belongs to a compaction that wasnt completed
+    CHECK(copyFile(CHUNK_FILE, CHUNK_FILE + ".compact"));
+    {
+        std::ofstream(CHUNK_FILE + ".compact", std::ios::binary | std::ios::app) << "garbage";
+    }
+
+    testReopen(expected);
+    CHECK(!std::ifstream(CHUNK_FILE + ".compact").is_open());
+}
+
+int main() {
+
+    // the world file logs every compaction
+    Logger::setMinLevel(UND_LOG_LEVEL_WARNING);
+    JobSystem::init(1);
+
+    removeTestFiles();
+    testMissingRootEndTag();
+    removeTestFiles();
+
+    if(!createEmptyWorld()) {
+        std::cerr << "failed to create the test world\n";
+        return 1;
+    }
+
+    ExpectedChunks expected;
+    testCompaction(expected);
+    testReopen(expected);
+    testInterruptedCompaction(expected);
+
+    removeTestFiles();
+
+    JobSystem::cleanUp();
+    Logger::flush();
+
+    return reportChecks();
+}
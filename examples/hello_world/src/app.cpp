@@ -103,9 +103,12 @@ void HelloWorldApp::mainLoop() {
 
             if(!_model._vertex_count.at(i)) continue;
 
+            const Texture* texture = _model._textures.get(_model._texture_ids.at(i));
+            if(!texture) continue;
+
             _renderer.accquireDescriptorSet(0);
             _renderer.bindUniformBuffer(0, 0, _uniform_buffer.getBuffer());
-            _renderer.bindImage(0 , 1, _model._textures[_model._texture_ids[i]].getImage().getImageView(), _model._textures[_model._texture_ids[i]].getLayout(), _sampler.getSampler());
+            _renderer.bindImage(0 , 1, texture->getImage().getImageView(), texture->getLayout(), _sampler.getSampler());
             _renderer.bindDescriptorSet(getDrawCmd(), 0);
 
             _renderer.bindVertexBuffer(getDrawCmd(), _model._vertex_buffers.at(i));
@@ -172,8 +175,14 @@ void HelloWorldApp::loadModel(const std::string& file_name, TexturedModel& loadT
         undicht::vulkan::Texture t;
         t.setMipMaps(true);
         loadTexture(data, t, transfer_cmd, transfer_buffer);
-        _model._textures.push_back(t);
 
+        undicht::Handle handle = _model._textures.insert(t);
+        if(handle.isNull()) {
+            UND_ERROR << "failed to store texture: the model has more than " << HELLO_WORLD_MAX_TEXTURES << " textures\n";
+            t.cleanUp();
+        }
+
+        _model._loaded_textures.push_back(handle);
     }
 
     // loading the meshes
@@ -182,7 +191,11 @@ void HelloWorldApp::loadModel(const std::string& file_name, TexturedModel& loadT
         undicht::vulkan::VertexBuffer t;
         loadMesh(data, t, transfer_cmd, transfer_buffer);
         _model._vertex_buffers.push_back(t);
-        _model._texture_ids.push_back(data.color_texture);
+        // meshes without a texture (color_texture is -1) get a null handle and are not drawn
+        if((data.color_texture >= 0) && (size_t(data.color_texture) < _model._loaded_textures.size()))
+            _model._texture_ids.push_back(_model._loaded_textures.at(data.color_texture));
+        else
+            _model._texture_ids.push_back(undicht::Handle());
         _model._vertex_count.push_back(data.vertices.size() / 8);
     }
 
@@ -12,20 +12,37 @@
 #include "model_loading/model_loader.h"
 #include "renderer/vulkan/uniform_buffer.h"
 #include "3D/camera/perspective_camera_3d.h"
+#include "slot_map.h"
+
+// the number of textures a model can have
+#ifndef HELLO_WORLD_MAX_TEXTURES
+#define HELLO_WORLD_MAX_TEXTURES 256
+#endif
 
 class TexturedModel {
 
 public:
 
-    std::vector<undicht::vulkan::Texture> _textures;
+    // the vertex buffers reference their texture through a handle,
+    // so a texture that was removed (or whose slot got reused) is never bound by accident
+    undicht::SlotMap<undicht::vulkan::Texture> _textures{HELLO_WORLD_MAX_TEXTURES};
+    std::vector<undicht::Handle> _loaded_textures; // in the order of the model file (null if the texture couldnt be stored)
     std::vector<undicht::vulkan::VertexBuffer> _vertex_buffers;
-    std::vector<uint32_t> _texture_ids; // which texture is used by which vertex buffer
+    std::vector<undicht::Handle> _texture_ids; // which texture is used by which vertex buffer
     std::vector<uint32_t> _vertex_count;
 
     void cleanUp() {
 
-        for(auto& t : _textures)
-            t.cleanUp();
+        for(const undicht::Handle& handle : _loaded_textures) {
+            if(undicht::vulkan::Texture* t = _textures.get(handle)) {
+                t->cleanUp();
+                _textures.remove(handle);
+            }
+        }
+
+        // the gpu has finished using the textures at this point
+        _textures.collect();
+        _loaded_textures.clear();
 
         for(auto& t : _vertex_buffers)
             t.cleanUp();
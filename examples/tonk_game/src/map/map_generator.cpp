@@ -28,8 +28,8 @@ namespace tonk {
             x = i % _width;
             y = i / _width;
 
-            std::vector<std::pair<uint32_t, float>> props = calcPropabilities(x, y, tile_set, map);
-            map.setTile(chooseTile(props, tile_set.getTileCount()), x, y, tile_map);
+            calcPropabilities(x, y, tile_set, map, _propabilities);
+            map.setTile(chooseTile(_propabilities, tile_set.getTileCount()), x, y, tile_map);
             
         }
 
@@ -37,9 +37,9 @@ namespace tonk {
         return true;
     }
 
-    std::vector<std::pair<uint32_t, float>> MapGenerator::calcPropabilities(int x, int y, const TileSet& tile_set, const Map& map) {
+    void MapGenerator::calcPropabilities(int x, int y, const TileSet& tile_set, const Map& map, std::vector<std::pair<uint32_t, float>>& propabilities) {
 
-        std::vector<std::pair<uint32_t, float>> propabilities;
+        propabilities.clear();
 
         for(int i = TONK_X_POSITIVE; i <= TONK_Y_NEGATIVE; i++) {
             
@@ -51,18 +51,18 @@ namespace tonk {
             const Tile* neighbour = tile_set.getTile(map.getTile(x_neighbour, y_neighbour));
             if(!neighbour) continue;
 
-            std::vector<std::pair<uint32_t, float>> additional_propabilities = neighbour->getPossibleNeighbours(i);
+            neighbour->getPossibleNeighbours(i, _additional_propabilities);
 
-            if(!propabilities.size() && additional_propabilities.size()) {
+            if(!propabilities.size() && _additional_propabilities.size()) {
 
-                propabilities = additional_propabilities;
+                propabilities = _additional_propabilities;
                 
-            } else if(additional_propabilities.size()) {
+            } else if(_additional_propabilities.size()) {
                 
                 for(std::pair<uint32_t, float>& prop : propabilities) {
                     
                     float multiplier = 0.0f;
-                    for(std::pair<uint32_t, float>& ap : additional_propabilities)
+                    for(std::pair<uint32_t, float>& ap : _additional_propabilities)
                         if(ap.first == prop.first) {
                             multiplier = ap.second;
                             break;
@@ -75,7 +75,6 @@ namespace tonk {
 
         }
 
-        return propabilities;
     }
 
     uint32_t MapGenerator::chooseTile(const std::vector<std::pair<uint32_t, float>>& propabilities, uint32_t total_tile_count) {
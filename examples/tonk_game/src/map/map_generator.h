@@ -14,6 +14,9 @@ namespace tonk {
         uint32_t _width = 40;
         uint32_t _height = 25;
 
+        // reused for every tile, so that generating the map doesnt allocate memory for each tile
+        std::vector<std::pair<uint32_t, float>> _propabilities;
+        std::vector<std::pair<uint32_t, float>> _additional_propabilities;
 
     public:
 
@@ -25,7 +28,7 @@ namespace tonk {
 
     protected:
 
-        std::vector<std::pair<uint32_t, float>> calcPropabilities(int x, int y, const TileSet& tile_set, const Map& map);
+        void calcPropabilities(int x, int y, const TileSet& tile_set, const Map& map, std::vector<std::pair<uint32_t, float>>& propabilities);
         uint32_t chooseTile(const std::vector<std::pair<uint32_t, float>>& propabilities, uint32_t total_tile_count);
         void findNextPositionToResolve(uint32_t& x, uint32_t& y, const TileSet& tile_set, const Map& map);
         
@@ -60,6 +60,15 @@ namespace tonk {
     std::vector<std::pair<uint32_t, float>> Tile::getPossibleNeighbours(uint32_t direction) const {
 
         std::vector<std::pair<uint32_t, float>> neighbours;
+        getPossibleNeighbours(direction, neighbours);
+
+        return neighbours;
+    }
+
+    void Tile::getPossibleNeighbours(uint32_t direction, std::vector<std::pair<uint32_t, float>>& neighbours) const {
+        // clears the vector, then stores the neighbours in it (the capacity of the vector is kept)
+
+        neighbours.clear();
 
         for(const Neighbour& neighbour : _neighbours) {
 
@@ -80,7 +89,6 @@ namespace tonk {
 
         }
 
-        return neighbours;
     }
 
     void Tile::setName(const std::string& name) {
@@ -57,6 +57,7 @@ namespace tonk {
         Neighbour* getNeighbour(uint32_t unique_id);
 
         std::vector<std::pair<uint32_t, float>> getPossibleNeighbours(uint32_t direction) const;
+        void getPossibleNeighbours(uint32_t direction, std::vector<std::pair<uint32_t, float>>& neighbours) const; // reuses the memory of the vector
 
         void setName(const std::string& name);
         void setUniqueID(uint32_t id);
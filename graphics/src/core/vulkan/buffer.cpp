@@ -53,7 +53,7 @@ namespace undicht {
 
             if(byte_size + offset > getAllocatedSize()) {
                 UND_ERROR << "failed to store data in buffer: not enough memory allocated\n";
-                UND_LOG << "Note: allocated memory: " << getAllocatedSize() << " byte_size + offset: " << byte_size + offset << "\n";
+                UND_LOG_CAT(GRAPHICS) << "allocated memory: " << getAllocatedSize() << " byte_size + offset: " << byte_size + offset << "\n";
                 return;
             }
 
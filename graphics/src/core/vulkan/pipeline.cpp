@@ -163,14 +163,9 @@ namespace undicht {
             uint32_t total_size = layout.getTotalSize();
             addVertexBinding(id, total_size);
 
-            uint32_t current_offset = 0;
-            uint32_t attribute_id = location_offset;
-            for(const undicht::FixedType& t : layout.m_types) {
+            for(uint32_t i = 0; i < layout.getTypeCount(); i++) {
 
-                addVertexAttribute(id, attribute_id, current_offset, vulkan::translate(t)); // position
-
-                current_offset += t.getSize();
-                attribute_id += 1;
+                addVertexAttribute(id, location_offset + i, layout.getOffset(i), vulkan::translate(layout.getType(i)));
             }
         }
 
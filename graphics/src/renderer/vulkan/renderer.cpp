@@ -133,7 +133,7 @@ namespace undicht {
             _pipeline.setVertexBinding(0, 0, vertex_layout);
 
             if(instance_layout.getTotalSize())
-                _pipeline.setVertexBinding(1, vertex_layout.m_types.size(), instance_layout);
+                _pipeline.setVertexBinding(1, vertex_layout.getTypeCount(), instance_layout);
 
         }
 
@@ -100,7 +100,7 @@ namespace undicht {
             if(dst.getAllocatedSize() < (byte_size + offset)) {
                 // cant store the data
                 UND_ERROR << "failed to store the data, please allocate enough memory\n";
-                UND_LOG << "Note: data size: " << byte_size << ", offset: " << offset << " allocated: " << dst.getAllocatedSize() << "\n";
+                UND_LOG_CAT(GRAPHICS) << "data size: " << byte_size << ", offset: " << offset << " allocated: " << dst.getAllocatedSize() << "\n";
                 return false;
             }
 
@@ -0,0 +1,33 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cstdint>
+#include <iostream>
+
+// the checks shared by the test executables (run them with ctest)
+// a failed CHECK gets reported and counted, the test keeps running so that all failures show up at once
+
+inline uint32_t failed_checks = 0;
+
+#define CHECK(condition) \
+    do { \
+        if(!(condition)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition "\n"; \
+            failed_checks++; \
+        } \
+    } while(0)
+
+/// @brief prints how many checks failed
+/// @return the exit code of the test (1 if any check failed)
+inline int reportChecks() {
+
+    if(failed_checks) {
+        std::cerr << failed_checks << " checks failed\n";
+        return 1;
+    }
+
+    std::cerr << "all checks passed\n";
+    return 0;
+}
+
+#endif // CHECK_H
@@ -4,6 +4,8 @@
 #include "IBL/ibl.h"
 #include "glm/glm.hpp"
 #include "debug.h"
+#include "profiler.h"
+#include "job_system.h"
 
 
 namespace undicht {
@@ -17,6 +19,7 @@ namespace undicht {
             /// @param cube_map the environment which to convolute
             /// @param dst the cubemap in which to store the result
             /// @param dst_size the targeted size of the resulting cube map 
+            UND_PROFILE_SCOPE("convoluteCubeMap");
 
             const float texel_size = 1.0f / dst_size; // size of one "pixel" on the cubemap (in uv coords)
 
@@ -24,56 +27,58 @@ namespace undicht {
             dst.setExtent(dst_size);
             dst.setNrChannels(cube_map.getNrChannels());
 
-            for(int face = 0; face < 6; face++) { // six faces of the cubemap
-
-                for(int x = 0; x < dst_size; x++) {
-                    for(int y = 0; y < dst_size; y++) { // going through every pixel on the dst cubemap's face
-
-                        // calculating the direction corresponding to the current pixel (normal)
-                        glm::vec3 normal = glm::vec3(CUBE_MAP_DIRS.at(face) + ((x * texel_size) - 0.5f) * 2.0f * CUBE_MAP_RIGHTS.at(face) + ((y * texel_size) - 0.5f) * 2.0f * CUBE_MAP_UPS.at(face));
-                        normal = glm::normalize(normal);
-
-                        // going through a finite amount of points on the hemisphere pointing in the normal direction
-                        // to discretely solve the irradiance integral
-                        // source: https://learnopengl.com/PBR/IBL/Diffuse-irradiance
-                        glm::vec3 irradiance = glm::vec3(0.0);
-                        glm::vec3 right = glm::normalize(glm::cross(CUBE_MAP_UPS.at(face), normal)); // local coord system for the current hemisphere
-                        glm::vec3 up    = glm::normalize(glm::cross(normal, right));
-
-                        float sample_delta = 0.05f; // 0.025f;
-                        uint32_t nr_samples = 0;
-                        for(float phi = 0.0f; phi < 2.0f * M_PI; phi += sample_delta) {
-                            for(float theta = 0.0f; theta < 0.5f * M_PI; theta += sample_delta) {
-                                // spherical to cartesian (in tangent space)
-                                float sin_theta = glm::sin(theta); // used twice
-                                float cos_theta = glm::cos(theta); // used twice
-                                glm::vec3 tangent_sample = glm::vec3(sin_theta * glm::cos(phi), sin_theta * glm::sin(phi), cos_theta);
-                                // tangent space to world
-                                glm::vec3 sample_vec = tangent_sample.x * right + tangent_sample.y * up + tangent_sample.z * normal;
-
-                                // get the pixel from the cube map
-                                float* pixels = cube_map.getPixel(sample_vec);
-                                irradiance += glm::vec3(pixels[0], pixels[1], pixels[2]) * cos_theta * sin_theta;
-                                nr_samples++;
-                            }
+            // every column of every face gets calculated by a separate job
+            JobSystem::parallelFor(0, 6 * dst_size, 1, [&](uint32_t column) {
+
+                const int face = column / dst_size; // six faces of the cubemap
+                const int x = column % dst_size;
+
+                for(int y = 0; y < dst_size; y++) { // going through every pixel on the dst cubemap's face
+
+                    // calculating the direction corresponding to the current pixel (normal)
+                    glm::vec3 normal = glm::vec3(CUBE_MAP_DIRS.at(face) + ((x * texel_size) - 0.5f) * 2.0f * CUBE_MAP_RIGHTS.at(face) + ((y * texel_size) - 0.5f) * 2.0f * CUBE_MAP_UPS.at(face));
+                    normal = glm::normalize(normal);
+
+                    // going through a finite amount of points on the hemisphere pointing in the normal direction
+                    // to discretely solve the irradiance integral
+                    // source: https://learnopengl.com/PBR/IBL/Diffuse-irradiance
+                    glm::vec3 irradiance = glm::vec3(0.0);
+                    glm::vec3 right = glm::normalize(glm::cross(CUBE_MAP_UPS.at(face), normal)); // local coord system for the current hemisphere
+                    glm::vec3 up    = glm::normalize(glm::cross(normal, right));
+
+                    float sample_delta = 0.05f; // 0.025f;
+                    uint32_t nr_samples = 0;
+                    for(float phi = 0.0f; phi < 2.0f * M_PI; phi += sample_delta) {
+                        for(float theta = 0.0f; theta < 0.5f * M_PI; theta += sample_delta) {
+                            // spherical to cartesian (in tangent space)
+                            float sin_theta = glm::sin(theta); // used twice
+                            float cos_theta = glm::cos(theta); // used twice
+                            glm::vec3 tangent_sample = glm::vec3(sin_theta * glm::cos(phi), sin_theta * glm::sin(phi), cos_theta);
+                            // tangent space to world
+                            glm::vec3 sample_vec = tangent_sample.x * right + tangent_sample.y * up + tangent_sample.z * normal;
+
+                            // get the pixel from the cube map
+                            float* pixels = cube_map.getPixel(sample_vec);
+                            irradiance += glm::vec3(pixels[0], pixels[1], pixels[2]) * cos_theta * sin_theta;
+                            nr_samples++;
                         }
+                    }
 
-                        irradiance = float(M_PI) * irradiance * (1.0f / float(nr_samples));
-                        
-                        // storing the irradiance in the dst cubemap
-                        const float pixel[] = {
-                            irradiance.r,
-                            irradiance.g,
-                            irradiance.b,
-                            0.0f
-                        };
+                    irradiance = float(M_PI) * irradiance * (1.0f / float(nr_samples));
+                    
+                    // storing the irradiance in the dst cubemap
+                    const float pixel[] = {
+                        irradiance.r,
+                        irradiance.g,
+                        irradiance.b,
+                        0.0f
+                    };
 
-                        dst.getFace((CubeMapData<float>::Face)face).setPixel(pixel, x, y);
+                    dst.getFace((CubeMapData<float>::Face)face).setPixel(pixel, x, y);
 
-                    }
                 }
 
-            }
+            });
         }
 
         float radicalInverseVdC(uint32_t bits) {
@@ -125,6 +130,7 @@ namespace undicht {
             /// @param dst cube map mip-levels that contain the result of the prefiltering, the mip map level 0 is the highest resolution (=dst_size) and contains the reflections for the lowest roughness
             /// @param dst_size size of mip-level 0
             /// @param mip_levels number of mip-levels to generate
+            UND_PROFILE_SCOPE("prefilterSpecularReflections");
 
             dst.resize(mip_levels);
 
@@ -140,52 +146,55 @@ namespace undicht {
                 dst.at(mip_level).setExtent(mip_level_size);
                 dst.at(mip_level).setNrChannels(cube_map.getNrChannels());
 
-                for(int face = 0; face < 6; face++) { // six faces of the cubemap
-
-                    for(int x = 0; x < mip_level_size; x++) {
-                        for(int y = 0; y < mip_level_size; y++) { // going through every pixel on the dst cubemap's face for the current mip_level
-
-                            // calculating the direction corresponding to the current pixel (normal)
-                            glm::vec3 normal = glm::vec3(CUBE_MAP_DIRS.at(face) + ((x * texel_size) - 0.5f) * 2.0f * CUBE_MAP_RIGHTS.at(face) + ((y * texel_size) - 0.5f) * 2.0f * CUBE_MAP_UPS.at(face));
-                            normal = glm::normalize(normal);
-
-                            // prefiltering the specular reflection in the direction of the current pixel
-                            // source: https://learnopengl.com/PBR/IBL/Specular-IBL
-                            glm::vec3 N = normal;
-                            glm::vec3 R = N;
-                            glm::vec3 V = R;
-
-                            const uint32_t SAMPLE_COUNT = 1024u * roughness + 1; // the * roughness + 1 part is experimental 
-                            float totalWeight = 0.0f;
-                            glm::vec3 prefilteredColor = glm::vec3(0.0f);
-                            for(int i = 0; i < SAMPLE_COUNT; i++){
-                                glm::vec2 Xi = hammersley(i, SAMPLE_COUNT);
-                                glm::vec3 H  = importanceSampleGGX(Xi, N, roughness);
-                                glm::vec3 L  = glm::normalize(2.0f * glm::dot(V, H) * H - V);
-
-                                float NdotL = glm::max(glm::dot(N, L), 0.0f);
-                                if(NdotL > 0.0f) {
-                                    // get the color value in the direction L from the environment map
-                                    float* pixel = cube_map.getPixel(L);
-                                    prefilteredColor += glm::vec3(pixel[0], pixel[1], pixel[2]) * NdotL;
-                                    totalWeight      += NdotL;
-                                }
-                            }
-                            prefilteredColor = prefilteredColor / totalWeight;
+                // every column of every face gets calculated by a separate job
+                JobSystem::parallelFor(0, 6 * mip_level_size, 1, [&](uint32_t column) {
 
-                            // write the prefiltered color to the dst cubemap at the current mip level
-                            float pixel[] = {
-                                prefilteredColor.r,
-                                prefilteredColor.g,
-                                prefilteredColor.b,
-                                0.0f,
-                            };
+                    const int face = column / mip_level_size; // six faces of the cubemap
+                    const int x = column % mip_level_size;
 
-                            dst.at(mip_level).getFace((CubeMapData<float>::Face)face).setPixel(pixel, x, y);
+                    for(int y = 0; y < mip_level_size; y++) { // going through every pixel on the dst cubemap's face for the current mip_level
 
+                        // calculating the direction corresponding to the current pixel (normal)
+                        glm::vec3 normal = glm::vec3(CUBE_MAP_DIRS.at(face) + ((x * texel_size) - 0.5f) * 2.0f * CUBE_MAP_RIGHTS.at(face) + ((y * texel_size) - 0.5f) * 2.0f * CUBE_MAP_UPS.at(face));
+                        normal = glm::normalize(normal);
+
+                        // prefiltering the specular reflection in the direction of the current pixel
+                        // source: https://learnopengl.com/PBR/IBL/Specular-IBL
+                        glm::vec3 N = normal;
+                        glm::vec3 R = N;
+                        glm::vec3 V = R;
+
+                        const uint32_t SAMPLE_COUNT = 1024u * roughness + 1; // the * roughness + 1 part is experimental 
+                        float totalWeight = 0.0f;
+                        glm::vec3 prefilteredColor = glm::vec3(0.0f);
+                        for(int i = 0; i < SAMPLE_COUNT; i++){
+                            glm::vec2 Xi = hammersley(i, SAMPLE_COUNT);
+                            glm::vec3 H  = importanceSampleGGX(Xi, N, roughness);
+                            glm::vec3 L  = glm::normalize(2.0f * glm::dot(V, H) * H - V);
+
+                            float NdotL = glm::max(glm::dot(N, L), 0.0f);
+                            if(NdotL > 0.0f) {
+                                // get the color value in the direction L from the environment map
+                                float* pixel = cube_map.getPixel(L);
+                                prefilteredColor += glm::vec3(pixel[0], pixel[1], pixel[2]) * NdotL;
+                                totalWeight      += NdotL;
+                            }
                         }
+                        prefilteredColor = prefilteredColor / totalWeight;
+
+                        // write the prefiltered color to the dst cubemap at the current mip level
+                        float pixel[] = {
+                            prefilteredColor.r,
+                            prefilteredColor.g,
+                            prefilteredColor.b,
+                            0.0f,
+                        };
+
+                        dst.at(mip_level).getFace((CubeMapData<float>::Face)face).setPixel(pixel, x, y);
+
                     }
-                }
+
+                });
 
             }
 
@@ -215,6 +224,7 @@ namespace undicht {
             /// @brief the brdf map contains a precalculated scale and a bias for combinations of a fresnel factor (the dot product of view and normal vector) and roughness(y-Axis)
             /// @param dst the 2D image to fill with the precalculated values (pixel format is vec2f)
             /// @param dst_size size of that image
+            UND_PROFILE_SCOPE("createBRDFIntegrationMap");
 
             // resize the dst texture
             dst.setExtent(dst_size, dst_size);
@@ -222,7 +232,8 @@ namespace undicht {
 
             float texel_size = 1.0f / dst_size;
 
-            for(uint32_t x = 0; x < dst_size; x++) {
+            // every column of the texture gets calculated by a separate job
+            JobSystem::parallelFor(0, dst_size, 1, [&](uint32_t x) {
                 for(uint32_t y = 0; y < dst_size; y++) { // going through every pixel on the texture
                     // source: https://learnopengl.com/PBR/IBL/Specular-IBL
 
@@ -266,7 +277,7 @@ namespace undicht {
                     dst.getPixel(x, y)[0] = A;
                     dst.getPixel(x, y)[1] = B;
                 }
-            }
+            });
 
         }
 
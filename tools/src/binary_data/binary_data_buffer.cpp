@@ -1,5 +1,5 @@
 #include "binary_data_buffer.h"
-#include "algorithm"
+#include "iterator"
 
 namespace undicht {
 
@@ -14,81 +14,120 @@ namespace undicht {
             entry.offset = offset;
             entry.byte_size = byte_size;
 
-            _buffer_entries.push_back(entry);
+            if(!in_use)
+                _unused_entries.insert(std::make_pair(byte_size, offset));
 
-            return _buffer_entries.back();
+            return _buffer_entries[offset] = entry;
         }
 
-        void BinaryDataBuffer::removeEmptyEntries() {
-            /// @brief remove buffer entries with a byte_size of 0
+        void BinaryDataBuffer::removeBufferEntry(size_t location) {
 
-            for(int i = _buffer_entries.size() - 1; i >= 0; i--) {
-                if(_buffer_entries.at(i).byte_size == 0) {
+            std::map<size_t, BufferEntry>::iterator entry = _buffer_entries.find(location);
+            if(entry == _buffer_entries.end())
+                return;
 
-                    _buffer_entries.erase(_buffer_entries.begin() + i);
-                }
-            }
+            if(!entry->second.is_in_use)
+                _unused_entries.erase(std::make_pair(entry->second.byte_size, location));
+
+            _buffer_entries.erase(entry);
+        }
+
+        void BinaryDataBuffer::clearBufferEntries() {
+
+            _buffer_entries.clear();
+            _unused_entries.clear();
+        }
 
+        void BinaryDataBuffer::setInUse(BufferEntry& entry, bool in_use) {
+            /// @brief change the state / size of an entry
+            /// (the members of the entry should not be changed directly, since unused entries are also stored in _unused_entries)
+
+            if(entry.is_in_use == in_use)
+                return;
+
+            if(in_use)
+                _unused_entries.erase(std::make_pair(entry.byte_size, entry.offset));
+            else
+                _unused_entries.insert(std::make_pair(entry.byte_size, entry.offset));
+
+            entry.is_in_use = in_use;
         }
 
-        void BinaryDataBuffer::sortBufferEntries() {
-            /// @brief make sure the _buffer_entries are sorted by their offsets
+        void BinaryDataBuffer::setByteSize(BufferEntry& entry, size_t byte_size) {
 
-            if(!_buffer_entries.size()) return;
+            if(!entry.is_in_use) {
+                _unused_entries.erase(std::make_pair(entry.byte_size, entry.offset));
+                _unused_entries.insert(std::make_pair(byte_size, entry.offset));
+            }
 
-            // sort the sections
-            std::sort(_buffer_entries.begin(), _buffer_entries.end());
+            entry.byte_size = byte_size;
         }
 
-        void BinaryDataBuffer::mergeUnusedEntries() {
-            /// @brief will try to merge following entries marked as unused
-            /// @warning entries have to be in a sorted state before calling this function !!!!
-
-            // not using pointers since the _buffer_entries vector could shrink
-            // and i am only 99.9% certain that the pointers will stay valid if that happens
-            size_t unused_base = -1; 
-
-            for(int i = 0; i < _buffer_entries.size(); i++) {
-
-                if((!_buffer_entries.at(i).is_in_use) && (unused_base != -1)) {
-                    // the current buffer entry can be merged with the "unused" entry
-                    _buffer_entries.at(unused_base).byte_size = _buffer_entries.at(i).offset - _buffer_entries.at(unused_base).offset + _buffer_entries.at(i).byte_size; 
-                    _buffer_entries.erase(_buffer_entries.begin() + i);
-                    i--;
-                } else if(!_buffer_entries.at(i).is_in_use){
-                    // this entry could be used as a base for merging with the following entries
-                    unused_base = i;
-                } else {
-                    // no merging with this entry possible, since it is in use
-                    unused_base = -1;
-                }
+        BinaryDataBuffer::BufferEntry& BinaryDataBuffer::mergeUnusedEntries(BufferEntry& entry) {
+            /// @brief merges the unused entry with the unused entries directly before and after it
+            /// @return the merged entry (might start before the entry that was passed)
 
+            std::map<size_t, BufferEntry>::iterator merged = _buffer_entries.find(entry.offset);
+
+            if((merged == _buffer_entries.end()) || merged->second.is_in_use)
+                return entry;
+
+            // merging with the following entry
+            std::map<size_t, BufferEntry>::iterator next = std::next(merged);
+            if((next != _buffer_entries.end()) && !next->second.is_in_use) {
+
+                setByteSize(merged->second, next->second.offset + next->second.byte_size - merged->second.offset);
+                removeBufferEntry(next->first);
+            }
+
+            // merging with the previous entry
+            if(merged != _buffer_entries.begin()) {
+
+                std::map<size_t, BufferEntry>::iterator previous = std::prev(merged);
+                if(!previous->second.is_in_use) {
+
+                    setByteSize(previous->second, merged->second.offset + merged->second.byte_size - previous->second.offset);
+                    removeBufferEntry(merged->first);
+                    merged = previous;
+                }
             }
 
+            return merged->second;
         }
 
         BinaryDataBuffer::BufferEntry* BinaryDataBuffer::findBufferEntry(size_t location) const{
             /// @brief tries to find an entry with the specified offset
             /// @return will return nullptr if no such entry was found
 
-            for(const BufferEntry& entry : _buffer_entries)
-                if(entry.offset == location)
-                    return (BufferEntry*)&entry;
+            std::map<size_t, BufferEntry>::const_iterator entry = _buffer_entries.find(location);
+
+            if(entry == _buffer_entries.end())
+                return nullptr;
 
-            return nullptr;
+            return (BufferEntry*)&entry->second;
         }
 
         BinaryDataBuffer::BufferEntry* BinaryDataBuffer::findUnusedMemory(size_t byte_size) const {
-            /// @brief tries to find a entry that is marked as unused with specified size of at least byte_size
+            /// @brief tries to find the smallest entry that is marked as unused with a size of at least byte_size
             /// @return will return nullptr if no entry with a large enough unused memory could be found
 
-            for(const BufferEntry& entry : _buffer_entries)
-                if((!entry.is_in_use) && (entry.byte_size <= byte_size))
-                    return (BufferEntry*)&entry;
+            std::set<std::pair<size_t, size_t>>::const_iterator best_fit = _unused_entries.lower_bound(std::make_pair(byte_size, size_t(0)));
+
+            if(best_fit == _unused_entries.end())
+                return nullptr;
+
+            return findBufferEntry(best_fit->second);
+        }
+
+        BinaryDataBuffer::BufferEntry* BinaryDataBuffer::getLastBufferEntry() const {
+            /// @return the entry with the highest offset, nullptr if there are no entries
+
+            if(_buffer_entries.empty())
+                return nullptr;
 
-            return nullptr;
+            return (BufferEntry*)&_buffer_entries.rbegin()->second;
         }
 
-    } // tools 
+    } // tools
 
 } // undicht
\ No newline at end of file
@@ -2,7 +2,9 @@
 #define BINARY_DATA_BUFFER_H
 
 #include "cstdlib" // size_t
-#include "vector"
+#include "map"
+#include "set"
+#include "utility"
 
 namespace undicht {
 
@@ -12,7 +14,7 @@ namespace undicht {
             // a base class for classes that want to store data in a binary buffer
             // and want to keep track of where things are in that buffer
           public:
-            
+
             struct BufferEntry {
                 // stores the location and offset of data stored in the buffer
                 bool is_in_use = true;
@@ -29,33 +31,43 @@ namespace undicht {
 
           protected:
 
-            std::vector<BufferEntry> _buffer_entries;
+            // all entries, sorted by their offsets
+            std::map<size_t, BufferEntry> _buffer_entries;
+
+            // (byte_size, offset) of the entries marked as unused, sorted by their size (for finding the best fit)
+            std::set<std::pair<size_t, size_t>> _unused_entries;
 
           public:
-          
+
           protected:
             // protected BinaryDataBuffer functions
 
             BufferEntry& addBufferEntry(bool in_use, size_t offset, size_t byte_size);
 
-            /// @brief remove buffer entries with a byte_size of 0 
-            void removeEmptyEntries();
+            void removeBufferEntry(size_t location);
 
-            /// @brief make sure the _buffer_entries are sorted by their offsets
-            void sortBufferEntries();
+            void clearBufferEntries();
+
+            /// @brief change the state / size of an entry
+            /// (the members of the entry should not be changed directly, since unused entries are also stored in _unused_entries)
+            void setInUse(BufferEntry& entry, bool in_use);
+            void setByteSize(BufferEntry& entry, size_t byte_size);
+
+            /// @brief merges the unused entry with the unused entries directly before and after it
+            /// @return the merged entry (might start before the entry that was passed)
+            BufferEntry& mergeUnusedEntries(BufferEntry& entry);
 
-            /// @brief will try to merge following entries marked as unused
-            /// @warning entries have to be in a sorted state before calling this function !!!!
-            void mergeUnusedEntries();
-            
             /// @brief tries to find an entry with the specified offset
             /// @return will return nullptr if no such entry was found
             BufferEntry* findBufferEntry(size_t location) const;
 
-            /// @brief tries to find an entry that is marked as unused with specified size of at least byte_size
+            /// @brief tries to find the smallest entry that is marked as unused with a size of at least byte_size
             /// @return will return nullptr if no entry with a large enough unused memory could be found
             BufferEntry* findUnusedMemory(size_t byte_size) const;
 
+            /// @return the entry with the highest offset, nullptr if there are no entries
+            BufferEntry* getLastBufferEntry() const;
+
         };
 
     } // tools
@@ -1,15 +1,45 @@
 #include "binary_data_file.h"
 #include "debug.h"
+#include "config.h"
+#include "cstring"
+#include "cstdio"
+#include "algorithm"
+
+#ifdef PLATFORM_UNIX
+#include "fcntl.h"
+#include "unistd.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+#include "sys/uio.h"
+#include "climits"
+#include "cerrno"
+#endif
 
 #define BINARY_FILE_OPTIONS std::fstream::in | std::fstream::out | std::fstream::binary
 
+// in MEMORY_MAPPED mode the file gets enlarged (and remapped) in steps of this size
+#ifndef BINARY_FILE_MAP_EXTENT
+#define BINARY_FILE_MAP_EXTENT (16 * 1024 * 1024)
+#endif
+
+// number of calls to store() / update() / free() after which the block index gets written
+#ifndef BINARY_FILE_CHECKPOINT_INTERVAL
+#define BINARY_FILE_CHECKPOINT_INTERVAL 1024
+#endif
+
+// first 8 bytes of the index file ("UNDBIDX1")
+#define BINARY_FILE_INDEX_MAGIC 0x3158444942444e55ull
+
+// first 8 bytes of the log file ("UNDBLOG1")
+#define BINARY_FILE_LOG_MAGIC 0x31474f4c42444e55ull
+
 namespace undicht {
 
     namespace tools {
 
-        BinaryDataFile::BinaryDataFile(const std::string& file_name) {
+        BinaryDataFile::BinaryDataFile(const std::string& file_name, Mode mode) {
 
-            open(file_name);
+            open(file_name, mode);
         }
 
         BinaryDataFile::~BinaryDataFile() {
@@ -17,60 +47,115 @@ namespace undicht {
             close();
         }
 
-        bool BinaryDataFile::open(const std::string& file_name) {
+        bool BinaryDataFile::open(const std::string& file_name, Mode mode) {
 
             _file_name = file_name;
-            _file.open(_file_name, BINARY_FILE_OPTIONS);
+            _mode = mode;
 
-            if(!_file.is_open())
-                return false;
-            
-            // reading in the structure of the data stored in the file
-            while(!_file.eof()) {
+#ifndef PLATFORM_UNIX
+            if(_mode == MEMORY_MAPPED) {
+                UND_WARNING << "memory mapped binary files are not supported on this platform, using a file stream instead\n";
+                _mode = STREAM;
+            }
+#endif
 
-                // read block header
-                uint64_t block_header;
-                size_t offset = _file.tellg();
-                _file.read((char*)&block_header, 8);
-                if(_file.fail()) break;
+            if(_mode == STREAM) {
 
-                // create buffer entry
-                BufferEntry entry;
-                entry.byte_size = getBlockSize(block_header);
-                entry.offset = offset;
-                entry.is_in_use = isInUse(block_header);
+                _file.open(_file_name, BINARY_FILE_OPTIONS);
 
-                // move past current block
-                _file.seekg(entry.offset + entry.byte_size);
-                if(_file.fail()) break;
+                if(!_file.is_open())
+                    return false;
 
-                // if the position after the block could be reached, the entry is seen as valid
-                _buffer_entries.push_back(entry);
+                _file.seekg(0, std::fstream::end);
+                _file_size = _file.tellg();
 
-                // move to next properly aligned block header
-                _file.seekg(nextBlockHeaderPos(_file.tellg()));
-                if(_file.fail()) break;
+            } else {
 
+                if(!openMappedFile(false))
+                    return false;
             }
 
+            // finishing a transaction that was interrupted
+            if(recoverFromLog())
+                std::remove(getIndexFileName().c_str());
+
+            // reading in the structure of the data stored in the file
+            // (from the index if possible, else from the block headers)
+            _changes_since_checkpoint = 0;
+            _index_is_written = readIndex();
+
+            if(!_index_is_written)
+                readBlockHeaders();
+
             return true;
         }
 
         void BinaryDataFile::close() {
 
-            _file.close();
+            bool is_open = (_mode == STREAM) ? _file.is_open() : (_file_descriptor >= 0);
+
+            if(is_open && _in_transaction)
+                commitTransaction();
+
+            _in_transaction = false;
+            _pending_writes.clear();
+            _transaction_data.clear();
+
+            if(is_open && !_index_is_written)
+                writeIndex();
+
+            if(_mode == STREAM)
+                _file.close();
+            else
+                closeMappedFile();
+
             _file_name.clear();
-            _buffer_entries.clear();
+            clearBufferEntries();
+            _read_buffer.clear();
+            _file_size = 0;
+        }
+
+        BinaryDataFile::Mode BinaryDataFile::getMode() const {
+
+            return _mode;
         }
 
+        size_t BinaryDataFile::getFileSize() const {
+            /// @return the size of the file (the end of the last block)
+
+            return _file_size;
+        }
+
+        size_t BinaryDataFile::getUnusedSize() const {
+            /// @return the number of bytes in blocks that are marked as unused (the space that could be reclaimed by compacting the file)
+
+            size_t unused_size = 0;
+            for(const std::pair<size_t, size_t>& entry : _unused_entries)
+                unused_size += entry.first;
+
+            return unused_size;
+        }
 
         void BinaryDataFile::newBinaryFile() {
             /// @brief if the opened file didnt exist before, it will be created
             /// if it existed, its contents will be "reset", as if it was a newly created binary file
 
-            _file.close();
-            _file.open(_file_name, BINARY_FILE_OPTIONS | std::fstream::trunc);
-            _buffer_entries.clear();
+            std::remove(getIndexFileName().c_str());
+            _index_is_written = false;
+            clearBufferEntries();
+            _file_size = 0;
+
+            // changes made during the current transaction are no longer needed
+            _pending_writes.clear();
+            _transaction_data.clear();
+
+            if(_mode == STREAM) {
+                _file.close();
+                _file.open(_file_name, BINARY_FILE_OPTIONS | std::fstream::trunc);
+            } else {
+                closeMappedFile();
+                openMappedFile(true);
+            }
 
         }
 
@@ -82,42 +167,52 @@ namespace undicht {
             
             size_t total_size = byte_size + 8; // 8 additional bytes will be used for the block header
 
-            // try finding unused memory
+            // try finding the smallest unused block that is big enough
             BufferEntry* entry = findUnusedMemory(total_size);
-            size_t write_location;
 
             if(entry) {
                 // update the unused entry
 
-                // marking the memory that is still unused
                 size_t last_next_offset = nextBlockHeaderPos(entry->offset + entry->byte_size);
                 size_t new_next_offset = nextBlockHeaderPos(entry->offset + total_size);
 
-                if((last_next_offset - new_next_offset) > 0)
-                    writeBlockHeader(addBufferEntry(false, new_next_offset, last_next_offset - new_next_offset));
-                
+                // the last block of the file is not followed by padding
+                if(entry == getLastBufferEntry())
+                    last_next_offset = entry->offset + entry->byte_size;
+
                 // storing the data in the unused block
-                entry->is_in_use = true;
-                entry->byte_size = total_size;
-                writeBlockHeader(*entry);
+                setInUse(*entry, true);
+                setByteSize(*entry, total_size);
 
-                sortBufferEntries();
-                write_location = entry->offset;
+                // marking the memory that is still unused
+                if(last_next_offset >= new_next_offset + 8)
+                    writeBlockHeader(mergeUnusedEntries(addBufferEntry(false, new_next_offset, last_next_offset - new_next_offset)));
 
             } else {
-                // create a block header to extent the file
+                // extend the file
+
+                entry = getLastBufferEntry();
 
-                sortBufferEntries();
-                write_location = _buffer_entries.size() ? _buffer_entries.back().offset + _buffer_entries.back().byte_size : 0;
-                write_location = nextBlockHeaderPos(write_location);
+                if(entry && !entry->is_in_use) {
+                    // the unused block at the end of the file can be enlarged
+                    setInUse(*entry, true);
+                    setByteSize(*entry, total_size);
+                } else {
+                    // create a block header after the last block
+                    size_t location = entry ? nextBlockHeaderPos(entry->offset + entry->byte_size) : 0;
+                    entry = &addBufferEntry(true, location, total_size);
+                }
 
-                writeBlockHeader(addBufferEntry(true, write_location, total_size));
             }
 
-            UND_LOG << "writing at location " << write_location << ", size: " << total_size << "\n";
+            size_t write_location = entry->offset;
+            writeBlockHeader(*entry);
+
+            UND_LOG_CAT(IO) << "writing at location " << write_location << ", size: " << total_size << "\n";
 
             // write the data
-            _file.write(data, byte_size);
+            writeData(write_location + 8, data, byte_size);
+            countChange();
 
             return write_location;
         }
@@ -136,9 +231,11 @@ namespace undicht {
 
             BufferEntry* entry = findBufferEntry(location);
 
-            if(entry) {
-                entry->is_in_use = false;
-                writeBlockHeader(*entry);
+            if(entry && entry->is_in_use) {
+                // merging with unused neighbours, so that the memory can be reused for bigger blocks
+                setInUse(*entry, false);
+                writeBlockHeader(mergeUnusedEntries(*entry));
+                countChange();
             }
 
         }
@@ -149,61 +246,726 @@ namespace undicht {
             /// @param data the vector will be resized to fit all the data stored in the block
             /// @return whether or not reading from the location was a success
 
-            // clear previous errors
-            _file.clear();
+            const BufferEntry* entry = findValidBlock(location);
+            if(!entry)
+                return false;
+
+            // read the data
+            data.resize(entry->byte_size - 8); // not storing the block header
+            if(!readData(location + 8, data.data(), data.size())) {
+                UND_ERROR << "failed to read binary block data at location " << location << "\n";
+                return false;
+            }
+
+            return true;
+        }
+
+        bool BinaryDataFile::read(size_t location, const char*& data, size_t& byte_size) {
+            /// @brief tries to read the block of data at the specified location without copying it (in MEMORY_MAPPED mode)
+            /// @param data will point to the data of the block,
+            /// it stays valid until the next call to store(), update(), read(), newBinaryFile() or close()
+            /// @param byte_size the size of the data (without the block header)
+            /// @return whether or not reading from the location was a success
+
+            if(_mode == STREAM) {
+                // no way around copying the data
+                if(!read(location, _read_buffer))
+                    return false;
+
+                data = _read_buffer.data();
+                byte_size = _read_buffer.size();
+                return true;
+            }
+
+            const BufferEntry* entry = findValidBlock(location);
+            if(!entry)
+                return false;
+
+            byte_size = entry->byte_size - 8;
+            data = _in_transaction ? findPendingData(location + 8, byte_size) : nullptr;
+
+            if(!data)
+                data = _mapped_data + location + 8;
+
+            return true;
+        }
+
+        void BinaryDataFile::read(std::vector<ReadRequest>& requests) {
+            /// @brief reads the blocks of all requests, sorted by their location
+            /// neighbouring blocks are read together (in STREAM mode), so that there are as few reads as possible
+            /// can be called from any thread, as long as the file is not changed at the same time
+
+            if(_in_transaction) {
+                // some of the blocks might not be in the file yet
+                for(ReadRequest& request : requests) {
+
+                    const char* data;
+                    size_t byte_size;
+                    request.success = read(request.location, data, byte_size);
+
+                    if(request.success && request.on_read)
+                        request.on_read(data, byte_size);
+                }
+
+                return;
+            }
+
+            // reading the file front to back
+            std::vector<ReadRequest*> sorted;
+            sorted.reserve(requests.size());
+
+            for(ReadRequest& request : requests) {
+                request.success = false;
+                sorted.push_back(&request);
+            }
+
+            std::sort(sorted.begin(), sorted.end(), [](const ReadRequest* a, const ReadRequest* b) {
+                return a->location < b->location;
+            });
+
+            // the stream of the file cant be shared with other threads
+            std::ifstream file;
+            if(_mode == STREAM)
+                file.open(_file_name, std::ios::in | std::ios::binary);
+
+            std::vector<char> buffer;
+            size_t i = 0;
+
+            while(i < sorted.size()) {
+
+                // finding the blocks that follow each other in the file
+                size_t run_start = sorted.at(i)->location;
+                size_t run_end = run_start;
+                size_t run_size = 0;
+
+                while(i + run_size < sorted.size()) {
+
+                    const BufferEntry* entry = findBufferEntry(sorted.at(i + run_size)->location);
+
+                    if(!entry && run_size)
+                        break; // reading the blocks that were found so far
+
+                    if(!entry) {
+                        UND_ERROR << "failed to read binary block at location " << sorted.at(i)->location << ", no buffer entry for this location\n";
+                        i++;
+                        continue;
+                    }
+
+                    if(run_size && (entry->offset > nextBlockHeaderPos(run_end)))
+                        break;
+
+                    if(!run_size)
+                        run_start = entry->offset;
+
+                    run_end = std::max(run_end, entry->offset + entry->byte_size);
+                    run_size++;
+                }
+
+                if(!run_size)
+                    continue;
+
+                // reading the blocks
+                const char* run_data = nullptr;
+
+                if(_mode == MEMORY_MAPPED) {
+                    run_data = _mapped_data + run_start;
+                } else {
+                    buffer.resize(run_end - run_start);
+                    file.clear();
+                    file.seekg(run_start);
+                    file.read(buffer.data(), buffer.size());
+                    run_data = file.fail() ? nullptr : buffer.data();
+                }
+
+                for(size_t j = i; j < i + run_size; j++) {
+
+                    ReadRequest& request = *sorted.at(j);
+                    const BufferEntry* entry = findBufferEntry(request.location);
+
+                    // checking the block header
+                    uint64_t block_header = 0;
+                    if(run_data)
+                        std::memcpy(&block_header, run_data + (entry->offset - run_start), 8);
+
+                    if(!run_data || (getBlockSize(block_header) != entry->byte_size)) {
+                        UND_ERROR << "failed to read binary block header at location / block header indicates wrong block size " << request.location << "\n";
+                        continue;
+                    }
+
+                    if(request.on_read)
+                        request.on_read(run_data + (entry->offset - run_start) + 8, entry->byte_size - 8);
+
+                    request.success = true;
+                }
+
+                i += run_size;
+            }
+
+        }
+
+        void BinaryDataFile::readAsync(std::vector<ReadRequest>& requests, JobCounter& counter) {
+            /// @brief reads the requests as a job of the JobSystem
+            /// the requests have to stay alive (and the file unchanged) until the counter is done
+            /// the job also keeps a pointer to this file, so it must not be moved or destroyed before that either
+
+            std::vector<ReadRequest>* batch = &requests;
+
+            JobSystem::run([this, batch]() {
+                read(*batch);
+            }, &counter);
+
+        }
+
+        bool BinaryDataFile::writeIndex() {
+            /// @brief stores the positions and sizes of all blocks (used and unused) in the index file (file_name + ".index"),
+            /// so that open() doesnt need to read every block header of the file
+            /// gets called when closing the file and after every BINARY_FILE_CHECKPOINT_INTERVAL changes
+            /// @return whether or not the index could be written
+
+            // magic number, file size, number of entries, (offset, block header) per entry, checksum
+            std::vector<uint64_t> index;
+            index.reserve(4 + 2 * _buffer_entries.size());
+            index.push_back(BINARY_FILE_INDEX_MAGIC);
+            index.push_back(_file_size);
+            index.push_back(_buffer_entries.size());
+
+            for(const std::pair<const size_t, BufferEntry>& entry : _buffer_entries) {
+                index.push_back(entry.second.offset);
+                index.push_back(createBlockHeader(entry.second.is_in_use, entry.second.byte_size));
+            }
+
+            index.push_back(calcChecksum((const char*)index.data(), index.size() * 8));
+
+            // writing to a temporary file first, so that there is never a half written index file
+            std::string temp_file_name = getIndexFileName() + ".tmp";
+            std::ofstream index_file(temp_file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+            index_file.write((const char*)index.data(), index.size() * 8);
+            index_file.close();
+
+            if(index_file.fail() || std::rename(temp_file_name.c_str(), getIndexFileName().c_str())) {
+                UND_ERROR << "failed to write the block index of binary file " << _file_name << "\n";
+                std::remove(temp_file_name.c_str());
+                return false;
+            }
+
+            _index_is_written = true;
+            _changes_since_checkpoint = 0;
+
+            return true;
+        }
+
+        void BinaryDataFile::beginTransaction() {
+            /// @brief from now on, changes made by store(), update() and free() are collected
+            /// and only written to the file when commitTransaction() gets called
+            /// blocks stored during the transaction can already be read
+
+            if(_in_transaction) {
+                UND_WARNING << "binary file " << _file_name << ": a transaction was started while another one was still running\n";
+                return;
+            }
+
+            _in_transaction = true;
+        }
+
+        bool BinaryDataFile::commitTransaction() {
+            /// @brief writes all changes since beginTransaction() to the file
+            /// the changes first get written to a log file (file_name + ".log"), if the program stops while writing
+            /// to the file, the next open() completes the transaction (if the log is incomplete, the transaction is dropped)
+            /// @return false if the changes could not be written, the file should be reopened in that case
+
+            if(!_in_transaction)
+                return false;
+
+            _in_transaction = false;
+
+            bool success = true;
+
+            if(_pending_writes.size()) {
+
+                // once the log is complete, the transaction can always be finished
+                success = writeLog() && writePendingData(_pending_writes, _transaction_data.data());
+
+                if(success)
+                    std::remove(getLogFileName().c_str());
+                else
+                    UND_ERROR << "failed to commit the transaction to binary file " << _file_name << "\n";
+
+            }
+
+            _pending_writes.clear();
+            _transaction_data.clear();
+
+            if(success && (_changes_since_checkpoint >= BINARY_FILE_CHECKPOINT_INTERVAL))
+                writeIndex();
+
+            return success;
+        }
+
+        bool BinaryDataFile::isInTransaction() const {
+
+            return _in_transaction;
+        }
+
+        ////////////////////////////////// protected BinaryDataFile functions ////////////////////////////////
+
+        void BinaryDataFile::readBlockHeaders() {
+            // read in the block headers stored in the file
+
+            size_t offset = 0;
+
+            while(offset + 8 <= _file_size) {
+
+                // read block header
+                uint64_t block_header;
+                if(!readData(offset, (char*)&block_header, 8)) break;
+
+                // create buffer entry
+                BufferEntry entry;
+                entry.byte_size = getBlockSize(block_header);
+                entry.offset = offset;
+                entry.is_in_use = isInUse(block_header);
+
+                // if the position after the block can be reached, the entry is seen as valid
+                // (a memory mapped file that wasnt closed properly ends with empty memory)
+                if((entry.byte_size < 8) || (entry.offset + entry.byte_size > _file_size)) break;
+
+                addBufferEntry(entry.is_in_use, entry.offset, entry.byte_size);
+
+                // move to next properly aligned block header
+                offset = nextBlockHeaderPos(entry.offset + entry.byte_size);
+            }
+
+        }
+
+        std::string BinaryDataFile::getIndexFileName() const {
+
+            return _file_name + ".index";
+        }
+
+        bool BinaryDataFile::readIndex() {
+            // @return false if the index file is missing, damaged or doesnt match the file
+
+            std::ifstream index_file(getIndexFileName(), std::ios::in | std::ios::binary | std::ios::ate);
+            if(!index_file.is_open())
+                return false;
+
+            size_t index_size = index_file.tellg();
+            if((index_size < 32) || (index_size % 8))
+                return false;
+
+            std::vector<uint64_t> index(index_size / 8);
+            index_file.seekg(0);
+            index_file.read((char*)index.data(), index_size);
+
+            if(index_file.fail() || (index.at(0) != BINARY_FILE_INDEX_MAGIC) || (index.at(2) != (index.size() - 4) / 2)) {
+                UND_WARNING << "the block index of binary file " << _file_name << " is damaged, reading the block headers instead\n";
+                return false;
+            }
+
+            if(index.back() != calcChecksum((const char*)index.data(), index_size - 8)) {
+                UND_WARNING << "the block index of binary file " << _file_name << " is damaged, reading the block headers instead\n";
+                return false;
+            }
+
+            if(index.at(1) != _file_size) {
+                // the file was changed without updating the index
+                UND_WARNING << "the block index of binary file " << _file_name << " is outdated, reading the block headers instead\n";
+                return false;
+            }
+
+            size_t block_end = 0;
+
+            for(size_t i = 3; i + 1 < index.size(); i += 2) {
+
+                size_t offset = index.at(i);
+                size_t byte_size = getBlockSize(index.at(i + 1));
+
+                if((offset < block_end) || (byte_size < 8) || (offset + byte_size > _file_size)) {
+                    UND_WARNING << "the block index of binary file " << _file_name << " is damaged, reading the block headers instead\n";
+                    clearBufferEntries();
+                    return false;
+                }
+
+                addBufferEntry(isInUse(index.at(i + 1)), offset, byte_size);
+                block_end = offset + byte_size;
+            }
+
+            return true;
+        }
+
+        void BinaryDataFile::invalidateIndex() {
+            // removes the index file before the file gets changed
+            // (if the program stops before the index gets written again, the next open() reads the block headers)
+
+            if(!_index_is_written)
+                return;
+
+            std::remove(getIndexFileName().c_str());
+            _index_is_written = false;
+        }
+
+        void BinaryDataFile::countChange() {
+            // writes the index after enough changes have been made
+
+            _changes_since_checkpoint++;
+
+            // the index cant be written while the changes are not in the file yet
+            if(!_in_transaction && (_changes_since_checkpoint >= BINARY_FILE_CHECKPOINT_INTERVAL))
+                writeIndex();
+        }
+
+        uint64_t BinaryDataFile::calcChecksum(const char* data, size_t byte_size, uint64_t hash) const {
+            // FNV-1a hash of the data
+
+            for(size_t i = 0; i < byte_size; i++) {
+                hash ^= uint8_t(data[i]);
+                hash *= 0x100000001b3ull;
+            }
+
+            return hash;
+        }
+
+        //////////////////////////////////////////// transactions ////////////////////////////////////////////
+
+#ifdef PLATFORM_UNIX
+        static bool writeToDescriptor(int file_descriptor, std::vector<iovec>& buffers, size_t offset) {
+            // writes all buffers to the file, starting at the offset
+
+            size_t i = 0;
+
+            while(i < buffers.size()) {
+
+                ssize_t written = pwritev(file_descriptor, &buffers.at(i), std::min<size_t>(buffers.size() - i, IOV_MAX), offset);
+
+                if((written < 0) && (errno == EINTR))
+                    continue;
+
+                if(written < 0)
+                    return false;
+
+                offset += written;
+
+                // skipping the buffers that were written completely
+                while((i < buffers.size()) && (size_t(written) >= buffers.at(i).iov_len)) {
+                    written -= buffers.at(i).iov_len;
+                    i++;
+                }
+
+                // the rest of a partially written buffer
+                if(i < buffers.size()) {
+                    buffers.at(i).iov_base = (char*)buffers.at(i).iov_base + written;
+                    buffers.at(i).iov_len -= written;
+                }
+
+            }
+
+            return true;
+        }
+#endif
+
+        std::string BinaryDataFile::getLogFileName() const {
+
+            return _file_name + ".log";
+        }
+
+        void BinaryDataFile::addPendingWrite(size_t offset, const char* data, size_t byte_size) {
+            // store a write that is part of the current transaction
+
+            uint64_t record[2] = {offset, byte_size};
+            _transaction_data.insert(_transaction_data.end(), (const char*)record, (const char*)record + 16);
+
+            PendingWrite write;
+            write.offset = offset;
+            write.data_offset = _transaction_data.size();
+            write.byte_size = byte_size;
+            _pending_writes.push_back(write);
+
+            // padding the data, so that the next record is aligned
+            _transaction_data.insert(_transaction_data.end(), data, data + byte_size);
+            _transaction_data.resize((_transaction_data.size() + 7) / 8 * 8, 0);
+        }
+
+        const char* BinaryDataFile::findPendingData(size_t offset, size_t byte_size) const {
+            // @return the data for the range of the file if it was written during the current transaction
+
+            // searching the most recent writes first
+            for(std::vector<PendingWrite>::const_reverse_iterator write = _pending_writes.rbegin(); write != _pending_writes.rend(); write++) {
+
+                if((write->offset <= offset) && (offset + byte_size <= write->offset + write->byte_size))
+                    return _transaction_data.data() + write->data_offset + (offset - write->offset);
+
+            }
+
+            return nullptr;
+        }
+
+        bool BinaryDataFile::writeLog() {
+            // write the log file for the current transaction and wait until it is stored on the disk
+
+            uint64_t header[2] = {BINARY_FILE_LOG_MAGIC, _transaction_data.size()};
+
+            uint64_t checksum = calcChecksum((const char*)header, sizeof(header));
+            checksum = calcChecksum(_transaction_data.data(), _transaction_data.size(), checksum);
+
+#ifdef PLATFORM_UNIX
+
+            int log_file = ::open(getLogFileName().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if(log_file < 0)
+                return false;
+
+            std::vector<iovec> buffers(3);
+            buffers.at(0).iov_base = header;
+            buffers.at(0).iov_len = sizeof(header);
+            buffers.at(1).iov_base = _transaction_data.data();
+            buffers.at(1).iov_len = _transaction_data.size();
+            buffers.at(2).iov_base = &checksum;
+            buffers.at(2).iov_len = sizeof(checksum);
+
+            bool success = writeToDescriptor(log_file, buffers, 0) && !fdatasync(log_file);
+            ::close(log_file);
+
+            return success;
+#else
+
+            std::ofstream log_file(getLogFileName(), std::ios::out | std::ios::binary | std::ios::trunc);
+            log_file.write((const char*)header, sizeof(header));
+            log_file.write(_transaction_data.data(), _transaction_data.size());
+            log_file.write((const char*)&checksum, sizeof(checksum));
+            log_file.close();
+
+            return !log_file.fail();
+#endif
+        }
+
+        bool BinaryDataFile::writePendingData(const std::vector<PendingWrite>& writes, const char* data) {
+            // write the data to the file (consecutive writes are combined) and wait until it is stored on the disk
+
+            size_t file_end = 0;
+            for(const PendingWrite& write : writes)
+                file_end = std::max(file_end, write.offset + write.byte_size);
+
+#ifdef PLATFORM_UNIX
+
+            int file_descriptor = _file_descriptor;
+
+            if(_mode == STREAM) {
+                // writing through a separate file descriptor
+                _file.flush();
+                file_descriptor = ::open(_file_name.c_str(), O_WRONLY);
+            } else if(!mapFile(file_end)) {
+                // the file needs to be big enough for the mapped memory to stay valid
+                return false;
+            }
+
+            if(file_descriptor < 0)
+                return false;
+
+            // writes that follow each other get combined (the gap between the end of a block and the next block header gets filled)
+            static const char padding[8] = {};
+            std::vector<iovec> buffers;
+            size_t run_offset = 0;
+            size_t run_end = 0;
+            bool success = true;
+
+            for(const PendingWrite& write : writes) {
+
+                if(buffers.size() && ((write.offset < run_end) || (write.offset >= run_end + 8))) {
+                    success &= writeToDescriptor(file_descriptor, buffers, run_offset);
+                    buffers.clear();
+                }
+
+                if(buffers.empty()) {
+                    run_offset = write.offset;
+                } else if(write.offset > run_end) {
+                    iovec gap = {(void*)padding, write.offset - run_end};
+                    buffers.push_back(gap);
+                }
+
+                iovec buffer = {(void*)(data + write.data_offset), write.byte_size};
+                buffers.push_back(buffer);
+                run_end = write.offset + write.byte_size;
+            }
+
+            if(buffers.size())
+                success &= writeToDescriptor(file_descriptor, buffers, run_offset);
+
+            success &= !fdatasync(file_descriptor);
+
+            if(_mode == STREAM)
+                ::close(file_descriptor);
+
+            return success;
+#else
+
+            bool success = true;
+
+            for(const PendingWrite& write : writes)
+                success &= writeData(write.offset, data + write.data_offset, write.byte_size);
+
+            _file.flush();
+
+            return success;
+#endif
+        }
+
+        bool BinaryDataFile::recoverFromLog() {
+            // completes a transaction that was interrupted while writing to the file
+            // @return true if the file was changed
+
+            std::ifstream log_file(getLogFileName(), std::ios::in | std::ios::binary | std::ios::ate);
+            if(!log_file.is_open())
+                return false;
+
+            size_t log_size = log_file.tellg();
+            std::vector<uint64_t> log(log_size / 8);
+            log_file.seekg(0);
+            log_file.read((char*)log.data(), log.size() * 8);
+            log_file.close();
+
+            bool is_complete = (log_size >= 24) && !(log_size % 8) && (log.at(0) == BINARY_FILE_LOG_MAGIC) && (log.at(1) == log_size - 24);
+            is_complete = is_complete && (log.back() == calcChecksum((const char*)log.data(), log_size - 8));
+
+            if(!is_complete) {
+                // the program stopped before the transaction was committed, the file was not changed yet
+                UND_WARNING << "binary file " << _file_name << ": dropping an incomplete transaction\n";
+                std::remove(getLogFileName().c_str());
+                return false;
+            }
+
+            // reading the writes stored in the log
+            const char* body = (const char*)log.data() + 16;
+            std::vector<PendingWrite> writes;
+            size_t position = 0;
+
+            while(position + 16 <= log.at(1)) {
+
+                PendingWrite write;
+                write.offset = *(const uint64_t*)(body + position);
+                write.byte_size = *(const uint64_t*)(body + position + 8);
+                write.data_offset = position + 16;
+
+                if(write.data_offset + write.byte_size > log.at(1))
+                    break;
+
+                writes.push_back(write);
+                position = (write.data_offset + write.byte_size + 7) / 8 * 8;
+            }
+
+            UND_LOG << "binary file " << _file_name << ": completing an interrupted transaction (" << writes.size() << " writes)\n";
+
+            if(!writePendingData(writes, body)) {
+                UND_ERROR << "binary file " << _file_name << ": failed to complete the interrupted transaction\n";
+                return false;
+            }
+
+            for(const PendingWrite& write : writes)
+                _file_size = std::max(_file_size, write.offset + write.byte_size);
+
+            std::remove(getLogFileName().c_str());
+
+            return true;
+        }
+
+        const BinaryDataBuffer::BufferEntry* BinaryDataFile::findValidBlock(size_t location) {
+            // finds the entry of the block at the location and checks that its header matches the entry
+            // @return nullptr if there is no valid block at the location
 
             // find the buffer entry
             BufferEntry* entry = findBufferEntry(location);
             if(!entry) {
                 UND_ERROR << "failed to read binary block at location " << location << ", no buffer entry for this location\n";
-                return false;
-            } 
-
-            // move the read cursor to the position
-            _file.seekg(location);
-            if(_file.fail()) {
-                UND_ERROR << "failed to read binary block at location " << location << ", cant reach read position\n";
-                return false; // couldnt go to the position
+                return nullptr;
             } 
 
             // read the block header
             uint64_t block_header;
-            _file.read((char*)&block_header, 8);
-            if(_file.fail() || (getBlockSize(block_header) != entry->byte_size)) {
+            if(!readData(location, (char*)&block_header, 8) || (getBlockSize(block_header) != entry->byte_size)) {
                 UND_ERROR << "failed to read binary block header at location / block header indicates wrong block size " << location << "\n";
-                return false;
+                return nullptr;
             }
 
-            // read the data
-            data.resize(entry->byte_size - 8); // not storing the block header
-            _file.read(data.data(), data.size());
-            if(_file.fail()) {
-                UND_ERROR << "failed to read binary block data at location " << location << "\n";
+            return entry;
+        }
+
+        void BinaryDataFile::writeBlockHeader(const BufferEntry& entry) {
+            // write the entry as a block header to the file
+
+            uint64_t block_header = createBlockHeader(entry.is_in_use, entry.byte_size);
+
+            if(!writeData(entry.offset, (char*)&block_header, 8))
+                UND_ERROR << "failed to write binary file block header\n";
+
+        }
+
+        bool BinaryDataFile::readData(size_t offset, char* data, size_t byte_size) {
+            // read data at the offset (counting from the start of the file), using the current mode
+
+            if(offset + byte_size > _file_size)
                 return false;
+
+            if(_in_transaction) {
+                // the data might not be in the file yet
+                const char* pending_data = findPendingData(offset, byte_size);
+
+                if(pending_data) {
+                    std::memcpy(data, pending_data, byte_size);
+                    return true;
+                }
+
             }
 
-            return true;
+            if(_mode == MEMORY_MAPPED) {
+                std::memcpy(data, _mapped_data + offset, byte_size);
+                return true;
+            }
+
+            // clear previous errors
+            _file.clear();
+
+            // move the read cursor to the position
+            _file.seekg(offset);
+            if(_file.fail())
+                return false; // couldnt go to the position
+
+            _file.read(data, byte_size);
+
+            return !_file.fail();
         }
 
-        ////////////////////////////////// protected BinaryDataFile functions ////////////////////////////////
+        bool BinaryDataFile::writeData(size_t offset, const char* data, size_t byte_size) {
+            // write data at the offset (counting from the start of the file), using the current mode
 
-        void BinaryDataFile::writeBlockHeader(const BufferEntry& entry) {
-            // write the entry as a block header to the file
+            invalidateIndex();
 
-            // try to go to the location specified by the entry
+            if(_in_transaction) {
+                addPendingWrite(offset, data, byte_size);
+                _file_size = std::max(_file_size, offset + byte_size);
+                return true;
+            }
+
+            if(_mode == MEMORY_MAPPED) {
+
+                if(!mapFile(offset + byte_size))
+                    return false;
+
+                if(byte_size) // data might be nullptr for empty blocks
+                    std::memcpy(_mapped_data + offset, data, byte_size);
+
+                _file_size = std::max(_file_size, offset + byte_size);
+                return true;
+            }
+
+            // try to go to the location
             _file.clear(); // clear previous errors
-            _file.seekp(entry.offset);
+            _file.seekp(offset);
 
             if(_file.fail()) // assume the reason it failed was that the file wasnt big enough
-                enlargeFile(entry.offset);
-
-            if(_file.fail())
-                UND_ERROR << "failed to write binary file block header\n";
+                enlargeFile(offset);
 
-            // write the block header
-            uint64_t block_header = createBlockHeader(entry.is_in_use, entry.byte_size);
-            _file.write((char*)&block_header, 8);
+            _file.write(data, byte_size);
+            _file_size = std::max(_file_size, offset + byte_size);
 
+            return !_file.fail();
         }
 
         void BinaryDataFile::enlargeFile(size_t new_size) {
@@ -221,11 +983,108 @@ namespace undicht {
         }
 
 
+        ////////////////////////////////////// MEMORY_MAPPED mode //////////////////////////////////////
+
+        bool BinaryDataFile::openMappedFile(bool truncate) {
+#ifdef PLATFORM_UNIX
+
+            int flags = truncate ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDWR;
+            _file_descriptor = ::open(_file_name.c_str(), flags, 0644);
+
+            if(_file_descriptor < 0)
+                return false;
+
+            struct stat file_stat;
+            if(fstat(_file_descriptor, &file_stat)) {
+                closeMappedFile();
+                return false;
+            }
+
+            _file_size = file_stat.st_size;
+
+            if(!mapFile(_file_size)) {
+                closeMappedFile();
+                return false;
+            }
+
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        void BinaryDataFile::closeMappedFile() {
+#ifdef PLATFORM_UNIX
+
+            unmapFile();
+
+            if(_file_descriptor >= 0) {
+                // removing the unused space at the end of the file
+                if(ftruncate(_file_descriptor, _file_size))
+                    UND_ERROR << "failed to truncate binary file " << _file_name << "\n";
+
+                ::close(_file_descriptor);
+                _file_descriptor = -1;
+            }
+
+#endif
+        }
+
+        bool BinaryDataFile::mapFile(size_t min_size) {
+            // makes sure that at least min_size bytes of the file are mapped, enlarging the file if necessary
+#ifdef PLATFORM_UNIX
+
+            if(_mapped_data && (min_size <= _mapped_size))
+                return true;
+
+            // enlarging the file in big steps, so that it doesnt need to be remapped often
+            size_t new_size = (min_size / BINARY_FILE_MAP_EXTENT + 1) * BINARY_FILE_MAP_EXTENT;
+
+            unmapFile();
+
+            if(ftruncate(_file_descriptor, new_size)) {
+                UND_ERROR << "failed to enlarge binary file " << _file_name << " to " << new_size << " bytes\n";
+                return false;
+            }
+
+            // prefaulting the pages (where supported), page faults while storing data are a lot slower
+            int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+            flags |= MAP_POPULATE;
+#endif
+
+            void* mapped_data = mmap(nullptr, new_size, PROT_READ | PROT_WRITE, flags, _file_descriptor, 0);
+            if(mapped_data == MAP_FAILED) {
+                UND_ERROR << "failed to map binary file " << _file_name << " into memory\n";
+                return false;
+            }
+
+            _mapped_data = (char*)mapped_data;
+            _mapped_size = new_size;
+
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        void BinaryDataFile::unmapFile() {
+#ifdef PLATFORM_UNIX
+
+            if(_mapped_data)
+                munmap(_mapped_data, _mapped_size);
+
+#endif
+            _mapped_data = nullptr;
+            _mapped_size = 0;
+        }
+
         size_t BinaryDataFile::nextBlockHeaderPos(size_t position) const {
             // calculate the next properly aligned block header position
             // following the position given as a parameter
 
-            return position + position % 8;
+            // (files written before this was fixed only contain blocks whose sizes are multiples of 4, for those the result was the same)
+            return (position + 7) / 8 * 8;
         }
 
         /////////////////////// functions that should make the block headers easier to use ///////////////////
@@ -5,7 +5,9 @@
 #include "vector"
 #include "fstream"
 #include "string"
+#include "functional"
 #include "binary_data/binary_data_buffer.h"
+#include "job_system.h"
 
 namespace undicht {
 
@@ -20,21 +22,73 @@ namespace undicht {
             /// after the header starts the data
             /// blocks can only start every 8 bytes (counting from the beginning of the file)
 
+          public:
+
+            enum Mode {
+                STREAM, // reading and writing through a std::fstream
+                MEMORY_MAPPED, // the file is mapped into memory, read() can return pointers into the file (only on unix, falls back to STREAM)
+            };
+
+            struct ReadRequest {
+                // a block that should be read as part of a batch (see read(std::vector<ReadRequest>&))
+
+                size_t location = 0;
+
+                // gets called with the data of the block (on the thread that reads the batch)
+                // the data is only valid during the call
+                std::function<void(const char* data, size_t byte_size)> on_read;
+
+                bool success = false; // set once the block was read
+            };
+
           protected:
 
             std::string _file_name;
+            Mode _mode = STREAM;
+
+            // STREAM mode
             std::fstream _file; // used for reading and writing
+            std::vector<char> _read_buffer; // for the zero-copy read() in STREAM mode
+
+            // MEMORY_MAPPED mode
+            int _file_descriptor = -1;
+            char* _mapped_data = nullptr;
+            size_t _mapped_size = 0; // the file gets enlarged in big steps, so this is usually bigger than _file_size
+            size_t _file_size = 0; // end of the last block, the file gets truncated to this size when closing
+
+            // block index (stored in a separate file, see writeIndex())
+            bool _index_is_written = false; // whether the index file matches the current state of the file
+            uint32_t _changes_since_checkpoint = 0;
+
+            // transactions (see beginTransaction())
+            struct PendingWrite {
+                size_t offset = 0; // in the file
+                size_t data_offset = 0; // in _transaction_data
+                size_t byte_size = 0;
+            };
+
+            bool _in_transaction = false;
+            std::vector<PendingWrite> _pending_writes;
+            std::vector<char> _transaction_data; // the body of the write-ahead log: (offset, byte_size, data padded to 8 bytes) per write
 
           public:
 
             BinaryDataFile() = default;
-            BinaryDataFile(const std::string& file_name);
+            BinaryDataFile(const std::string& file_name, Mode mode = STREAM);
             virtual~ BinaryDataFile();
 
 
-            bool open(const std::string& file_name);
+            bool open(const std::string& file_name, Mode mode = STREAM);
             void close();
 
+            Mode getMode() const;
+
+            /// @return the size of the file (the end of the last block)
+            size_t getFileSize() const;
+
+            /// @return the number of bytes in blocks that are marked as unused (the space that could be reclaimed by compacting the file)
+            size_t getUnusedSize() const;
+
             /// @brief if the opened file didnt exist before, it will be created
             /// if it existed, its contents will be "reset", as if it was a newly created binary file
             void newBinaryFile();
@@ -57,15 +111,104 @@ namespace undicht {
             /// @return whether or not reading from the location was a success
             bool read(size_t location, std::vector<char>& data);
 
+            /// @brief tries to read the block of data at the specified location without copying it (in MEMORY_MAPPED mode)
+            /// @param data will point to the data of the block,
+            /// it stays valid until the next call to store(), update(), read(), newBinaryFile() or close()
+            /// @param byte_size the size of the data (without the block header)
+            /// @return whether or not reading from the location was a success
+            bool read(size_t location, const char*& data, size_t& byte_size);
+
+            /// @brief reads the blocks of all requests, sorted by their location
+            /// neighbouring blocks are read together (in STREAM mode), so that there are as few reads as possible
+            /// can be called from any thread, as long as the file is not changed at the same time
+            void read(std::vector<ReadRequest>& requests);
+
+            /// @brief reads the requests as a job of the JobSystem
+            /// the requests have to stay alive (and the file unchanged) until the counter is done
+            /// the job also keeps a pointer to this file, so it must not be moved or destroyed before that either
+            void readAsync(std::vector<ReadRequest>& requests, JobCounter& counter);
+
+            /// @brief stores the positions and sizes of all blocks (used and unused) in the index file (file_name + ".index"),
+            /// so that open() doesnt need to read every block header of the file
+            /// gets called when closing the file and after every BINARY_FILE_CHECKPOINT_INTERVAL changes
+            /// @return whether or not the index could be written
+            bool writeIndex();
+
+            /// @brief from now on, changes made by store(), update() and free() are collected
+            /// and only written to the file when commitTransaction() gets called
+            /// blocks stored during the transaction can already be read
+            void beginTransaction();
+
+            /// @brief writes all changes since beginTransaction() to the file
+            /// the changes first get written to a log file (file_name + ".log"), if the program stops while writing
+            /// to the file, the next open() completes the transaction (if the log is incomplete, the transaction is dropped)
+            /// @return false if the changes could not be written, the file should be reopened in that case
+            bool commitTransaction();
+
+            bool isInTransaction() const;
+
           protected:
             // protected BinaryDataFile functions
 
+            // read in the block headers stored in the file
+            void readBlockHeaders();
+
+            // block index
+            std::string getIndexFileName() const;
+
+            // @return false if the index file is missing, damaged or doesnt match the file
+            bool readIndex();
+
+            // removes the index file before the file gets changed
+            void invalidateIndex();
+
+            // writes the index after enough changes have been made
+            void countChange();
+
+            // FNV-1a hash of the data
+            uint64_t calcChecksum(const char* data, size_t byte_size, uint64_t hash = 0xcbf29ce484222325ull) const;
+
+            // transactions
+            std::string getLogFileName() const;
+
+            // store a write that is part of the current transaction
+            void addPendingWrite(size_t offset, const char* data, size_t byte_size);
+
+            // @return the data for the range of the file if it was written during the current transaction
+            const char* findPendingData(size_t offset, size_t byte_size) const;
+
+            // write the log file for the current transaction and wait until it is stored on the disk
+            bool writeLog();
+
+            // write the data to the file (consecutive writes are combined) and wait until it is stored on the disk
+            bool writePendingData(const std::vector<PendingWrite>& writes, const char* data);
+
+            // completes a transaction that was interrupted while writing to the file
+            // @return true if the file was changed
+            bool recoverFromLog();
+
+            // finds the entry of the block at the location and checks that its header matches the entry
+            // @return nullptr if there is no valid block at the location
+            const BufferEntry* findValidBlock(size_t location);
+
             // write the entry as a block header to the file
             void writeBlockHeader(const BufferEntry& entry);
 
+            // read / write data at the offset (counting from the start of the file), using the current mode
+            bool readData(size_t offset, char* data, size_t byte_size);
+            bool writeData(size_t offset, const char* data, size_t byte_size);
+
             // write enough empty data to get the file to the specified size 
             void enlargeFile(size_t new_size);
 
+            // MEMORY_MAPPED mode
+            bool openMappedFile(bool truncate);
+            void closeMappedFile();
+
+            // makes sure that at least min_size bytes of the file are mapped, enlarging the file if necessary
+            bool mapFile(size_t min_size);
+            void unmapFile();
+
             // calculate the next properly aligned block header position
             // following the position given as a parameter
             size_t nextBlockHeaderPos(size_t position) const;
@@ -2,6 +2,28 @@
 #include <stdlib.h>
 #include <sys/stat.h>
 #include "fstream"
+#include "cstring"
+#include "charconv"
+#include "algorithm"
+#include "climits"
+#include "job_system.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include "emmintrin.h"
+#define UND_FILE_TOOLS_SSE2
+#endif
+
+// std::from_chars for floats is not supported by every standard library yet (strtof is used instead)
+#if defined(__cpp_lib_to_chars)
+#define UND_FILE_TOOLS_FROM_CHARS_FLOAT
+#endif
+
+// arrays larger than this (in chars) get parsed in parallel
+#ifndef FILE_TOOLS_PARALLEL_PARSE_SIZE
+#define FILE_TOOLS_PARALLEL_PARSE_SIZE (256 * 1024)
+#endif
+
+#define FILE_TOOLS_MAX_PARSE_PARTS 64
 
 
 namespace undicht {
@@ -89,64 +111,276 @@ namespace undicht {
         }
 
 
-        void extractFloatArray(std::vector<float> &loadTo,std::string src, unsigned int num, int stride) {
-            /**@brief float arrays might be stored as chars in a text file, this functions converts them to floats */
-            /**@brief they should be only one char apart from each other though*/
+        /////////////////////////////////////// parsing numbers ///////////////////////////////////////
+
+        static bool isWhitespace(char c) {
 
-            // loadTo.clear();
+            return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r') || (c == '\v') || (c == '\f');
+        }
 
-            src.push_back('X'); // making sure the extracting stops there
-            // while reading through the array of chars,
-            // this pointer points to the end of the last float extracted
-            char* reading_position = ((char*)src.data());
-            char* end_position = ((char*)src.data()) + src.size() - 1;
+        static bool isSeparator(char c) {
+            // chars that can separate the numbers of an array
 
-            while(reading_position < end_position) {
-                // the strtof function will store the end of the extracted float in the char array as an pointer
-                // this way the reading position gets updated and moves forward
-                loadTo.push_back(strtof(reading_position, &reading_position));
+            return isWhitespace(c) || (c == ',');
+        }
 
-                if(loadTo.size() >= num) {
-                    break;
-                }
+        static const char* readNumber(const char* begin, const char* end, float& number) {
+            /// @return the end of the number, begin if there is no number
+
+            const char* start = begin;
+            if((start != end) && (*start == '+'))
+                start++; // from_chars doesnt accept a leading '+'
+
+#ifdef UND_FILE_TOOLS_FROM_CHARS_FLOAT
+            std::from_chars_result result = std::from_chars(start, end, number);
 
-                reading_position += stride;
+            // hex floats and values out of range are left to strtof, so that the results stay the same
+            if((result.ec == std::errc()) && ((result.ptr == end) || ((*result.ptr != 'x') && (*result.ptr != 'X'))))
+                return result.ptr;
+#endif
 
+            // strtof needs a null terminated string
+            const char* token_end = begin;
+            while((token_end != end) && !isWhitespace(*token_end))
+                token_end++;
+
+            char buffer[64];
+            std::string long_token;
+            const char* token = buffer;
+
+            if(size_t(token_end - begin) < sizeof(buffer)) {
+                std::memcpy(buffer, begin, token_end - begin);
+                buffer[token_end - begin] = 0;
+            } else {
+                long_token.assign(begin, token_end);
+                token = long_token.c_str();
             }
 
-            src.pop_back(); // deleting the last char
+            char* number_end;
+            number = std::strtof(token, &number_end);
 
+            return begin + (number_end - token);
         }
 
+        static const char* readNumber(const char* begin, const char* end, int& number) {
+            /// @return the end of the number, begin if there is no number
 
-        void extractIntArray(std::vector<int> &loadTo, std::string src, unsigned int num, int stride) {
-            /**@brief extract ints from a char array*/
-            /** @warning might not work correctly if the src's length equals its capacity, so make sure there is (at least) one extra char */
+            const char* start = begin;
+            if((start != end) && (*start == '+'))
+                start++; // from_chars doesnt accept a leading '+'
 
-            // loadTo.clear();
+            std::from_chars_result result = std::from_chars(start, end, number);
 
-            src.push_back('X'); // making sure the extracting stops there
-            // while reading through the array of chars,
-            // this pointer points to the end of the last float extracted
-            char* reading_position = ((char*)src.data());
-            char* end_position = ((char*)src.data()) + src.size() - 1;
+            if(result.ec == std::errc::result_out_of_range) {
+                // clamping like strtol
+                number = (*start == '-') ? INT_MIN : INT_MAX;
+            } else if(result.ec != std::errc()) {
+                number = 0;
+                return begin;
+            }
+
+            return result.ptr;
+        }
 
-            while(reading_position < end_position) {
-                // the strtof function will store the end of the extracted float in the char array as an pointer
-                // this way the reading position gets updated and moves forward
-                loadTo.push_back(strtol(reading_position, &reading_position, 0));
+        template<typename T>
+        static size_t parseNumber(std::string_view str, T& number) {
+
+            const char* begin = str.data();
+            const char* end = str.data() + str.size();
+
+            while((begin != end) && isWhitespace(*begin))
+                begin++;
+
+            const char* number_end = readNumber(begin, end, number);
+
+            if(number_end == begin) {
+                number = 0;
+                return 0;
+            }
 
-                if(loadTo.size() >= num) {
+            return number_end - str.data();
+        }
+
+        size_t parseFloat(std::string_view str, float& number) {
+            /** @brief parses the number at the beginning of str (leading whitespace is skipped)
+            * gives the same results as strtof, but doesnt need a null terminated string
+            * @return the number of chars that were read (including the whitespace), 0 if str doesnt start with a number */
+
+            return parseNumber(str, number);
+        }
+
+        size_t parseInt(std::string_view str, int& number) {
+            /** @brief parses the number at the beginning of str (leading whitespace is skipped)
+            * gives the same results as strtol (base 10), but doesnt need a null terminated string
+            * @return the number of chars that were read (including the whitespace), 0 if str doesnt start with a number */
+
+            return parseNumber(str, number);
+        }
+
+        static size_t countNumbers(const char* begin, const char* end) {
+            // counts the chars that are not separators, but follow a separator (or the beginning)
+
+            size_t count = 0;
+            bool after_separator = true;
+            const char* c = begin;
+
+#ifdef UND_FILE_TOOLS_SSE2
+            // finding the separators of 16 chars at once
+            const __m128i spaces = _mm_set1_epi8(' ');
+            const __m128i commas = _mm_set1_epi8(',');
+            const __m128i control_min = _mm_set1_epi8('\t' - 1);
+            const __m128i control_max = _mm_set1_epi8('\r' + 1);
+
+            for(; c + 16 <= end; c += 16) {
+
+                __m128i chars = _mm_loadu_si128((const __m128i*)c);
+
+                __m128i separators = _mm_or_si128(_mm_cmpeq_epi8(chars, spaces), _mm_cmpeq_epi8(chars, commas));
+                __m128i control = _mm_and_si128(_mm_cmpgt_epi8(chars, control_min), _mm_cmplt_epi8(chars, control_max)); // \t \n \v \f \r
+                separators = _mm_or_si128(separators, control);
+
+                uint32_t separator_mask = _mm_movemask_epi8(separators);
+                uint32_t previous_mask = (separator_mask << 1) | uint32_t(after_separator);
+                uint32_t start_mask = ~separator_mask & previous_mask & 0xffff;
+
+                for(; start_mask; start_mask &= start_mask - 1)
+                    count++;
+
+                after_separator = separator_mask & 0x8000;
+            }
+#endif
+
+            for(; c < end; c++) {
+
+                bool separator = isSeparator(*c);
+                count += after_separator && !separator;
+                after_separator = separator;
+            }
+
+            return count;
+        }
+
+        template<typename T>
+        static size_t parseNumbers(const char* begin, const char* end, T* dst, size_t max_count) {
+            // parses the numbers on the calling thread
+
+            size_t count = 0;
+            const char* c = begin;
+
+            while(count < max_count) {
+
+                while((c != end) && isSeparator(*c))
+                    c++;
+
+                if(c == end)
                     break;
-                }
 
-                reading_position += stride;
+                const char* number_end = readNumber(c, end, dst[count]);
+                if(number_end == c)
+                    break; // not a number
+
+                c = number_end;
+                count++;
+            }
+
+            return count;
+        }
+
+        template<typename T>
+        static size_t parseArray(std::string_view src, T* dst, size_t max_count) {
+
+            const char* begin = src.data();
+            const char* end = src.data() + src.size();
+
+            if((src.size() < FILE_TOOLS_PARALLEL_PARSE_SIZE) || !JobSystem::isInitialized())
+                return parseNumbers(begin, end, dst, max_count);
+
+            // splitting the array into parts (between numbers)
+            uint32_t part_count = std::min<uint32_t>(JobSystem::getWorkerCount() + 1, FILE_TOOLS_MAX_PARSE_PARTS);
+            part_count = std::min<uint32_t>(part_count, src.size() / (FILE_TOOLS_PARALLEL_PARSE_SIZE / 4));
+
+            const char* part_begin[FILE_TOOLS_MAX_PARSE_PARTS + 1];
+            size_t part_offset[FILE_TOOLS_MAX_PARSE_PARTS + 1];
+            size_t part_parsed[FILE_TOOLS_MAX_PARSE_PARTS];
+
+            part_begin[0] = begin;
+            part_begin[part_count] = end;
+            for(uint32_t i = 1; i < part_count; i++) {
+
+                const char* c = std::max(begin + src.size() * i / part_count, part_begin[i - 1]);
+                while((c != end) && !isSeparator(*c))
+                    c++;
+
+                part_begin[i] = c;
+            }
+
+            // finding the position of the first number of each part in dst
+            JobSystem::parallelFor(0, part_count, 1, [&](uint32_t part) {
+                part_offset[part + 1] = countNumbers(part_begin[part], part_begin[part + 1]);
+            });
+
+            part_offset[0] = 0;
+            for(uint32_t i = 1; i <= part_count; i++)
+                part_offset[i] += part_offset[i - 1];
+
+            JobSystem::parallelFor(0, part_count, 1, [&](uint32_t part) {
 
+                size_t offset = std::min(part_offset[part], max_count);
+                size_t count = std::min(part_offset[part + 1], max_count) - offset;
+
+                part_parsed[part] = parseNumbers(part_begin[part], part_begin[part + 1], dst + offset, count);
+            });
+
+            // stopping at the first part that contained an invalid number
+            size_t count = 0;
+            for(uint32_t i = 0; i < part_count; i++) {
+
+                count += part_parsed[i];
+
+                if(part_parsed[i] < std::min(part_offset[i + 1], max_count) - std::min(part_offset[i], max_count))
+                    break;
             }
 
-            src.pop_back(); // deleting the last char
+            return count;
+        }
+
+        size_t countNumbers(std::string_view src) {
+            /** @return the number of numbers in src (separated by whitespace or ','), to size the array for parseFloatArray() / parseIntArray() */
+
+            return countNumbers(src.data(), src.data() + src.size());
+        }
+
+        size_t parseFloatArray(std::string_view src, float* dst, size_t max_count) {
+            /** @brief parses the numbers in src (separated by whitespace or ',') into dst, without allocating memory
+            * large arrays get split into parts that are parsed in parallel by the JobSystem (if it is initialized)
+            * @return the number of numbers that were parsed (stops at max_count or at the first invalid number) */
+
+            return parseArray(src, dst, max_count);
+        }
+
+        size_t parseIntArray(std::string_view src, int* dst, size_t max_count) {
+
+            return parseArray(src, dst, max_count);
+        }
+
+        void extractFloatArray(std::vector<float> &loadTo, std::string_view src, unsigned int num) {
+            /**@brief float arrays might be stored as chars in a text file, this functions converts them to floats */
+
+            size_t old_size = loadTo.size();
+            loadTo.resize(old_size + std::min<size_t>(num, countNumbers(src)));
+
+            size_t count = parseFloatArray(src, loadTo.data() + old_size, loadTo.size() - old_size);
+            loadTo.resize(old_size + count);
+        }
+
+        void extractIntArray(std::vector<int> &loadTo, std::string_view src, unsigned int num) {
+            /**@brief extract ints from a char array*/
 
+            size_t old_size = loadTo.size();
+            loadTo.resize(old_size + std::min<size_t>(num, countNumbers(src)));
 
+            size_t count = parseIntArray(src, loadTo.data() + old_size, loadTo.size() - old_size);
+            loadTo.resize(old_size + count);
         }
 
     } // tools
@@ -2,6 +2,7 @@
 #define STRING_TOOLS_H_INCLUDED
 
 #include <sstream>
+#include <string_view>
 #include <vector>
 
 // some simple string tools
@@ -44,15 +45,31 @@ namespace undicht {
         /** @brief replace all chars with an other char */
         std::string replaceAllChars(std::string str, char to_be_replaced, char replace_with);
 
+        /** @brief parses the number at the beginning of str (leading whitespace is skipped)
+        * gives the same results as strtof / strtol (base 10), but doesnt need a null terminated string
+        * @param number is set to 0 if str doesnt start with a number
+        * @return the number of chars that were read (including the whitespace), 0 if str doesnt start with a number */
+        size_t parseFloat(std::string_view str, float& number);
+        size_t parseInt(std::string_view str, int& number);
+
+        /** @return the number of numbers in src (separated by whitespace or ','), to size the array for parseFloatArray() / parseIntArray() */
+        size_t countNumbers(std::string_view src);
+
+        /** @brief parses the numbers in src (separated by whitespace or ',') into dst, without allocating memory
+        * large arrays get split into parts that are parsed in parallel by the JobSystem (if it is initialized)
+        * @param max_count the number of elements in dst
+        * @return the number of numbers that were parsed (stops at max_count or at the first invalid number) */
+        size_t parseFloatArray(std::string_view src, float* dst, size_t max_count);
+        size_t parseIntArray(std::string_view src, int* dst, size_t max_count);
+
         /**@brief float arrays might be stored as chars in a text file, this functions converts them to floats
-        * @param num is the number of floats to extract
-        * @param stride is the distance in chars between each float, default is 1 (example: " ")*/
-        void extractFloatArray(std::vector<float> &loadTo, std::string src, unsigned int num, int stride = 1);
-
-        /**@brief extract ints from a char array
-        * @param num is the number of ints to extract
-        * @param stride is the distance in chars between each int, default is 1 (example: " ") */
-        void extractIntArray(std::vector<int> &loadTo, std::string src, unsigned int num, int stride = 1);
+        * and adds them to loadTo (the floats can be separated by whitespace or ',')
+        * @param num is the maximum number of floats to extract */
+        void extractFloatArray(std::vector<float> &loadTo, std::string_view src, unsigned int num);
+
+        /**@brief extract ints from a char array and adds them to loadTo (the ints can be separated by whitespace or ',')
+        * @param num is the maximum number of ints to extract */
+        void extractIntArray(std::vector<int> &loadTo, std::string_view src, unsigned int num);
 
     } // tools
 
@@ -44,6 +44,7 @@ namespace undicht {
             PIXEL_TYPE* getPixel(float u, float v) const;
 
             /// @brief sample the image by linearly interpolating between the nearest pixels to the u v coordinates
+            /// (allocates the returned vector, use an ImageSampler to sample many coordinates)
             std::vector<PIXEL_TYPE> sampleLinear(float u, float v) const;
 
             /// @brief sample a equirectangular map in a given direction
@@ -36,6 +36,7 @@ namespace undicht {
             PIXEL_TYPE* getPixel(float u, float v, float w) const;
 
             // linear interpolation will only happen in uv direction
+            // (allocates the returned vector, an ImageSampler3D samples many coordinates trilinearly)
             std::vector<PIXEL_TYPE> sampleLinear(float u, float v, float w) const;
 
             uint32_t getWidth() const;
@@ -0,0 +1,453 @@
+#include "image_sampler.h"
+#include "cmath"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include "emmintrin.h"
+#define UND_SAMPLER_SSE2
+#endif
+
+namespace undicht {
+
+    namespace tools {
+
+        template class ImageSampler<char, 1>;
+        template class ImageSampler<char, 2>;
+        template class ImageSampler<char, 3>;
+        template class ImageSampler<char, 4>;
+        template class ImageSampler<float, 1>;
+        template class ImageSampler<float, 2>;
+        template class ImageSampler<float, 3>;
+        template class ImageSampler<float, 4>;
+
+        template class ImageSampler3D<char, 1>;
+        template class ImageSampler3D<char, 2>;
+        template class ImageSampler3D<char, 3>;
+        template class ImageSampler3D<char, 4>;
+        template class ImageSampler3D<float, 1>;
+        template class ImageSampler3D<float, 2>;
+        template class ImageSampler3D<float, 3>;
+        template class ImageSampler3D<float, 4>;
+
+        /////////////////////////////////////// addressing (shared by all samplers) ///////////////////////////////////////
+
+        // 8 bit channels are unsigned
+        static inline float loadChannel(char c) {
+
+            return float(uint8_t(c));
+        }
+
+        static inline float loadChannel(float c) {
+
+            return c;
+        }
+
+        static inline float lerp(float a, float b, float t) {
+
+            return a + (b - a) * t;
+        }
+
+        // @return the part of the coordinate after the decimal point (0 for nan / inf)
+        static inline float repeatCoord(float coord) {
+
+            float frac = coord - std::floor(coord);
+
+            return (frac >= 0.0f) ? frac : 0.0f;
+        }
+
+        // @return the pixel closest to the coordinate
+        static inline int32_t addressNearest(float coord, uint32_t size, SamplerAddressMode mode) {
+
+            float x = (mode == SamplerAddressMode::REPEAT) ? repeatCoord(coord) * size : coord * size;
+
+            x = (x > 0.0f) ? x : 0.0f;
+            x = (x < float(size - 1)) ? x : float(size - 1);
+
+            return int32_t(x);
+        }
+
+        // finds the two pixels whose centers are next to the coordinate
+        // @param t: how close the coordinate is to the center of the second pixel (0 to 1)
+        static inline void addressLinear(float coord, uint32_t size, SamplerAddressMode mode, int32_t& i0, int32_t& i1, float& t) {
+
+            float x;
+
+            if(mode == SamplerAddressMode::REPEAT) {
+                x = repeatCoord(coord) * size - 0.5f;
+            } else {
+                x = coord * size - 0.5f;
+                x = (x > 0.0f) ? x : 0.0f;
+                x = (x < float(size - 1)) ? x : float(size - 1);
+            }
+
+            float x0 = std::floor(x);
+            t = x - x0;
+            i0 = int32_t(x0);
+            i1 = i0 + 1;
+
+            if(mode == SamplerAddressMode::REPEAT) {
+                i0 = (i0 < 0) ? int32_t(size - 1) : i0;
+                i1 = (i1 >= int32_t(size)) ? 0 : i1;
+            } else {
+                i1 = (i1 >= int32_t(size)) ? int32_t(size - 1) : i1;
+            }
+
+        }
+
+#ifdef UND_SAMPLER_SSE2
+
+        // floor for values that fit into an int32
+        static inline __m128 floor4(__m128 x) {
+
+            __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+
+            return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, x), _mm_set1_ps(1.0f)));
+        }
+
+        // same as addressLinear() for 4 coordinates
+        static inline void addressLinear4(__m128 coord, uint32_t size, SamplerAddressMode mode, int32_t* i0, int32_t* i1, __m128& t) {
+
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 last = _mm_set1_ps(float(size - 1));
+            __m128 x;
+
+            if(mode == SamplerAddressMode::REPEAT) {
+                // floats >= 2^23 have no decimal places (and might not fit into the int32 used by floor4())
+                __m128 abs_coord = _mm_and_ps(coord, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+                __m128 frac = _mm_sub_ps(coord, floor4(coord));
+                frac = _mm_and_ps(frac, _mm_and_ps(_mm_cmpge_ps(frac, zero), _mm_cmplt_ps(abs_coord, _mm_set1_ps(8388608.0f))));
+                x = _mm_sub_ps(_mm_mul_ps(frac, _mm_set1_ps(float(size))), _mm_set1_ps(0.5f));
+            } else {
+                x = _mm_sub_ps(_mm_mul_ps(coord, _mm_set1_ps(float(size))), _mm_set1_ps(0.5f));
+                x = _mm_and_ps(x, _mm_cmpgt_ps(x, zero));
+                x = _mm_min_ps(x, last);
+            }
+
+            __m128 x0 = floor4(x);
+            t = _mm_sub_ps(x, x0);
+
+            __m128i first = _mm_cvttps_epi32(x0);
+            __m128i second = _mm_add_epi32(first, _mm_set1_epi32(1));
+            __m128i last_pixel = _mm_set1_epi32(int32_t(size - 1));
+            __m128i after_last = _mm_cmpgt_epi32(second, last_pixel);
+
+            if(mode == SamplerAddressMode::REPEAT) {
+                __m128i before_first = _mm_cmplt_epi32(first, _mm_setzero_si128());
+                first = _mm_or_si128(_mm_andnot_si128(before_first, first), _mm_and_si128(before_first, last_pixel));
+                second = _mm_andnot_si128(after_last, second);
+            } else {
+                second = _mm_or_si128(_mm_andnot_si128(after_last, second), _mm_and_si128(after_last, last_pixel));
+            }
+
+            _mm_storeu_si128((__m128i*)i0, first);
+            _mm_storeu_si128((__m128i*)i1, second);
+        }
+
+        // loads the channel of 4 pixels
+        template<typename PIXEL_TYPE>
+        static inline __m128 gather4(const PIXEL_TYPE* const* pixels, uint32_t channel) {
+
+            return _mm_setr_ps(loadChannel(pixels[0][channel]), loadChannel(pixels[1][channel]), loadChannel(pixels[2][channel]), loadChannel(pixels[3][channel]));
+        }
+
+        static inline __m128 lerp4(__m128 a, __m128 b, __m128 t) {
+
+            return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+        }
+
+        // stores the channels of 4 samples (one __m128 per channel) as CHANNELS floats per sample
+        template<uint32_t CHANNELS>
+        static inline void storeSamples4(const __m128* channels, float* dst) {
+
+            if(CHANNELS == 1) {
+                _mm_storeu_ps(dst, channels[0]);
+                return;
+            }
+
+            alignas(16) float values[CHANNELS][4];
+            for(uint32_t channel = 0; channel < CHANNELS; channel++)
+                _mm_store_ps(values[channel], channels[channel]);
+
+            for(uint32_t sample = 0; sample < 4; sample++)
+                for(uint32_t channel = 0; channel < CHANNELS; channel++)
+                    dst[sample * CHANNELS + channel] = values[channel][sample];
+
+        }
+
+#endif // UND_SAMPLER_SSE2
+
+        /////////////////////////////////////// ImageSampler ///////////////////////////////////////
+
+        template<typename PIXEL_TYPE, uint32_t CHANNELS>
+        ImageSampler<PIXEL_TYPE, CHANNELS>::ImageSampler(const ImageData<PIXEL_TYPE>& image, SamplerFilter filter, SamplerAddressMode address_mode) {
+
+            setImage(image);
+            setFilter(filter);
+            setAddressMode(address_mode, address_mode);
+        }
+
+        template<typename PIXEL_TYPE, uint32_t CHANNELS>
+        bool ImageSampler<PIXEL_TYPE, CHANNELS>::setImage(const ImageData<PIXEL_TYPE>& image) {
+            /// @return false if the image doesnt have CHANNELS channels (the sampler returns 0 for every sample then)
+
+            bool valid = (image.getNrChannels() == CHANNELS) && image.getWidth() && image.getHeight() && image.getPixelData();
+
+            _pixels = valid ? image.getPixelData() : nullptr;
+            _width = valid ? image.getWidth() : 0;
+            _height = valid ? image.getHeight() : 0;
+
+            return valid;
+        }
+
+        template<typename PIXEL_TYPE, uint32_t CHANNELS>
+        void ImageSampler<PIXEL_TYPE, CHANNELS>::setFilter(SamplerFilter filter) {
+
+            _filter = filter;
+        }
+
+        template<typename PIXEL_TYPE, uint32_t CHANNELS>
+        void ImageSampler<PIXEL_TYPE, CHANNELS>::setAddressMode(SamplerAddressMode u, SamplerAddressMode v) {
+
+            _address_u = u;
+            _address_v = v;
+        }
+
+        template<typename PIXEL_TYPE, uint32_t CHANNELS>
+        void ImageSampler<PIXEL_TYPE, CHANNELS>::sample(float u, float v, float* dst) const {
+            /// @brief writes the CHANNELS channels of the sample to dst
+
+            if(!_pixels) {
+                for(uint32_t channel = 0; channel < CHANNELS; channel++)
+                    dst[channel] = 0.0f;
+                return;
+            }
+
+            if(_filter == SamplerFilter::NEAREST) {
+                const PIXEL_TYPE* pixel = getPixel(addressNearest(u, _width, _address_u), addressNearest(v, _height, _address_v));
+                for(uint32_t channel = 0; channel < CHANNELS; channel++)
+                    dst[channel] = loadChannel(pixel[channel]);
+                return;
+            }
+
+            int32_t x0, x1, y0, y1;
+            float tx, ty;
+            addressLinear(u, _width, _address_u, x0, x1, tx);
+            addressLinear(v, _height, _address_v, y0, y1, ty);
+
+            const PIXEL_TYPE* p00 = getPixel(x0, y0);
+            const PIXEL_TYPE* p10 = getPixel(x1, y0);
+            const PIXEL_TYPE* p01 = getPixel(x0, y1);
+            const PIXEL_TYPE* p11 = getPixel(x1, y1);
+
+            for(uint32_t channel = 0; channel < CHANNELS; channel++) {
+                float top = lerp(loadChannel(p00[channel]), loadChannel(p10[channel]), tx);
+                float bottom = lerp(loadChannel(p01[channel]), loadChannel(p11[channel]), tx);
+                dst[channel] = lerp(top, bottom, ty);
+            }
+
+        }
+
+        template<typename PIXEL_TYPE, uint32_t CHANNELS>
+        void ImageSampler<PIXEL_TYPE, CHANNELS>::sample(const float* u, const float* v, size_t count, float* dst) const {
+            /// @brief samples count coordinates (u[i], v[i]) and writes the channels of sample i to dst[i * CHANNELS]
+
+            size_t i = 0;
+
+#ifdef UND_SAMPLER_SSE2
+
+            if(_pixels && (_filter == SamplerFilter::LINEAR)) {
+
+                for(; i + 4 <= count; i += 4) {
+
+                    alignas(16) int32_t x0[4], x1[4], y0[4], y1[4];
+                    __m128 tx, ty;
+                    addressLinear4(_mm_loadu_ps(u + i), _width, _address_u, x0, x1, tx);
+                    addressLinear4(_mm_loadu_ps(v + i), _height, _address_v, y0, y1, ty);
+
+                    const PIXEL_TYPE* p00[4];
+                    const PIXEL_TYPE* p10[4];
+                    const PIXEL_TYPE* p01[4];
+                    const PIXEL_TYPE* p11[4];
+
+                    for(int lane = 0; lane < 4; lane++) {
+                        p00[lane] = getPixel(x0[lane], y0[lane]);
+                        p10[lane] = getPixel(x1[lane], y0[lane]);
+                        p01[lane] = getPixel(x0[lane], y1[lane]);
+                        p11[lane] = getPixel(x1[lane], y1[lane]);
+                    }
+
+                    __m128 channels[CHANNELS];
+
+                    for(uint32_t channel = 0; channel < CHANNELS; channel++) {
+                        __m128 top = lerp4(gather4(p00, channel), gather4(p10, channel), tx);
+                        __m128 bottom = lerp4(gather4(p01, channel), gather4(p11, channel), tx);
+                        channels[channel] = lerp4(top, bottom, ty);
+                    }
+
+                    storeSamples4<CHANNELS>(channels, dst + i * CHANNELS);
+                }
+
+            }
+
+#endif // UND_SAMPLER_SSE2
+
+            for(; i < count; i++)
+                sample(u[i], v[i], dst + i * CHANNELS);
+
+        }
+
+        template<typename PIXEL_TYPE, uint32_t CHANNELS>
+        const PIXEL_TYPE* ImageSampler<PIXEL_TYPE, CHANNELS>::getPixel(int32_t x, int32_t y) const {
+
+            return _pixels + (size_t(y) * _width + x) * CHANNELS;
+        }
+
+        /////////////////////////////////////// ImageSampler3D ///////////////////////////////////////
+
+        template<typename PIXEL_TYPE, uint32_t CHANNELS>
+        ImageSampler3D<PIXEL_TYPE, CHANNELS>::ImageSampler3D(const ImageData3D<PIXEL_TYPE>& image, SamplerFilter filter, SamplerAddressMode address_mode) {
+
+            setImage(image);
+            setFilter(filter);
+            setAddressMode(address_mode, address_mode, address_mode);
+        }
+
+        template<typename PIXEL_TYPE, uint32_t CHANNELS>
+        bool ImageSampler3D<PIXEL_TYPE, CHANNELS>::setImage(const ImageData3D<PIXEL_TYPE>& image) {
+            /// @return false if the image doesnt have CHANNELS channels (the sampler returns 0 for every sample then)
+
+            _layers.clear();
+            _width = 0;
+            _height = 0;
+            _depth = 0;
+
+            if((image.getNrChannels() != CHANNELS) || !image.getWidth() || !image.getHeight() || !image.getDepth())
+                return false;
+
+            for(uint32_t z = 0; z < image.getDepth(); z++)
+                _layers.push_back(image.getImageLayer(z).getPixelData());
+
+            _width = image.getWidth();
+            _height = image.getHeight();
+            _depth = image.getDepth();
+
+            return true;
+        }
+
+        template<typename PIXEL_TYPE, uint32_t CHANNELS>
+        void ImageSampler3D<PIXEL_TYPE, CHANNELS>::setFilter(SamplerFilter filter) {
+
+            _filter = filter;
+        }
+
+        template<typename PIXEL_TYPE, uint32_t CHANNELS>
+        void ImageSampler3D<PIXEL_TYPE, CHANNELS>::setAddressMode(SamplerAddressMode u, SamplerAddressMode v, SamplerAddressMode w) {
+
+            _address_u = u;
+            _address_v = v;
+            _address_w = w;
+        }
+
+        template<typename PIXEL_TYPE, uint32_t CHANNELS>
+        void ImageSampler3D<PIXEL_TYPE, CHANNELS>::sample(float u, float v, float w, float* dst) const {
+            /// @brief writes the CHANNELS channels of the sample to dst
+
+            if(_layers.empty()) {
+                for(uint32_t channel = 0; channel < CHANNELS; channel++)
+                    dst[channel] = 0.0f;
+                return;
+            }
+
+            if(_filter == SamplerFilter::NEAREST) {
+                int32_t x = addressNearest(u, _width, _address_u);
+                int32_t y = addressNearest(v, _height, _address_v);
+                int32_t z = addressNearest(w, _depth, _address_w);
+                const PIXEL_TYPE* pixel = getPixel(x, y, z);
+                for(uint32_t channel = 0; channel < CHANNELS; channel++)
+                    dst[channel] = loadChannel(pixel[channel]);
+                return;
+            }
+
+            int32_t x0, x1, y0, y1, z0, z1;
+            float tx, ty, tz;
+            addressLinear(u, _width, _address_u, x0, x1, tx);
+            addressLinear(v, _height, _address_v, y0, y1, ty);
+            addressLinear(w, _depth, _address_w, z0, z1, tz);
+
+            const PIXEL_TYPE* p000 = getPixel(x0, y0, z0);
+            const PIXEL_TYPE* p100 = getPixel(x1, y0, z0);
+            const PIXEL_TYPE* p010 = getPixel(x0, y1, z0);
+            const PIXEL_TYPE* p110 = getPixel(x1, y1, z0);
+            const PIXEL_TYPE* p001 = getPixel(x0, y0, z1);
+            const PIXEL_TYPE* p101 = getPixel(x1, y0, z1);
+            const PIXEL_TYPE* p011 = getPixel(x0, y1, z1);
+            const PIXEL_TYPE* p111 = getPixel(x1, y1, z1);
+
+            for(uint32_t channel = 0; channel < CHANNELS; channel++) {
+                float front = lerp(lerp(loadChannel(p000[channel]), loadChannel(p100[channel]), tx), lerp(loadChannel(p010[channel]), loadChannel(p110[channel]), tx), ty);
+                float back = lerp(lerp(loadChannel(p001[channel]), loadChannel(p101[channel]), tx), lerp(loadChannel(p011[channel]), loadChannel(p111[channel]), tx), ty);
+                dst[channel] = lerp(front, back, tz);
+            }
+
+        }
+
+        template<typename PIXEL_TYPE, uint32_t CHANNELS>
+        void ImageSampler3D<PIXEL_TYPE, CHANNELS>::sample(const float* u, const float* v, const float* w, size_t count, float* dst) const {
+            /// @brief samples count coordinates (u[i], v[i], w[i]) and writes the channels of sample i to dst[i * CHANNELS]
+
+            size_t i = 0;
+
+#ifdef UND_SAMPLER_SSE2
+
+            if(!_layers.empty() && (_filter == SamplerFilter::LINEAR)) {
+
+                for(; i + 4 <= count; i += 4) {
+
+                    alignas(16) int32_t x0[4], x1[4], y0[4], y1[4], z0[4], z1[4];
+                    __m128 tx, ty, tz;
+                    addressLinear4(_mm_loadu_ps(u + i), _width, _address_u, x0, x1, tx);
+                    addressLinear4(_mm_loadu_ps(v + i), _height, _address_v, y0, y1, ty);
+                    addressLinear4(_mm_loadu_ps(w + i), _depth, _address_w, z0, z1, tz);
+
+                    // the 8 pixels around each sample (index: x + 2 * y + 4 * z)
+                    const PIXEL_TYPE* corners[8][4];
+
+                    for(int lane = 0; lane < 4; lane++) {
+                        corners[0][lane] = getPixel(x0[lane], y0[lane], z0[lane]);
+                        corners[1][lane] = getPixel(x1[lane], y0[lane], z0[lane]);
+                        corners[2][lane] = getPixel(x0[lane], y1[lane], z0[lane]);
+                        corners[3][lane] = getPixel(x1[lane], y1[lane], z0[lane]);
+                        corners[4][lane] = getPixel(x0[lane], y0[lane], z1[lane]);
+                        corners[5][lane] = getPixel(x1[lane], y0[lane], z1[lane]);
+                        corners[6][lane] = getPixel(x0[lane], y1[lane], z1[lane]);
+                        corners[7][lane] = getPixel(x1[lane], y1[lane], z1[lane]);
+                    }
+
+                    __m128 channels[CHANNELS];
+
+                    for(uint32_t channel = 0; channel < CHANNELS; channel++) {
+                        __m128 front = lerp4(lerp4(gather4(corners[0], channel), gather4(corners[1], channel), tx), lerp4(gather4(corners[2], channel), gather4(corners[3], channel), tx), ty);
+                        __m128 back = lerp4(lerp4(gather4(corners[4], channel), gather4(corners[5], channel), tx), lerp4(gather4(corners[6], channel), gather4(corners[7], channel), tx), ty);
+                        channels[channel] = lerp4(front, back, tz);
+                    }
+
+                    storeSamples4<CHANNELS>(channels, dst + i * CHANNELS);
+                }
+
+            }
+
+#endif // UND_SAMPLER_SSE2
+
+            for(; i < count; i++)
+                sample(u[i], v[i], w[i], dst + i * CHANNELS);
+
+        }
+
+        template<typename PIXEL_TYPE, uint32_t CHANNELS>
+        const PIXEL_TYPE* ImageSampler3D<PIXEL_TYPE, CHANNELS>::getPixel(int32_t x, int32_t y, int32_t z) const {
+
+            return _layers[z] + (size_t(y) * _width + x) * CHANNELS;
+        }
+
+    } // tools
+
+} // undicht
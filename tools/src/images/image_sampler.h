@@ -0,0 +1,112 @@
+#ifndef IMAGE_SAMPLER_H
+#define IMAGE_SAMPLER_H
+
+#include "cstdint"
+#include "cstddef"
+#include "vector"
+#include "images/image_data.h"
+#include "images/image_data_3d.h"
+
+namespace undicht {
+
+    namespace tools {
+
+        // samplers that read ImageData / ImageData3D without allocating memory
+        // the number of channels is a template parameter, the samples get written to memory provided by the caller
+        // (CHANNELS floats per sample, 8 bit channels keep their 0 to 255 range)
+        // the batched sample() functions filter 4 coordinates at once with SSE2 when the compiler targets it
+        // supported are char and float images with 1 to 4 channels
+
+        enum class SamplerFilter {
+            NEAREST,
+            LINEAR, // bilinear for ImageSampler, trilinear for ImageSampler3D
+        };
+
+        enum class SamplerAddressMode {
+            REPEAT, // coordinates outside [0, 1] wrap around
+            CLAMP_TO_EDGE, // coordinates outside [0, 1] use the pixels at the edge of the image
+        };
+
+        template<typename PIXEL_TYPE, uint32_t CHANNELS>
+        class ImageSampler {
+            /** samples an ImageData at uv coordinates (range [0, 1], the pixel centers are at (x + 0.5) / width)
+            * the sampler only stores a pointer to the pixels, the image has to stay alive and keep its extent while it is sampled */
+
+          protected:
+
+            const PIXEL_TYPE* _pixels = nullptr;
+            uint32_t _width = 0;
+            uint32_t _height = 0;
+
+            SamplerFilter _filter = SamplerFilter::LINEAR;
+            SamplerAddressMode _address_u = SamplerAddressMode::REPEAT;
+            SamplerAddressMode _address_v = SamplerAddressMode::REPEAT;
+
+          public:
+
+            ImageSampler() = default;
+            ImageSampler(const ImageData<PIXEL_TYPE>& image, SamplerFilter filter = SamplerFilter::LINEAR, SamplerAddressMode address_mode = SamplerAddressMode::REPEAT);
+
+            /// @return false if the image doesnt have CHANNELS channels (the sampler returns 0 for every sample then)
+            bool setImage(const ImageData<PIXEL_TYPE>& image);
+
+            void setFilter(SamplerFilter filter);
+            void setAddressMode(SamplerAddressMode u, SamplerAddressMode v);
+
+            /// @brief writes the CHANNELS channels of the sample to dst
+            void sample(float u, float v, float* dst) const;
+
+            /// @brief samples count coordinates (u[i], v[i]) and writes the channels of sample i to dst[i * CHANNELS]
+            void sample(const float* u, const float* v, size_t count, float* dst) const;
+
+          protected:
+
+            const PIXEL_TYPE* getPixel(int32_t x, int32_t y) const;
+
+        };
+
+        template<typename PIXEL_TYPE, uint32_t CHANNELS>
+        class ImageSampler3D {
+            /** samples an ImageData3D at uvw coordinates (range [0, 1], the pixel centers are at (x + 0.5) / width)
+            * the sampler only stores pointers to the layers, the image has to stay alive and keep its extent while it is sampled */
+
+          protected:
+
+            std::vector<const PIXEL_TYPE*> _layers; // the pixels of every layer of the image
+            uint32_t _width = 0;
+            uint32_t _height = 0;
+            uint32_t _depth = 0;
+
+            SamplerFilter _filter = SamplerFilter::LINEAR;
+            SamplerAddressMode _address_u = SamplerAddressMode::REPEAT;
+            SamplerAddressMode _address_v = SamplerAddressMode::REPEAT;
+            SamplerAddressMode _address_w = SamplerAddressMode::REPEAT;
+
+          public:
+
+            ImageSampler3D() = default;
+            ImageSampler3D(const ImageData3D<PIXEL_TYPE>& image, SamplerFilter filter = SamplerFilter::LINEAR, SamplerAddressMode address_mode = SamplerAddressMode::REPEAT);
+
+            /// @return false if the image doesnt have CHANNELS channels (the sampler returns 0 for every sample then)
+            bool setImage(const ImageData3D<PIXEL_TYPE>& image);
+
+            void setFilter(SamplerFilter filter);
+            void setAddressMode(SamplerAddressMode u, SamplerAddressMode v, SamplerAddressMode w);
+
+            /// @brief writes the CHANNELS channels of the sample to dst
+            void sample(float u, float v, float w, float* dst) const;
+
+            /// @brief samples count coordinates (u[i], v[i], w[i]) and writes the channels of sample i to dst[i * CHANNELS]
+            void sample(const float* u, const float* v, const float* w, size_t count, float* dst) const;
+
+          protected:
+
+            const PIXEL_TYPE* getPixel(int32_t x, int32_t y, int32_t z) const;
+
+        };
+
+    } // tools
+
+} // undicht
+
+#endif // IMAGE_SAMPLER_H
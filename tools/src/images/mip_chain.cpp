@@ -0,0 +1,438 @@
+#include "mip_chain.h"
+#include "images/pixel_conversion.h"
+#include "job_system.h"
+#include "debug.h"
+#include "cmath"
+#include "cstring"
+#include "algorithm"
+#include "type_traits"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include "emmintrin.h"
+#define UND_MIP_SSE2
+#endif
+
+// the number of floats filtered by a single job (rows get grouped until they reach this size)
+#ifndef MIP_CHAIN_JOB_SIZE
+#define MIP_CHAIN_JOB_SIZE 16384
+#endif
+
+namespace undicht {
+
+    namespace tools {
+
+        /////////////////////////////////////// filter kernels ///////////////////////////////////////
+
+        const float KERNEL_RADIUS = 3.0f; // of the kaiser and lanczos filter (in pixels of the downsampled image)
+        const float KAISER_ALPHA = 4.0f;
+
+        static float sinc(float x) {
+
+            if(std::abs(x) < 1.0e-5f)
+                return 1.0f;
+
+            x *= 3.14159265f;
+
+            return std::sin(x) / x;
+        }
+
+        // modified bessel function of the first kind (order 0), used by the kaiser window
+        static float bessel0(float x) {
+
+            float sum = 1.0f;
+            float term = 1.0f;
+            float x_half = x * 0.5f;
+
+            for(int i = 1; i < 32; i++) {
+
+                term *= x_half / i;
+                sum += term * term;
+
+                if(term * term < sum * 1.0e-8f)
+                    break;
+            }
+
+            return sum;
+        }
+
+        static float evalKernel(MipFilter filter, float t) {
+            // t is the distance to the center of the downsampled pixel (in its pixels)
+
+            if(std::abs(t) >= KERNEL_RADIUS)
+                return 0.0f;
+
+            if(filter == MipFilter::KAISER) {
+                float s = t / KERNEL_RADIUS;
+                return sinc(t) * bessel0(KAISER_ALPHA * std::sqrt(1.0f - s * s)) / bessel0(KAISER_ALPHA);
+            }
+
+            return sinc(t) * sinc(t / KERNEL_RADIUS); // lanczos
+        }
+
+        /////////////////////////////////////// filtering one axis ///////////////////////////////////////
+
+        struct FilterAxis {
+            // the source pixels (and their weights) that make up the pixels of the downsampled axis
+
+            uint32_t tap_count = 0;
+            std::vector<uint32_t> indices; // tap_count indices per downsampled pixel
+            std::vector<float> weights;
+        };
+
+        static uint32_t addressTap(int32_t i, uint32_t size, SamplerAddressMode mode) {
+
+            if(mode == SamplerAddressMode::REPEAT)
+                return uint32_t(((i % int32_t(size)) + int32_t(size)) % int32_t(size));
+
+            return uint32_t(i < 0 ? 0 : (i >= int32_t(size) ? int32_t(size) - 1 : i));
+        }
+
+        static void initFilterAxis(FilterAxis& axis, MipFilter filter, SamplerAddressMode mode, uint32_t src_tile, uint32_t dst_tile, uint32_t tile_count) {
+            // every tile is filtered on its own (the taps outside of the tile get addressed inside it)
+
+            if(src_tile == dst_tile) {
+                // the axis keeps its size
+
+                axis.tap_count = 1;
+                axis.indices.resize(dst_tile * tile_count);
+                axis.weights.assign(dst_tile * tile_count, 1.0f);
+
+                for(uint32_t i = 0; i < axis.indices.size(); i++)
+                    axis.indices[i] = i;
+
+                return;
+            }
+
+            const float scale = float(src_tile) / float(dst_tile); // source pixels per downsampled pixel
+            const float radius = ((filter == MipFilter::BOX) ? 0.5f : KERNEL_RADIUS) * scale; // in source pixels
+
+            axis.tap_count = uint32_t(std::ceil(2.0f * radius)) + 1;
+            axis.indices.resize(dst_tile * tile_count * axis.tap_count);
+            axis.weights.resize(dst_tile * tile_count * axis.tap_count);
+
+            for(uint32_t x = 0; x < dst_tile; x++) {
+
+                uint32_t* indices = axis.indices.data() + x * axis.tap_count;
+                float* weights = axis.weights.data() + x * axis.tap_count;
+
+                float center = (x + 0.5f) * scale;
+                int32_t first = int32_t(std::floor(center - radius));
+                float weight_sum = 0.0f;
+
+                for(uint32_t tap = 0; tap < axis.tap_count; tap++) {
+
+                    int32_t i = first + int32_t(tap);
+
+                    if(filter == MipFilter::BOX) {
+                        // the part of the source pixel that is covered by the downsampled pixel
+                        float covered = std::min(i + 1.0f, center + radius) - std::max(float(i), center - radius);
+                        weights[tap] = covered > 0.0f ? covered : 0.0f;
+                    } else {
+                        weights[tap] = evalKernel(filter, (i + 0.5f - center) / scale);
+                    }
+
+                    indices[tap] = addressTap(i, src_tile, mode);
+                    weight_sum += weights[tap];
+                }
+
+                for(uint32_t tap = 0; tap < axis.tap_count; tap++)
+                    weights[tap] /= weight_sum;
+
+            }
+
+            // dropping the taps at the end that have no weight for any pixel (i.e. the box filter only needs 2 taps for even extents)
+            uint32_t used_taps = 1;
+            for(uint32_t i = 0; i < dst_tile * axis.tap_count; i++)
+                if(axis.weights[i] != 0.0f)
+                    used_taps = std::max(used_taps, i % axis.tap_count + 1);
+
+            for(uint32_t x = 0; x < dst_tile; x++) {
+                for(uint32_t tap = 0; tap < used_taps; tap++) {
+
+                    axis.indices[x * used_taps + tap] = axis.indices[x * axis.tap_count + tap];
+                    axis.weights[x * used_taps + tap] = axis.weights[x * axis.tap_count + tap];
+                }
+            }
+
+            axis.tap_count = used_taps;
+
+            // the other tiles use the same weights with their own pixels
+            for(uint32_t tile = 1; tile < tile_count; tile++) {
+                for(uint32_t i = 0; i < dst_tile * axis.tap_count; i++) {
+
+                    axis.indices[tile * dst_tile * axis.tap_count + i] = axis.indices[i] + tile * src_tile;
+                    axis.weights[tile * dst_tile * axis.tap_count + i] = axis.weights[i];
+                }
+            }
+
+        }
+
+        static void filterRow(const float* src, float* dst, const FilterAxis& axis, uint32_t dst_width, uint32_t channels) {
+            // downsamples a row of pixels
+
+            for(uint32_t x = 0; x < dst_width; x++) {
+
+                const uint32_t* indices = axis.indices.data() + x * axis.tap_count;
+                const float* weights = axis.weights.data() + x * axis.tap_count;
+                float* pixel = dst + x * channels;
+
+#if defined(UND_MIP_SSE2)
+                if(channels == 4) {
+                    // one pixel fits into a register
+
+                    __m128 sum = _mm_setzero_ps();
+
+                    for(uint32_t tap = 0; tap < axis.tap_count; tap++)
+                        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + indices[tap] * 4), _mm_set1_ps(weights[tap])));
+
+                    _mm_storeu_ps(pixel, sum);
+                    continue;
+                }
+#endif
+
+                for(uint32_t c = 0; c < channels; c++)
+                    pixel[c] = 0.0f;
+
+                for(uint32_t tap = 0; tap < axis.tap_count; tap++)
+                    for(uint32_t c = 0; c < channels; c++)
+                        pixel[c] += src[indices[tap] * channels + c] * weights[tap];
+
+            }
+
+        }
+
+        static void filterColumns(const float* src, float* dst, const uint32_t* rows, const float* weights, uint32_t tap_count, uint32_t row_size) {
+            // dst = the weighted sum of the source rows
+
+            uint32_t i = 0;
+
+#if defined(UND_MIP_SSE2)
+            for(; i + 8 <= row_size; i += 8) {
+
+                __m128 sum0 = _mm_setzero_ps();
+                __m128 sum1 = _mm_setzero_ps();
+
+                for(uint32_t tap = 0; tap < tap_count; tap++) {
+
+                    const float* row = src + size_t(rows[tap]) * row_size + i;
+                    __m128 weight = _mm_set1_ps(weights[tap]);
+                    sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(row), weight));
+                    sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(row + 4), weight));
+                }
+
+                _mm_storeu_ps(dst + i, sum0);
+                _mm_storeu_ps(dst + i + 4, sum1);
+            }
+#endif
+
+            for(; i < row_size; i++) {
+
+                float sum = 0.0f;
+
+                for(uint32_t tap = 0; tap < tap_count; tap++)
+                    sum += src[size_t(rows[tap]) * row_size + i] * weights[tap];
+
+                dst[i] = sum;
+            }
+
+        }
+
+        static void renormalizeRow(float* row, uint32_t width, uint32_t channels, bool unorm) {
+            // the filtered normals get shorter where they point in different directions
+            // unorm normals are stored in the [0, 1] range (filtering them is the same as filtering the decoded normals)
+
+            for(uint32_t x = 0; x < width; x++) {
+
+                float* n = row + x * channels;
+                float v[3];
+
+                for(int c = 0; c < 3; c++)
+                    v[c] = unorm ? n[c] * 2.0f - 1.0f : n[c];
+
+                float length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+
+                if(length < 1.0e-6f)
+                    continue;
+
+                for(int c = 0; c < 3; c++)
+                    n[c] = unorm ? (v[c] / length) * 0.5f + 0.5f : v[c] / length;
+
+            }
+
+        }
+
+        /////////////////////////////////////// converting rows ///////////////////////////////////////
+
+        static void decodeRow(const char* src, float* dst, uint32_t width, uint32_t channels, bool srgb) {
+
+            const uint8_t* bytes = (const uint8_t*)src;
+
+            if(!srgb) {
+                convertUnorm8ToFloat(bytes, dst, width * channels);
+                return;
+            }
+
+            convertSRGBToLinear(bytes, dst, width * channels);
+
+            if((channels == 2) || (channels == 4)) // alpha is linear
+                for(uint32_t x = 0; x < width; x++)
+                    convertUnorm8ToFloat(bytes + x * channels + channels - 1, dst + x * channels + channels - 1, 1);
+
+        }
+
+        static void decodeRow(const float* src, float* dst, uint32_t width, uint32_t channels, bool /*srgb*/) {
+            // float images are always stored linear
+
+            std::memcpy(dst, src, width * channels * sizeof(float));
+        }
+
+        static void encodeRow(const float* src, char* dst, uint32_t width, uint32_t channels, bool srgb) {
+
+            uint8_t* bytes = (uint8_t*)dst;
+
+            if(!srgb) {
+                convertFloatToUnorm8(src, bytes, width * channels);
+                return;
+            }
+
+            convertLinearToSRGB(src, bytes, width * channels);
+
+            if((channels == 2) || (channels == 4)) // alpha is linear
+                for(uint32_t x = 0; x < width; x++)
+                    convertFloatToUnorm8(src + x * channels + channels - 1, bytes + x * channels + channels - 1, 1);
+
+        }
+
+        static void encodeRow(const float* src, float* dst, uint32_t width, uint32_t channels, bool /*srgb*/) {
+            // float images are always stored linear
+
+            std::memcpy(dst, src, width * channels * sizeof(float));
+        }
+
+        static uint32_t calcRowsPerJob(uint32_t row_size) {
+
+            return row_size < MIP_CHAIN_JOB_SIZE ? MIP_CHAIN_JOB_SIZE / row_size : 1;
+        }
+
+        /////////////////////////////////////// building the mip chain ///////////////////////////////////////
+
+        uint32_t calcMipLevelCount(uint32_t width, uint32_t height) {
+            /// @return the number of levels of a full mip chain (until the extent is 1x1)
+
+            uint32_t max_dim = std::max(width, height);
+            uint32_t mip_levels = 1;
+
+            while(max_dim /= 2) mip_levels++;
+
+            return mip_levels;
+        }
+
+        template<typename PIXEL_TYPE>
+        bool buildMipChain(const ImageData<PIXEL_TYPE>& image, std::vector<ImageData<PIXEL_TYPE>>& loadTo_levels, const MipChainSettings& settings) {
+            /// @brief builds the mip chain of the image, loadTo_levels[0] is a copy of the image
+            /// every level has half the extent of the previous one (at least 1 pixel) until the image (or its tiles) is 1x1
+            /// @return false if the image is empty or the tile extent doesnt divide the image extent
+
+            const uint32_t width = image.getWidth();
+            const uint32_t height = image.getHeight();
+            const uint32_t channels = image.getNrChannels();
+
+            if(!width || !height || !channels) {
+                UND_ERROR << "failed to build mip chain: the image is empty\n";
+                return false;
+            }
+
+            const uint32_t tile_width = settings.tile_width ? settings.tile_width : width;
+            const uint32_t tile_height = settings.tile_height ? settings.tile_height : height;
+
+            if((width % tile_width) || (height % tile_height)) {
+                UND_ERROR << "failed to build mip chain: the tile extent doesnt divide the image extent\n";
+                return false;
+            }
+
+            const uint32_t tiles_x = width / tile_width;
+            const uint32_t tiles_y = height / tile_height;
+
+            bool normal_map = settings.normal_map;
+            if(normal_map && (channels < 3)) {
+                UND_WARNING << "the image has less than 3 channels, it gets filtered as a color image instead of a normal map\n";
+                normal_map = false;
+            }
+
+            const bool srgb = settings.srgb && !normal_map;
+            const uint32_t level_count = std::max(1u, std::min(calcMipLevelCount(tile_width, tile_height), settings.max_levels));
+
+            loadTo_levels.clear();
+            loadTo_levels.reserve(level_count);
+            loadTo_levels.push_back(image);
+
+            if(level_count == 1)
+                return true;
+
+            // the previous level in linear floats
+            std::vector<float> src(size_t(width) * height * channels);
+
+            JobSystem::parallelFor(0, height, calcRowsPerJob(width * channels), [&](uint32_t y) {
+                decodeRow(image.getPixel(0, y), src.data() + size_t(y) * width * channels, width, channels, srgb);
+            });
+
+            std::vector<float> tmp; // the previous level downsampled along the x axis
+            std::vector<float> dst;
+            FilterAxis axis_x;
+            FilterAxis axis_y;
+
+            uint32_t src_tile_width = tile_width;
+            uint32_t src_tile_height = tile_height;
+
+            for(uint32_t level = 1; level < level_count; level++) {
+
+                const uint32_t dst_tile_width = std::max(1u, src_tile_width / 2);
+                const uint32_t dst_tile_height = std::max(1u, src_tile_height / 2);
+
+                const uint32_t src_width = src_tile_width * tiles_x;
+                const uint32_t src_height = src_tile_height * tiles_y;
+                const uint32_t dst_width = dst_tile_width * tiles_x;
+                const uint32_t dst_height = dst_tile_height * tiles_y;
+                const uint32_t dst_row_size = dst_width * channels;
+
+                initFilterAxis(axis_x, settings.filter, settings.address_mode, src_tile_width, dst_tile_width, tiles_x);
+                initFilterAxis(axis_y, settings.filter, settings.address_mode, src_tile_height, dst_tile_height, tiles_y);
+
+                tmp.resize(size_t(dst_row_size) * src_height);
+                dst.resize(size_t(dst_row_size) * dst_height);
+
+                JobSystem::parallelFor(0, src_height, calcRowsPerJob(src_width * channels), [&](uint32_t y) {
+                    filterRow(src.data() + size_t(y) * src_width * channels, tmp.data() + size_t(y) * dst_row_size, axis_x, dst_width, channels);
+                });
+
+                loadTo_levels.emplace_back(dst_width, dst_height, channels);
+                ImageData<PIXEL_TYPE>& dst_level = loadTo_levels.back();
+
+                JobSystem::parallelFor(0, dst_height, calcRowsPerJob(dst_row_size * axis_y.tap_count), [&](uint32_t y) {
+
+                    float* row = dst.data() + size_t(y) * dst_row_size;
+                    const uint32_t* rows = axis_y.indices.data() + y * axis_y.tap_count;
+                    const float* weights = axis_y.weights.data() + y * axis_y.tap_count;
+
+                    filterColumns(tmp.data(), row, rows, weights, axis_y.tap_count, dst_row_size);
+
+                    if(normal_map)
+                        renormalizeRow(row, dst_width, channels, std::is_same<PIXEL_TYPE, char>::value);
+
+                    encodeRow(row, dst_level.getPixel(0, y), dst_width, channels, srgb);
+                });
+
+                src.swap(dst);
+                src_tile_width = dst_tile_width;
+                src_tile_height = dst_tile_height;
+            }
+
+            return true;
+        }
+
+        template bool buildMipChain<char>(const ImageData<char>& image, std::vector<ImageData<char>>& loadTo_levels, const MipChainSettings& settings);
+        template bool buildMipChain<float>(const ImageData<float>& image, std::vector<ImageData<float>>& loadTo_levels, const MipChainSettings& settings);
+
+    } // tools
+
+} // undicht
@@ -0,0 +1,60 @@
+#ifndef MIP_CHAIN_H
+#define MIP_CHAIN_H
+
+#include "cstdint"
+#include "vector"
+#include "images/image_data.h"
+#include "images/image_sampler.h"
+
+namespace undicht {
+
+    namespace tools {
+
+        // building the mip levels of an image on the cpu (i.e. for textures that get uploaded with auto generated mip maps disabled)
+        // every level gets filtered from the previous one in 32 bit floats, so the 8 bit rounding errors dont add up
+        // the filters are separable, the rows of a level are filtered in parallel (JobSystem) and with SSE2 when the compiler targets it
+
+        enum class MipFilter {
+            BOX, // averages the pixels covered by the new pixel (2x2 for even extents)
+            KAISER, // windowed sinc (radius 3, alpha 4), sharper than BOX without much ringing
+            LANCZOS, // lanczos 3, the sharpest, but causes slight halos at hard edges
+        };
+
+        struct MipChainSettings {
+
+            MipFilter filter = MipFilter::KAISER;
+
+            // how the filter reads pixels outside of the image (or outside of the tile for tiled images)
+            SamplerAddressMode address_mode = SamplerAddressMode::CLAMP_TO_EDGE;
+
+            // the color channels are srgb encoded and get filtered in linear space (only used for 8 bit images, not for normal maps)
+            // alpha stays linear (the last channel of 2 and 4 channel images)
+            bool srgb = false;
+
+            // the first 3 channels store a normal, which gets renormalized on every level
+            // (8 bit images map 0 to 255 to -1 to 1, float images store the normal directly)
+            bool normal_map = false;
+
+            // if not 0, the image is made of tiles of this extent (i.e. a texture atlas)
+            // every tile gets downsampled on its own, so neighbouring tiles dont bleed into each other
+            uint32_t tile_width = 0;
+            uint32_t tile_height = 0;
+
+            // the maximum number of levels (including the original image)
+            uint32_t max_levels = 0xffffffff;
+        };
+
+        /// @return the number of levels of a full mip chain (until the extent is 1x1)
+        uint32_t calcMipLevelCount(uint32_t width, uint32_t height);
+
+        /// @brief builds the mip chain of the image, loadTo_levels[0] is a copy of the image
+        /// every level has half the extent of the previous one (at least 1 pixel) until the image (or its tiles) is 1x1
+        /// @return false if the image is empty or the tile extent doesnt divide the image extent
+        template<typename PIXEL_TYPE>
+        bool buildMipChain(const ImageData<PIXEL_TYPE>& image, std::vector<ImageData<PIXEL_TYPE>>& loadTo_levels, const MipChainSettings& settings = MipChainSettings());
+
+    } // tools
+
+} // undicht
+
+#endif // MIP_CHAIN_H
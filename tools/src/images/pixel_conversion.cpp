@@ -0,0 +1,643 @@
+#include "pixel_conversion.h"
+#include "debug.h"
+#include "cstring"
+#include "cmath"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include "emmintrin.h"
+#define UND_PIXEL_SSE2
+#endif
+
+#if defined(__AVX__) && defined(__F16C__)
+#include "immintrin.h"
+#define UND_PIXEL_F16C
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include "arm_neon.h"
+#define UND_PIXEL_NEON
+#endif
+
+namespace undicht {
+
+    namespace tools {
+
+        static uint32_t floatBits(float f) {
+
+            uint32_t bits;
+            std::memcpy(&bits, &f, sizeof(float));
+
+            return bits;
+        }
+
+        static float bitsToFloat(uint32_t bits) {
+
+            float f;
+            std::memcpy(&f, &bits, sizeof(float));
+
+            return f;
+        }
+
+        /////////////////////////////////////// float16 ///////////////////////////////////////
+        // bit manipulation based on https://gist.github.com/rygorous/2156668
+
+        uint16_t floatToHalf(float f) {
+            // round to nearest even, values too large for a 16 bit float become infinity
+
+            uint32_t bits = floatBits(f);
+            uint32_t sign = (bits >> 16) & 0x8000;
+            uint32_t abs_bits = bits & 0x7fffffff;
+
+            if(abs_bits >= 0x47800000) // infinity, nan or too large
+                return sign | (abs_bits > 0x7f800000 ? 0x7e00 : 0x7c00);
+
+            if(abs_bits < 0x38800000) { // the result is a subnormal 16 bit float (or 0)
+                // adding 0.5 moves the value into the mantissa, the fpu does the rounding
+                float subnormal = bitsToFloat(abs_bits) + 0.5f;
+                return sign | (floatBits(subnormal) - 0x3f000000);
+            }
+
+            // adjusting the exponent and rounding the mantissa
+            uint32_t mantissa_odd = (abs_bits >> 13) & 1;
+            abs_bits += 0xc8000fff + mantissa_odd;
+
+            return sign | (abs_bits >> 13);
+        }
+
+        float halfToFloat(uint16_t h) {
+
+            uint32_t sign = uint32_t(h & 0x8000) << 16;
+            uint32_t bits = uint32_t(h & 0x7fff) << 13;
+            uint32_t exponent = bits & 0x0f800000;
+
+            bits += (127 - 15) << 23; // adjusting the exponent
+
+            if(exponent == 0x0f800000) { // infinity / nan
+                bits += (128 - 16) << 23;
+            } else if(exponent == 0) { // subnormal
+                bits += 1 << 23;
+                bits = floatBits(bitsToFloat(bits) - bitsToFloat(113 << 23));
+            }
+
+            return bitsToFloat(bits | sign);
+        }
+
+#ifdef UND_PIXEL_SSE2
+
+        static __m128i select(__m128i mask, __m128i a, __m128i b) {
+            // a where mask is set, b everywhere else
+
+            return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+        }
+
+        static __m128i floatToHalfSSE2(__m128 f) {
+            // same as floatToHalf() for 4 floats, the results are stored in the lower 16 bits of each 32 bit lane
+
+            __m128i bits = _mm_castps_si128(f);
+            __m128i sign = _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(0x8000));
+            __m128i abs_bits = _mm_and_si128(bits, _mm_set1_epi32(0x7fffffff));
+
+            __m128i subnormal = _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(abs_bits), _mm_set1_ps(0.5f)));
+            subnormal = _mm_sub_epi32(subnormal, _mm_set1_epi32(0x3f000000));
+
+            __m128i mantissa_odd = _mm_and_si128(_mm_srli_epi32(abs_bits, 13), _mm_set1_epi32(1));
+            __m128i normal = _mm_add_epi32(_mm_add_epi32(abs_bits, _mm_set1_epi32(0xc8000fff)), mantissa_odd);
+            normal = _mm_srli_epi32(normal, 13);
+
+            __m128i is_nan = _mm_cmpgt_epi32(abs_bits, _mm_set1_epi32(0x7f800000));
+            __m128i inf_nan = select(is_nan, _mm_set1_epi32(0x7e00), _mm_set1_epi32(0x7c00));
+
+            __m128i is_subnormal = _mm_cmplt_epi32(abs_bits, _mm_set1_epi32(0x38800000));
+            __m128i is_large = _mm_cmpgt_epi32(abs_bits, _mm_set1_epi32(0x477fffff));
+
+            __m128i result = select(is_subnormal, subnormal, normal);
+            result = select(is_large, inf_nan, result);
+
+            return _mm_or_si128(result, sign);
+        }
+
+        static __m128 halfToFloatSSE2(__m128i h) {
+            // same as halfToFloat() for 4 values stored in the lower 16 bits of each 32 bit lane
+
+            __m128i sign = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+            __m128i bits = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7fff)), 13);
+            __m128i exponent = _mm_and_si128(bits, _mm_set1_epi32(0x0f800000));
+
+            bits = _mm_add_epi32(bits, _mm_set1_epi32((127 - 15) << 23));
+
+            __m128i is_inf_nan = _mm_cmpeq_epi32(exponent, _mm_set1_epi32(0x0f800000));
+            bits = _mm_add_epi32(bits, _mm_and_si128(is_inf_nan, _mm_set1_epi32((128 - 16) << 23)));
+
+            __m128i is_subnormal = _mm_cmpeq_epi32(exponent, _mm_setzero_si128());
+            __m128 subnormal = _mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(1 << 23)));
+            subnormal = _mm_sub_ps(subnormal, _mm_castsi128_ps(_mm_set1_epi32(113 << 23)));
+            bits = select(is_subnormal, _mm_castps_si128(subnormal), bits);
+
+            return _mm_castsi128_ps(_mm_or_si128(bits, sign));
+        }
+
+#endif // UND_PIXEL_SSE2
+
+        void convertFloat32ToFloat16(const float* src, uint16_t* dst, size_t count) {
+            // round to nearest even, values too large for a 16 bit float become infinity
+
+            size_t i = 0;
+
+#if defined(UND_PIXEL_F16C)
+            for(; i + 8 <= count; i += 8) {
+                __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+                _mm_storeu_si128((__m128i*)(dst + i), h);
+            }
+#elif defined(UND_PIXEL_SSE2)
+            for(; i + 8 <= count; i += 8) {
+                __m128i h0 = floatToHalfSSE2(_mm_loadu_ps(src + i));
+                __m128i h1 = floatToHalfSSE2(_mm_loadu_ps(src + i + 4));
+                // sign extending, so that packing with signed saturation keeps all 16 bits
+                h0 = _mm_srai_epi32(_mm_slli_epi32(h0, 16), 16);
+                h1 = _mm_srai_epi32(_mm_slli_epi32(h1, 16), 16);
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(h0, h1));
+            }
+#elif defined(UND_PIXEL_NEON)
+            for(; i + 4 <= count; i += 4) {
+                float16x4_t h = vcvt_f16_f32(vld1q_f32(src + i));
+                vst1_u16(dst + i, vreinterpret_u16_f16(h));
+            }
+#endif
+
+            for(; i < count; i++)
+                dst[i] = floatToHalf(src[i]);
+
+        }
+
+        void convertFloat16ToFloat32(const uint16_t* src, float* dst, size_t count) {
+
+            size_t i = 0;
+
+#if defined(UND_PIXEL_F16C)
+            for(; i + 8 <= count; i += 8) {
+                __m256 f = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(src + i)));
+                _mm256_storeu_ps(dst + i, f);
+            }
+#elif defined(UND_PIXEL_SSE2)
+            for(; i + 8 <= count; i += 8) {
+                __m128i h = _mm_loadu_si128((const __m128i*)(src + i));
+                _mm_storeu_ps(dst + i, halfToFloatSSE2(_mm_unpacklo_epi16(h, _mm_setzero_si128())));
+                _mm_storeu_ps(dst + i + 4, halfToFloatSSE2(_mm_unpackhi_epi16(h, _mm_setzero_si128())));
+            }
+#elif defined(UND_PIXEL_NEON)
+            for(; i + 4 <= count; i += 4) {
+                float32x4_t f = vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i)));
+                vst1q_f32(dst + i, f);
+            }
+#endif
+
+            for(; i < count; i++)
+                dst[i] = halfToFloat(src[i]);
+
+        }
+
+        /////////////////////////////////////// unsigned normalized ///////////////////////////////////////
+
+        static uint8_t floatToUnorm8(float f) {
+
+            f = f > 0.0f ? (f < 1.0f ? f : 1.0f) : 0.0f; // nan becomes 0
+
+            return (uint8_t)std::lrint(f * 255.0f);
+        }
+
+        void convertFloatToUnorm8(const float* src, uint8_t* dst, size_t count) {
+
+            size_t i = 0;
+
+#if defined(UND_PIXEL_SSE2)
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 scale = _mm_set1_ps(255.0f);
+
+            for(; i + 16 <= count; i += 16) {
+
+                __m128i v[4];
+                for(int j = 0; j < 4; j++) {
+                    __m128 f = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + j * 4), zero), one);
+                    v[j] = _mm_cvtps_epi32(_mm_mul_ps(f, scale));
+                }
+
+                __m128i packed = _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]), _mm_packs_epi32(v[2], v[3]));
+                _mm_storeu_si128((__m128i*)(dst + i), packed);
+            }
+#elif defined(UND_PIXEL_NEON)
+            for(; i + 8 <= count; i += 8) {
+                float32x4_t f0 = vminq_f32(vmaxq_f32(vld1q_f32(src + i), vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f));
+                float32x4_t f1 = vminq_f32(vmaxq_f32(vld1q_f32(src + i + 4), vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f));
+                uint32x4_t u0 = vcvtnq_u32_f32(vmulq_n_f32(f0, 255.0f));
+                uint32x4_t u1 = vcvtnq_u32_f32(vmulq_n_f32(f1, 255.0f));
+                vst1_u8(dst + i, vmovn_u16(vcombine_u16(vmovn_u32(u0), vmovn_u32(u1))));
+            }
+#endif
+
+            for(; i < count; i++)
+                dst[i] = floatToUnorm8(src[i]);
+
+        }
+
+        void convertUnorm8ToFloat(const uint8_t* src, float* dst, size_t count) {
+
+            const float scale = 1.0f / 255.0f;
+            size_t i = 0;
+
+#if defined(UND_PIXEL_SSE2)
+            const __m128i zero = _mm_setzero_si128();
+
+            for(; i + 16 <= count; i += 16) {
+
+                __m128i bytes = _mm_loadu_si128((const __m128i*)(src + i));
+                __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+                __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+
+                _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), _mm_set1_ps(scale)));
+                _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), _mm_set1_ps(scale)));
+                _mm_storeu_ps(dst + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), _mm_set1_ps(scale)));
+                _mm_storeu_ps(dst + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), _mm_set1_ps(scale)));
+            }
+#elif defined(UND_PIXEL_NEON)
+            for(; i + 8 <= count; i += 8) {
+                uint16x8_t u = vmovl_u8(vld1_u8(src + i));
+                vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(u))), scale));
+                vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(u))), scale));
+            }
+#endif
+
+            for(; i < count; i++)
+                dst[i] = src[i] * scale;
+
+        }
+
+        /////////////////////////////////////// srgb ///////////////////////////////////////
+
+        static double srgbToLinear(double c) {
+
+            return c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+        }
+
+        struct SRGBTables {
+            // lookup tables for the srgb conversions (a lot faster than calculating std::pow() for every component)
+
+            float m_to_linear[256];
+
+            // m_thresholds[i] is the smallest linear value that gets encoded as i + 1
+            float m_thresholds[255];
+
+            // encoded value for the start of each of the buckets of the [0, 1] range
+            uint8_t m_bucket_start[4097];
+
+            SRGBTables() {
+
+                for(int i = 0; i < 256; i++)
+                    m_to_linear[i] = (float)srgbToLinear(i / 255.0);
+
+                for(int i = 0; i < 255; i++)
+                    m_thresholds[i] = (float)srgbToLinear((i + 0.5) / 255.0);
+
+                uint8_t encoded = 0;
+                for(int i = 0; i <= 4096; i++) {
+
+                    while((encoded < 255) && (i / 4096.0f >= m_thresholds[encoded]))
+                        encoded++;
+
+                    m_bucket_start[i] = encoded;
+                }
+
+            }
+
+            uint8_t encode(float linear) const {
+
+                linear = linear > 0.0f ? (linear < 1.0f ? linear : 1.0f) : 0.0f; // nan becomes 0
+
+                // the buckets are small enough that only a few thresholds have to be checked
+                uint32_t encoded = m_bucket_start[(uint32_t)(linear * 4096.0f)];
+
+                while((encoded < 255) && (linear >= m_thresholds[encoded]))
+                    encoded++;
+
+                return encoded;
+            }
+
+        };
+
+        static const SRGBTables& getSRGBTables() {
+
+            static const SRGBTables tables;
+
+            return tables;
+        }
+
+        void convertLinearToSRGB(const float* src, uint8_t* dst, size_t count) {
+
+            const SRGBTables& tables = getSRGBTables();
+
+            for(size_t i = 0; i < count; i++)
+                dst[i] = tables.encode(src[i]);
+
+        }
+
+        void convertSRGBToLinear(const uint8_t* src, float* dst, size_t count) {
+
+            const SRGBTables& tables = getSRGBTables();
+
+            for(size_t i = 0; i < count; i++)
+                dst[i] = tables.m_to_linear[src[i]];
+
+        }
+
+        /////////////////////////////////////// kernels working on pixels ///////////////////////////////////////
+
+        void swapRedBlue(const uint8_t* src, uint8_t* dst, size_t pixel_count) {
+            /// @brief swaps the first and third channel of 4 channel 8 bit pixels (rgba <-> bgra), src and dst may be the same
+
+            size_t i = 0;
+
+#if defined(UND_PIXEL_SSE2)
+            const __m128i mask_ga = _mm_set1_epi32(0xff00ff00);
+            const __m128i mask_low = _mm_set1_epi32(0x000000ff);
+
+            for(; i + 4 <= pixel_count; i += 4) {
+                __m128i v = _mm_loadu_si128((const __m128i*)(src + i * 4));
+                __m128i ga = _mm_and_si128(v, mask_ga);
+                __m128i r = _mm_slli_epi32(_mm_and_si128(v, mask_low), 16);
+                __m128i b = _mm_and_si128(_mm_srli_epi32(v, 16), mask_low);
+                _mm_storeu_si128((__m128i*)(dst + i * 4), _mm_or_si128(ga, _mm_or_si128(r, b)));
+            }
+#elif defined(UND_PIXEL_NEON)
+            for(; i + 16 <= pixel_count; i += 16) {
+                uint8x16x4_t v = vld4q_u8(src + i * 4);
+                uint8x16_t red = v.val[0];
+                v.val[0] = v.val[2];
+                v.val[2] = red;
+                vst4q_u8(dst + i * 4, v);
+            }
+#endif
+
+            for(; i < pixel_count; i++) {
+                uint8_t red = src[i * 4 + 0];
+                dst[i * 4 + 0] = src[i * 4 + 2];
+                dst[i * 4 + 1] = src[i * 4 + 1];
+                dst[i * 4 + 2] = red;
+                dst[i * 4 + 3] = src[i * 4 + 3];
+            }
+
+        }
+
+        void convertChannels(const float* src, uint32_t src_channels, float* dst, uint32_t dst_channels, size_t pixel_count) {
+            /// @brief changes the number of channels per pixel
+            /// missing color channels are set to 0, a missing alpha channel to 1, extra channels get dropped
+
+            uint32_t copied = src_channels < dst_channels ? src_channels : dst_channels;
+
+            for(size_t i = 0; i < pixel_count; i++) {
+
+                for(uint32_t c = 0; c < copied; c++)
+                    dst[i * dst_channels + c] = src[i * src_channels + c];
+
+                for(uint32_t c = copied; c < dst_channels; c++)
+                    dst[i * dst_channels + c] = (c == 3) ? 1.0f : 0.0f;
+
+            }
+
+        }
+
+        /////////////////////////////////////// converting between FixedTypes ///////////////////////////////////////
+
+        enum class PixelEncoding {
+            FLOAT32,
+            FLOAT16,
+            UNORM8,
+            SRGB8,
+            UNORM16,
+        };
+
+        struct PixelFormat {
+            PixelEncoding m_encoding;
+            bool m_bgra = false; // first and third channel are swapped
+            uint32_t m_channels = 0;
+        };
+
+        static bool getPixelFormat(const FixedType& type, PixelFormat& format) {
+            /// @return false, if the type is not supported
+
+            if(!type.m_little_endian || (type.m_num_components < 1) || (type.m_num_components > 4))
+                return false;
+
+            format.m_channels = type.m_num_components;
+            format.m_bgra = (type.m_type == Type::COLOR_BGRA) || (type.m_type == Type::COLOR_BGRA_SRGB);
+
+            if((type.m_type == Type::FLOAT) && (type.m_size == 4))
+                format.m_encoding = PixelEncoding::FLOAT32;
+            else if((type.m_type == Type::FLOAT) && (type.m_size == 2))
+                format.m_encoding = PixelEncoding::FLOAT16;
+            else if(((type.m_type == Type::COLOR_RGBA) || (type.m_type == Type::COLOR_BGRA)) && (type.m_size == 1))
+                format.m_encoding = PixelEncoding::UNORM8;
+            else if(((type.m_type == Type::COLOR_RGBA_SRGB) || (type.m_type == Type::COLOR_BGRA_SRGB)) && (type.m_size == 1))
+                format.m_encoding = PixelEncoding::SRGB8;
+            else if((type.m_type == Type::COLOR_RGBA) && (type.m_size == 2))
+                format.m_encoding = PixelEncoding::UNORM16;
+            else
+                return false;
+
+            return true;
+        }
+
+        static void decodePixels(const char* src, const PixelFormat& format, float* dst, size_t pixel_count) {
+            // converts the pixels to floats (with the same number of channels, rgba order)
+
+            size_t count = pixel_count * format.m_channels;
+
+            switch(format.m_encoding) {
+                case PixelEncoding::FLOAT32:
+                    std::memcpy(dst, src, count * sizeof(float));
+                    break;
+                case PixelEncoding::FLOAT16:
+                    convertFloat16ToFloat32((const uint16_t*)src, dst, count);
+                    break;
+                case PixelEncoding::UNORM8:
+                    convertUnorm8ToFloat((const uint8_t*)src, dst, count);
+                    break;
+                case PixelEncoding::SRGB8:
+                    convertSRGBToLinear((const uint8_t*)src, dst, count);
+                    if(format.m_channels == 4) // alpha is always linear
+                        for(size_t i = 0; i < pixel_count; i++)
+                            dst[i * 4 + 3] = ((const uint8_t*)src)[i * 4 + 3] * (1.0f / 255.0f);
+                    break;
+                case PixelEncoding::UNORM16:
+                    for(size_t i = 0; i < count; i++)
+                        dst[i] = ((const uint16_t*)src)[i] * (1.0f / 65535.0f);
+                    break;
+            }
+
+            if(format.m_bgra && (format.m_channels >= 3))
+                for(size_t i = 0; i < pixel_count; i++)
+                    std::swap(dst[i * format.m_channels], dst[i * format.m_channels + 2]);
+
+        }
+
+        static void encodePixels(float* src, const PixelFormat& format, char* dst, size_t pixel_count) {
+            // converts the float pixels (rgba order) to the format (changes the order of channels in src for bgra formats)
+
+            size_t count = pixel_count * format.m_channels;
+
+            if(format.m_bgra && (format.m_channels >= 3))
+                for(size_t i = 0; i < pixel_count; i++)
+                    std::swap(src[i * format.m_channels], src[i * format.m_channels + 2]);
+
+            switch(format.m_encoding) {
+                case PixelEncoding::FLOAT32:
+                    std::memcpy(dst, src, count * sizeof(float));
+                    break;
+                case PixelEncoding::FLOAT16:
+                    convertFloat32ToFloat16(src, (uint16_t*)dst, count);
+                    break;
+                case PixelEncoding::UNORM8:
+                    convertFloatToUnorm8(src, (uint8_t*)dst, count);
+                    break;
+                case PixelEncoding::SRGB8:
+                    convertLinearToSRGB(src, (uint8_t*)dst, count);
+                    if(format.m_channels == 4) // alpha is always linear
+                        for(size_t i = 0; i < pixel_count; i++)
+                            ((uint8_t*)dst)[i * 4 + 3] = floatToUnorm8(src[i * 4 + 3]);
+                    break;
+                case PixelEncoding::UNORM16:
+                    for(size_t i = 0; i < count; i++) {
+                        float f = src[i] > 0.0f ? (src[i] < 1.0f ? src[i] : 1.0f) : 0.0f;
+                        ((uint16_t*)dst)[i] = (uint16_t)std::lrint(f * 65535.0f);
+                    }
+                    break;
+            }
+
+        }
+
+        bool isConvertiblePixelType(const FixedType& type) {
+            /// @return true, if pixels of the type can be converted by convertPixels()
+
+            PixelFormat format;
+
+            return getPixelFormat(type, format);
+        }
+
+        bool convertPixels(const void* src, const FixedType& src_type, void* dst, const FixedType& dst_type, size_t pixel_count) {
+            /// @brief converts pixels from one FixedType to another (the types describe a whole pixel, i.e. UND_R8G8B8A8_SRGB)
+            /// @return false, if the conversion is not supported
+
+            if(src_type == dst_type) {
+                std::memcpy(dst, src, pixel_count * src_type.getSize());
+                return true;
+            }
+
+            PixelFormat src_format;
+            PixelFormat dst_format;
+
+            if(!getPixelFormat(src_type, src_format) || !getPixelFormat(dst_type, dst_format)) {
+                UND_ERROR << "failed to convert pixels: conversion between the types is not supported\n";
+                return false;
+            }
+
+            // conversions that dont need to go through floats
+            if((src_format.m_channels == dst_format.m_channels) && (src_format.m_bgra == dst_format.m_bgra)) {
+
+                size_t count = pixel_count * src_format.m_channels;
+
+                if((src_format.m_encoding == PixelEncoding::FLOAT32) && (dst_format.m_encoding == PixelEncoding::FLOAT16)) {
+                    convertFloat32ToFloat16((const float*)src, (uint16_t*)dst, count);
+                    return true;
+                }
+
+                if((src_format.m_encoding == PixelEncoding::FLOAT16) && (dst_format.m_encoding == PixelEncoding::FLOAT32)) {
+                    convertFloat16ToFloat32((const uint16_t*)src, (float*)dst, count);
+                    return true;
+                }
+
+            }
+
+            if((src_format.m_channels == 4) && (dst_format.m_channels == 4) && (src_format.m_encoding == dst_format.m_encoding)) {
+
+                if((src_format.m_encoding == PixelEncoding::UNORM8) || (src_format.m_encoding == PixelEncoding::SRGB8)) {
+                    // only the order of the channels is different
+                    swapRedBlue((const uint8_t*)src, (uint8_t*)dst, pixel_count);
+                    return true;
+                }
+
+            }
+
+            // converting blocks of pixels to floats and from there to the destination format
+            const size_t BLOCK_SIZE = 256;
+            float decoded[BLOCK_SIZE * 4];
+            float converted[BLOCK_SIZE * 4];
+
+            const char* src_pixels = (const char*)src;
+            char* dst_pixels = (char*)dst;
+
+            for(size_t first = 0; first < pixel_count; first += BLOCK_SIZE) {
+
+                size_t count = (pixel_count - first) < BLOCK_SIZE ? (pixel_count - first) : BLOCK_SIZE;
+
+                decodePixels(src_pixels + first * src_type.getSize(), src_format, decoded, count);
+
+                if(src_format.m_channels != dst_format.m_channels) {
+                    convertChannels(decoded, src_format.m_channels, converted, dst_format.m_channels, count);
+                    encodePixels(converted, dst_format, dst_pixels + first * dst_type.getSize(), count);
+                } else {
+                    encodePixels(decoded, dst_format, dst_pixels + first * dst_type.getSize(), count);
+                }
+
+            }
+
+            return true;
+        }
+
+        template<typename PIXEL_TYPE>
+        bool convertImage(const ImageData<PIXEL_TYPE>& src, const FixedType& src_type, const FixedType& dst_type, std::vector<char>& dst) {
+            /// @brief converts all pixels of the image and stores them in dst
+            /// @param src_type the type of a pixel in the image, has to have as many components as the image has channels
+
+            size_t pixel_count = size_t(src.getWidth()) * src.getHeight();
+
+            if((src_type.getNumComp() != src.getNrChannels()) || (src_type.getSize() * pixel_count != src.getPixelDataSize())) {
+                UND_ERROR << "failed to convert image: the source type does not match the pixels of the image\n";
+                return false;
+            }
+
+            dst.resize(pixel_count * dst_type.getSize());
+
+            return convertPixels(src.getPixelData(), src_type, dst.data(), dst_type, pixel_count);
+        }
+
+        template<typename PIXEL_TYPE>
+        bool convertCubeMap(const CubeMapData<PIXEL_TYPE>& src, const FixedType& src_type, const FixedType& dst_type, std::vector<char>& dst) {
+            /// @brief converts all faces of the cube map and stores them one after the other in dst
+
+            size_t face_pixels = size_t(src.getExtent()) * src.getExtent();
+            dst.resize(6 * face_pixels * dst_type.getSize());
+
+            for(int face = 0; face < 6; face++) {
+
+                const ImageData<PIXEL_TYPE>& face_data = src.getFace((typename CubeMapData<PIXEL_TYPE>::Face)face);
+
+                if((src_type.getNumComp() != face_data.getNrChannels()) || (src_type.getSize() * face_pixels != face_data.getPixelDataSize())) {
+                    UND_ERROR << "failed to convert cube map: the source type does not match the pixels of the cube map\n";
+                    return false;
+                }
+
+                if(!convertPixels(face_data.getPixelData(), src_type, dst.data() + face * face_pixels * dst_type.getSize(), dst_type, face_pixels))
+                    return false;
+
+            }
+
+            return true;
+        }
+
+        template bool convertImage<char>(const ImageData<char>& src, const FixedType& src_type, const FixedType& dst_type, std::vector<char>& dst);
+        template bool convertImage<float>(const ImageData<float>& src, const FixedType& src_type, const FixedType& dst_type, std::vector<char>& dst);
+        template bool convertCubeMap<char>(const CubeMapData<char>& src, const FixedType& src_type, const FixedType& dst_type, std::vector<char>& dst);
+        template bool convertCubeMap<float>(const CubeMapData<float>& src, const FixedType& src_type, const FixedType& dst_type, std::vector<char>& dst);
+
+    } // tools
+
+} // undicht
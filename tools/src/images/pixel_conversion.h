@@ -0,0 +1,67 @@
+#ifndef PIXEL_CONVERSION_H
+#define PIXEL_CONVERSION_H
+
+#include "cstdint"
+#include "cstddef"
+#include "vector"
+#include "types.h"
+#include "images/image_data.h"
+#include "images/cube_map_data.h"
+
+namespace undicht {
+
+    namespace tools {
+
+        // conversion between the pixel formats described by FixedTypes (i.e. UND_VEC4F -> UND_VEC4F16)
+        // the kernels use SSE2 / AVX (+F16C) / NEON when the compiler targets them, with a scalar fallback otherwise
+        // supported pixel types: 32 and 16 bit floats, 8 bit (rgba / bgra, linear / srgb) and 16 bit (rgba) normalized colors
+
+        /////////////////////////////////////// kernels working on components ///////////////////////////////////////
+
+        // round to nearest even, values too large for a 16 bit float become infinity
+        void convertFloat32ToFloat16(const float* src, uint16_t* dst, size_t count);
+        void convertFloat16ToFloat32(const uint16_t* src, float* dst, size_t count);
+
+        uint16_t floatToHalf(float f);
+        float halfToFloat(uint16_t h);
+
+        // conversion between floats in the [0, 1] range and 8 bit unsigned normalized values
+        void convertFloatToUnorm8(const float* src, uint8_t* dst, size_t count);
+        void convertUnorm8ToFloat(const uint8_t* src, float* dst, size_t count);
+
+        // conversion between linear floats and 8 bit srgb encoded values (for all components, alpha has to be handled separately)
+        void convertLinearToSRGB(const float* src, uint8_t* dst, size_t count);
+        void convertSRGBToLinear(const uint8_t* src, float* dst, size_t count);
+
+        /////////////////////////////////////// kernels working on pixels ///////////////////////////////////////
+
+        /// @brief swaps the first and third channel of 4 channel 8 bit pixels (rgba <-> bgra), src and dst may be the same
+        void swapRedBlue(const uint8_t* src, uint8_t* dst, size_t pixel_count);
+
+        /// @brief changes the number of channels per pixel
+        /// missing color channels are set to 0, a missing alpha channel to 1, extra channels get dropped
+        void convertChannels(const float* src, uint32_t src_channels, float* dst, uint32_t dst_channels, size_t pixel_count);
+
+        /////////////////////////////////////// converting between FixedTypes ///////////////////////////////////////
+
+        /// @return true, if pixels of the type can be converted by convertPixels()
+        bool isConvertiblePixelType(const FixedType& type);
+
+        /// @brief converts pixels from one FixedType to another (the types describe a whole pixel, i.e. UND_R8G8B8A8_SRGB)
+        /// @return false, if the conversion is not supported
+        bool convertPixels(const void* src, const FixedType& src_type, void* dst, const FixedType& dst_type, size_t pixel_count);
+
+        /// @brief converts all pixels of the image and stores them in dst
+        /// @param src_type the type of a pixel in the image, has to have as many components as the image has channels
+        template<typename PIXEL_TYPE>
+        bool convertImage(const ImageData<PIXEL_TYPE>& src, const FixedType& src_type, const FixedType& dst_type, std::vector<char>& dst);
+
+        /// @brief converts all faces of the cube map and stores them one after the other in dst
+        template<typename PIXEL_TYPE>
+        bool convertCubeMap(const CubeMapData<PIXEL_TYPE>& src, const FixedType& src_type, const FixedType& dst_type, std::vector<char>& dst);
+
+    } // tools
+
+} // undicht
+
+#endif // PIXEL_CONVERSION_H
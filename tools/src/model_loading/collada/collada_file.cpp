@@ -177,19 +177,19 @@ namespace undicht {
 			if (position_source && load_positions) {
 				attribute_data.emplace_back(std::vector<float>());
 				extractFloatArray(attribute_data.back(), position_source->getContent(), -1);
-				vertex_layout.m_types.push_back(UND_VEC3F);
+				vertex_layout.addType(UND_VEC3F);
 			}
 
 			if (uv_source && load_uvs) {
 				attribute_data.emplace_back(std::vector<float>());
 				extractFloatArray(attribute_data.back(), uv_source->getContent(), -1);
-				vertex_layout.m_types.push_back(UND_VEC2F);
+				vertex_layout.addType(UND_VEC2F);
 			}
 
 			if (normal_source && load_normals) {
 				attribute_data.emplace_back(std::vector<float>());
 				extractFloatArray(attribute_data.back(), normal_source->getContent(), -1);
-				vertex_layout.m_types.push_back(UND_VEC3F);
+				vertex_layout.addType(UND_VEC3F);
 			}
 
 			// getting attribute index data
@@ -0,0 +1,686 @@
+#include "cooked_mesh_file.h"
+#include "debug.h"
+#include "config.h"
+#include "file_tools.h"
+#include "model_loading/mesh_optimizer.h"
+#include "model_loading/obj/obj_file.h"
+#include "model_loading/collada/collada_file.h"
+#include "cstring"
+#include "cstdio"
+#include "cstddef"
+#include "fstream"
+#include "filesystem"
+#include "algorithm"
+
+#ifdef PLATFORM_UNIX
+#include "fcntl.h"
+#include "unistd.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+#endif
+
+// first 8 bytes of a cooked mesh file ("UNDMESH1", the number gets increased when the format changes)
+#define COOKED_MESH_MAGIC 0x314853454d444e55ull
+
+// flags stored in the cooked file (files cooked with different flags are not reused)
+#define COOKED_MESH_OPTIMIZED 1u
+
+namespace undicht {
+
+	namespace tools {
+
+		struct CookedFileHeader {
+			// the start of a cooked mesh file, followed by the mesh table
+
+			uint64_t magic = COOKED_MESH_MAGIC;
+			uint64_t file_size = 0;
+
+			// the source file at the time it was cooked
+			uint64_t source_size = 0;
+			int64_t source_time = 0;
+			uint64_t source_hash = 0;
+
+			uint32_t flags = 0;
+			uint32_t mesh_count = 0;
+			uint32_t texture_count = 0;
+			uint32_t padding[3] = {};
+		};
+
+		struct CookedMeshEntry {
+			// an entry of the mesh table, the offsets count from the start of the file
+
+			uint64_t vertex_offset = 0;
+			uint64_t vertex_byte_size = 0;
+			uint64_t index_offset = 0;
+			uint32_t index_count = 0;
+			int32_t color_texture = -1;
+
+			// vertex layout
+			uint32_t packing = 0;
+			uint32_t type_count = 0;
+			uint32_t types[COOKED_MESH_MAX_ATTRIBUTES][4] = {}; // type, component size, number of components, little endian
+
+			uint32_t attributes = 0;
+			float min[3] = {};
+			float max[3] = {};
+			uint32_t padding = 0;
+		};
+
+		static_assert(sizeof(CookedFileHeader) == 64, "the size of the header is part of the file format");
+		static_assert(sizeof(CookedMeshEntry) % 8 == 0, "the mesh entries have to keep the 64 bit members aligned");
+
+		static size_t alignSize(size_t size) {
+
+			return (size + COOKED_MESH_ALIGNMENT - 1) / COOKED_MESH_ALIGNMENT * COOKED_MESH_ALIGNMENT;
+		}
+
+		CookedMeshFile::CookedMeshFile(const std::string& source_file_name, bool optimize) {
+
+			open(source_file_name, optimize);
+		}
+
+		CookedMeshFile::~CookedMeshFile() {
+
+			close();
+		}
+
+		bool CookedMeshFile::open(const std::string& source_file_name, bool optimize) {
+			/** @brief opens the cooked version of the source file (source_file_name + COOKED_MESH_FILE_ENDING)
+			* the source file gets cooked first if there is no cooked file yet or if the source file was changed since it was cooked
+			* (if the cooked file cant be written, the cooked meshes are kept in memory)
+			* @param optimize: weld and optimize the meshes while cooking (see optimizeMesh()), the cooked meshes will have indices
+			* @return false if neither the cooked nor the source file could be loaded */
+
+			std::string cooked_file_name = getCookedFileName(source_file_name);
+
+			if(isUpToDate(source_file_name, cooked_file_name, optimize) && openCookedFile(cooked_file_name, source_file_name))
+				return true;
+
+			close();
+
+			if(!cookData(source_file_name, optimize, _file_data))
+				return false;
+
+			if(!writeFile(cooked_file_name, _file_data)) {
+				UND_WARNING << "failed to store the cooked meshes of " << source_file_name << ", they will be cooked again next time\n";
+			}
+
+			_file_name = cooked_file_name;
+			_source_file_name = source_file_name;
+
+			return readMeshes(_file_data.data(), _file_data.size());
+		}
+
+		bool CookedMeshFile::openCookedFile(const std::string& cooked_file_name, const std::string& source_file_name) {
+			/** @brief maps the cooked file into memory without checking whether it is up to date
+			* @param source_file_name: the file the textures get loaded from (can be empty)
+			* @return false if the file could not be opened or is not a valid cooked mesh file */
+
+			close();
+
+			_file_name = cooked_file_name;
+			_source_file_name = source_file_name;
+
+			const char* data = nullptr;
+			size_t byte_size = 0;
+
+#ifdef PLATFORM_UNIX
+
+			int file_descriptor = ::open(cooked_file_name.c_str(), O_RDONLY);
+			struct stat file_stat;
+
+			if((file_descriptor < 0) || fstat(file_descriptor, &file_stat)) {
+				UND_ERROR << "failed to open cooked mesh file: " << cooked_file_name << "\n";
+				if(file_descriptor >= 0) ::close(file_descriptor);
+				return false;
+			}
+
+			if(file_stat.st_size > 0) {
+
+				void* mapped_data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+
+				if(mapped_data != MAP_FAILED) {
+					_mapped_data = (char*)mapped_data;
+					_mapped_size = file_stat.st_size;
+					data = _mapped_data;
+					byte_size = _mapped_size;
+				}
+
+			}
+
+			::close(file_descriptor);
+
+#else
+
+			std::ifstream file(cooked_file_name, std::ios::binary | std::ios::ate);
+
+			if(!file.is_open()) {
+				UND_ERROR << "failed to open cooked mesh file: " << cooked_file_name << "\n";
+				return false;
+			}
+
+			_file_data.resize(file.tellg());
+			file.seekg(0);
+			file.read(_file_data.data(), _file_data.size());
+
+			data = _file_data.data();
+			byte_size = _file_data.size();
+
+#endif
+
+			if(!readMeshes(data, byte_size)) {
+				UND_ERROR << "failed to open cooked mesh file: " << cooked_file_name << " : the file is damaged\n";
+				close();
+				return false;
+			}
+
+			return true;
+		}
+
+		void CookedMeshFile::close() {
+
+#ifdef PLATFORM_UNIX
+			if(_mapped_data)
+				munmap(_mapped_data, _mapped_size);
+#endif
+
+			_mapped_data = nullptr;
+			_mapped_size = 0;
+			_file_data.clear();
+			_file_data.shrink_to_fit();
+
+			_meshes.clear();
+			_texture_count = 0;
+			_source_loader.reset();
+		}
+
+		const std::vector<CookedMeshFile::Mesh>& CookedMeshFile::getMeshes() const {
+			/** @return the meshes of the file, their data points into the mapped file */
+
+			return _meshes;
+		}
+
+		std::string CookedMeshFile::getCookedFileName(const std::string& source_file_name) {
+			/** @return the name of the cooked file belonging to the source file */
+
+			return source_file_name + COOKED_MESH_FILE_ENDING;
+		}
+
+		bool CookedMeshFile::isUpToDate(const std::string& source_file_name, const std::string& cooked_file_name, bool optimize) {
+			/** @return whether the cooked file exists and was cooked from the current version of the source file (with the same optimize setting)
+			* if only the modification time of the source file changed (but not its content), the time stored in the cooked file gets updated */
+
+			uint64_t source_size = 0;
+			int64_t source_time = 0;
+
+			if(!getSourceState(source_file_name, source_size, source_time))
+				return false;
+
+			std::fstream file(cooked_file_name, std::ios::in | std::ios::out | std::ios::binary);
+			CookedFileHeader header;
+
+			if(!file.read((char*)&header, sizeof(header)))
+				return false;
+
+			if((header.magic != COOKED_MESH_MAGIC) || (header.source_size != source_size))
+				return false;
+
+			if(header.flags != (optimize ? COOKED_MESH_OPTIMIZED : 0))
+				return false;
+
+			if(header.source_time == source_time)
+				return true;
+
+			// the file might have been touched without changing it (i.e. by a checkout)
+			uint64_t source_hash = 0;
+			if(!hashFile(source_file_name, source_hash) || (source_hash != header.source_hash))
+				return false;
+
+			// so that the next check doesnt need to hash the file again
+			file.seekp(offsetof(CookedFileHeader, source_time));
+			file.write((const char*)&source_time, sizeof(source_time));
+
+			return true;
+		}
+
+		bool CookedMeshFile::cook(const std::string& source_file_name, const std::string& cooked_file_name, bool optimize) {
+			/** @brief loads all meshes of the source file and stores them in the cooked file
+			* @return false if the source file could not be loaded or the cooked file could not be written */
+
+			std::vector<char> data;
+
+			if(!cookData(source_file_name, optimize, data))
+				return false;
+
+			if(!writeFile(cooked_file_name, data)) {
+				UND_ERROR << "failed to write cooked mesh file: " << cooked_file_name << "\n";
+				return false;
+			}
+
+			return true;
+		}
+
+		////////////////////////////////////////// functions to load single meshes / textures ///////////////////////////////////////////
+
+		int CookedMeshFile::getMeshCount() {
+			/** @return the number of meshes stored in the file */
+
+			return _meshes.size();
+		}
+
+		int CookedMeshFile::getTextureCount() {
+			/** @return the number of unique textures used by the meshes
+			* if a mesh should use for example a color + normal texture, thats 2 */
+
+			return _texture_count;
+		}
+
+		void CookedMeshFile::getMesh(MeshData& loadTo_mesh, unsigned int id, bool load_positions, bool load_uvs, bool load_normals) {
+			/** loads the vertices of the mesh (copies them out of the mapped file)
+			* @param id: to iterate through the meshes of the file */
+
+			if(id >= _meshes.size()) {
+				UND_ERROR << "failed to load mesh " << id << " from cooked file " << _file_name << " : mesh doesnt exist\n";
+				return;
+			}
+
+			const Mesh& mesh = _meshes.at(id);
+
+			uint32_t attributes = (load_positions ? uint32_t(POSITION) : 0) | (load_uvs ? uint32_t(UV) : 0) | (load_normals ? uint32_t(NORMAL) : 0);
+
+			loadTo_mesh.vertex_layout = mesh.vertex_layout;
+			loadTo_mesh.color_texture = mesh.color_texture;
+			loadTo_mesh.indices.assign((const int*)mesh.indices, (const int*)mesh.indices + mesh.index_count);
+
+			if(!mesh.attributes || ((mesh.attributes & attributes) == mesh.attributes)) {
+				// copying the vertices as they are
+				loadTo_mesh.vertices.resize(mesh.vertex_byte_size / sizeof(float));
+				if(mesh.vertex_byte_size)
+					std::memcpy(loadTo_mesh.vertices.data(), mesh.vertices, loadTo_mesh.vertices.size() * sizeof(float));
+				return;
+			}
+
+			// the i-th type of the layout belongs to the i-th attribute stored in the mesh
+			std::vector<uint32_t> kept_types;
+			loadTo_mesh.vertex_layout = BufferLayout({}, mesh.vertex_layout.getPacking());
+
+			uint32_t type = 0;
+			for(uint32_t attribute : {POSITION, UV, NORMAL}) {
+
+				if(!(mesh.attributes & attribute))
+					continue;
+
+				if(attributes & attribute) {
+					kept_types.push_back(type);
+					loadTo_mesh.vertex_layout.addType(mesh.vertex_layout.getType(type));
+				}
+
+				type++;
+			}
+
+			// copying the kept attributes of every vertex
+			uint32_t stride = mesh.vertex_layout.getTotalSize();
+			uint32_t new_stride = loadTo_mesh.vertex_layout.getTotalSize();
+			std::vector<char> vertices(size_t(mesh.vertex_count) * new_stride);
+
+			for(uint32_t vertex = 0; vertex < mesh.vertex_count; vertex++) {
+
+				for(uint32_t i = 0; i < kept_types.size(); i++) {
+
+					const char* src = mesh.vertices + size_t(vertex) * stride + mesh.vertex_layout.getOffset(kept_types[i]);
+					char* dst = vertices.data() + size_t(vertex) * new_stride + loadTo_mesh.vertex_layout.getOffset(i);
+					std::memcpy(dst, src, loadTo_mesh.vertex_layout.getType(i).getSize());
+				}
+
+			}
+
+			loadTo_mesh.vertices.resize(vertices.size() / sizeof(float));
+			if(vertices.size())
+				std::memcpy(loadTo_mesh.vertices.data(), vertices.data(), loadTo_mesh.vertices.size() * sizeof(float));
+		}
+
+		void CookedMeshFile::getTexture(ImageData<char>& loadTo_texture, int id) {
+			/** @param id: to iterate through the texture of the file */
+
+			if(!_source_loader && _source_file_name.size())
+				_source_loader = openSourceFile(_source_file_name);
+
+			if(!_source_loader) {
+				UND_ERROR << "failed to load texture " << id << " for cooked file " << _file_name << " : the source file could not be opened\n";
+				return;
+			}
+
+			_source_loader->getTexture(loadTo_texture, id);
+		}
+
+		////////////////////////////////////////// functions to load all meshes / textures ///////////////////////////////////////////
+
+		void CookedMeshFile::loadAllMeshes(std::vector<MeshData>& loadTo_meshes, bool load_positions, bool load_uvs, bool load_normals) {
+
+			for(unsigned int id = 0; id < _meshes.size(); id++) {
+
+				loadTo_meshes.emplace_back();
+				getMesh(loadTo_meshes.back(), id, load_positions, load_uvs, load_normals);
+			}
+
+		}
+
+		void CookedMeshFile::loadAllTextures(std::vector<ImageData<char>>& loadTo_textures) {
+
+			if(!_texture_count)
+				return;
+
+			if(!_source_loader && _source_file_name.size())
+				_source_loader = openSourceFile(_source_file_name);
+
+			if(!_source_loader) {
+				UND_ERROR << "failed to load the textures for cooked file " << _file_name << " : the source file could not be opened\n";
+				return;
+			}
+
+			_source_loader->loadAllTextures(loadTo_textures);
+		}
+
+		////////////////////////////////////////// protected CookedMeshFile functions ///////////////////////////////////////////
+
+		bool CookedMeshFile::readMeshes(const char* data, size_t byte_size) {
+			// reads the mesh table of the mapped file into _meshes
+			// @return false if the data is not a valid cooked mesh file
+
+			_meshes.clear();
+
+			if(byte_size < sizeof(CookedFileHeader))
+				return false;
+
+			CookedFileHeader header;
+			std::memcpy(&header, data, sizeof(header));
+
+			if((header.magic != COOKED_MESH_MAGIC) || (header.file_size != byte_size))
+				return false;
+
+			if(header.mesh_count > (byte_size - sizeof(CookedFileHeader)) / sizeof(CookedMeshEntry))
+				return false;
+
+			_meshes.resize(header.mesh_count);
+			_texture_count = header.texture_count;
+
+			for(uint32_t i = 0; i < header.mesh_count; i++) {
+
+				CookedMeshEntry entry;
+				std::memcpy(&entry, data + sizeof(CookedFileHeader) + i * sizeof(CookedMeshEntry), sizeof(entry));
+
+				// checking that the data of the mesh is inside the file
+				uint64_t index_byte_size = uint64_t(entry.index_count) * sizeof(uint32_t);
+
+				if((entry.vertex_offset % COOKED_MESH_ALIGNMENT) || (entry.index_offset % COOKED_MESH_ALIGNMENT))
+					return false;
+
+				if((entry.vertex_offset > byte_size) || (entry.vertex_byte_size > byte_size - entry.vertex_offset))
+					return false;
+
+				if((entry.index_offset > byte_size) || (index_byte_size > byte_size - entry.index_offset))
+					return false;
+
+				if((entry.type_count > COOKED_MESH_MAX_ATTRIBUTES) || (entry.packing > uint32_t(LayoutPacking::STD430)))
+					return false;
+
+				Mesh& mesh = _meshes.at(i);
+
+				std::vector<FixedType> types;
+				for(uint32_t type = 0; type < entry.type_count; type++)
+					types.push_back(FixedType(Type(entry.types[type][0]), entry.types[type][1], entry.types[type][2], entry.types[type][3]));
+
+				mesh.vertex_layout = BufferLayout(types, LayoutPacking(entry.packing));
+				mesh.attributes = entry.attributes;
+
+				if(entry.vertex_byte_size && (!mesh.vertex_layout.getTotalSize() || (entry.vertex_byte_size % mesh.vertex_layout.getTotalSize())))
+					return false;
+
+				mesh.vertices = data + entry.vertex_offset;
+				mesh.vertex_byte_size = entry.vertex_byte_size;
+				mesh.vertex_count = entry.vertex_byte_size ? entry.vertex_byte_size / mesh.vertex_layout.getTotalSize() : 0;
+
+				mesh.indices = entry.index_count ? (const uint32_t*)(data + entry.index_offset) : nullptr;
+				mesh.index_count = entry.index_count;
+
+				mesh.color_texture = entry.color_texture;
+				mesh.min = glm::vec3(entry.min[0], entry.min[1], entry.min[2]);
+				mesh.max = glm::vec3(entry.max[0], entry.max[1], entry.max[2]);
+			}
+
+			return true;
+		}
+
+		std::unique_ptr<ModelLoader> CookedMeshFile::openSourceFile(const std::string& source_file_name) {
+			// opens the source file with the loader for its file type
+			// @return nullptr if the file type is not supported
+
+			if(hasFileType(source_file_name, ".obj")) {
+
+				std::unique_ptr<OBJFile> file(new OBJFile());
+				if(file->open(source_file_name))
+					return file;
+
+			} else if(hasFileType(source_file_name, ".dae")) {
+
+				std::unique_ptr<ColladaFile> file(new ColladaFile());
+				if(file->open(source_file_name))
+					return file;
+
+			} else {
+				UND_ERROR << "failed to cook model file: " << source_file_name << " : unsupported file type\n";
+			}
+
+			return nullptr;
+		}
+
+		bool CookedMeshFile::cookData(const std::string& source_file_name, bool optimize, std::vector<char>& loadTo_data) {
+			// loads the meshes of the source file and stores them in the format of the cooked file
+			// @return false if the source file could not be loaded
+
+			uint64_t source_size = 0;
+			int64_t source_time = 0;
+			uint64_t source_hash = 0;
+
+			if(!getSourceState(source_file_name, source_size, source_time) || !hashFile(source_file_name, source_hash)) {
+				UND_ERROR << "failed to cook model file: " << source_file_name << " : file not found\n";
+				return false;
+			}
+
+			std::unique_ptr<ModelLoader> source_file = openSourceFile(source_file_name);
+
+			if(!source_file)
+				return false;
+
+			std::vector<MeshData> meshes;
+			source_file->loadAllMeshes(meshes);
+
+			if(optimize)
+				for(MeshData& mesh : meshes)
+					optimizeMesh(mesh);
+
+			writeMeshData(meshes, source_file->getTextureCount(), source_size, source_time, source_hash, optimize ? COOKED_MESH_OPTIMIZED : 0, loadTo_data);
+
+			return true;
+		}
+
+		void CookedMeshFile::writeMeshData(const std::vector<MeshData>& meshes, uint32_t texture_count, uint64_t source_size,
+			int64_t source_time, uint64_t source_hash, uint32_t flags, std::vector<char>& loadTo_data) {
+			// stores the meshes in the format of the cooked file
+
+			CookedFileHeader header;
+			header.source_size = source_size;
+			header.source_time = source_time;
+			header.source_hash = source_hash;
+			header.flags = flags;
+			header.mesh_count = meshes.size();
+			header.texture_count = texture_count;
+
+			// header and mesh table, followed by the vertices of all meshes and then the indices of all meshes
+			// (so that the vertices / indices of all meshes can be uploaded at once)
+			std::vector<CookedMeshEntry> entries(meshes.size());
+			size_t offset = alignSize(sizeof(CookedFileHeader) + entries.size() * sizeof(CookedMeshEntry));
+
+			for(size_t i = 0; i < meshes.size(); i++) {
+				entries[i].vertex_offset = offset;
+				entries[i].vertex_byte_size = meshes[i].vertices.size() * sizeof(float);
+				offset = alignSize(offset + entries[i].vertex_byte_size);
+			}
+
+			for(size_t i = 0; i < meshes.size(); i++) {
+				entries[i].index_offset = offset;
+				entries[i].index_count = meshes[i].indices.size();
+				offset = alignSize(offset + entries[i].index_count * sizeof(uint32_t));
+			}
+
+			header.file_size = offset;
+
+			// the rest of the mesh entries
+			for(size_t i = 0; i < meshes.size(); i++) {
+
+				const MeshData& mesh = meshes[i];
+				CookedMeshEntry& entry = entries[i];
+
+				entry.color_texture = mesh.color_texture;
+				entry.packing = uint32_t(mesh.vertex_layout.getPacking());
+				entry.type_count = std::min<uint32_t>(mesh.vertex_layout.getTypeCount(), COOKED_MESH_MAX_ATTRIBUTES);
+
+				if(mesh.vertex_layout.getTypeCount() > COOKED_MESH_MAX_ATTRIBUTES) {
+					UND_WARNING << "cooked mesh file: the vertex layout of mesh " << i << " has too many types, only the first " << COOKED_MESH_MAX_ATTRIBUTES << " are stored\n";
+				}
+
+				for(uint32_t type = 0; type < entry.type_count; type++) {
+					const FixedType& t = mesh.vertex_layout.getType(type);
+					entry.types[type][0] = uint32_t(t.m_type);
+					entry.types[type][1] = t.m_size;
+					entry.types[type][2] = t.m_num_components;
+					entry.types[type][3] = t.m_little_endian;
+				}
+
+				entry.attributes = findAttributes(mesh.vertex_layout);
+
+				// bounding box (the position is the first attribute)
+				size_t stride = mesh.vertex_layout.getTotalSize() / sizeof(float);
+
+				if((entry.attributes & POSITION) && stride && (mesh.vertices.size() >= stride)) {
+
+					glm::vec3 min(mesh.vertices[0], mesh.vertices[1], mesh.vertices[2]);
+					glm::vec3 max = min;
+
+					for(size_t v = 0; v + stride <= mesh.vertices.size(); v += stride) {
+						glm::vec3 position(mesh.vertices[v], mesh.vertices[v + 1], mesh.vertices[v + 2]);
+						min = glm::min(min, position);
+						max = glm::max(max, position);
+					}
+
+					for(int axis = 0; axis < 3; axis++) {
+						entry.min[axis] = min[axis];
+						entry.max[axis] = max[axis];
+					}
+
+				}
+
+			}
+
+			// storing the data (the padding stays 0)
+			loadTo_data.assign(header.file_size, 0);
+			std::memcpy(loadTo_data.data(), &header, sizeof(header));
+			if(entries.size())
+				std::memcpy(loadTo_data.data() + sizeof(header), entries.data(), entries.size() * sizeof(CookedMeshEntry));
+
+			for(size_t i = 0; i < meshes.size(); i++) {
+
+				if(entries[i].vertex_byte_size)
+					std::memcpy(loadTo_data.data() + entries[i].vertex_offset, meshes[i].vertices.data(), entries[i].vertex_byte_size);
+
+				if(entries[i].index_count)
+					std::memcpy(loadTo_data.data() + entries[i].index_offset, meshes[i].indices.data(), entries[i].index_count * sizeof(uint32_t));
+			}
+
+		}
+
+		bool CookedMeshFile::writeFile(const std::string& file_name, const std::vector<char>& data) {
+			// writes the data through a temporary file, so that an incomplete file never replaces the old one
+
+			std::string temp_file_name = file_name + ".tmp";
+			std::ofstream file(temp_file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+			file.write(data.data(), data.size());
+			file.close();
+
+			if(file.fail() || std::rename(temp_file_name.c_str(), file_name.c_str())) {
+				std::remove(temp_file_name.c_str());
+				return false;
+			}
+
+			return true;
+		}
+
+		uint32_t CookedMeshFile::findAttributes(const BufferLayout& vertex_layout) {
+			// @return the Attributes matching the types of the layout (expects them in the order position, uv, normal)
+
+			const uint32_t attributes[] = {POSITION, UV, NORMAL};
+			const FixedType attribute_types[] = {UND_VEC3F, UND_VEC2F, UND_VEC3F};
+
+			uint32_t found = 0;
+			uint32_t next = 0; // the next attribute that could match
+
+			for(const FixedType& type : vertex_layout.getTypes()) {
+
+				// skipping the attributes that are not part of the layout
+				while((next < 3) && !(type == attribute_types[next]))
+					next++;
+
+				if(next == 3)
+					return 0;
+
+				found |= attributes[next];
+				next++;
+			}
+
+			return found;
+		}
+
+		bool CookedMeshFile::getSourceState(const std::string& source_file_name, uint64_t& size, int64_t& time) {
+			// @return false if the file doesnt exist
+
+			std::error_code error;
+
+			size = std::filesystem::file_size(source_file_name, error);
+			if(error)
+				return false;
+
+			time = std::filesystem::last_write_time(source_file_name, error).time_since_epoch().count();
+			if(error)
+				return false;
+
+			return true;
+		}
+
+		bool CookedMeshFile::hashFile(const std::string& file_name, uint64_t& hash) {
+			// FNV-1a hash of the files content
+
+			std::ifstream file(file_name, std::ios::binary);
+
+			if(!file.is_open())
+				return false;
+
+			hash = 0xcbf29ce484222325ull;
+			std::vector<char> buffer(64 * 1024);
+
+			while(file) {
+
+				file.read(buffer.data(), buffer.size());
+
+				for(std::streamsize i = 0; i < file.gcount(); i++) {
+					hash ^= uint8_t(buffer[i]);
+					hash *= 0x100000001b3ull;
+				}
+
+			}
+
+			return true;
+		}
+
+	} // tools
+
+} // undicht
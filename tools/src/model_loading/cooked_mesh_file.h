@@ -0,0 +1,182 @@
+#ifndef COOKED_MESH_FILE_H
+#define COOKED_MESH_FILE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include "glm/glm.hpp"
+#include "model_loading/model_loader.h"
+
+// added to the name of the source file to get the name of the cooked file
+#ifndef COOKED_MESH_FILE_ENDING
+#define COOKED_MESH_FILE_ENDING ".cmesh"
+#endif
+
+// the vertex and index data of every mesh starts at a multiple of this (counting from the start of the file)
+#ifndef COOKED_MESH_ALIGNMENT
+#define COOKED_MESH_ALIGNMENT 64
+#endif
+
+// the maximum number of types in the vertex layout of a cooked mesh
+#ifndef COOKED_MESH_MAX_ATTRIBUTES
+#define COOKED_MESH_MAX_ATTRIBUTES 8
+#endif
+
+namespace undicht {
+
+	namespace tools {
+
+		class CookedMeshFile : public ModelLoader {
+			/** a binary file storing the meshes of a model file (.obj, .dae) the way they get uploaded to the gpu:
+			* the interleaved vertices, the indices, the vertex layout, the material and the bounding box of every mesh
+			* the cooked file gets created from the source file when it is opened for the first time
+			* and is reused as long as the source file doesnt change (checked by its size, modification time and hash)
+			* the file gets memory mapped and the vertex / index data is aligned, so it can be uploaded without copying it (see getMeshes())
+			* the textures are not cooked, they get loaded from the source file when they are requested
+			* the data is stored in the byte order of the machine that cooked the file (its a cache, not an exchange format) */
+
+		public:
+
+			enum Attributes : uint32_t {
+				// the attributes of the vertices (in the order in which they are stored, see ModelLoader)
+				POSITION = 1, // UND_VEC3F
+				UV = 2, // UND_VEC2F
+				NORMAL = 4, // UND_VEC3F
+			};
+
+			struct Mesh {
+				// a mesh stored in the mapped file (the pointers stay valid until the file is closed)
+
+				BufferLayout vertex_layout;
+				uint32_t attributes = 0; // the Attributes the vertices are made of (0 if the layout doesnt match the default attributes)
+
+				const char* vertices = nullptr;
+				size_t vertex_byte_size = 0;
+				uint32_t vertex_count = 0;
+
+				const uint32_t* indices = nullptr; // nullptr if the mesh is not indexed
+				uint32_t index_count = 0;
+
+				int color_texture = -1; // the texture of the source file used by this mesh
+
+				// the bounding box of the positions (both 0 if the vertices dont have a position)
+				glm::vec3 min = glm::vec3(0.0f);
+				glm::vec3 max = glm::vec3(0.0f);
+			};
+
+		protected:
+
+			std::string _file_name; // of the cooked file
+			std::string _source_file_name;
+
+			// the opened file
+			char* _mapped_data = nullptr;
+			size_t _mapped_size = 0;
+			std::vector<char> _file_data; // used instead of the mapping if memory mapping is not supported
+
+			std::vector<Mesh> _meshes;
+			uint32_t _texture_count = 0;
+
+			// opened when the textures are requested
+			std::unique_ptr<ModelLoader> _source_loader;
+
+		public:
+
+			CookedMeshFile() = default;
+			CookedMeshFile(const std::string& source_file_name, bool optimize = false);
+			CookedMeshFile(const CookedMeshFile&) = delete;
+			CookedMeshFile& operator=(const CookedMeshFile&) = delete;
+			virtual ~CookedMeshFile();
+
+			/** @brief opens the cooked version of the source file (source_file_name + COOKED_MESH_FILE_ENDING)
+			* the source file gets cooked first if there is no cooked file yet or if the source file was changed since it was cooked
+			* (if the cooked file cant be written, the cooked meshes are kept in memory)
+			* @param optimize: weld and optimize the meshes while cooking (see optimizeMesh()), the cooked meshes will have indices
+			* @return false if neither the cooked nor the source file could be loaded */
+			bool open(const std::string& source_file_name, bool optimize = false);
+
+			/** @brief maps the cooked file into memory without checking whether it is up to date
+			* @param source_file_name: the file the textures get loaded from (can be empty)
+			* @return false if the file could not be opened or is not a valid cooked mesh file */
+			bool openCookedFile(const std::string& cooked_file_name, const std::string& source_file_name = "");
+
+			void close();
+
+			/** @return the meshes of the file, their data points into the mapped file */
+			const std::vector<Mesh>& getMeshes() const;
+
+			/** @return the name of the cooked file belonging to the source file */
+			static std::string getCookedFileName(const std::string& source_file_name);
+
+			/** @return whether the cooked file exists and was cooked from the current version of the source file (with the same optimize setting)
+			* if only the modification time of the source file changed (but not its content), the time stored in the cooked file gets updated */
+			static bool isUpToDate(const std::string& source_file_name, const std::string& cooked_file_name, bool optimize = false);
+
+			/** @brief loads all meshes of the source file and stores them in the cooked file
+			* @return false if the source file could not be loaded or the cooked file could not be written */
+			static bool cook(const std::string& source_file_name, const std::string& cooked_file_name, bool optimize = false);
+
+		public:
+			// ModelLoader api functions
+
+			////////////////////////////////////////// functions to load single meshes / textures ///////////////////////////////////////////
+
+			/** @return the number of meshes stored in the file */
+			virtual int getMeshCount();
+
+			/** @return the number of unique textures used by the meshes
+			* if a mesh should use for example a color + normal texture, thats 2 */
+			virtual int getTextureCount();
+
+			/** loads the vertices of the mesh (copies them out of the mapped file)
+			* @param id: to iterate through the meshes of the file */
+			virtual void getMesh(MeshData& loadTo_mesh, unsigned int id = 0, bool load_positions = true, bool load_uvs = true, bool load_normals = true);
+
+			/** @param id: to iterate through the texture of the file */
+			virtual void getTexture(ImageData<char>& loadTo_texture, int id = 0);
+
+			////////////////////////////////////////// functions to load all meshes / textures ///////////////////////////////////////////
+
+			virtual void loadAllMeshes(std::vector<MeshData>& loadTo_meshes, bool load_positions = true, bool load_uvs = true, bool load_normals = true);
+
+			virtual void loadAllTextures(std::vector<ImageData<char>>& loadTo_textures);
+
+		protected:
+			// protected CookedMeshFile functions
+
+			// reads the mesh table of the mapped file into _meshes
+			// @return false if the data is not a valid cooked mesh file
+			bool readMeshes(const char* data, size_t byte_size);
+
+			// opens the source file with the loader for its file type
+			// @return nullptr if the file type is not supported
+			static std::unique_ptr<ModelLoader> openSourceFile(const std::string& source_file_name);
+
+			// loads the meshes of the source file and stores them in the format of the cooked file
+			// @return false if the source file could not be loaded
+			static bool cookData(const std::string& source_file_name, bool optimize, std::vector<char>& loadTo_data);
+
+			// stores the meshes in the format of the cooked file
+			static void writeMeshData(const std::vector<MeshData>& meshes, uint32_t texture_count, uint64_t source_size,
+				int64_t source_time, uint64_t source_hash, uint32_t flags, std::vector<char>& loadTo_data);
+
+			// writes the data through a temporary file, so that an incomplete file never replaces the old one
+			static bool writeFile(const std::string& file_name, const std::vector<char>& data);
+
+			// @return the Attributes matching the types of the layout (expects them in the order position, uv, normal)
+			static uint32_t findAttributes(const BufferLayout& vertex_layout);
+
+			// @return false if the file doesnt exist
+			static bool getSourceState(const std::string& source_file_name, uint64_t& size, int64_t& time);
+
+			// FNV-1a hash of the files content
+			static bool hashFile(const std::string& file_name, uint64_t& hash);
+
+		};
+
+	} // tools
+
+} // undicht
+
+#endif // COOKED_MESH_FILE_H
@@ -0,0 +1,543 @@
+#include "mesh_optimizer.h"
+#include "debug.h"
+#include "cstring"
+#include "cmath"
+#include "algorithm"
+
+// scoring of the vertices in optimizeVertexCache()
+// source: https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+#define MESH_CACHE_DECAY_POWER 1.5f
+#define MESH_LAST_TRIANGLE_SCORE 0.75f
+#define MESH_VALENCE_BOOST_SCALE 2.0f
+#define MESH_VALENCE_BOOST_POWER 0.5f
+
+// number of remaining triangles of a vertex for which the valence score is precomputed
+#define MESH_MAX_PRECOMPUTED_VALENCE 32
+
+namespace undicht {
+
+	namespace tools {
+
+		static size_t getVertexSize(const BufferLayout& vertex_layout) {
+			// the number of floats per vertex
+
+			return vertex_layout.getTotalSize() / sizeof(float);
+		}
+
+		static size_t getVertexCount(const MeshData& mesh) {
+
+			size_t vertex_size = getVertexSize(mesh.vertex_layout);
+
+			return vertex_size ? mesh.vertices.size() / vertex_size : 0;
+		}
+
+		static uint32_t hashVertex(const float* vertex, size_t vertex_size) {
+			// murmur2 like mixing of the bits of the floats
+
+			const uint32_t m = 0x5bd1e995;
+			uint32_t hash = 0;
+
+			for (size_t i = 0; i < vertex_size; i++) {
+
+				uint32_t bits;
+				std::memcpy(&bits, vertex + i, sizeof(float));
+
+				bits *= m;
+				bits ^= bits >> 24;
+				bits *= m;
+
+				hash *= m;
+				hash ^= bits;
+			}
+
+			return hash;
+		}
+
+		static uint32_t updateFifoCache(const int* triangle, uint32_t cache_size, std::vector<uint32_t>& cache_timestamps, uint32_t& timestamp) {
+			/** simulates a fifo cache (a vertex is in the cache if less than cache_size vertices were added after it)
+			* @return the number of vertices of the triangle that were not in the cache */
+
+			uint32_t misses = 0;
+
+			for (int i = 0; i < 3; i++) {
+
+				if (timestamp - cache_timestamps.at(triangle[i]) > cache_size) {
+					cache_timestamps.at(triangle[i]) = timestamp++;
+					misses++;
+				}
+
+			}
+
+			return misses;
+		}
+
+		///////////////////////////////////////////// welding vertices /////////////////////////////////////////////
+
+		void weldVertices(const std::vector<float>& vertices, const BufferLayout& vertex_layout, std::vector<float>& loadTo_vertices, std::vector<int>& loadTo_indices) {
+			/** removes double vertices (vertices with the same bytes) by adding indices referencing the first version of that vertex to the loadTo_indices vector
+			* vertices already stored in loadTo_vertices are reused as well */
+
+			size_t vertex_size = getVertexSize(vertex_layout);
+			if (!vertex_size)
+				return;
+
+			size_t vertex_count = vertices.size() / vertex_size;
+			size_t old_vertex_count = loadTo_vertices.size() / vertex_size;
+
+			// hash table (open addressing) storing the indices of the unique vertices in loadTo_vertices
+			size_t table_size = 16;
+			while (table_size < 2 * (vertex_count + old_vertex_count))
+				table_size *= 2;
+
+			std::vector<int> table(table_size, -1);
+
+			loadTo_vertices.reserve(loadTo_vertices.size() + vertices.size());
+			loadTo_indices.reserve(loadTo_indices.size() + vertex_count);
+
+			// @return the slot of the table containing an equal vertex, or the empty slot in which the vertex should be stored
+			auto findSlot = [&](const float* vertex) -> size_t {
+
+				size_t slot = hashVertex(vertex, vertex_size) & (table_size - 1);
+
+				while (table.at(slot) >= 0) {
+
+					const float* indexed_vertex = loadTo_vertices.data() + table.at(slot) * vertex_size;
+					if (!std::memcmp(vertex, indexed_vertex, vertex_size * sizeof(float)))
+						break;
+
+					slot = (slot + 1) & (table_size - 1); // linear probing
+				}
+
+				return slot;
+			};
+
+			// the vertices that were already stored in loadTo_vertices
+			// (if some of them are equal, they stay where they are, but only the first one gets referenced by new indices)
+			for (size_t vertex = 0; vertex < old_vertex_count; vertex++) {
+
+				size_t slot = findSlot(loadTo_vertices.data() + vertex * vertex_size);
+				if (table.at(slot) < 0)
+					table.at(slot) = vertex;
+			}
+
+			for (size_t vertex = 0; vertex < vertex_count; vertex++) {
+
+				const float* data = vertices.data() + vertex * vertex_size;
+				size_t slot = findSlot(data);
+
+				if (table.at(slot) < 0) {
+					// the vertex is unique
+					table.at(slot) = loadTo_vertices.size() / vertex_size;
+					loadTo_vertices.insert(loadTo_vertices.end(), data, data + vertex_size);
+				}
+
+				loadTo_indices.push_back(table.at(slot));
+			}
+
+		}
+
+		void weldVertices(MeshData& mesh) {
+			/** welds the vertices of the mesh (if the mesh already has indices, they get updated) */
+
+			std::vector<float> vertices;
+			std::vector<int> remap;
+			weldVertices(mesh.vertices, mesh.vertex_layout, vertices, remap);
+
+			if (mesh.indices.size()) {
+
+				for (int& index : mesh.indices)
+					index = remap.at(index);
+
+			} else {
+
+				mesh.indices = std::move(remap);
+			}
+
+			mesh.vertices = std::move(vertices);
+		}
+
+		///////////////////////////////////////////// optimizing the triangle order /////////////////////////////////////////////
+
+		void optimizeVertexCache(MeshData& mesh, uint32_t cache_size) {
+			/** reorders the triangles, so that their vertices are more likely to be in the post transform cache of the gpu
+			* (Tom Forsyth's "Linear-Speed Vertex Cache Optimisation")
+			* each vertex gets a score based on its position in a simulated lru cache and on the number of triangles still using it,
+			* the next triangle is the one with the highest sum of vertex scores among the triangles using the vertices in the cache */
+
+			size_t vertex_count = getVertexCount(mesh);
+			size_t triangle_count = mesh.indices.size() / 3;
+
+			if (!triangle_count || (cache_size < 4))
+				return;
+
+			// precomputing the scores
+			std::vector<float> cache_scores(cache_size);
+			for (uint32_t i = 0; i < cache_size; i++) {
+
+				if (i < 3) {
+					// the vertices of the last triangle get a fixed score, so that it doesnt matter in which direction the next triangle goes
+					cache_scores.at(i) = MESH_LAST_TRIANGLE_SCORE;
+				} else {
+					float score = 1.0f - float(i - 3) / float(cache_size - 3);
+					cache_scores.at(i) = std::pow(score, MESH_CACHE_DECAY_POWER);
+				}
+
+			}
+
+			// vertices with few remaining triangles get a boost, so that they can leave the cache
+			float valence_scores[MESH_MAX_PRECOMPUTED_VALENCE];
+			for (uint32_t i = 1; i < MESH_MAX_PRECOMPUTED_VALENCE; i++)
+				valence_scores[i] = MESH_VALENCE_BOOST_SCALE * std::pow(float(i), -MESH_VALENCE_BOOST_POWER);
+
+			// the triangles using each vertex (the ones that were not added yet come first)
+			std::vector<uint32_t> triangles_offsets(vertex_count + 1, 0);
+			std::vector<uint32_t> remaining_triangles(vertex_count, 0);
+
+			for (int index : mesh.indices)
+				remaining_triangles.at(index)++;
+
+			for (size_t vertex = 0; vertex < vertex_count; vertex++)
+				triangles_offsets.at(vertex + 1) = triangles_offsets.at(vertex) + remaining_triangles.at(vertex);
+
+			std::vector<uint32_t> vertex_triangles(mesh.indices.size());
+			std::vector<uint32_t> fill_positions(triangles_offsets.begin(), triangles_offsets.end() - 1);
+
+			for (size_t i = 0; i < mesh.indices.size(); i++)
+				vertex_triangles.at(fill_positions.at(mesh.indices.at(i))++) = i / 3;
+
+			// @return the score of the vertex based on its position in the cache and the number of triangles still using it
+			auto calcVertexScore = [&](int cache_position, uint32_t remaining) -> float {
+
+				if (!remaining)
+					return -1.0f; // the vertex is not needed anymore
+
+				float score = (cache_position >= 0) ? cache_scores.at(cache_position) : 0.0f;
+
+				if (remaining < MESH_MAX_PRECOMPUTED_VALENCE)
+					score += valence_scores[remaining];
+				else
+					score += MESH_VALENCE_BOOST_SCALE * std::pow(float(remaining), -MESH_VALENCE_BOOST_POWER);
+
+				return score;
+			};
+
+			std::vector<int> cache_positions(vertex_count, -1);
+			std::vector<float> vertex_scores(vertex_count);
+			for (size_t vertex = 0; vertex < vertex_count; vertex++)
+				vertex_scores.at(vertex) = calcVertexScore(-1, remaining_triangles.at(vertex));
+
+			std::vector<float> triangle_scores(triangle_count);
+			std::vector<bool> triangle_added(triangle_count, false);
+			for (size_t triangle = 0; triangle < triangle_count; triangle++) {
+
+				const int* vertices = mesh.indices.data() + 3 * triangle;
+				triangle_scores.at(triangle) = vertex_scores.at(vertices[0]) + vertex_scores.at(vertices[1]) + vertex_scores.at(vertices[2]);
+			}
+
+			// starting with the best triangle
+			int best_triangle = std::max_element(triangle_scores.begin(), triangle_scores.end()) - triangle_scores.begin();
+			size_t next_unadded_triangle = 0; // used when there is no triangle using the vertices in the cache
+
+			std::vector<uint32_t> cache, new_cache;
+			cache.reserve(cache_size + 3);
+			new_cache.reserve(cache_size + 3);
+
+			std::vector<int> new_indices;
+			new_indices.reserve(mesh.indices.size());
+
+			for (size_t added = 0; added < triangle_count; added++) {
+
+				if (best_triangle < 0) {
+					// no triangle is using the vertices in the cache
+					while (triangle_added.at(next_unadded_triangle))
+						next_unadded_triangle++;
+
+					best_triangle = next_unadded_triangle;
+				}
+
+				// adding the triangle
+				const int* triangle = mesh.indices.data() + 3 * best_triangle;
+				new_indices.insert(new_indices.end(), triangle, triangle + 3);
+				triangle_added.at(best_triangle) = true;
+
+				new_cache.clear();
+
+				for (int i = 0; i < 3; i++) {
+
+					uint32_t vertex = triangle[i];
+
+					// removing the triangle from the remaining triangles of the vertex
+					uint32_t* triangles = vertex_triangles.data() + triangles_offsets.at(vertex);
+					uint32_t& remaining = remaining_triangles.at(vertex);
+					std::swap(*std::find(triangles, triangles + remaining, uint32_t(best_triangle)), triangles[remaining - 1]);
+					remaining--;
+
+					if (std::find(new_cache.begin(), new_cache.end(), vertex) == new_cache.end())
+						new_cache.push_back(vertex);
+				}
+
+				// the vertices of the triangle move to the front of the cache
+				for (uint32_t vertex : cache)
+					if ((vertex != uint32_t(triangle[0])) && (vertex != uint32_t(triangle[1])) && (vertex != uint32_t(triangle[2])))
+						new_cache.push_back(vertex);
+
+				// updating the scores of the vertices that were in the cache (and the ones that were pushed out of it)
+				for (size_t i = 0; i < new_cache.size(); i++) {
+
+					uint32_t vertex = new_cache.at(i);
+					cache_positions.at(vertex) = (i < cache_size) ? int(i) : -1;
+					vertex_scores.at(vertex) = calcVertexScore(cache_positions.at(vertex), remaining_triangles.at(vertex));
+				}
+
+				// updating the scores of the triangles using these vertices and finding the best one
+				best_triangle = -1;
+				float best_score = -1.0f;
+
+				for (uint32_t vertex : new_cache) {
+
+					const uint32_t* triangles = vertex_triangles.data() + triangles_offsets.at(vertex);
+
+					for (uint32_t i = 0; i < remaining_triangles.at(vertex); i++) {
+
+						const int* vertices = mesh.indices.data() + 3 * triangles[i];
+						float score = vertex_scores.at(vertices[0]) + vertex_scores.at(vertices[1]) + vertex_scores.at(vertices[2]);
+						triangle_scores.at(triangles[i]) = score;
+
+						if (score > best_score) {
+							best_score = score;
+							best_triangle = triangles[i];
+						}
+
+					}
+
+				}
+
+				new_cache.resize(std::min<size_t>(new_cache.size(), cache_size));
+				std::swap(cache, new_cache);
+			}
+
+			mesh.indices = std::move(new_indices);
+		}
+
+		void optimizeOverdraw(MeshData& mesh, float threshold) {
+			/** reorders clusters of triangles so that the ones facing outwards get drawn first (to reduce overdraw)
+			* the triangles are split into clusters in a way that keeps the order of the triangles within the clusters
+			* and that doesnt make the average cache miss ratio worse than the threshold allows,
+			* then the clusters get sorted by how much they face away from the center of the mesh
+			* (based on "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" by Sander et al.) */
+
+			size_t vertex_size = getVertexSize(mesh.vertex_layout);
+			size_t vertex_count = getVertexCount(mesh);
+			size_t triangle_count = mesh.indices.size() / 3;
+
+			if (!triangle_count)
+				return;
+
+			if (!mesh.vertex_layout.getTypeCount() || !(mesh.vertex_layout.getType(0) == UND_VEC3F)) {
+				UND_WARNING << "failed to optimize the overdraw of the mesh: the first vertex attribute is not a position\n";
+				return;
+			}
+
+			std::vector<uint32_t> cache_timestamps(vertex_count, 0);
+			uint32_t timestamp = MESH_FIFO_CACHE_SIZE + 1;
+
+			// hard boundaries: triangles with three cache misses usually start a new part of the mesh
+			std::vector<size_t> hard_clusters;
+			for (size_t triangle = 0; triangle < triangle_count; triangle++) {
+
+				uint32_t misses = updateFifoCache(mesh.indices.data() + 3 * triangle, MESH_FIFO_CACHE_SIZE, cache_timestamps, timestamp);
+				if (!triangle || (misses == 3))
+					hard_clusters.push_back(triangle);
+			}
+
+			// soft boundaries: splitting the clusters as soon as the cache miss ratio of the part is good enough
+			std::vector<size_t> clusters;
+			for (size_t i = 0; i < hard_clusters.size(); i++) {
+
+				size_t start = hard_clusters.at(i);
+				size_t end = (i + 1 < hard_clusters.size()) ? hard_clusters.at(i + 1) : triangle_count;
+
+				// the cache miss ratio of the whole cluster
+				timestamp += MESH_FIFO_CACHE_SIZE + 1; // resetting the cache
+				uint32_t cluster_misses = 0;
+				for (size_t triangle = start; triangle < end; triangle++)
+					cluster_misses += updateFifoCache(mesh.indices.data() + 3 * triangle, MESH_FIFO_CACHE_SIZE, cache_timestamps, timestamp);
+
+				float cluster_threshold = threshold * float(cluster_misses) / float(end - start);
+
+				clusters.push_back(start);
+
+				timestamp += MESH_FIFO_CACHE_SIZE + 1;
+				uint32_t running_misses = 0;
+				uint32_t running_triangles = 0;
+
+				for (size_t triangle = start; triangle < end; triangle++) {
+
+					running_misses += updateFifoCache(mesh.indices.data() + 3 * triangle, MESH_FIFO_CACHE_SIZE, cache_timestamps, timestamp);
+					running_triangles++;
+
+					if (float(running_misses) / float(running_triangles) <= cluster_threshold) {
+						// the next triangle starts a new cluster
+						clusters.push_back(triangle + 1);
+						timestamp += MESH_FIFO_CACHE_SIZE + 1;
+						running_misses = 0;
+						running_triangles = 0;
+					}
+
+				}
+
+				// the last cluster usually is too small to be good, so it gets merged with the one before it
+				// (this also removes the boundary at the end of the cluster, if there is one)
+				if (clusters.back() != start)
+					clusters.pop_back();
+			}
+
+			// the center of the mesh
+			auto getPosition = [&](int vertex) -> const float* {
+				return mesh.vertices.data() + vertex * vertex_size;
+			};
+
+			float mesh_center[3] = {0.0f, 0.0f, 0.0f};
+			float mesh_area = 0.0f;
+
+			std::vector<float> cluster_keys(clusters.size());
+			std::vector<float> cluster_data(clusters.size() * 7); // center (weighted by area), area, normal (weighted by area)
+
+			for (size_t i = 0; i < clusters.size(); i++) {
+
+				size_t start = clusters.at(i);
+				size_t end = (i + 1 < clusters.size()) ? clusters.at(i + 1) : triangle_count;
+				float* data = cluster_data.data() + 7 * i;
+
+				for (size_t triangle = start; triangle < end; triangle++) {
+
+					const float* p0 = getPosition(mesh.indices.at(3 * triangle + 0));
+					const float* p1 = getPosition(mesh.indices.at(3 * triangle + 1));
+					const float* p2 = getPosition(mesh.indices.at(3 * triangle + 2));
+
+					float e0[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+					float e1[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+					float normal[3] = {e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0]};
+
+					float area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+					for (int c = 0; c < 3; c++) {
+						data[c] += (p0[c] + p1[c] + p2[c]) / 3.0f * area;
+						data[4 + c] += normal[c];
+					}
+
+					data[3] += area;
+				}
+
+				for (int c = 0; c < 3; c++)
+					mesh_center[c] += data[c];
+
+				mesh_area += data[3];
+			}
+
+			for (int c = 0; c < 3; c++)
+				mesh_center[c] /= (mesh_area > 0.0f) ? mesh_area : 1.0f;
+
+			for (size_t i = 0; i < clusters.size(); i++) {
+
+				const float* data = cluster_data.data() + 7 * i;
+
+				float normal_length = std::sqrt(data[4] * data[4] + data[5] * data[5] + data[6] * data[6]);
+				float area = (data[3] > 0.0f) ? data[3] : 1.0f;
+
+				// how far the cluster faces away from the center of the mesh
+				float key = 0.0f;
+				for (int c = 0; c < 3; c++)
+					key += (data[c] / area - mesh_center[c]) * data[4 + c];
+
+				cluster_keys.at(i) = (normal_length > 0.0f) ? key / normal_length : 0.0f;
+			}
+
+			// drawing the outwards facing clusters first
+			std::vector<uint32_t> cluster_order(clusters.size());
+			for (size_t i = 0; i < clusters.size(); i++)
+				cluster_order.at(i) = i;
+
+			std::stable_sort(cluster_order.begin(), cluster_order.end(), [&](uint32_t a, uint32_t b) {
+				return cluster_keys.at(a) > cluster_keys.at(b);
+			});
+
+			std::vector<int> new_indices;
+			new_indices.reserve(mesh.indices.size());
+
+			for (uint32_t cluster : cluster_order) {
+
+				size_t start = clusters.at(cluster);
+				size_t end = (cluster + 1 < clusters.size()) ? clusters.at(cluster + 1) : triangle_count;
+
+				new_indices.insert(new_indices.end(), mesh.indices.begin() + 3 * start, mesh.indices.begin() + 3 * end);
+			}
+
+			mesh.indices = std::move(new_indices);
+		}
+
+		///////////////////////////////////////////// optimizing the vertex order /////////////////////////////////////////////
+
+		void optimizeVertexFetch(MeshData& mesh) {
+			/** reorders the vertices in the order in which they are first used by the triangles (vertices that are not used get removed) */
+
+			size_t vertex_size = getVertexSize(mesh.vertex_layout);
+			size_t vertex_count = getVertexCount(mesh);
+
+			if (!vertex_size)
+				return;
+
+			std::vector<int> remap(vertex_count, -1);
+			std::vector<float> new_vertices;
+			new_vertices.reserve(mesh.vertices.size());
+
+			for (int& index : mesh.indices) {
+
+				if (remap.at(index) < 0) {
+					remap.at(index) = new_vertices.size() / vertex_size;
+					new_vertices.insert(new_vertices.end(), mesh.vertices.begin() + index * vertex_size, mesh.vertices.begin() + (index + 1) * vertex_size);
+				}
+
+				index = remap.at(index);
+			}
+
+			mesh.vertices = std::move(new_vertices);
+		}
+
+		void optimizeMesh(MeshData& mesh, bool vertex_cache, bool overdraw, bool vertex_fetch) {
+			/** welds the vertices of the mesh and applies the optimizations (in the order in which they should be applied) */
+
+			weldVertices(mesh);
+
+			if (vertex_cache)
+				optimizeVertexCache(mesh);
+
+			if (overdraw)
+				optimizeOverdraw(mesh);
+
+			if (vertex_fetch)
+				optimizeVertexFetch(mesh);
+
+		}
+
+		float calcACMR(const std::vector<int>& indices, size_t vertex_count, uint32_t cache_size) {
+			/** @return the average number of cache misses per triangle when drawing the triangles with a fifo cache of the size
+			* (3 without any reuse, 0.5 is the best possible value for large regular meshes) */
+
+			size_t triangle_count = indices.size() / 3;
+			if (!triangle_count)
+				return 0.0f;
+
+			std::vector<uint32_t> cache_timestamps(vertex_count, 0);
+			uint32_t timestamp = cache_size + 1;
+			size_t misses = 0;
+
+			for (size_t triangle = 0; triangle < triangle_count; triangle++)
+				misses += updateFifoCache(indices.data() + 3 * triangle, cache_size, cache_timestamps, timestamp);
+
+			return float(misses) / float(triangle_count);
+		}
+
+	} // tools
+
+} // undicht
@@ -0,0 +1,55 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <vector>
+#include <cstdint>
+#include "model_loading/model_loader.h"
+
+// size of the post transform cache simulated by optimizeVertexCache()
+#ifndef MESH_VERTEX_CACHE_SIZE
+#define MESH_VERTEX_CACHE_SIZE 32
+#endif
+
+// size of the fifo cache used to find the clusters of triangles for optimizeOverdraw() and calcACMR()
+#ifndef MESH_FIFO_CACHE_SIZE
+#define MESH_FIFO_CACHE_SIZE 16
+#endif
+
+namespace undicht {
+
+	namespace tools {
+
+		// functions that prepare meshes loaded by a ModelLoader for rendering
+		// the meshes are expected to be triangle lists (3 indices per triangle)
+
+		/** removes double vertices (vertices with the same bytes) by adding indices referencing the first version of that vertex to the loadTo_indices vector
+		* vertices already stored in loadTo_vertices are reused as well */
+		void weldVertices(const std::vector<float>& vertices, const BufferLayout& vertex_layout, std::vector<float>& loadTo_vertices, std::vector<int>& loadTo_indices);
+
+		/** welds the vertices of the mesh (if the mesh already has indices, they get updated) */
+		void weldVertices(MeshData& mesh);
+
+		/** reorders the triangles, so that their vertices are more likely to be in the post transform cache of the gpu
+		* (Tom Forsyth's "Linear-Speed Vertex Cache Optimisation") */
+		void optimizeVertexCache(MeshData& mesh, uint32_t cache_size = MESH_VERTEX_CACHE_SIZE);
+
+		/** reorders clusters of triangles so that the ones facing outwards get drawn first (to reduce overdraw)
+		* should be used after optimizeVertexCache(), the position has to be the first attribute of the vertices (UND_VEC3F)
+		* @param threshold: how much the vertex cache efficiency may get worse (1.05 -> the average cache miss ratio may increase by 5%) */
+		void optimizeOverdraw(MeshData& mesh, float threshold = 1.05f);
+
+		/** reorders the vertices in the order in which they are first used by the triangles (vertices that are not used get removed) */
+		void optimizeVertexFetch(MeshData& mesh);
+
+		/** welds the vertices of the mesh and applies the optimizations (in the order in which they should be applied) */
+		void optimizeMesh(MeshData& mesh, bool vertex_cache = true, bool overdraw = true, bool vertex_fetch = true);
+
+		/** @return the average number of cache misses per triangle when drawing the triangles with a fifo cache of the size
+		* (3 without any reuse, 0.5 is the best possible value for large regular meshes) */
+		float calcACMR(const std::vector<int>& indices, size_t vertex_count, uint32_t cache_size = MESH_FIFO_CACHE_SIZE);
+
+	} // tools
+
+} // undicht
+
+#endif // MESH_OPTIMIZER_H
@@ -1,4 +1,5 @@
 #include "model_loader.h"
+#include "mesh_optimizer.h"
 #include "debug.h"
 
 namespace undicht {
@@ -35,14 +36,14 @@ namespace undicht {
 			/** takes an attribute (size determined by vertex_layout, can be UND_FLOAT, UND_VEC3F, ...) from each attribute_data list,
 			* which attribute is determined by the attribute index, to build the vertices */
 
-			int attributes_per_vertex = vertex_layout.m_types.size();
+			int attributes_per_vertex = vertex_layout.getTypeCount();
 			int vertex_count = attribute_indices.size() / attributes_per_vertex;
 
 			//std::cout << "attributes: " << attributes_per_vertex << " vertex_count: " << vertex_count << "\n";
 
 			std::vector<int> attribute_sizes; // the number of floats of each attribute used in a vertex
 
-			for (const FixedType& attribute_type : vertex_layout.m_types) {
+			for (const FixedType& attribute_type : vertex_layout.getTypes()) {
 
 				attribute_sizes.push_back(attribute_type.m_num_components);
 				//std::cout << "attribute size: " << core::getNumberOfComponents(attribute_type) << "\n";
@@ -68,50 +69,10 @@ namespace undicht {
 		}
 
 		void ModelLoader::buildIndices(const std::vector<float>& vertices, const BufferLayout& vertex_layout, std::vector<float>& loadTo_vertices, std::vector<int>& loadTo_indices) {
-			/** removes double vertices by adding indices referencing the first version of that vertex to the loadTo_indices vector*/
-
-			int vertex_size = vertex_layout.getTotalSize() / sizeof(float);
-			int vertex_count = vertices.size() / vertex_size;
-
-			for (int vertex = 0; vertex < vertex_count; vertex++) {
-
-				int indexed_vertex; // the index of the vertex in loadTo_vertices equal to the current vertex
-				bool vertices_are_equal = false; // (only if this is true)
-
-				// comparing the vertex to the ones that where already confirmed unique
-				for (indexed_vertex = 0; indexed_vertex < loadTo_vertices.size() / vertex_size; indexed_vertex++) {
-
-					vertices_are_equal = true;
-
-					// testing if one float is different
-					for (int f = 0; f < vertex_size; f++) {
-
-						if (vertices.at(vertex * vertex_size + f) != loadTo_vertices.at(indexed_vertex * vertex_size + f)) {
-							// vertices are not equal
-							vertices_are_equal = false;
-							break;
-						}
-
-					}
-
-					if (vertices_are_equal) {
-						// found one, adding the index to the indices list
-						//std::cout << "found an redundant vertex " << "\n";
-						loadTo_indices.push_back(indexed_vertex);
-						break;
-					}
-
-				}
-
-				if (!vertices_are_equal) {
-					// no equal vertices were found, so adding the vertex to loadTo_vertices
-					// std::cout << "vertex is unique" << "\n";
-					loadTo_indices.push_back(loadTo_vertices.size() / vertex_size);
-					loadTo_vertices.insert(loadTo_vertices.end(), vertices.begin() + vertex * vertex_size, vertices.begin() + (vertex + 1) * vertex_size);
-				}
-
-			}
+			/** removes double vertices by adding indices referencing the first version of that vertex to the loadTo_indices vector
+			* (the vertices are compared by their bytes, see weldVertices()) */
 
+			weldVertices(vertices, vertex_layout, loadTo_vertices, loadTo_indices);
 		}
 
 
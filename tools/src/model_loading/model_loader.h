@@ -70,7 +70,8 @@ namespace undicht {
 				const BufferLayout& vertex_layout, const std::vector<int>& attribute_indices);
 
 
-			/** removes double vertices by adding indices referencing the first version of that vertex to the loadTo_indices vector*/
+			/** removes double vertices by adding indices referencing the first version of that vertex to the loadTo_indices vector
+			* (the vertices are compared by their bytes, see weldVertices()) */
 			virtual void buildIndices(const std::vector<float>& vertices, const BufferLayout& vertex_layout, std::vector<float>& loadTo_vertices, std::vector<int>& loadTo_indices);
 
 		};
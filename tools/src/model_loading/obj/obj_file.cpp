@@ -1,9 +1,25 @@
 #include "obj_file.h"
 #include "fstream"
+#include "cstring"
+#include "algorithm"
+#include "config.h"
 #include "debug.h"
+#include "job_system.h"
 #include "file_tools.h"
 #include "images/image_file.h"
 
+#ifdef PLATFORM_UNIX
+#include "fcntl.h"
+#include "unistd.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+#endif
+
+// files larger than this get split into ranges of about this size, which are parsed in parallel
+#ifndef OBJ_PARALLEL_RANGE_SIZE
+#define OBJ_PARALLEL_RANGE_SIZE (1024 * 1024)
+#endif
+
 namespace undicht {
 
     namespace tools {
@@ -23,15 +39,57 @@ namespace undicht {
 
         bool OBJFile::open(const std::string& file_name) {
 
-            std::ifstream file(file_name);
             _file_name = file_name;
+            _objects.clear();
+            _positions.clear();
+            _tex_coords.clear();
+            _normals.clear();
+            _current_mtl_lib.clear();
+
+#ifdef PLATFORM_UNIX
+
+            // mapping the file into memory
+            int file_descriptor = ::open(file_name.c_str(), O_RDONLY);
+            struct stat file_stat;
+
+            if((file_descriptor < 0) || fstat(file_descriptor, &file_stat)) {
+                UND_ERROR << "failed to open file: " << file_name << "\n";
+                if(file_descriptor >= 0) ::close(file_descriptor);
+				return false;
+            }
+
+            if(file_stat.st_size > 0) { // an empty file cant be mapped
+
+                void* data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+                if(data == MAP_FAILED) {
+                    UND_ERROR << "failed to map file: " << file_name << "\n";
+                    ::close(file_descriptor);
+                    return false;
+                }
+
+                madvise(data, file_stat.st_size, MADV_WILLNEED);
+                loadFileContent((const char*)data, file_stat.st_size);
+                munmap(data, file_stat.st_size);
+            }
+
+            ::close(file_descriptor);
+
+#else
+
+            std::ifstream file(file_name, std::ios::binary | std::ios::ate);
 
 			if (!file.is_open()) {
                 UND_ERROR << "failed to open file: " << file_name << "\n";
 				return false;
 			}
 
-            loadFileContent(file);
+            std::vector<char> data(file.tellg());
+            file.seekg(0);
+            file.read(data.data(), data.size());
+
+            loadFileContent(data.data(), data.size());
+
+#endif
 
             return true;
         }
@@ -94,9 +152,9 @@ namespace undicht {
 
                 MeshData data;
 
-                if(load_positions) data.vertex_layout.m_types.push_back(UND_VEC3F);
-                if(load_uvs) data.vertex_layout.m_types.push_back(UND_VEC2F);
-                if(load_normals) data.vertex_layout.m_types.push_back(UND_VEC3F);
+                if(load_positions) data.vertex_layout.addType(UND_VEC3F);
+                if(load_uvs) data.vertex_layout.addType(UND_VEC2F);
+                if(load_normals) data.vertex_layout.addType(UND_VEC3F);
 
                 for(const Group& g : o._groups) { // should only be one, might be 0?
 
@@ -106,28 +164,28 @@ namespace undicht {
 
                         for(int vertex = 0; vertex < 3; vertex++) {
                             
-                            if(f._vertex_ids.size() && load_positions) {
-                                data.vertices.push_back(_positions.at(f._vertex_ids.at(vertex) - 1).x);
-                                data.vertices.push_back(_positions.at(f._vertex_ids.at(vertex) - 1).y);
-                                data.vertices.push_back(_positions.at(f._vertex_ids.at(vertex) - 1).z);
+                            if(f._vertex_ids[vertex] && load_positions) {
+                                data.vertices.push_back(_positions.at(f._vertex_ids[vertex] - 1).x);
+                                data.vertices.push_back(_positions.at(f._vertex_ids[vertex] - 1).y);
+                                data.vertices.push_back(_positions.at(f._vertex_ids[vertex] - 1).z);
                             } else if (load_positions) {
                                 data.vertices.push_back(0.0f);
                                 data.vertices.push_back(0.0f);
                                 data.vertices.push_back(0.0f);
                             }
 
-                            if(f._tex_coord_ids.size() && load_uvs) {
-                                data.vertices.push_back(_tex_coords.at(f._tex_coord_ids.at(vertex) - 1).u);
-                                data.vertices.push_back(_tex_coords.at(f._tex_coord_ids.at(vertex) - 1).v);
+                            if(f._tex_coord_ids[vertex] && load_uvs) {
+                                data.vertices.push_back(_tex_coords.at(f._tex_coord_ids[vertex] - 1).u);
+                                data.vertices.push_back(_tex_coords.at(f._tex_coord_ids[vertex] - 1).v);
                             } else if (load_uvs) {
                                 data.vertices.push_back(0.0f);
                                 data.vertices.push_back(0.0f);
                             }
 
-                            if(f._normal_ids.size() && load_normals) {
-                                data.vertices.push_back(_normals.at(f._normal_ids.at(vertex) - 1).x);
-                                data.vertices.push_back(_normals.at(f._normal_ids.at(vertex) - 1).y);
-                                data.vertices.push_back(_normals.at(f._normal_ids.at(vertex) - 1).z);
+                            if(f._normal_ids[vertex] && load_normals) {
+                                data.vertices.push_back(_normals.at(f._normal_ids[vertex] - 1).x);
+                                data.vertices.push_back(_normals.at(f._normal_ids[vertex] - 1).y);
+                                data.vertices.push_back(_normals.at(f._normal_ids[vertex] - 1).z);
                             } else if (load_normals) {
                                 data.vertices.push_back(0.0f);
                                 data.vertices.push_back(0.0f);
@@ -175,143 +233,189 @@ namespace undicht {
 
         /////////////////////////////////////////////// private obj loading functions ///////////////////////////////////////////////
 
-        void OBJFile::loadFileContent(std::ifstream& file) {
+        void OBJFile::loadFileContent(const char* data, size_t byte_size) {
             // loads the content of the file into the internal data structures
+            // (large files get split into ranges of lines which are parsed in parallel)
 
-            std::string line;
-            std::string data;
-            readNextLine(file, line);
-            while(!file.eof()) {
-                
-                // mtllib
-                while(readMtlLib(line, data)) {
-                    _current_mtl_lib = data;
-                    _mtl_file.open(getFilePath(_file_name) + data);
-                    readNextLine(file, line);
-                }
+            size_t range_count = std::max<size_t>(byte_size / OBJ_PARALLEL_RANGE_SIZE, 1);
 
-                // object
-                while(readObject(line, data)) {
-                    Object new_object;
-                    new_object._name = data;
-                    new_object._mtl_lib = _current_mtl_lib;
-                    _objects.push_back(new_object);
-                    readNextLine(file, line);
-                }
+            // the ranges start at the beginning of a line
+            std::vector<const char*> range_begins(range_count + 1);
+            range_begins.at(0) = data;
+            range_begins.at(range_count) = data + byte_size;
 
-                // creating a default object if no object was specified in the file
-                if(!_objects.size()) {
-                    Object new_object;
-                    new_object._name = "default";
-                    new_object._mtl_lib = _current_mtl_lib;
-                    _objects.push_back(new_object);
-                }
+            for(size_t i = 1; i < range_count; i++) {
 
-                // vertex positions
-                while(readVertexPos(line, _positions))
-                    readNextLine(file, line);
-                        
-                // tex coords
-                while(readTexCoord(line, _tex_coords))
-                    readNextLine(file, line);
+                const char* begin = std::max(data + byte_size * i / range_count, range_begins.at(i - 1));
+                const char* line_end = (const char*)std::memchr(begin, '\n', data + byte_size - begin);
 
-                // vertex normals
-                while(readVertexNorm(line, _normals))
-                    readNextLine(file, line);
+                range_begins.at(i) = line_end ? line_end + 1 : data + byte_size;
+            }
 
-                // group
-                while(readGroup(line, data)) {
-                    Group new_group;
-                    new_group._name = data;
-                    _objects.back()._groups.push_back(new_group);
-                    readNextLine(file, line);
-                }
+            std::vector<ParsedRange> ranges(range_count);
+            JobSystem::parallelFor(0, range_count, 1, [&](uint32_t range) {
+                parseRange(range_begins.at(range), range_begins.at(range + 1), ranges.at(range));
+            });
+
+            // merging the ranges in the order of the file
+            size_t position_count = 0, tex_coord_count = 0, normal_count = 0;
+            for(const ParsedRange& range : ranges) {
+                position_count += range._positions.size();
+                tex_coord_count += range._tex_coords.size();
+                normal_count += range._normals.size();
+            }
 
-                // creating a default group if no group was specified in the file
-                if(!_objects.back()._groups.size()) {
-                    Group new_group;
-                    new_group._name = "default";
-                    _objects.back()._groups.push_back(new_group);
-                }
+            _positions.reserve(position_count);
+            _tex_coords.reserve(tex_coord_count);
+            _normals.reserve(normal_count);
 
-                // usemtl
-                while(readUseMtl(line, data)) {
-                    _objects.back()._groups.back()._mtl = data;
-                    readNextLine(file, line);
-                }
+            for(ParsedRange& range : ranges) {
+                mergeRange(range);
+                range = ParsedRange(); // freeing the memory
+            }
+
+            // creating a default object if no object was specified in the file
+            if(!_objects.size() && (position_count || tex_coord_count || normal_count))
+                getCurrentGroup();
 
-                // faces
-                while(readFace(line, _objects.back()._groups.back())) {
-                    readNextLine(file, line);
+        }
+
+        void OBJFile::parseRange(const char* begin, const char* end, ParsedRange& loadTo) const {
+            // parses the lines in the range (the range has to start at the beginning of a line)
+
+            const char* line_begin = begin;
+
+            while(line_begin < end) {
+
+                const char* line_end = (const char*)std::memchr(line_begin, '\n', end - line_begin);
+                if(!line_end)
+                    line_end = end;
+
+                std::string_view line(line_begin, line_end - line_begin);
+                if(line.size() && (line.back() == '\r'))
+                    line.remove_suffix(1);
+
+                line_begin = line_end + 1;
+
+                // vertex data / faces
+                if(readVertexPos(line, loadTo._positions)) continue;
+                if(readTexCoord(line, loadTo._tex_coords)) continue;
+                if(readVertexNorm(line, loadTo._normals)) continue;
+                if(readFace(line, loadTo)) continue;
+
+                // lines changing the object / group / material of the following faces
+                RangeEvent event;
+                size_t name_start;
+
+                if(!line.compare(0, 7, "mtllib ")) {
+                    event._type = RangeEvent::MTL_LIB;
+                    name_start = 7;
+                } else if(!line.compare(0, 2, "o ")) {
+                    event._type = RangeEvent::OBJECT;
+                    name_start = 2;
+                } else if(!line.compare(0, 2, "g ")) {
+                    event._type = RangeEvent::GROUP;
+                    name_start = 2;
+                } else if(!line.compare(0, 7, "usemtl ")) {
+                    event._type = RangeEvent::USE_MTL;
+                    name_start = 7;
+                } else {
+                    continue; // comments and other lines that currently cant be processed
                 }
+
+                event._name = line.substr(name_start);
+                event._face_count = loadTo._faces.size();
+                loadTo._events.push_back(event);
             }
 
         }
 
-        bool OBJFile::readNextLine(std::ifstream& file, std::string& line) {
-            // reads the next line that is a valid line (i.e. not a comment line or other lines that currently cant be processed)
-            // returns false if the end of the file is reached
-
-            while(!file.eof()) {
-                std::getline(file, line);
-                if(!line.compare(0, 7, "mtllib ")) break;
-                if(!line.compare(0, 2, "o ")) break;
-                if(!line.compare(0, 2, "g ")) break;
-                if(!line.compare(0, 7, "usemtl ")) break;
-                if(!line.compare(0, 2, "v ")) break;
-                if(!line.compare(0, 3, "vt ")) break;
-                if(!line.compare(0, 3, "vn ")) break;
-                if(!line.compare(0, 2, "f ")) break;
+        void OBJFile::mergeRange(ParsedRange& range) {
+            // adds the data of the range to the internal data structures (the ranges have to be merged in the order of the file)
+
+            // ids that are relative to the range start after the data of the ranges before it
+            for(size_t relative_id : range._relative_ids) {
+
+                Face& face = range._faces.at(relative_id / 9);
+                size_t attribute = relative_id % 9 / 3;
+                size_t vertex = relative_id % 3;
+
+                if(attribute == 0) face._vertex_ids[vertex] += _positions.size();
+                if(attribute == 1) face._tex_coord_ids[vertex] += _tex_coords.size();
+                if(attribute == 2) face._normal_ids[vertex] += _normals.size();
             }
-            
-            if(file.eof())
-                return false;
-            else
-                return true;
-        }
 
-        ///////////////////////// reading lines (return false if the line does not contain the right data) /////////////////////////
+            _positions.insert(_positions.end(), range._positions.begin(), range._positions.end());
+            _tex_coords.insert(_tex_coords.end(), range._tex_coords.begin(), range._tex_coords.end());
+            _normals.insert(_normals.end(), range._normals.begin(), range._normals.end());
 
-        bool OBJFile::readMtlLib(const std::string& line, std::string& mtl_lib) {
+            // the faces before each event belong to the current group
+            size_t first_face = 0;
+            for(size_t i = 0; i <= range._events.size(); i++) {
 
-            if(line.compare(0, 7, "mtllib "))
-                return false; // not a line with a material lib
+                size_t last_face = (i < range._events.size()) ? range._events.at(i)._face_count : range._faces.size();
 
-            mtl_lib = line.substr(7, line.size() - 7);
+                if(last_face > first_face) {
+                    std::vector<Face>& faces = getCurrentGroup()._faces;
+                    faces.insert(faces.end(), range._faces.begin() + first_face, range._faces.begin() + last_face);
+                    first_face = last_face;
+                }
 
-            return true;
-        }
+                if(i == range._events.size())
+                    break;
 
-        bool OBJFile::readObject(const std::string& line, std::string& obj_name) {
+                const RangeEvent& event = range._events.at(i);
 
-            if(line.compare(0, 2, "o "))
-                return false; // not a line with a object name
+                if(event._type == RangeEvent::MTL_LIB) {
 
-            obj_name = line.substr(2, line.size() - 2);
+                    _current_mtl_lib = event._name;
+                    _mtl_file.open(getFilePath(_file_name) + event._name);
 
-            return true;
-        }
+                } else if(event._type == RangeEvent::OBJECT) {
 
-        bool OBJFile::readGroup(const std::string& line, std::string& group_name) {
+                    Object new_object;
+                    new_object._name = event._name;
+                    new_object._mtl_lib = _current_mtl_lib;
+                    _objects.push_back(new_object);
 
-            if(line.compare(0, 2, "g "))
-                return false; // not a line with a group name
+                } else if(event._type == RangeEvent::GROUP) {
 
-            group_name = line.substr(2, line.size() - 2);
+                    getCurrentGroup(); // creating a default object if there is none
+                    Group new_group;
+                    new_group._name = event._name;
+                    _objects.back()._groups.push_back(new_group);
+
+                } else if(event._type == RangeEvent::USE_MTL) {
+
+                    getCurrentGroup()._mtl = event._name;
+                }
+
+            }
 
-            return true;
         }
 
-        bool OBJFile::readUseMtl(const std::string& line, std::string& mtl_name) {
-            if(line.compare(0, 7, "usemtl "))
-                return false; // not a line with a usemtl command
+        OBJFile::Group& OBJFile::getCurrentGroup() {
+            // the group that gets the following faces (creates a default object / group if there is none)
+
+            if(!_objects.size()) {
+                Object new_object;
+                new_object._name = "default";
+                new_object._mtl_lib = _current_mtl_lib;
+                _objects.push_back(new_object);
+            }
 
-            mtl_name = line.substr(7, line.size() - 7);
+            if(!_objects.back()._groups.size()) {
+                Group new_group;
+                new_group._name = "default";
+                _objects.back()._groups.push_back(new_group);
+            }
 
-            return true;
+            return _objects.back()._groups.back();
         }
 
-        bool OBJFile::readVertexPos(const std::string& line, std::vector<VertexPos>& loadTo) {
+        ///////////////////////// reading lines (return false if the line does not contain the right data) /////////////////////////
+
+        bool OBJFile::readVertexPos(std::string_view line, std::vector<VertexPos>& loadTo) const {
             // reading vertex data (return false if the line does not contain the right data)
 
             if(line.compare(0, 2, "v "))
@@ -319,9 +423,9 @@ namespace undicht {
             
             // extracting the vertex positions from the line
             float pos[3];
-            char* str = (char*)line.data() + 2;
+            size_t position = 2;
             for(int i = 0; i < 3; i++) {
-                pos[i] = std::strtof(str, &str); // strtof sets the second param to point to the char after the float that was extracted
+                position += parseFloat(line.substr(position), pos[i]); // returns the number of chars that were read
             }            
 
             // storing the vertex positions
@@ -330,16 +434,16 @@ namespace undicht {
             return true;
         }
 
-        bool OBJFile::readTexCoord(const std::string& line, std::vector<TexCoord>& loadTo) {
+        bool OBJFile::readTexCoord(std::string_view line, std::vector<TexCoord>& loadTo) const {
 
             if(line.compare(0, 3, "vt "))
                 return false; // not a line with tex coord data
 
             // extracting the tex coords from the line
             float uv[2];
-            char* str = (char*)line.data() + 3;
+            size_t position = 3;
             for(int i = 0; i < 2; i++) {
-                uv[i] = std::strtof(str, &str); // strtof sets the second param to point to the char after the float that was extracted
+                position += parseFloat(line.substr(position), uv[i]); // returns the number of chars that were read
             }
 
             // storing the tex coord
@@ -348,16 +452,16 @@ namespace undicht {
             return true;
         }
 
-        bool OBJFile::readVertexNorm(const std::string& line, std::vector<VertexNorm>& loadTo) {
+        bool OBJFile::readVertexNorm(std::string_view line, std::vector<VertexNorm>& loadTo) const {
 
             if(line.compare(0, 3, "vn "))
                 return false; // not a line with normal data
 
             // extracting the normal from the line
             float normal[3];
-            char* str = (char*)line.data() + 3;
+            size_t position = 3;
             for(int i = 0; i < 3; i++) {
-                normal[i] = std::strtof(str, &str); // strtof sets the second param to point to the char after the float that was extracted
+                position += parseFloat(line.substr(position), normal[i]); // returns the number of chars that were read
             }
 
             // storing the normal
@@ -366,31 +470,83 @@ namespace undicht {
             return true;
         }
 
-        bool OBJFile::readFace(const std::string& line, Group& loadTo) {
+        bool OBJFile::readFace(std::string_view line, ParsedRange& loadTo) const {
+            // faces with more than 3 vertices get split into triangles sharing the first vertex
 
             if(line.compare(0, 2, "f "))
                 return false; // not a line with face data
 
-            Face new_face;
-            char* str = (char*)line.data() + 1;
-            for(int i = 0; i < 3; i++) {
+            // the number of attributes before the face (to resolve negative indices, which are relative to the end of the data)
+            const size_t attribute_counts[3] = {loadTo._positions.size(), loadTo._tex_coords.size(), loadTo._normals.size()};
+
+            int first_vertex[3], previous_vertex[3];
+            bool first_relative[3], previous_relative[3];
+            size_t vertex_count = 0;
+            size_t position = 2;
+
+            while(position < line.size()) {
+
+                // reading the ids of the next vertex (id, id/id, id//id or id/id/id)
+                int ids[3] = {0, 0, 0};
+                bool relative[3] = {false, false, false};
+                size_t vertex_start = position;
+
                 for(int j = 0; j < 3; j++) {
-                    
-                    str++; // moving past the first delimiter
-                    if(str[0] == '/') continue; // attribute was not specified
 
-                    int index = std::strtoul(str, &str, 10);
+                    if((position < line.size()) && (line[position] != '/')) {
 
-                    if(j == 0) new_face._vertex_ids.push_back(index);
-                    if(j == 1) new_face._tex_coord_ids.push_back(index);
-                    if(j == 2) new_face._normal_ids.push_back(index);
+                        position += parseInt(line.substr(position), ids[j]);
 
-                    if(str[0] == ' ') break; // no further attributes were specified
-                
+                        if(ids[j] < 0) {
+                            // relative to the data of the range for now (see mergeRange())
+                            ids[j] += attribute_counts[j] + 1;
+                            relative[j] = true;
+                        }
+
+                    }
+
+                    if((position >= line.size()) || (line[position] != '/'))
+                        break; // no further attributes were specified
+
+                    position++; // moving past the '/'
                 }
-            }
 
-            loadTo._faces.push_back(new_face);
+                while((position < line.size()) && ((line[position] == ' ') || (line[position] == '\t')))
+                    position++;
+
+                if(position == vertex_start)
+                    break; // not a valid vertex
+
+                if(!ids[0] && !relative[0])
+                    continue; // (i.e. trailing whitespace)
+
+                // adding a triangle
+                if(vertex_count >= 2) {
+
+                    Face new_face;
+                    const int* vertices[3] = {first_vertex, previous_vertex, ids};
+                    const bool* relative_vertices[3] = {first_relative, previous_relative, relative};
+
+                    for(int vertex = 0; vertex < 3; vertex++) {
+
+                        new_face._vertex_ids[vertex] = vertices[vertex][0];
+                        new_face._tex_coord_ids[vertex] = vertices[vertex][1];
+                        new_face._normal_ids[vertex] = vertices[vertex][2];
+
+                        for(int j = 0; j < 3; j++)
+                            if(relative_vertices[vertex][j])
+                                loadTo._relative_ids.push_back(loadTo._faces.size() * 9 + j * 3 + vertex);
+                    }
+
+                    loadTo._faces.push_back(new_face);
+                }
+
+                int* stored_vertex = vertex_count ? previous_vertex : first_vertex;
+                bool* stored_relative = vertex_count ? previous_relative : first_relative;
+                std::copy(ids, ids + 3, stored_vertex);
+                std::copy(relative, relative + 3, stored_relative);
+                vertex_count++;
+            }
 
             return true;
         }
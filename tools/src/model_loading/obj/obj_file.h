@@ -3,6 +3,7 @@
 
 #include "model_loading/model_loader.h"
 #include "string.h"
+#include "string_view"
 #include "vector"
 #include "mtl_file.h"
 
@@ -16,10 +17,10 @@ namespace undicht {
             // internal data structures
 
             struct Face {
-                // obj starts counting at 1!!!!!
-                std::vector<uint32_t> _vertex_ids;
-                std::vector<uint32_t> _tex_coord_ids; // (optional)
-                std::vector<uint32_t> _normal_ids; // (optional)
+                // obj starts counting at 1!!!!! (0 if the attribute was not specified)
+                int _vertex_ids[3] = {0, 0, 0};
+                int _tex_coord_ids[3] = {0, 0, 0}; // (optional)
+                int _normal_ids[3] = {0, 0, 0}; // (optional)
             };
 
             struct Group {
@@ -54,6 +55,26 @@ namespace undicht {
                 std::vector<Group> _groups;
             };
 
+            struct RangeEvent {
+                // a line of a range that changes the object / group / material of the following faces
+                enum Type {MTL_LIB, OBJECT, GROUP, USE_MTL} _type;
+                std::string _name;
+                size_t _face_count; // the number of faces of the range that came before the line
+            };
+
+            struct ParsedRange {
+                // the data of a part of the file (which gets parsed independently of the other parts)
+                std::vector<VertexPos> _positions;
+                std::vector<TexCoord> _tex_coords;
+                std::vector<VertexNorm> _normals;
+                std::vector<Face> _faces;
+                std::vector<RangeEvent> _events;
+
+                // ids of the faces that are relative to the data of the range (negative indices in the file)
+                // stored as the position in the _faces array * 9 + the position in the face
+                std::vector<size_t> _relative_ids;
+            };
+
           protected:
             
             std::string _file_name;
@@ -102,21 +123,23 @@ namespace undicht {
             // private obj loading functions
 
             // loads the content of the file into the internal data structures
-            void loadFileContent(std::ifstream& file);
+            // (large files get split into ranges of lines which are parsed in parallel)
+            void loadFileContent(const char* data, size_t byte_size);
+
+            // parses the lines in the range (the range has to start at the beginning of a line)
+            void parseRange(const char* begin, const char* end, ParsedRange& loadTo) const;
+
+            // adds the data of the range to the internal data structures (the ranges have to be merged in the order of the file)
+            void mergeRange(ParsedRange& range);
 
-            // reads the next line that is a valid line (i.e. not a comment line or other lines that currently cant be processed)
-            // returns false if the end of the file is reached
-            bool readNextLine(std::ifstream& file, std::string& line);
+            // the group that gets the following faces (creates a default object / group if there is none)
+            Group& getCurrentGroup();
 
             // reading lines (return false if the line does not contain the right data)
-            bool readMtlLib(const std::string& line, std::string& mtl_lib);
-            bool readObject(const std::string& line, std::string& obj_name);
-            bool readGroup(const std::string& line, std::string& group_name);
-            bool readUseMtl(const std::string& line, std::string& mtl_name);
-            bool readVertexPos(const std::string& line, std::vector<VertexPos>& loadTo);
-            bool readTexCoord(const std::string& line, std::vector<TexCoord>& loadTo);
-            bool readVertexNorm(const std::string& line, std::vector<VertexNorm>& loadTo);
-            bool readFace(const std::string& line, Group& loadTo);
+            bool readVertexPos(std::string_view line, std::vector<VertexPos>& loadTo) const;
+            bool readTexCoord(std::string_view line, std::vector<TexCoord>& loadTo) const;
+            bool readVertexNorm(std::string_view line, std::vector<VertexNorm>& loadTo) const;
+            bool readFace(std::string_view line, ParsedRange& loadTo) const;
 
         };
 
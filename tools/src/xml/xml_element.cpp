@@ -3,6 +3,10 @@
 #include <algorithm>
 #include "sstream"
 
+// elements with fewer children are searched without an index (unless an attribute was indexed)
+#ifndef XML_INDEX_MIN_CHILDREN
+#define XML_INDEX_MIN_CHILDREN 32
+#endif
 
 namespace undicht {
 
@@ -18,10 +22,87 @@ namespace undicht {
 		}
 
 
+		XmlElement::XmlElement(const XmlElement& other) :
+			m_tag_name(other.m_tag_name),
+			m_tag_attributes(other.m_tag_attributes),
+			m_content(other.m_content),
+			m_child_elements(other.m_child_elements),
+			m_parent_element(other.m_parent_element),
+			m_changes(other.m_changes) {
+
+			adoptChildElements();
+			copyChildIndex(other);
+		}
+
+		XmlElement::XmlElement(XmlElement&& other) noexcept :
+			m_tag_name(std::move(other.m_tag_name)),
+			m_tag_attributes(std::move(other.m_tag_attributes)),
+			m_content(std::move(other.m_content)),
+			m_child_elements(std::move(other.m_child_elements)),
+			m_parent_element(other.m_parent_element),
+			m_child_index(std::move(other.m_child_index)),
+			m_changes(other.m_changes) {
+
+			adoptChildElements();
+		}
+
+		XmlElement& XmlElement::operator=(const XmlElement& other) {
+
+			if (this == &other)
+				return *this;
+
+			m_tag_name = other.m_tag_name;
+			m_tag_attributes = other.m_tag_attributes;
+			m_content = other.m_content;
+			m_child_elements = other.m_child_elements;
+			m_parent_element = other.m_parent_element;
+			m_changes = other.m_changes;
+
+			adoptChildElements();
+			copyChildIndex(other);
+
+			return *this;
+		}
+
+		XmlElement& XmlElement::operator=(XmlElement&& other) noexcept {
+
+			m_tag_name = std::move(other.m_tag_name);
+			m_tag_attributes = std::move(other.m_tag_attributes);
+			m_content = std::move(other.m_content);
+			m_child_elements = std::move(other.m_child_elements);
+			m_parent_element = other.m_parent_element;
+			m_child_index = std::move(other.m_child_index);
+			m_changes = other.m_changes;
+
+			adoptChildElements();
+
+			return *this;
+		}
+
 		XmlElement::~XmlElement() {
 			//dtor
 		}
 
+		void XmlElement::adoptChildElements() {
+			// the parent pointers of the child elements have to point to the new location of the element
+
+			for (XmlElement& child : m_child_elements)
+				child.m_parent_element = this;
+		}
+
+		void XmlElement::copyChildIndex(const XmlElement& other) {
+			// copies the attributes selected by indexAttribute(), the indexes get rebuilt when they are needed
+
+			m_child_index.reset();
+
+			if (!other.m_child_index)
+				return;
+
+			m_child_index.reset(new ChildIndex);
+			for (const AttributeIndex& index : other.m_child_index->m_attributes)
+				indexAttribute(index.m_attrib_name);
+		}
+
 
 		///////////////////////////////////////// functions to access the data stored in the element //////////////////////////
 
@@ -48,6 +129,32 @@ namespace undicht {
 			return (attributes_found == tag_attributes.size());
 		}
 
+		bool XmlElement::hasAttributes(const XmlQuery::Step& step) const {
+			/** @return whether the element has all the attributes of the query step (might have more) */
+
+			for (const XmlQuery::Condition& condition : step.m_conditions) {
+
+				if (!condition.m_is_valid)
+					return false;
+
+				bool found = false;
+
+				for (const XmlTagAttrib& elem_attr : m_tag_attributes) {
+
+					if (!elem_attr.m_name.compare(condition.m_name) && (bool(elem_attr.m_value.compare(condition.m_value)) == condition.m_negate)) {
+						found = true;
+						break;
+					}
+
+				}
+
+				if (!found)
+					return false;
+			}
+
+			return true;
+		}
+
 		bool XmlElement::hasChildElements(const std::vector<std::string>& elem_names) const {
 
 			int elements_found = 0; // has to equal the length of elem_names at the end
@@ -101,23 +208,40 @@ namespace undicht {
 			* @param attrib_num: needed so that the function can be used recursivly (what attribute string to use)
 			* @return 0 if the element could not be found */
 
-			// splitting the attributes
-			std::string elem_name;
-			std::vector<std::string> attributes = splitAttributeString(attribute_strings.at(attrib_num), elem_name);
+			return getElement(XmlQuery(attribute_strings), attrib_num);
+		}
+
+		std::vector<XmlElement*> XmlElement::getAllElements(const std::vector<std::string>& attribute_strings, int attrib_num) const {
+			/** @return all xml elements that have all the requested tag attributes */
+
+			return getAllElements(XmlQuery(attribute_strings), attrib_num);
+		}
+
+		XmlElement* XmlElement::getElement(const XmlQuery& query, size_t step) const {
+			/** the same as the function above, but the attribute strings dont need to be split again for every search
+			* @param step the step of the query which is used to search the children of this element */
+
+			const XmlQuery::Step& current_step = query.getSteps().at(step);
+
+			// the children that could match the step (all of them if there is no index)
+			const std::vector<uint32_t>* candidates = findCandidates(current_step);
+			size_t candidate_count = candidates ? candidates->size() : m_child_elements.size();
 
 			// searching for a child element
-			for (const XmlElement& elem : m_child_elements) {
+			for (size_t i = 0; i < candidate_count; i++) {
 
-				if (elem.hasAttributes(attributes) && (!elem.getName().compare(elem_name))) {
+				const XmlElement& elem = m_child_elements.at(candidates ? candidates->at(i) : i);
+
+				if (!elem.getName().compare(current_step.m_tag_name) && elem.hasAttributes(current_step)) {
 					// found the element matching the current attributes
 
-					if (attrib_num + 1 >= attribute_strings.size()) {
+					if (step + 1 >= query.getSteps().size()) {
 						// last element of the search queue
 						return (XmlElement*)&elem;
 					}
 					else {
 						// the search continues
-						return elem.getElement(attribute_strings, attrib_num + 1);
+						return elem.getElement(query, step + 1);
 					}
 
 				}
@@ -127,29 +251,34 @@ namespace undicht {
 			return 0;
 		}
 
-		std::vector<XmlElement*> XmlElement::getAllElements(const std::vector<std::string>& attribute_strings, int attrib_num) const {
-			/** @return all xml elements that have all the requested tag attributes */
+		std::vector<XmlElement*> XmlElement::getAllElements(const XmlQuery& query, size_t step) const {
+			/** the same as the function above, but the attribute strings dont need to be split again for every search
+			* @param step the step of the query which is used to search the children of this element */
 
-			// splitting the attributes
-			std::string elem_name;
-			std::vector<std::string> attributes = splitAttributeString(attribute_strings.at(attrib_num), elem_name);
+			const XmlQuery::Step& current_step = query.getSteps().at(step);
+
+			// the children that could match the step (all of them if there is no index)
+			const std::vector<uint32_t>* candidates = findCandidates(current_step);
+			size_t candidate_count = candidates ? candidates->size() : m_child_elements.size();
 
 			std::vector<XmlElement*> elements;
 
 			// searching for child elements
-			for (const XmlElement& elem : m_child_elements) {
+			for (size_t i = 0; i < candidate_count; i++) {
+
+				const XmlElement& elem = m_child_elements.at(candidates ? candidates->at(i) : i);
 
-				if (elem.hasAttributes(attributes) && (!elem.getName().compare(elem_name))) {
+				if (!elem.getName().compare(current_step.m_tag_name) && elem.hasAttributes(current_step)) {
 					// found an element matching the current attributes
 
-					if (attrib_num + 1 >= attribute_strings.size()) {
+					if (step + 1 >= query.getSteps().size()) {
 						// at end of search queue
 						elements.push_back((XmlElement*)&elem);
 					}
 					else {
 						// the search continues
 
-						std::vector<XmlElement*> new_elements = elem.getAllElements(attribute_strings, attrib_num + 1);
+						std::vector<XmlElement*> new_elements = elem.getAllElements(query, step + 1);
 						elements.insert(elements.end(), new_elements.begin(), new_elements.end());
 					}
 
@@ -160,6 +289,23 @@ namespace undicht {
 			return elements;
 		}
 
+		void XmlElement::indexAttribute(const std::string& attrib_name) {
+			/** @brief child elements can be found by the value of the attribute without comparing all of them
+			* (for elements with many children that are searched by an id, i.e. "CHUNK chunk_pos=0_0_0")
+			* the index gets built by the first search that uses the attribute and is kept up to date when children are added
+			* note: since searching might build the index, elements should not be searched from multiple threads at the same time */
+
+			if (!m_child_index)
+				m_child_index.reset(new ChildIndex);
+
+			for (const AttributeIndex& index : m_child_index->m_attributes)
+				if (!index.m_attrib_name.compare(attrib_name))
+					return; // already indexed
+
+			m_child_index->m_attributes.emplace_back();
+			m_child_index->m_attributes.back().m_attrib_name = attrib_name;
+		}
+
 		std::vector<std::string> XmlElement::splitAttributeString(std::string attribute_string, std::string& loadTo_name) const {
 			/// the attribute string should look like this "name attr0=val0 attr1=val1 ..."
 
@@ -197,41 +343,87 @@ namespace undicht {
 		std::string XmlElement::getXmlStringRecursive(int indent) const {
 			// stores the entire element in a string as it would appear in a xml file (including its child elements)
 
-			std::stringstream s;
-			
-			// this elements indentation
-			std::string ind(std::max(indent, 0), ' ');
+			std::string s;
+			appendXmlString(s, indent);
+
+			return s;
+		}
+
+		void XmlElement::appendXmlString(std::string& buffer, int indent) const {
+			// appends the entire element to the buffer as it would appear in a xml file (including its child elements)
 
-			// adding the element start
-			s << ind << "<" << m_tag_name;
+			// adding the element start (with the indentation)
+			buffer.append(std::max(indent, 0), ' ');
+			buffer += '<';
+			buffer += m_tag_name;
 
 			// adding the attributes
-			for(const XmlTagAttrib& attr : m_tag_attributes) 
-				s << " " << attr.m_name << "=" << attr.m_value;
-			
-			s << ">";
+			for(const XmlTagAttrib& attr : m_tag_attributes) {
+				buffer += ' ';
+				buffer += attr.m_name;
+				buffer += '=';
+				buffer += attr.m_value;
+			}
+
+			// processing instructions (<?xml ...?>)
+			if(m_tag_name.size() && (m_tag_name.at(0) == '?'))
+				buffer += '?';
+
+			buffer += '>';
 
 			// adding the elements content (Exclusive) OR the child elements
 			// i think it is possible for elements to have only one of the two (????)
 			if(m_child_elements.size()) {
-				
-				s << "\n";
 
-				for(const XmlElement& e : m_child_elements)
-					s << e.getXmlStringRecursive(indent + 2) << "\n";
+				buffer += '\n';
+
+				for(const XmlElement& e : m_child_elements) {
+					e.appendXmlString(buffer, indent + 2);
+					buffer += '\n';
+				}
 
 				// adding the end element
-				if(indent >= 0) // if its not the root element (<?xml>)
-					s << ind << "</" << m_tag_name << ">";
+				if((indent >= 0) || m_tag_name.empty() || (m_tag_name.at(0) != '?')) { // if its not the root element <?xml>, which has no end tag
+					buffer.append(std::max(indent, 0), ' ');
+					buffer += "</";
+					buffer += m_tag_name;
+					buffer += '>';
+				}
 
 			} else {
-				
-				s << m_content << "</" << m_tag_name << ">";
+
+				appendContent(buffer);
+				buffer += "</";
+				buffer += m_tag_name;
+				buffer += '>';
+			}
+
+		}
+
+		void XmlElement::appendContent(std::string& buffer) const {
+			// appends the content, content that would be read as markup is stored in CDATA sections
+			// (the parser doesnt decode character references, so escaping it with &lt; ... would change the content)
+
+			if ((m_content.find_first_of("<&") == std::string::npos) && (m_content.find("]]>") == std::string::npos)) {
+				buffer += m_content;
+				return;
 			}
 
+			buffer += "<![CDATA[";
 
+			// a CDATA section ends at the first "]]>", so the content gets split into two sections there
+			size_t section_start = 0;
+			size_t section_end = m_content.find("]]>");
 
-			return s.str();
+			while (section_end != std::string::npos) {
+				buffer.append(m_content, section_start, section_end + 2 - section_start);
+				buffer += "]]><![CDATA[";
+				section_start = section_end + 2;
+				section_end = m_content.find("]]>", section_start);
+			}
+
+			buffer.append(m_content, section_start, std::string::npos);
+			buffer += "]]>";
 		}
 
 		////////////////////////////////////////// functions to print the content of the element ////////////////////////////////////////
@@ -280,10 +472,13 @@ namespace undicht {
 		XmlElement* XmlElement::addChildElement(const std::string& name, const std::vector<std::string>& attribs) {
 
 			m_child_elements.emplace_back(XmlElement(this));
-			m_child_elements.back().setName(name);
+			m_child_elements.back().m_tag_name = name;
 
 			for(const std::string& s : attribs)
-				m_child_elements.back().addTagAttrib(s);
+				m_child_elements.back().m_tag_attributes.emplace_back(XmlTagAttrib(s));
+
+			indexChildElement(m_child_elements.size() - 1);
+			m_child_elements.back().markChanged(NEW_ELEMENT);
 
 			return &m_child_elements.back();
 		}
@@ -301,17 +496,26 @@ namespace undicht {
 		void XmlElement::setName(const std::string& name) {
 
 			m_tag_name = name;
+
+			if (m_parent_element)
+				m_parent_element->invalidateChildIndex();
+
+			markChanged(TAG_CHANGED);
 		}
 
 		void XmlElement::setContent(const std::string& content) {
 
 			m_content = content;
+			markChanged(CONTENT_CHANGED);
 		}
 
 		XmlTagAttrib* XmlElement::addTagAttrib(const std::string& data) {
 			
 			m_tag_attributes.emplace_back(XmlTagAttrib(data));
 
+			indexTagAttrib(m_tag_attributes.back());
+			markChanged(TAG_CHANGED);
+
 			return &m_tag_attributes.back();
 		}
 
@@ -349,6 +553,162 @@ namespace undicht {
 
 			// content
 			m_content = line.substr(tag_end + 1, line.find('<', tag_end + 1) - tag_end - 1);
+
+			if (m_parent_element)
+				m_parent_element->invalidateChildIndex();
+
+			markChanged(TAG_CHANGED);
+		}
+
+		////////////////////////////////////////////// indexes of the child elements //////////////////////////////////////////////
+
+		const std::vector<uint32_t>* XmlElement::findCandidates(const XmlQuery::Step& step) const {
+			// @return the positions of the child elements that might match the step, nullptr if all of them have to be checked
+
+			static const std::vector<uint32_t> no_candidates;
+
+			if (!m_child_index && (m_child_elements.size() < XML_INDEX_MIN_CHILDREN))
+				return nullptr;
+
+			if (!m_child_index)
+				m_child_index.reset(new ChildIndex);
+
+			// looking for an indexed attribute
+			for (const XmlQuery::Condition& condition : step.m_conditions) {
+
+				if (!condition.m_is_valid || condition.m_negate)
+					continue;
+
+				for (AttributeIndex& index : m_child_index->m_attributes) {
+
+					if (index.m_attrib_name.compare(condition.m_name))
+						continue;
+
+					if (!index.m_is_built)
+						buildAttributeIndex(index);
+
+					std::unordered_map<std::string, std::vector<uint32_t>>::const_iterator children = index.m_values.find(condition.m_value);
+					return (children != index.m_values.end()) ? &children->second : &no_candidates;
+				}
+
+			}
+
+			// using the tag name
+			if (m_child_elements.size() < XML_INDEX_MIN_CHILDREN)
+				return nullptr;
+
+			if (!m_child_index->m_has_name_index)
+				buildNameIndex();
+
+			std::unordered_map<std::string, std::vector<uint32_t>>::const_iterator children = m_child_index->m_names.find(step.m_tag_name);
+			return (children != m_child_index->m_names.end()) ? &children->second : &no_candidates;
+		}
+
+		void XmlElement::buildNameIndex() const {
+
+			m_child_index->m_names.clear();
+
+			for (uint32_t i = 0; i < m_child_elements.size(); i++)
+				m_child_index->m_names[m_child_elements.at(i).m_tag_name].push_back(i);
+
+			m_child_index->m_has_name_index = true;
+		}
+
+		void XmlElement::buildAttributeIndex(AttributeIndex& index) const {
+
+			index.m_values.clear();
+
+			for (uint32_t i = 0; i < m_child_elements.size(); i++) {
+
+				XmlTagAttrib* attrib = m_child_elements.at(i).getAttribute(index.m_attrib_name);
+				if (attrib)
+					index.m_values[attrib->m_value].push_back(i);
+			}
+
+			index.m_is_built = true;
+		}
+
+		void XmlElement::indexChildElement(uint32_t position) {
+			// adds the child element at the position to the indexes that are already built
+
+			if (!m_child_index)
+				return;
+
+			const XmlElement& child = m_child_elements.at(position);
+
+			if (m_child_index->m_has_name_index)
+				m_child_index->m_names[child.m_tag_name].push_back(position);
+
+			for (AttributeIndex& index : m_child_index->m_attributes) {
+
+				if (!index.m_is_built)
+					continue;
+
+				XmlTagAttrib* attrib = child.getAttribute(index.m_attrib_name);
+				if (attrib)
+					index.m_values[attrib->m_value].push_back(position);
+			}
+
+		}
+
+		void XmlElement::indexTagAttrib(const XmlTagAttrib& attrib) {
+			// adds the attribute of the element to the indexes of its parent
+
+			if (!m_parent_element || !m_parent_element->m_child_index)
+				return;
+
+			uint32_t position = this - m_parent_element->m_child_elements.data();
+
+			for (AttributeIndex& index : m_parent_element->m_child_index->m_attributes) {
+
+				if (!index.m_is_built || index.m_attrib_name.compare(attrib.m_name))
+					continue;
+
+				// keeping the positions sorted, so that the first matching child is found first
+				std::vector<uint32_t>& positions = index.m_values[attrib.m_value];
+				positions.insert(std::lower_bound(positions.begin(), positions.end(), position), position);
+			}
+
+		}
+
+		void XmlElement::invalidateChildIndex() {
+			// the indexes get rebuilt when they are needed next
+
+			if (!m_child_index)
+				return;
+
+			m_child_index->m_has_name_index = false;
+			m_child_index->m_names.clear();
+
+			for (AttributeIndex& index : m_child_index->m_attributes) {
+				index.m_is_built = false;
+				index.m_values.clear();
+			}
+
+		}
+
+		////////////////////////////////////////// changes since the file was last written //////////////////////////////////////////
+
+		void XmlElement::markChanged(uint8_t change) {
+			// marks the element (and its parents) as changed
+
+			m_changes |= change;
+
+			// the parents only need to be marked once
+			for (XmlElement* parent = m_parent_element; parent && !(parent->m_changes & CHILDREN_CHANGED); parent = parent->m_parent_element)
+				parent->m_changes |= CHILDREN_CHANGED;
+
+		}
+
+		void XmlElement::clearChanges() {
+			// resets the changes of the element and its changed children
+
+			if (m_changes & CHILDREN_CHANGED)
+				for (XmlElement& child : m_child_elements)
+					if (child.m_changes)
+						child.clearChanges();
+
+			m_changes = 0;
 		}
 
 	} // tools
@@ -3,7 +3,10 @@
 
 #include <string>
 #include <vector>
+#include <memory>
+#include <unordered_map>
 #include "xml_tag_attribute.h"
+#include "xml_query.h"
 
 
 
@@ -27,6 +30,32 @@ namespace undicht {
 			// the parent element
 			XmlElement* m_parent_element = 0;
 
+			// indexes of the child elements (their positions in m_child_elements), so that searching them doesnt need to compare every child
+			struct AttributeIndex {
+				std::string m_attrib_name;
+				bool m_is_built = false;
+				std::unordered_map<std::string, std::vector<uint32_t>> m_values;
+			};
+
+			struct ChildIndex {
+				bool m_has_name_index = false;
+				std::unordered_map<std::string, std::vector<uint32_t>> m_names;
+				std::vector<AttributeIndex> m_attributes; // see indexAttribute()
+			};
+
+			// gets created once an element with enough children gets searched (or an attribute gets indexed)
+			mutable std::unique_ptr<ChildIndex> m_child_index;
+
+			// changes since the file was last written (so that XmlFile::writeChanges() only needs to visit the changed subtrees)
+			enum Change : uint8_t {
+				CONTENT_CHANGED = 1,
+				NEW_ELEMENT = 2,
+				CHILDREN_CHANGED = 4, // some element below this one changed
+				TAG_CHANGED = 8 // the name or attributes changed
+			};
+
+			uint8_t m_changes = 0;
+
 		private:
 		
 			// only the class XmlFile can create a root xml element (child elements can be created via addChildElement())
@@ -35,8 +64,39 @@ namespace undicht {
 			XmlElement();
 			XmlElement(XmlElement* parent);
 
+			// the parent pointers of the child elements have to point to the new location of the element
+			void adoptChildElements();
+
+			// copies the attributes selected by indexAttribute(), the indexes get rebuilt when they are needed
+			void copyChildIndex(const XmlElement& other);
+
+			// @return the positions of the child elements that might match the step, nullptr if all of them have to be checked
+			const std::vector<uint32_t>* findCandidates(const XmlQuery::Step& step) const;
+
+			void buildNameIndex() const;
+			void buildAttributeIndex(AttributeIndex& index) const;
+
+			// adds the child element at the position to the indexes that are already built
+			void indexChildElement(uint32_t position);
+
+			// adds the attribute of the element to the indexes of its parent
+			void indexTagAttrib(const XmlTagAttrib& attrib);
+
+			// the indexes get rebuilt when they are needed next
+			void invalidateChildIndex();
+
+			// marks the element (and its parents) as changed
+			void markChanged(uint8_t change);
+
+			// resets the changes of the element and its changed children
+			void clearChanges();
+
 		public:
 
+			XmlElement(const XmlElement& other);
+			XmlElement(XmlElement&& other) noexcept; // so that vectors of child elements dont copy when they grow
+			XmlElement& operator=(const XmlElement& other);
+			XmlElement& operator=(XmlElement&& other) noexcept;
 			virtual ~XmlElement();
 
 		public:
@@ -46,6 +106,9 @@ namespace undicht {
 			* @example tag attributes can be negated using a "!=" */
 			bool hasAttributes(const std::vector<std::string>& tag_attributes) const;
 
+			/** @return whether the element has all the attributes of the query step (might have more) */
+			bool hasAttributes(const XmlQuery::Step& step) const;
+
 			/** @return whether the element has child elements with all the names */
 			bool hasChildElements(const std::vector<std::string>& elem_names) const;
 
@@ -65,12 +128,31 @@ namespace undicht {
 			/** @return all xml elements that have all the requested tag attributes */
 			std::vector<XmlElement*> getAllElements(const std::vector<std::string>& attribute_strings, int attrib_num = 0) const;
 
+			/** the same as the functions above, but the attribute strings dont need to be split again for every search
+			* @param step the step of the query which is used to search the children of this element */
+			XmlElement* getElement(const XmlQuery& query, size_t step = 0) const;
+			std::vector<XmlElement*> getAllElements(const XmlQuery& query, size_t step = 0) const;
+
+			/** @brief child elements can be found by the value of the attribute without comparing all of them
+			* (for elements with many children that are searched by an id, i.e. "CHUNK chunk_pos=0_0_0")
+			* the index gets built by the first search that uses the attribute and is kept up to date when children are added
+			* note: since searching might build the index, elements should not be searched from multiple threads at the same time */
+			void indexAttribute(const std::string& attrib_name);
+
 			/// the attribute string should look like this "name attr0=val0 attr1=val1 ..."
 			std::vector<std::string> splitAttributeString(std::string attribute_string, std::string& loadTo_name) const;
 
 			// stores the entire element in a string as it would appear in a xml file (including its child elements)
 			std::string getXmlStringRecursive(int indent = 0) const;
 
+			// appends the entire element to the buffer as it would appear in a xml file (including its child elements)
+			void appendXmlString(std::string& buffer, int indent = 0) const;
+
+		protected:
+
+			// appends the content, content that would be read as markup is stored in CDATA sections
+			void appendContent(std::string& buffer) const;
+
 		public:
 			// functions to print the content of the element
 
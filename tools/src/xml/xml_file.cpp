@@ -1,11 +1,18 @@
 #include "xml_file.h"
 #include "fstream"
+#include "iterator"
+#include "algorithm"
+#include "cstdio"
+#include "cstdlib"
 #include "debug.h"
 
-const int XML_START_TAG = 1;
-const int XML_END_TAG = 2;
-const int XML_ONE_LINE_ELEMENT = 3;
+// the journal gets folded into the file once it is bigger than the file and this size
+#ifndef XML_JOURNAL_MIN_FOLD_SIZE
+#define XML_JOURNAL_MIN_FOLD_SIZE (64 * 1024)
+#endif
 
+// first line of the journal file, followed by the checksum of the file the journal belongs to
+#define XML_JOURNAL_MAGIC "UNDXMLJ1"
 
 namespace undicht {
 
@@ -26,146 +33,330 @@ namespace undicht {
 		}
 
 		bool XmlFile::open(const std::string& file_name) {
+			// loads the root element and all its sub elements
+			// (changes stored in the journal of the file get applied, see writeChanges())
 
+			m_file_name = file_name;
+			m_file_checksum = 0;
+			m_file_size = 0;
+			m_journal_size = 0;
 
-            std::ifstream file(file_name);
-            m_file_name = file_name;
-
-			if (!file.is_open()) {
+			XmlPullParser parser;
+			if (!parser.open(file_name)) {
                 UND_ERROR << "failed to open file: " << file_name << "\n";
 				return false;
 			}
 
-			// loading all xml elements
+			// removing the old elements
+			m_tag_name.clear();
+			m_tag_attributes.clear();
+			m_content.clear();
 			m_child_elements.clear();
+			invalidateChildIndex();
 
-			// the line in which the xml information is stored
-			std::string xml_info;
-            std::getline(file, xml_info);
+			if (!readElements(parser, nullptr)) {
+				UND_ERROR << "failed to read xml file: " << file_name << " (line " << parser.getLine() << ")\n";
+				return false;
+			}
 
-			setData(xml_info);
-			m_last_element = this;
+			m_file_checksum = calcChecksum(parser.getData().data(), parser.getData().size());
+			m_file_size = parser.getData().size();
 
+			// applying the changes that were not written to the file yet
+			bool journal_complete = readJournal();
 
-			while (!file.eof()) {
+			clearChanges();
 
-				if (!readNextLine(file)) {
+			// the file (and journal) need to be rewritten by the next writeChanges()
+			if (!journal_complete)
+				markChanged(TAG_CHANGED);
 
-					if (file.eof()) {
-						// a valid end to the reading
-						file.close();
-						return true;
-					}
-					// reached invalid line
-					file.close();
-					return false;
-				}
+			return true;
+		}
 
-			}
-			 
+		bool XmlFile::write(const std::string& file_name) {
+			// writes the contents stored in the root xml object into the file (which becomes the current file)
+			// @return false if the file could not be written (the file on the disk and the current file stay unchanged then)
+
+			m_write_buffer.clear();
+			appendXmlString(m_write_buffer, -2);
+
+			// replacing the old file only once the new one is complete
+			std::string temp_file_name = file_name + ".tmp";
+			std::ofstream file(temp_file_name, std::ios::binary | std::ios::trunc);
+			file.write(m_write_buffer.data(), m_write_buffer.size());
 			file.close();
-			return true; // it could have actually worked
-		}
 
-		void XmlFile::write(const std::string& file_name) {
-			// writes the contents stored in the root xml object into the file
+			if (file.fail() || std::rename(temp_file_name.c_str(), file_name.c_str())) {
+				UND_ERROR << "failed to write file: " << file_name << "\n";
+				std::remove(temp_file_name.c_str());
+				return false;
+			}
 
-			std::fstream file(file_name, std::fstream::trunc | std::fstream::out);
+			m_file_name = file_name;
+			m_file_checksum = calcChecksum(m_write_buffer.data(), m_write_buffer.size());
+			m_file_size = m_write_buffer.size();
 
-			std::string file_content = getXmlStringRecursive(-2);
+			// all changes are stored in the file now
+			std::remove(getJournalFileName().c_str());
+			m_journal_size = 0;
 
-			file.write(file_content.data(), file_content.size());
+			clearChanges();
 
-			file.close();
-		} 
+			return true;
+		}
 
-		/////////////////////////////////// reading line by line /////////////////////////////////////
+		void XmlFile::writeChanges() {
+			/** @brief stores the changes made since the last write in the journal of the current file (file name + ".journal"),
+			* so that small changes dont need to rewrite the whole file
+			* the journal gets applied by open() and folded into the file by the next write()
+			* (which happens here as well, if the journal gets bigger than the file or the changes cant be journaled,
+			* i.e. changed names or attributes of existing elements) */
 
+			if (!m_changes)
+				return;
 
-		bool XmlFile::readNextLine(std::ifstream& file) {
-			/// reads and processes the next line of the file
+			m_write_buffer.clear();
+			bool can_be_journaled = appendJournalRecords(*this, "-", m_write_buffer);
 
-			std::string line;
-            std::getline(file, line);
-			if (!removeIndentation(line)) return 0; // no tag in line (line invalid)
+			// folding the journal into the file
+			if (!can_be_journaled || (m_journal_size + m_write_buffer.size() > std::max(m_file_size, size_t(XML_JOURNAL_MIN_FOLD_SIZE)))) {
+				write(m_file_name);
+				return;
+			}
 
-			int line_tag_type = getLineTagType(line);
+			std::ofstream journal(getJournalFileName(), std::ios::binary | (m_journal_size ? std::ios::app : std::ios::trunc));
 
-			if (line_tag_type == XML_START_TAG) {
+			// a new journal starts with the checksum of the file it belongs to
+			if (!m_journal_size) {
+				char header[32];
+				int header_size = std::snprintf(header, sizeof(header), XML_JOURNAL_MAGIC " %016llx\n", (unsigned long long)m_file_checksum);
+				journal.write(header, header_size);
+				m_journal_size = header_size;
+			}
 
-				m_last_element = m_last_element->addChildElement();
-				m_last_element->setData(line);
+			journal.write(m_write_buffer.data(), m_write_buffer.size());
+			journal.close();
 
+			if (journal.fail()) {
+				UND_WARNING << "failed to write the journal of the file " << m_file_name << ", writing the whole file instead\n";
+				write(m_file_name);
+				return;
 			}
-			else if (line_tag_type == XML_END_TAG) {
 
-				m_last_element = m_last_element->getParentElement();
+			m_journal_size += m_write_buffer.size();
+			clearChanges();
+		}
+
+		///////////////////////////////////////// reading the file /////////////////////////////////////////
+
+		bool XmlFile::readElements(XmlPullParser& parser, XmlElement* element) {
+			/// @brief adds the elements read by the parser to the element
+			/// @param element the element that gets the elements as children,
+			/// if nullptr the first element read becomes the root element (this) and the following elements its children
+			/// @return false if the data is not valid xml
+
+			// the first element of the file (usually <?xml ...?>) is the root element,
+			// all following elements become its children, even if they come after its end tag
+			XmlElement* base_element = element ? element : this; // end tags dont go beyond this element
+
+			while (true) {
+
+				XmlPullParser::Event event = parser.next();
+
+				if (event == XmlPullParser::START_TAG) {
+
+					element = element ? element->addChildElement() : this;
+					loadElement(*element, parser);
 
-				if (!m_last_element) {
-					// the highest element should be the xml info element
-					// which has no end tag, so there is something wrong with the file
+				} else if (event == XmlPullParser::END_TAG) {
+
+					if (element != base_element)
+						element = element->getParentElement();
+
+				} else if (event == XmlPullParser::CONTENT) {
+
+					if (element)
+						element->m_content.append(parser.getContent());
+
+				} else if (event == XmlPullParser::END_OF_FILE) {
+
+					return true;
+
+				} else {
+					// invalid
 					return false;
 				}
 
 			}
-			else if (line_tag_type == XML_ONE_LINE_ELEMENT) {
 
-				m_last_element->addChildElement()->setData(line);
+		}
 
-			}
-			else if (line_tag_type == 0) {
-				// invalid
+		void XmlFile::loadElement(XmlElement& element, const XmlPullParser& parser) {
+			/// @brief stores the name and attributes of the parsers current start tag in the element
 
-				return false;
+			element.m_tag_name.assign(parser.getName());
+
+			element.m_tag_attributes.resize(parser.getAttributes().size());
+			for (size_t i = 0; i < parser.getAttributes().size(); i++) {
+				element.m_tag_attributes.at(i).m_name.assign(parser.getAttributes().at(i).m_name);
+				element.m_tag_attributes.at(i).m_value.assign(parser.getAttributes().at(i).m_value);
 			}
 
-			return true;
 		}
 
+		////////////////////////////////////////////////// journal //////////////////////////////////////////////////
 
-		int XmlFile::getLineTagType(const std::string& tag) {
-			/** @return the type of element tag stored in the line
-			* one of XML_START_TAG, XML_END_TAG, XML_ONE_LINE_ELEMENT
-			* @return 0 if invalid line */
+		// each change is stored as a record: "<type> <path> <byte size>\n<data>\n"
+		// C: the content of the element at the path was set to the data
+		// A: the data is a new child element of the element at the path (including its child elements)
 
+		std::string XmlFile::getJournalFileName() const {
 
-			if (tag.at(0) == '<') {
-				if (tag.back() == '>') {
-					// it seems to be a valid xml tag
-					if (tag.at(1) == '/') {
-						// end tag
+			return m_file_name + ".journal";
+		}
 
-						return XML_END_TAG;
+		bool XmlFile::readJournal() {
+			/// @brief applies the changes stored in the journal (if it belongs to the current file)
+			/// @return false if not all changes in the journal could be applied
 
-					}
-					else if ((tag.find("/>") != std::string::npos) || (tag.find("</") != std::string::npos)) {
-						// @if one line element (tag only) || one liner with content
+			m_journal_size = 0;
 
-						return XML_ONE_LINE_ELEMENT;
+			std::ifstream file(getJournalFileName(), std::ios::binary);
+			if (!file.is_open())
+				return true; // no journal
+
+			std::string journal((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			file.close();
+
+			// the journal has to belong to the current file
+			char header[32];
+			size_t header_size = std::snprintf(header, sizeof(header), XML_JOURNAL_MAGIC " %016llx\n", (unsigned long long)m_file_checksum);
+			if (journal.compare(0, header_size, header, header_size)) {
+				UND_WARNING << "the journal of the file " << m_file_name << " belongs to an older version of the file, ignoring it\n";
+				std::remove(getJournalFileName().c_str());
+				return true;
+			}
+
+			size_t position = header_size;
+			while (position < journal.size()) {
+
+				// reading the record header
+				size_t header_end = journal.find('\n', position);
+				if (header_end == std::string::npos)
+					break;
+
+				char type = journal.at(position);
+				size_t path_start = position + 2;
+				size_t path_end = journal.find(' ', path_start);
+				if ((path_end == std::string::npos) || (path_end > header_end))
+					break;
+
+				size_t data_start = header_end + 1;
+				size_t data_size = std::strtoull(journal.data() + path_end + 1, nullptr, 10);
+				if (data_start + data_size + 1 > journal.size())
+					break; // the record was not written completely
+
+				// finding the element (by the positions in the child elements of its parents)
+				XmlElement* element = this;
+				if (journal.at(path_start) != '-') {
+					const char* path = journal.data() + path_start;
+					while (element && (path < journal.data() + path_end)) {
+						char* next;
+						size_t child = std::strtoul(path, &next, 10);
+						element = (child < element->m_child_elements.size()) ? &element->m_child_elements.at(child) : nullptr;
+						path = next + 1; // skipping the '/'
 					}
+				}
 
-					return XML_START_TAG;
+				if (!element)
+					break;
+
+				// applying the change
+				if (type == 'C') {
+					element->m_content.assign(journal, data_start, data_size);
+				} else if (type == 'A') {
+					XmlPullParser parser;
+					parser.open(journal.data() + data_start, data_size);
+					if (!readElements(parser, element))
+						break;
+				} else {
+					break;
 				}
+
+				position = data_start + data_size + 1;
 			}
 
+			m_journal_size = position;
+
+			if (position < journal.size()) {
+				UND_WARNING << "the journal of the file " << m_file_name << " is damaged, the last changes are lost\n";
+				return false;
+			}
 
-			return 0; // invalid line
+			return true;
 		}
 
-		bool XmlFile::removeIndentation(std::string& str) {
-			/// removes all free space characters in front of the '<'
+		bool XmlFile::appendJournalRecords(const XmlElement& element, const std::string& path, std::string& buffer) const {
+			/// @brief adds records for the changes in the element and its changed children to the buffer
+			/// @param path the positions of the element and its parents in their parents children ("-" for the root element)
+			/// @return false if a change cant be stored in the journal (the file has to be rewritten)
 
-			int tag_start = str.find("<");
-			if (tag_start == std::string::npos) {
-				// no tag
+			if (element.m_changes & TAG_CHANGED)
 				return false;
+
+			if (element.m_changes & CONTENT_CHANGED) {
+				buffer += "C " + path + " " + std::to_string(element.m_content.size()) + "\n";
+				buffer += element.m_content;
+				buffer += '\n';
 			}
 
-			str = str.substr(tag_start);
+			if (!(element.m_changes & CHILDREN_CHANGED))
+				return true;
+
+			for (size_t i = 0; i < element.m_child_elements.size(); i++) {
+
+				const XmlElement& child = element.m_child_elements.at(i);
+
+				if (child.m_changes & NEW_ELEMENT) {
+
+					// the size of the element is only known once it is written
+					buffer += "A " + path + " ";
+					size_t size_position = buffer.size();
+					buffer += "0000000000\n";
+
+					size_t data_start = buffer.size();
+					child.appendXmlString(buffer, 0);
+
+					std::string data_size = std::to_string(buffer.size() - data_start);
+					buffer.replace(size_position + 10 - data_size.size(), data_size.size(), data_size);
+					buffer += '\n';
+
+				} else if (child.m_changes) {
+
+					std::string child_path = (path == "-") ? std::to_string(i) : (path + "/" + std::to_string(i));
+					if (!appendJournalRecords(child, child_path, buffer))
+						return false;
+				}
+
+			}
 
 			return true;
 		}
 
+		uint64_t XmlFile::calcChecksum(const char* data, size_t byte_size) {
+			// FNV-1a hash of the data
+
+			uint64_t hash = 0xcbf29ce484222325ull;
+
+			for (size_t i = 0; i < byte_size; i++) {
+				hash ^= uint8_t(data[i]);
+				hash *= 0x100000001b3ull;
+			}
+
+			return hash;
+		}
+
 	} // tools
 
 } // undicht
@@ -3,6 +3,7 @@
 
 
 #include "xml_element.h"
+#include "xml_pull_parser.h"
 #include "fstream"
 
 namespace undicht {
@@ -10,7 +11,7 @@ namespace undicht {
 	namespace tools {
 
 		class XmlFile : public XmlElement {
-			/** a class that can be used to read xml style files
+			/** a class that can be used to read xml style files (see XmlPullParser for the supported syntax)
 			* after being opened, the XmlFile object resembles the xml information element of the file
 			* the other elements are stored in m_child_elements */
         protected:
@@ -19,26 +20,56 @@ namespace undicht {
 
         private:
 
-			XmlElement* m_last_element = 0;
+			// the state of the file on the disk
+			uint64_t m_file_checksum = 0; // of the data in the file (the journal belongs to the file with this checksum)
+			size_t m_file_size = 0;
+			size_t m_journal_size = 0; // 0 if there is no journal
 
-			/**  reads and processes the next line of the file
-			*  @return whether the line was valid */
-			virtual bool readNextLine(std::ifstream& file);
+			// reused for writing the file / journal
+			std::string m_write_buffer;
 
-			/** @return the type of element tag stored in the line
-			* one of XML_START_TAG, XML_END_TAG, XML_ONE_LINE_ELEMENT
-			* @return 0 if invalid line */
-			int getLineTagType(const std::string& tag);
+		private:
 
-			/** removes all free space characters in front of the '<'
-			* @return false if the string does not contain a '<' */
-			bool removeIndentation(std::string& str);
+			/// @brief stores the name and attributes of the parsers current start tag in the element
+			void loadElement(XmlElement& element, const XmlPullParser& parser);
+
+			/// @brief adds the elements read by the parser to the element
+			/// @param element the element that gets the elements as children,
+			/// if nullptr the first element read becomes the root element (this) and the following elements its children
+			/// @return false if the data is not valid xml
+			bool readElements(XmlPullParser& parser, XmlElement* element);
+
+			// journal
+			std::string getJournalFileName() const;
+
+			/// @brief applies the changes stored in the journal (if it belongs to the current file)
+			/// @return false if not all changes in the journal could be applied
+			bool readJournal();
+
+			/// @brief adds records for the changes in the element and its changed children to the buffer
+			/// @param path the positions of the element and its parents in their parents children ("-" for the root element)
+			/// @return false if a change cant be stored in the journal (the file has to be rewritten)
+			bool appendJournalRecords(const XmlElement& element, const std::string& path, std::string& buffer) const;
+
+			// FNV-1a hash of the data
+			static uint64_t calcChecksum(const char* data, size_t byte_size);
 
 		public:
 
 			// loads the root element and all its sub elements
+			// (changes stored in the journal of the file get applied, see writeChanges())
 			virtual bool open(const std::string& file_name);
-			virtual void write(const std::string& file_name); // writes the contents stored in the root xml object into the file
+
+			// writes the contents stored in the root xml object into the file (which becomes the current file)
+			// @return false if the file could not be written (the file on the disk and the current file stay unchanged then)
+			virtual bool write(const std::string& file_name);
+
+			/** @brief stores the changes made since the last write in the journal of the current file (file name + ".journal"),
+			* so that small changes dont need to rewrite the whole file
+			* the journal gets applied by open() and folded into the file by the next write()
+			* (which happens here as well, if the journal gets bigger than the file or the changes cant be journaled,
+			* i.e. changed names or attributes of existing elements) */
+			virtual void writeChanges();
 
 			XmlFile();
 			XmlFile(const std::string& file_name);
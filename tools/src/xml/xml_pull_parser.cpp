@@ -0,0 +1,483 @@
+#include "xml_pull_parser.h"
+#include "config.h"
+#include "debug.h"
+#include "cstring"
+#include "fstream"
+#include "algorithm"
+#include "new"
+
+#ifdef PLATFORM_UNIX
+#include "fcntl.h"
+#include "unistd.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+#endif
+
+namespace undicht {
+
+	namespace tools {
+
+		XmlPullParser::XmlPullParser(const std::string& file_name) {
+
+			open(file_name);
+		}
+
+		XmlPullParser::~XmlPullParser() {
+
+			close();
+		}
+
+		bool XmlPullParser::open(const std::string& file_name) {
+			/// @brief maps the file into memory, parsing starts at the beginning of the file
+			/// @return false if the file could not be opened
+
+			close();
+
+#ifdef PLATFORM_UNIX
+
+			int file_descriptor = ::open(file_name.c_str(), O_RDONLY);
+			if (file_descriptor < 0)
+				return false;
+
+			struct stat file_stat;
+			if (fstat(file_descriptor, &file_stat)) {
+				::close(file_descriptor);
+				return false;
+			}
+
+			// an empty file cant be mapped
+			if (file_stat.st_size > 0) {
+
+				void* mapped_data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+				if (mapped_data == MAP_FAILED) {
+					::close(file_descriptor);
+					return false;
+				}
+
+				madvise(mapped_data, file_stat.st_size, MADV_SEQUENTIAL);
+				m_mapped_data = (char*)mapped_data;
+				m_mapped_size = file_stat.st_size;
+			}
+
+			// the mapping stays valid after closing the file
+			::close(file_descriptor);
+
+			open(m_mapped_data, m_mapped_size);
+
+#else
+
+			std::ifstream file(file_name, std::ios::binary | std::ios::ate);
+			if (!file.is_open())
+				return false;
+
+			m_file_data.resize(file.tellg());
+			file.seekg(0);
+			file.read(m_file_data.data(), m_file_data.size());
+
+			open(m_file_data.data(), m_file_data.size());
+
+#endif
+
+			return true;
+		}
+
+		void XmlPullParser::open(const char* data, size_t byte_size) {
+			/// @brief parse data that already is in memory (it doesnt get copied, so it has to stay alive while parsing)
+
+			m_data = data;
+			m_size = byte_size;
+			m_position = 0;
+
+			m_event = END_OF_FILE;
+			m_name = std::string_view();
+			m_content = std::string_view();
+			m_attributes.clear();
+			m_is_empty_element = false;
+			m_open_elements.clear();
+		}
+
+		void XmlPullParser::close() {
+
+#ifdef PLATFORM_UNIX
+			if (m_mapped_data)
+				munmap(m_mapped_data, m_mapped_size);
+#endif
+
+			m_mapped_data = nullptr;
+			m_mapped_size = 0;
+			m_file_data.clear();
+
+			open(nullptr, 0);
+		}
+
+		std::string_view XmlPullParser::getData() const {
+			/// @return all the data that gets parsed (i.e. the content of the opened file)
+
+			return std::string_view(m_data, m_size);
+		}
+
+		XmlPullParser::Event XmlPullParser::next() {
+			/// @brief reads the next tag / text
+
+			// the end of an empty element
+			if (m_is_empty_element) {
+				m_is_empty_element = false;
+				m_attributes.clear();
+				m_open_elements.pop_back();
+				return m_event = END_TAG;
+			}
+
+			m_attributes.clear();
+
+			while (m_position < m_size) {
+
+				if (m_data[m_position] != '<') {
+					// text between tags
+
+					size_t text_end = find("<", m_position);
+					m_content = std::string_view(m_data + m_position, text_end - m_position);
+					m_position = text_end;
+
+					if (std::find_if_not(m_content.begin(), m_content.end(), isWhitespace) != m_content.end())
+						return m_event = CONTENT;
+
+					continue; // only whitespace
+				}
+
+				if (startsWith("<!--", m_position)) {
+					// comment
+					m_position = find("-->", m_position + 4) + 3;
+					if (m_position > m_size)
+						return m_event = INVALID;
+
+					continue;
+				}
+
+				if (startsWith("<![CDATA[", m_position)) {
+
+					size_t data_end = find("]]>", m_position + 9);
+					if (data_end == m_size)
+						return m_event = INVALID;
+
+					m_content = std::string_view(m_data + m_position + 9, data_end - m_position - 9);
+					m_position = data_end + 3;
+
+					return m_event = CONTENT;
+				}
+
+				if (startsWith("<!", m_position)) {
+					// doctype declaration (might contain declarations in [] that end with a '>' as well)
+					size_t declaration_end = find(">", m_position);
+					size_t subset_start = find("[", m_position);
+					if (subset_start < declaration_end)
+						declaration_end = find(">", find("]", subset_start));
+
+					if (declaration_end == m_size)
+						return m_event = INVALID;
+
+					m_position = declaration_end + 1;
+					continue;
+				}
+
+				if (startsWith("</", m_position)) {
+					m_position += 2;
+					return m_event = readEndTag();
+				}
+
+				m_position += 1;
+				return m_event = readStartTag();
+			}
+
+			// files written by older versions dont have the end tag of the root element
+			if (m_open_elements.size() == 1) {
+				UND_WARNING << "xml: the root element " << m_open_elements.back() << " is not closed, treating it as closed at the end of the data\n";
+				m_open_elements.pop_back();
+			}
+
+			// elements that are still open at the end of the data (i.e. a truncated file)
+			if (!m_open_elements.empty())
+				return m_event = INVALID;
+
+			return m_event = END_OF_FILE;
+		}
+
+		XmlPullParser::Event XmlPullParser::getEvent() const {
+
+			return m_event;
+		}
+
+		std::string_view XmlPullParser::getName() const {
+			/// @return the name of the current START_TAG / END_TAG
+
+			return m_name;
+		}
+
+		std::string_view XmlPullParser::getContent() const {
+			/// @return the text of the current CONTENT event (with the whitespace around it)
+
+			return m_content;
+		}
+
+		const std::vector<XmlPullParser::Attribute>& XmlPullParser::getAttributes() const {
+			/// @return the attributes of the current START_TAG
+
+			return m_attributes;
+		}
+
+		std::string_view XmlPullParser::getAttribute(std::string_view name) const {
+			/// @return the value of the attribute of the current START_TAG, an empty view if there is no such attribute
+
+			for (const Attribute& attribute : m_attributes)
+				if (attribute.m_name == name)
+					return attribute.m_value;
+
+			return std::string_view();
+		}
+
+		bool XmlPullParser::isEmptyElement() const {
+			/// @return whether the current START_TAG belongs to an element without end tag (<name/>)
+
+			return (m_event == START_TAG) && m_is_empty_element;
+		}
+
+		size_t XmlPullParser::getDepth() const {
+			/// @return the number of elements that are currently open (without the current START_TAG)
+
+			if (m_event == START_TAG)
+				return m_open_elements.size() - 1;
+
+			return m_open_elements.size();
+		}
+
+		size_t XmlPullParser::getLine() const {
+			/// @return the line in which the parser currently is (counting from 1, to report errors)
+
+			return std::count(m_data, m_data + std::min(m_position, m_size), '\n') + 1;
+		}
+
+		/////////////////////////////////////// building a tree from the parsed data ///////////////////////////////////////
+
+		const XmlPullParser::Node* XmlPullParser::Node::getChild(std::string_view name, const Node* previous) const {
+			/// @return the first child with the name that comes after the child passed as previous (nullptr to search from the start)
+
+			const Node* child = previous ? previous->m_next_sibling : m_first_child;
+
+			while (child && (child->m_name != name))
+				child = child->m_next_sibling;
+
+			return child;
+		}
+
+		std::string_view XmlPullParser::Node::getAttribute(std::string_view name) const {
+			/// @return the value of the attribute, an empty view if there is no such attribute
+
+			for (size_t i = 0; i < m_attribute_count; i++)
+				if (m_attributes[i].m_name == name)
+					return m_attributes[i].m_value;
+
+			return std::string_view();
+		}
+
+		const XmlPullParser::Node* XmlPullParser::readTree(LinearArena& arena) {
+			/// @brief parses the rest of the data and stores it as a tree, all nodes and attributes are allocated from the arena
+			/// the tree stays valid until the arena is reset or the parser is closed
+			/// @return a node without name that contains the top level elements (processing instructions included),
+			/// nullptr if the data is not valid xml
+
+			Node* root = new(arena.allocate<Node>(1)) Node();
+			Node* current = root; // the node that gets new children
+
+			Event event;
+			while ((event = next()) != END_OF_FILE) {
+
+				if (event == START_TAG) {
+
+					Node* node = new(arena.allocate<Node>(1)) Node();
+					node->m_name = m_name;
+					node->m_parent = current;
+
+					if (m_attributes.size()) {
+						Attribute* attributes = arena.allocate<Attribute>(m_attributes.size());
+						std::uninitialized_copy(m_attributes.begin(), m_attributes.end(), attributes);
+						node->m_attributes = attributes;
+						node->m_attribute_count = m_attributes.size();
+					}
+
+					if (current->m_last_child)
+						current->m_last_child->m_next_sibling = node;
+					else
+						current->m_first_child = node;
+
+					current->m_last_child = node;
+					current = node;
+
+				} else if (event == END_TAG) {
+
+					current = current->m_parent;
+
+				} else if (event == CONTENT) {
+
+					if (current->m_content.empty())
+						current->m_content = m_content;
+
+				} else {
+					// invalid
+					return nullptr;
+				}
+
+			}
+
+			return root;
+		}
+
+		//////////////////////////////////////////// protected XmlPullParser functions ////////////////////////////////////////////
+
+		XmlPullParser::Event XmlPullParser::readStartTag() {
+			// reads the start tag after the '<'
+
+			// tag name (processing instructions start with a '?')
+			size_t name_start = m_position;
+			if ((m_position < m_size) && (m_data[m_position] == '?'))
+				m_position++;
+
+			while ((m_position < m_size) && !isNameEnd(m_data[m_position]))
+				m_position++;
+
+			m_name = std::string_view(m_data + name_start, m_position - name_start);
+			if (m_name.empty())
+				return INVALID;
+
+			// attributes
+			while (true) {
+
+				skipWhitespace();
+
+				if (m_position >= m_size)
+					return INVALID; // the tag was not closed
+
+				// end of the tag
+				if (m_data[m_position] == '>') {
+					m_position += 1;
+					break;
+				}
+
+				if (startsWith("/>", m_position) || startsWith("?>", m_position)) {
+					m_position += 2;
+					m_is_empty_element = true;
+					break;
+				}
+
+				// attribute name
+				size_t attr_start = m_position;
+				while ((m_position < m_size) && !isNameEnd(m_data[m_position]) && (m_data[m_position] != '='))
+					m_position++;
+
+				Attribute attribute;
+				attribute.m_name = std::string_view(m_data + attr_start, m_position - attr_start);
+				if (attribute.m_name.empty())
+					m_position++; // skipping a lonely '/' or '?'
+
+				skipWhitespace();
+
+				// attribute value
+				if ((m_position < m_size) && (m_data[m_position] == '=')) {
+
+					m_position++;
+					skipWhitespace();
+
+					// the value ends at the next whitespace outside of quotes
+					// (quotes are part of the value, there might be text after them, i.e. "terrain"::"grass")
+					size_t value_start = m_position;
+					while ((m_position < m_size) && !isWhitespace(m_data[m_position]) && (m_data[m_position] != '>') && !startsWith("/>", m_position) && !startsWith("?>", m_position)) {
+
+						if ((m_data[m_position] == '"') || (m_data[m_position] == '\'')) {
+							const char* quote_end = (const char*)std::memchr(m_data + m_position + 1, m_data[m_position], m_size - m_position - 1);
+							if (!quote_end)
+								return INVALID;
+
+							m_position = quote_end - m_data;
+						}
+
+						m_position++;
+					}
+
+					attribute.m_value = std::string_view(m_data + value_start, m_position - value_start);
+				}
+
+				if (!attribute.m_name.empty())
+					m_attributes.push_back(attribute);
+			}
+
+			m_open_elements.push_back(m_name);
+
+			return START_TAG;
+		}
+
+		XmlPullParser::Event XmlPullParser::readEndTag() {
+			// reads the end tag after the "</"
+
+			size_t name_start = m_position;
+			while ((m_position < m_size) && !isNameEnd(m_data[m_position]))
+				m_position++;
+
+			m_name = std::string_view(m_data + name_start, m_position - name_start);
+
+			skipWhitespace();
+			if ((m_position >= m_size) || (m_data[m_position] != '>'))
+				return INVALID;
+
+			m_position++;
+
+			// the end tag has to match the last start tag
+			if (m_open_elements.empty() || (m_open_elements.back() != m_name))
+				return INVALID;
+
+			m_open_elements.pop_back();
+
+			return END_TAG;
+		}
+
+		size_t XmlPullParser::find(std::string_view str, size_t position) const {
+			// @return the position of the first occurrence of str at or after the position, m_size if there is none
+
+			if (position >= m_size)
+				return m_size;
+
+			if (str.size() == 1) {
+				const char* found = (const char*)std::memchr(m_data + position, str[0], m_size - position);
+				return found ? (found - m_data) : m_size;
+			}
+
+			const char* found = std::search(m_data + position, m_data + m_size, str.begin(), str.end());
+
+			return found - m_data;
+		}
+
+		bool XmlPullParser::startsWith(std::string_view str, size_t position) const {
+
+			if (position + str.size() > m_size)
+				return false;
+
+			return !std::memcmp(m_data + position, str.data(), str.size());
+		}
+
+		void XmlPullParser::skipWhitespace() {
+
+			while ((m_position < m_size) && isWhitespace(m_data[m_position]))
+				m_position++;
+		}
+
+		bool XmlPullParser::isWhitespace(char c) {
+
+			return (c == ' ') || (c == '\n') || (c == '\t') || (c == '\r');
+		}
+
+		bool XmlPullParser::isNameEnd(char c) {
+			// characters that end a name (of a tag or attribute)
+
+			return isWhitespace(c) || (c == '>') || (c == '/') || (c == '?');
+		}
+
+	} // tools
+
+} // undicht
@@ -0,0 +1,161 @@
+#ifndef XML_PULL_PARSER_H
+#define XML_PULL_PARSER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "linear_arena.h"
+
+namespace undicht {
+
+	namespace tools {
+
+		class XmlPullParser {
+			/** reads a xml file one tag / text at a time (call next() until it returns END_OF_FILE)
+			* the file gets memory mapped, all names, values and contents are views into the mapped file,
+			* so nothing gets copied while parsing (the views stay valid until the parser is closed)
+			* tags dont need to be on separate lines and contents can span multiple lines
+			* comments, doctype declarations and whitespace between tags are skipped
+			* the end tag of the root element may be missing (older versions didnt write it), any other element has to be closed
+			* processing instructions (<?xml ...?>) are reported like empty elements (named "?xml") */
+
+		public:
+
+			enum Event {
+				START_TAG, // <name attr=value> (also for empty elements <name/>, which are followed by an END_TAG)
+				END_TAG, // </name>
+				CONTENT, // the text between tags (or the content of a CDATA section)
+				END_OF_FILE,
+				INVALID // the file is not valid xml (i.e. a tag is not closed or an end tag doesnt match its start tag)
+			};
+
+			struct Attribute {
+				std::string_view m_name;
+				std::string_view m_value; // as it is written in the file (including the quotes, just like XmlTagAttrib::m_value)
+			};
+
+		protected:
+
+			// the data that gets parsed
+			const char* m_data = nullptr;
+			size_t m_size = 0;
+			size_t m_position = 0;
+
+			// the opened file
+			char* m_mapped_data = nullptr;
+			size_t m_mapped_size = 0;
+			std::vector<char> m_file_data; // used instead of the mapping if memory mapping is not supported
+
+			// the current event
+			Event m_event = END_OF_FILE;
+			std::string_view m_name;
+			std::string_view m_content;
+			std::vector<Attribute> m_attributes; // keeps its memory between tags
+			bool m_is_empty_element = false; // the END_TAG for the element still needs to be reported
+
+			// names of the elements that were started, but not ended yet
+			std::vector<std::string_view> m_open_elements;
+
+		public:
+
+			XmlPullParser() = default;
+			XmlPullParser(const std::string& file_name);
+			XmlPullParser(const XmlPullParser&) = delete;
+			XmlPullParser& operator=(const XmlPullParser&) = delete;
+			virtual ~XmlPullParser();
+
+			/// @brief maps the file into memory, parsing starts at the beginning of the file
+			/// @return false if the file could not be opened
+			bool open(const std::string& file_name);
+
+			/// @brief parse data that already is in memory (it doesnt get copied, so it has to stay alive while parsing)
+			void open(const char* data, size_t byte_size);
+
+			void close();
+
+			/// @return all the data that gets parsed (i.e. the content of the opened file)
+			std::string_view getData() const;
+
+			/// @brief reads the next tag / text
+			Event next();
+
+			Event getEvent() const;
+
+			/// @return the name of the current START_TAG / END_TAG
+			std::string_view getName() const;
+
+			/// @return the text of the current CONTENT event (with the whitespace around it)
+			std::string_view getContent() const;
+
+			/// @return the attributes of the current START_TAG
+			const std::vector<Attribute>& getAttributes() const;
+
+			/// @return the value of the attribute of the current START_TAG, an empty view if there is no such attribute
+			std::string_view getAttribute(std::string_view name) const;
+
+			/// @return whether the current START_TAG belongs to an element without end tag (<name/>)
+			bool isEmptyElement() const;
+
+			/// @return the number of elements that are currently open (without the current START_TAG)
+			size_t getDepth() const;
+
+			/// @return the line in which the parser currently is (counting from 1, to report errors)
+			size_t getLine() const;
+
+		public:
+			// building a tree from the parsed data
+
+			struct Node {
+				/** an element of the tree built by readTree(), names and contents point into the parsed data */
+
+				std::string_view m_name;
+				std::string_view m_content; // the first text in the element
+				const Attribute* m_attributes = nullptr;
+				size_t m_attribute_count = 0;
+
+				Node* m_parent = nullptr;
+				Node* m_first_child = nullptr;
+				Node* m_last_child = nullptr;
+				Node* m_next_sibling = nullptr;
+
+				/// @return the first child with the name that comes after the child passed as previous (nullptr to search from the start)
+				const Node* getChild(std::string_view name, const Node* previous = nullptr) const;
+
+				/// @return the value of the attribute, an empty view if there is no such attribute
+				std::string_view getAttribute(std::string_view name) const;
+			};
+
+			/// @brief parses the rest of the data and stores it as a tree, all nodes and attributes are allocated from the arena
+			/// the tree stays valid until the arena is reset or the parser is closed
+			/// @return a node without name that contains the top level elements (processing instructions included),
+			/// nullptr if the data is not valid xml
+			const Node* readTree(LinearArena& arena);
+
+		protected:
+			// protected XmlPullParser functions
+
+			// reads the start tag after the '<'
+			Event readStartTag();
+
+			// reads the end tag after the "</"
+			Event readEndTag();
+
+			// @return the position of the first occurrence of str at or after the position, m_size if there is none
+			size_t find(std::string_view str, size_t position) const;
+
+			bool startsWith(std::string_view str, size_t position) const;
+
+			void skipWhitespace();
+
+			static bool isWhitespace(char c);
+
+			// characters that end a name (of a tag or attribute)
+			static bool isNameEnd(char c);
+
+		};
+
+	} // tools
+
+} // undicht
+
+#endif // XML_PULL_PARSER_H
@@ -0,0 +1,100 @@
+#include "xml_query.h"
+
+namespace undicht {
+
+	namespace tools {
+
+		XmlQuery::XmlQuery(const std::vector<std::string>& attribute_strings) {
+
+			setQuery(attribute_strings);
+		}
+
+		void XmlQuery::setQuery(const std::vector<std::string>& attribute_strings) {
+			/// @param attribute_strings look like this "name attr0=val0 attr1!=val1 ..."
+			/// each one is used to search the child elements of the elements found with the attribute string before it
+
+			m_steps.clear();
+			m_steps.resize(attribute_strings.size());
+
+			for (size_t i = 0; i < attribute_strings.size(); i++) {
+
+				const std::string& attribute_string = attribute_strings.at(i);
+				Step& step = m_steps.at(i);
+
+				// the tag name
+				size_t attr_end = attribute_string.find(' ');
+				if (attr_end == std::string::npos) {
+					// there probably are no attributes following the name
+					attr_end = attribute_string.size();
+				}
+
+				step.m_tag_name = attribute_string.substr(0, attr_end);
+
+				// the attributes (separated by single spaces)
+				while (attr_end != attribute_string.size()) {
+
+					size_t attr_start = attr_end + 1;
+					attr_end = attribute_string.find(' ', attr_start);
+
+					if (attr_end == std::string::npos) {
+						// there probably are no further attributes
+						attr_end = attribute_string.size();
+					}
+
+					step.m_conditions.push_back(createCondition(attribute_string.substr(attr_start, attr_end - attr_start)));
+				}
+
+			}
+
+		}
+
+		bool XmlQuery::setValue(const std::string& attrib_name, const std::string& value, size_t step) {
+			/// @brief changes the value that the attribute of the step gets compared to
+			/// (to reuse the query for elements with different ids, i.e. the chunks of a world file)
+			/// @return false if the step has no condition for the attribute
+
+			if (step >= m_steps.size())
+				return false;
+
+			for (Condition& condition : m_steps.at(step).m_conditions) {
+
+				if (!condition.m_name.compare(attrib_name)) {
+					condition.m_value = value;
+					return true;
+				}
+
+			}
+
+			return false;
+		}
+
+		const std::vector<XmlQuery::Step>& XmlQuery::getSteps() const {
+
+			return m_steps;
+		}
+
+		///////////////////////////////////////////// protected XmlQuery functions /////////////////////////////////////////////
+
+		XmlQuery::Condition XmlQuery::createCondition(const std::string& attribute) const {
+
+			Condition condition;
+
+			size_t split_pos = attribute.find("=");
+
+			if (split_pos == std::string::npos) {
+				// no attribute found
+				condition.m_name = attribute;
+				condition.m_is_valid = false;
+				return condition;
+			}
+
+			condition.m_negate = (attribute.find("!=") != std::string::npos);
+			condition.m_name = attribute.substr(0, split_pos - condition.m_negate);
+			condition.m_value = attribute.substr(split_pos + 1); // skipping the "="
+
+			return condition;
+		}
+
+	} // tools
+
+} // undicht
@@ -0,0 +1,63 @@
+#ifndef XML_QUERY_H
+#define XML_QUERY_H
+
+#include <string>
+#include <vector>
+
+namespace undicht {
+
+	namespace tools {
+
+		class XmlQuery {
+			/** the attribute strings used to search for xml elements (see XmlElement::getElement()),
+			* already split into tag names and attributes, so that the query can be reused without splitting it again
+			* @example XmlQuery query({"profile_COMMON", "newparam sid=sampler", "sampler2D"}); */
+
+		public:
+
+			struct Condition {
+				// the element needs an attribute with the name and value (or a different value, if negated)
+				std::string m_name;
+				std::string m_value;
+				bool m_negate = false;
+				bool m_is_valid = true; // an attribute string without a '=' never matches (just like XmlTagAttrib::operator==)
+			};
+
+			struct Step {
+				// one attribute string of the query
+				std::string m_tag_name;
+				std::vector<Condition> m_conditions;
+			};
+
+		protected:
+
+			std::vector<Step> m_steps;
+
+		public:
+
+			XmlQuery() = default;
+			explicit XmlQuery(const std::vector<std::string>& attribute_strings);
+
+			/// @param attribute_strings look like this "name attr0=val0 attr1!=val1 ..."
+			/// each one is used to search the child elements of the elements found with the attribute string before it
+			void setQuery(const std::vector<std::string>& attribute_strings);
+
+			/// @brief changes the value that the attribute of the step gets compared to
+			/// (to reuse the query for elements with different ids, i.e. the chunks of a world file)
+			/// @return false if the step has no condition for the attribute
+			bool setValue(const std::string& attrib_name, const std::string& value, size_t step = 0);
+
+			const std::vector<Step>& getSteps() const;
+
+		protected:
+			// protected XmlQuery functions
+
+			Condition createCondition(const std::string& attribute) const;
+
+		};
+
+	} // tools
+
+} // undicht
+
+#endif // XML_QUERY_H
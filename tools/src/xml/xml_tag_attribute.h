@@ -23,6 +23,10 @@ namespace undicht {
 
 			XmlTagAttrib();
 			XmlTagAttrib(const std::string& data);
+			XmlTagAttrib(const XmlTagAttrib&) = default;
+			XmlTagAttrib(XmlTagAttrib&&) noexcept = default;
+			XmlTagAttrib& operator=(const XmlTagAttrib&) = default;
+			XmlTagAttrib& operator=(XmlTagAttrib&&) noexcept = default;
 			virtual ~XmlTagAttrib();
 
 		};